@@ -0,0 +1,100 @@
+// Timing harness for the benchmark suite. Each case is run in batches
+// until the time budget is spent; batches grow so that the clock is read
+// rarely compared to the work being measured.
+
+var gcObserver = null;
+var gcTime = 0;
+
+// GC pause accounting needs perf_hooks (node >= 8.5). Older runtimes
+// report GC time as unavailable rather than guessing.
+try {
+  var perfHooks = require('perf_hooks');
+  gcObserver = new perfHooks.PerformanceObserver(function (list) {
+    var entries = list.getEntries();
+    for (var i = 0; i < entries.length; i++) {
+      gcTime += entries[i].duration;
+    }
+  });
+  gcObserver.observe({ entryTypes: ['gc'] });
+} catch (err) {
+  gcObserver = null;
+}
+
+function now () {
+  var t = process.hrtime();
+  return t[0] * 1e3 + t[1] / 1e6;
+}
+
+// Observer callbacks are delivered asynchronously, so GC totals are only
+// settled once the event loop has turned.
+function settle (callback) {
+  setImmediate(callback);
+}
+
+// Rough allocation estimate: heap growth over a batch started from a
+// freshly collected heap, less the growth of an empty batch. Requires
+// --expose-gc; a collection inside the batch shows up as negative growth
+// and makes the sample unusable.
+function heapGrowth (fn, ops) {
+  global.gc();
+  var before = process.memoryUsage().heapUsed;
+  for (var i = 0; i < ops; i++) fn();
+  return process.memoryUsage().heapUsed - before;
+}
+
+function allocationsPerOp (fn) {
+  if (typeof global.gc !== 'function') return null;
+
+  var ops = 1024;
+  var empty = function () {};
+  heapGrowth(empty, ops);
+  var overhead = heapGrowth(empty, ops);
+  var grown = heapGrowth(fn, ops);
+
+  return grown >= 0 ? Math.max(0, grown - overhead) / ops : null;
+}
+
+// Runs `fn` for roughly `options.time` milliseconds and calls back with
+// the measurements. `options.bytes` is the payload size of one operation
+// and is used to derive throughput.
+exports.measure = function measure (fn, options, callback) {
+  var budget = options.time || 1000;
+  var bytes = options.bytes || 0;
+
+  // Warm up so that the first batch does not pay for lazy compilation.
+  for (var i = 0; i < 16; i++) fn();
+
+  var alloc = allocationsPerOp(fn);
+  if (typeof global.gc === 'function') global.gc();
+
+  settle(function () {
+    var gcBefore = gcTime;
+    var ops = 0;
+    var batch = 1;
+    var start = now();
+    var elapsed = 0;
+
+    while (elapsed < budget) {
+      for (var j = 0; j < batch; j++) fn();
+      ops += batch;
+      elapsed = now() - start;
+      if (elapsed < budget / 10) batch *= 2;
+    }
+
+    settle(function () {
+      var seconds = elapsed / 1e3;
+      callback({
+        ops: ops,
+        elapsed: elapsed,
+        opsPerSec: ops / seconds,
+        mbPerSec: bytes ? ops * bytes / seconds / (1024 * 1024) : null,
+        allocPerOp: alloc,
+        gcTime: gcObserver ? gcTime - gcBefore : null
+      });
+    });
+  });
+};
+
+exports.hasGCTime = function () {
+  return gcObserver !== null;
+};
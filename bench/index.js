@@ -0,0 +1,138 @@
+// Benchmark suite for the binding. Run with
+//
+//   npm run bench [-- [filter] [--time=ms] [--json]]
+//
+// `filter` is a substring matched against "<shape>/<operation>". With
+// --json the results are printed as a single JSON document so that runs
+// of two binding versions can be compared mechanically.
+
+var read = require('fs').readFileSync;
+var harness = require('./harness');
+var shapes = require('./shapes');
+var Schema = require('../').Schema;
+
+var options = { filter: null, time: 1000, json: false };
+
+process.argv.slice(2).forEach(function (arg) {
+  if (arg === '--json') {
+    options.json = true;
+  } else if (arg.indexOf('--time=') === 0) {
+    options.time = parseInt(arg.slice(7), 10);
+  } else {
+    options.filter = arg;
+  }
+});
+
+var source = read(__dirname + '/../test/unittest.desc');
+var schema = new Schema(source);
+
+// Builds the list of cases: one per (shape, operation), plus schema load.
+function cases () {
+  var result = [{
+    name: 'schema/load',
+    bytes: source.length,
+    fn: function () { return new Schema(source); }
+  }];
+
+  shapes.forEach(function (shape) {
+    var T = schema[shape.type];
+    var object = shape.build(T);
+    var encoded = T.serialize(object);
+    var json = JSON.stringify(object);
+
+    result.push({
+      name: shape.name + '/parse',
+      bytes: encoded.length,
+      fn: function () { return T.parse(encoded); }
+    }, {
+      name: shape.name + '/serialize',
+      bytes: encoded.length,
+      fn: function () { return T.serialize(object); }
+    }, {
+      name: shape.name + '/roundtrip',
+      bytes: encoded.length,
+      fn: function () { return T.parse(T.serialize(object)); }
+    }, {
+      name: shape.name + '/JSON.parse',
+      bytes: json.length,
+      fn: function () { return JSON.parse(json); }
+    }, {
+      name: shape.name + '/JSON.stringify',
+      bytes: json.length,
+      fn: function () { return JSON.stringify(object); }
+    }, {
+      name: shape.name + '/JSON.roundtrip',
+      bytes: json.length,
+      fn: function () { return JSON.parse(JSON.stringify(object)); }
+    });
+  });
+
+  return result.filter(function (c) {
+    return !options.filter || c.name.indexOf(options.filter) !== -1;
+  });
+}
+
+function pad (s, width) {
+  s = String(s);
+  while (s.length < width) s = ' ' + s;
+  return s;
+}
+
+function fixed (n, digits) {
+  return n === null ? 'n/a' : n.toFixed(digits);
+}
+
+function header () {
+  console.log([
+    'case                          ',
+    pad('ops/s', 12),
+    pad('MB/s', 10),
+    pad('alloc B/op', 12),
+    pad('gc ms', 8)
+  ].join(' '));
+}
+
+function report (name, result) {
+  var label = name;
+  while (label.length < 30) label += ' ';
+  console.log([
+    label,
+    pad(fixed(result.opsPerSec, 0), 12),
+    pad(fixed(result.mbPerSec, 2), 10),
+    pad(fixed(result.allocPerOp, 0), 12),
+    pad(fixed(result.gcTime, 1), 8)
+  ].join(' '));
+}
+
+function run (list, results, done) {
+  if (!list.length) return done(results);
+
+  var c = list.shift();
+  harness.measure(c.fn, { time: options.time, bytes: c.bytes }, function (r) {
+    r.name = c.name;
+    r.bytes = c.bytes;
+    results.push(r);
+    if (!options.json) report(c.name, r);
+    run(list, results, done);
+  });
+}
+
+if (!options.json) {
+  if (typeof global.gc !== 'function') {
+    console.log('note: run with --expose-gc to report allocations');
+  }
+  if (!harness.hasGCTime()) {
+    console.log('note: GC time needs perf_hooks and is not reported');
+  }
+  header();
+}
+
+run(cases(), [], function (results) {
+  if (options.json) {
+    console.log(JSON.stringify({
+      node: process.version,
+      time: options.time,
+      results: results
+    }, null, 2));
+  }
+});
@@ -0,0 +1,82 @@
+// Message shapes exercised by the benchmark suite. All of them are types
+// from test/unittest.desc so the suite needs no schema of its own.
+
+var read = require('fs').readFileSync;
+
+var golden = read(__dirname + '/../test/golden_message');
+
+function range (n, fn) {
+  var result = [];
+  for (var i = 0; i < n; i++) result.push(fn(i));
+  return result;
+}
+
+function repeat (s, length) {
+  var result = '';
+  while (result.length < length) result += s;
+  return result.slice(0, length);
+}
+
+function nest (depth) {
+  var message = { i: depth };
+  for (var i = depth - 1; i >= 0; i--) {
+    message = { a: message, i: i };
+  }
+  return message;
+}
+
+// Each shape names a message type and builds the object to encode. The
+// object is built lazily, once per run, because some of them are large.
+module.exports = [
+  {
+    name: 'all-types',
+    type: 'protobuf_unittest.TestAllTypes',
+    build: function (T) { return T.parse(golden); }
+  },
+  {
+    name: 'deep-nesting',
+    type: 'protobuf_unittest.TestRecursiveMessage',
+    build: function () { return nest(64); }
+  },
+  {
+    name: 'wide-repeated',
+    type: 'protobuf_unittest.TestAllTypes',
+    build: function () {
+      return {
+        repeated_int32: range(256, function (i) { return i; }),
+        repeated_string: range(256, function (i) { return 'entry ' + i; }),
+        repeated_foreign_message: range(256, function (i) { return { c: i }; }),
+        repeated_nested_enum: range(256, function (i) {
+          return ['FOO', 'BAR', 'BAZ'][i % 3];
+        })
+      };
+    }
+  },
+  {
+    name: 'packed-large',
+    type: 'protobuf_unittest.TestPackedTypes',
+    build: function () {
+      return {
+        packed_int32: range(16384, function (i) { return i * 7 - 8192; }),
+        packed_uint32: range(16384, function (i) { return i * 131; }),
+        packed_fixed32: range(16384, function (i) { return i; }),
+        packed_double: range(16384, function (i) { return i / 3; }),
+        packed_bool: range(16384, function (i) { return i % 2 === 0; })
+      };
+    }
+  },
+  {
+    name: 'big-string',
+    type: 'protobuf_unittest.OneString',
+    build: function () { return { data: repeat('protobuf ', 1 << 20) }; }
+  },
+  {
+    name: 'big-bytes',
+    type: 'protobuf_unittest.OneBytes',
+    build: function () {
+      var data = new Buffer(1 << 20);
+      for (var i = 0; i < data.length; i++) data[i] = i & 0xff;
+      return { data: data };
+    }
+  }
+];
@@ -1,40 +1,66 @@
 {
+  'variables': {
+    # Everything but the module definition in src/protobuf.cc, so that the
+    # service test addon can link it too.
+    'binding_sources': [
+      'src/channel.cc',
+      'src/descriptor.cc',
+      'src/diff.cc',
+      'src/fingerprint.cc',
+      'src/rpc.cc',
+      'src/schema.cc',
+      'src/serializer.cc',
+      'src/server.cc',
+      'src/service.cc',
+      'src/stats.cc',
+    ],
+  },
+  'target_defaults': {
+    'include_dirs': [
+      '<!(node -e "require(\'nan\')")',
+      'protobuf/src',
+      'src',
+    ],
+    'dependencies': [
+      'protobuf/protobuf.gyp:protobuf_full_do_not_use',
+    ],
+    'conditions': [
+      # [
+      #   'OS=="linux"', {
+      #     'cflags_cc': [
+      #       '-std=c++0x'
+      #     ]
+      #   }
+      # ],
+      [
+        'OS =="mac"',{
+          # 'cflags_cc': [
+          #   '-std=c++0x'
+          # ],
+          'xcode_settings':{
+            'OTHER_CFLAGS' : [
+              '-mmacosx-version-min=10.7'
+            ],
+          },
+        },
+      ],
+    ],
+  },
   'targets': [
     {
       'target_name': 'binding',
-      'include_dirs': [
-        '<!(node -e "require(\'nan\')")',
-        'protobuf/src',
-        'src',
-      ],
-      'dependencies': [
-        'protobuf/protobuf.gyp:protobuf_full_do_not_use',
-      ],
       'sources': [
-        'src/descriptor.cc',
+        '<@(binding_sources)',
         'src/protobuf.cc',
-        'src/schema.cc',
       ],
-      'conditions': [
-        # [
-        #   'OS=="linux"', {
-        #     'cflags_cc': [
-        #       '-std=c++0x'
-        #     ]
-        #   }
-        # ],
-        [
-          'OS =="mac"',{
-            # 'cflags_cc': [
-            #   '-std=c++0x'
-            # ],
-            'xcode_settings':{
-              'OTHER_CFLAGS' : [
-                '-mmacosx-version-min=10.7'
-              ],
-            },
-          },
-        ],
+    },
+    {
+      # C++ services exported with ExportService(), for test/service.test.js.
+      'target_name': 'service_test',
+      'sources': [
+        '<@(binding_sources)',
+        'test/service_test.cc',
+        'test/service_test.pb.cc',
       ],
     },
   ],
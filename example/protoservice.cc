@@ -14,7 +14,7 @@
 
 #include <pwd.h>
 
-#include "../protobuf_for_node.h"
+#include "../src/service.h"
 #include "protoservice.pb.h"
 
 // Copy a struct passwd into a response message.
@@ -45,47 +45,47 @@ void GetpwentAsync(
 }
 
 
-extern "C" void init(v8::Handle<v8::Object> target) {
-  // Look Ma - no V8 api required!
+// Simple synchronous implementation.
+class SyncPwd : public pwd::Pwd {
+  virtual void GetEntries(google::protobuf::RpcController*,
+                          const pwd::EntriesRequest* request,
+                          pwd::EntriesResponse* response,
+                          google::protobuf::Closure* done) {
+    struct passwd* pwd;
+    while ((pwd = getpwent())) AddEntry(response, pwd);
+    setpwent();
+    done->Run();
+  }
+};
 
-  // Simple synchronous implementation.
-  protobuf_for_node::ExportService(
-      target, "sync",
-      new (class : public pwd::Pwd {
-        virtual void GetEntries(google::protobuf::RpcController*,
-                                const pwd::EntriesRequest* request,
-                                pwd::EntriesResponse* response,
-                                google::protobuf::Closure* done) {
-	  struct passwd* pwd;
-	  while ((pwd = getpwent())) AddEntry(response, pwd);
-	  setpwent();
-	  done->Run();
-        }
-      }));
+// Asynchronous implementation.
+class AsyncPwd : public pwd::Pwd {
+  // This is equivalent to the service call signature.
+  typedef node::protobuf::ServiceCall<
+    const pwd::EntriesRequest, pwd::EntriesResponse> Call;
 
-  // Asynchronous implementation.
-  protobuf_for_node::ExportService(
-      target, "async",
-      new (class : public pwd::Pwd {
-        // This is equivalent to the service call signature.
-        typedef protobuf_for_node::ServiceCall<
-          const pwd::EntriesRequest, pwd::EntriesResponse> Call;
+  static void OnPasswd(struct passwd* pwd, void* data) {
+    AddEntry(Call::Cast(data)->response, pwd);
+  }
 
-        static void OnPasswd(struct passwd* pwd, void* data) {
-	  AddEntry(Call::Cast(data)->response, pwd);
-        }
+  static void OnDone(void* data) {
+    delete Call::Cast(data);  // call complete - invokes done callback
+  }
 
-        static void OnDone(void* data) {
-          delete Call::Cast(data);  // call complete - invokes done callback
-        }
+  virtual void GetEntries(google::protobuf::RpcController*,
+                          const pwd::EntriesRequest* request,
+                          pwd::EntriesResponse* response,
+                          google::protobuf::Closure* done) {
+    GetpwentAsync(OnPasswd,
+                  OnDone,
+                  new Call(request, response, done));
+  }
+};
 
-        virtual void GetEntries(google::protobuf::RpcController*,
-                                const pwd::EntriesRequest* request,
-                                pwd::EntriesResponse* response,
-                                google::protobuf::Closure* done) {
-          GetpwentAsync(OnPasswd,
-                        OnDone,
-                        new Call(request, response, done));
-        }
-      }));
+void init(v8::Handle<v8::Object> target) {
+  // Look Ma - no V8 api required!
+  node::protobuf::ExportService(target, "sync", new SyncPwd);
+  node::protobuf::ExportService(target, "async", new AsyncPwd);
 }
+
+NODE_MODULE(protoservice, init)
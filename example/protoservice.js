@@ -22,9 +22,9 @@ var entries = pwd.sync.GetEntries({});
 puts(entries.entry.length + " users");
 
 // Synchronous implementations can be called callback style, too.
-// They will automatically be placed on the eio thred pool. This is
+// They will automatically be placed on the uv thread pool. This is
 // good for blocking or CPU-consuming tasks.
-pwd.sync.GetEntries({}, function(entries) {
+pwd.sync.GetEntries({}, function(err, entries) {
     // This will print last.
     puts("sync: " + entries.entry.length + " users");
 });
@@ -32,7 +32,7 @@ puts("Getting entries asynchronously from sync service ...");
 
 // Invocations of async services (ones that call "Done" only after the
 // initial service call returns) must be called callback-style.
-pwd.async.GetEntries({}, function(entries) {
+pwd.async.GetEntries({}, function(err, entries) {
     // This will print last.
     puts("async: " + entries.entry.length + " users");
 });
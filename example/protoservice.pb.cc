@@ -1,14 +1,17 @@
 // Generated by the protocol buffer compiler.  DO NOT EDIT!
+// source: protoservice.proto
 
 #define INTERNAL_SUPPRESS_PROTOBUF_FIELD_DEPRECATION
 #include "protoservice.pb.h"
 
 #include <algorithm>
 
+#include <google/protobuf/stubs/common.h>
 #include <google/protobuf/stubs/once.h>
 #include <google/protobuf/io/coded_stream.h>
 #include <google/protobuf/wire_format_lite_inl.h>
 #include <google/protobuf/descriptor.h>
+#include <google/protobuf/generated_message_reflection.h>
 #include <google/protobuf/reflection_ops.h>
 #include <google/protobuf/wire_format.h>
 // @@protoc_insertion_point(includes)
@@ -148,7 +151,6 @@ struct StaticDescriptorInitializer_protoservice_2eproto {
   }
 } static_descriptor_initializer_protoservice_2eproto_;
 
-
 // ===================================================================
 
 #ifndef _MSC_VER
@@ -193,7 +195,8 @@ const ::google::protobuf::Descriptor* EntriesRequest::descriptor() {
 }
 
 const EntriesRequest& EntriesRequest::default_instance() {
-  if (default_instance_ == NULL) protobuf_AddDesc_protoservice_2eproto();  return *default_instance_;
+  if (default_instance_ == NULL) protobuf_AddDesc_protoservice_2eproto();
+  return *default_instance_;
 }
 
 EntriesRequest* EntriesRequest::default_instance_ = NULL;
@@ -202,6 +205,11 @@ EntriesRequest* EntriesRequest::New() const {
   return new EntriesRequest;
 }
 
+EntriesRequest* EntriesRequest::New(::google::protobuf::Arena* arena) const {
+  return static_cast< EntriesRequest*>(
+      ::google::protobuf::Message::New(arena));
+}
+
 void EntriesRequest::Clear() {
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
   mutable_unknown_fields()->Clear();
@@ -240,9 +248,17 @@ void EntriesRequest::SerializeWithCachedSizes(
   return target;
 }
 
+void EntriesRequest::SerializeReverse(
+    ::google::protobuf::io::ReverseCodedOutputStream* output) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsReverse(
+        unknown_fields(), output);
+  }
+}
+
 int EntriesRequest::ByteSize() const {
   int total_size = 0;
-  
+
   if (!unknown_fields().empty()) {
     total_size +=
       ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
@@ -284,7 +300,7 @@ void EntriesRequest::CopyFrom(const EntriesRequest& from) {
 }
 
 bool EntriesRequest::IsInitialized() const {
-  
+
   return true;
 }
 
@@ -367,7 +383,8 @@ const ::google::protobuf::Descriptor* Entry::descriptor() {
 }
 
 const Entry& Entry::default_instance() {
-  if (default_instance_ == NULL) protobuf_AddDesc_protoservice_2eproto();  return *default_instance_;
+  if (default_instance_ == NULL) protobuf_AddDesc_protoservice_2eproto();
+  return *default_instance_;
 }
 
 Entry* Entry::default_instance_ = NULL;
@@ -376,6 +393,11 @@ Entry* Entry::New() const {
   return new Entry;
 }
 
+Entry* Entry::New(::google::protobuf::Arena* arena) const {
+  return static_cast< Entry*>(
+      ::google::protobuf::Message::New(arena));
+}
+
 void Entry::Clear() {
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
     if (has_name()) {
@@ -421,7 +443,7 @@ bool Entry::MergePartialFromCodedStream(
         if (input->ExpectTag(16)) goto parse_uid;
         break;
       }
-      
+
       // optional int32 uid = 2;
       case 2: {
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
@@ -437,7 +459,7 @@ bool Entry::MergePartialFromCodedStream(
         if (input->ExpectTag(24)) goto parse_gid;
         break;
       }
-      
+
       // optional int32 gid = 3;
       case 3: {
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
@@ -453,7 +475,7 @@ bool Entry::MergePartialFromCodedStream(
         if (input->ExpectTag(34)) goto parse_home;
         break;
       }
-      
+
       // optional string home = 4;
       case 4: {
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
@@ -470,7 +492,7 @@ bool Entry::MergePartialFromCodedStream(
         if (input->ExpectTag(42)) goto parse_shell;
         break;
       }
-      
+
       // optional string shell = 5;
       case 5: {
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
@@ -487,7 +509,7 @@ bool Entry::MergePartialFromCodedStream(
         if (input->ExpectAtEnd()) return true;
         break;
       }
-      
+
       default: {
       handle_uninterpreted:
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
@@ -514,17 +536,17 @@ void Entry::SerializeWithCachedSizes(
     ::google::protobuf::internal::WireFormatLite::WriteString(
       1, this->name(), output);
   }
-  
+
   // optional int32 uid = 2;
   if (has_uid()) {
     ::google::protobuf::internal::WireFormatLite::WriteInt32(2, this->uid(), output);
   }
-  
+
   // optional int32 gid = 3;
   if (has_gid()) {
     ::google::protobuf::internal::WireFormatLite::WriteInt32(3, this->gid(), output);
   }
-  
+
   // optional string home = 4;
   if (has_home()) {
     ::google::protobuf::internal::WireFormat::VerifyUTF8String(
@@ -533,7 +555,7 @@ void Entry::SerializeWithCachedSizes(
     ::google::protobuf::internal::WireFormatLite::WriteString(
       4, this->home(), output);
   }
-  
+
   // optional string shell = 5;
   if (has_shell()) {
     ::google::protobuf::internal::WireFormat::VerifyUTF8String(
@@ -542,7 +564,7 @@ void Entry::SerializeWithCachedSizes(
     ::google::protobuf::internal::WireFormatLite::WriteString(
       5, this->shell(), output);
   }
-  
+
   if (!unknown_fields().empty()) {
     ::google::protobuf::internal::WireFormat::SerializeUnknownFields(
         unknown_fields(), output);
@@ -560,17 +582,17 @@ void Entry::SerializeWithCachedSizes(
       ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
         1, this->name(), target);
   }
-  
+
   // optional int32 uid = 2;
   if (has_uid()) {
     target = ::google::protobuf::internal::WireFormatLite::WriteInt32ToArray(2, this->uid(), target);
   }
-  
+
   // optional int32 gid = 3;
   if (has_gid()) {
     target = ::google::protobuf::internal::WireFormatLite::WriteInt32ToArray(3, this->gid(), target);
   }
-  
+
   // optional string home = 4;
   if (has_home()) {
     ::google::protobuf::internal::WireFormat::VerifyUTF8String(
@@ -580,7 +602,7 @@ void Entry::SerializeWithCachedSizes(
       ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
         4, this->home(), target);
   }
-  
+
   // optional string shell = 5;
   if (has_shell()) {
     ::google::protobuf::internal::WireFormat::VerifyUTF8String(
@@ -590,7 +612,7 @@ void Entry::SerializeWithCachedSizes(
       ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
         5, this->shell(), target);
   }
-  
+
   if (!unknown_fields().empty()) {
     target = ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsToArray(
         unknown_fields(), target);
@@ -598,9 +620,54 @@ void Entry::SerializeWithCachedSizes(
   return target;
 }
 
+void Entry::SerializeReverse(
+    ::google::protobuf::io::ReverseCodedOutputStream* output) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsReverse(
+        unknown_fields(), output);
+  }
+
+  // optional string shell = 5;
+  if (has_shell()) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8String(
+      this->shell().data(), this->shell().length(),
+      ::google::protobuf::internal::WireFormat::SERIALIZE);
+    ::google::protobuf::internal::WireFormatLite::WriteStringReverse(
+      5, this->shell(), output);
+  }
+
+  // optional string home = 4;
+  if (has_home()) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8String(
+      this->home().data(), this->home().length(),
+      ::google::protobuf::internal::WireFormat::SERIALIZE);
+    ::google::protobuf::internal::WireFormatLite::WriteStringReverse(
+      4, this->home(), output);
+  }
+
+  // optional int32 gid = 3;
+  if (has_gid()) {
+    ::google::protobuf::internal::WireFormatLite::WriteInt32Reverse(3, this->gid(), output);
+  }
+
+  // optional int32 uid = 2;
+  if (has_uid()) {
+    ::google::protobuf::internal::WireFormatLite::WriteInt32Reverse(2, this->uid(), output);
+  }
+
+  // optional string name = 1;
+  if (has_name()) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8String(
+      this->name().data(), this->name().length(),
+      ::google::protobuf::internal::WireFormat::SERIALIZE);
+    ::google::protobuf::internal::WireFormatLite::WriteStringReverse(
+      1, this->name(), output);
+  }
+}
+
 int Entry::ByteSize() const {
   int total_size = 0;
-  
+
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
     // optional string name = 1;
     if (has_name()) {
@@ -608,35 +675,35 @@ int Entry::ByteSize() const {
         ::google::protobuf::internal::WireFormatLite::StringSize(
           this->name());
     }
-    
+
     // optional int32 uid = 2;
     if (has_uid()) {
       total_size += 1 +
         ::google::protobuf::internal::WireFormatLite::Int32Size(
           this->uid());
     }
-    
+
     // optional int32 gid = 3;
     if (has_gid()) {
       total_size += 1 +
         ::google::protobuf::internal::WireFormatLite::Int32Size(
           this->gid());
     }
-    
+
     // optional string home = 4;
     if (has_home()) {
       total_size += 1 +
         ::google::protobuf::internal::WireFormatLite::StringSize(
           this->home());
     }
-    
+
     // optional string shell = 5;
     if (has_shell()) {
       total_size += 1 +
         ::google::protobuf::internal::WireFormatLite::StringSize(
           this->shell());
     }
-    
+
   }
   if (!unknown_fields().empty()) {
     total_size +=
@@ -696,7 +763,7 @@ void Entry::CopyFrom(const Entry& from) {
 }
 
 bool Entry::IsInitialized() const {
-  
+
   return true;
 }
 
@@ -767,7 +834,8 @@ const ::google::protobuf::Descriptor* EntriesResponse::descriptor() {
 }
 
 const EntriesResponse& EntriesResponse::default_instance() {
-  if (default_instance_ == NULL) protobuf_AddDesc_protoservice_2eproto();  return *default_instance_;
+  if (default_instance_ == NULL) protobuf_AddDesc_protoservice_2eproto();
+  return *default_instance_;
 }
 
 EntriesResponse* EntriesResponse::default_instance_ = NULL;
@@ -776,6 +844,11 @@ EntriesResponse* EntriesResponse::New() const {
   return new EntriesResponse;
 }
 
+EntriesResponse* EntriesResponse::New(::google::protobuf::Arena* arena) const {
+  return static_cast< EntriesResponse*>(
+      ::google::protobuf::Message::New(arena));
+}
+
 void EntriesResponse::Clear() {
   entry_.Clear();
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
@@ -802,7 +875,7 @@ bool EntriesResponse::MergePartialFromCodedStream(
         if (input->ExpectAtEnd()) return true;
         break;
       }
-      
+
       default: {
       handle_uninterpreted:
         if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
@@ -826,7 +899,7 @@ void EntriesResponse::SerializeWithCachedSizes(
     ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
       1, this->entry(i), output);
   }
-  
+
   if (!unknown_fields().empty()) {
     ::google::protobuf::internal::WireFormat::SerializeUnknownFields(
         unknown_fields(), output);
@@ -841,7 +914,7 @@ void EntriesResponse::SerializeWithCachedSizes(
       WriteMessageNoVirtualToArray(
         1, this->entry(i), target);
   }
-  
+
   if (!unknown_fields().empty()) {
     target = ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsToArray(
         unknown_fields(), target);
@@ -849,9 +922,24 @@ void EntriesResponse::SerializeWithCachedSizes(
   return target;
 }
 
+void EntriesResponse::SerializeReverse(
+    ::google::protobuf::io::ReverseCodedOutputStream* output) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsReverse(
+        unknown_fields(), output);
+  }
+
+  // repeated .pwd.Entry entry = 1;
+  for (int i = this->entry_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualReverse(
+        1, this->entry(i), output);
+  }
+}
+
 int EntriesResponse::ByteSize() const {
   int total_size = 0;
-  
+
   // repeated .pwd.Entry entry = 1;
   total_size += 1 * this->entry_size();
   for (int i = 0; i < this->entry_size(); i++) {
@@ -859,7 +947,7 @@ int EntriesResponse::ByteSize() const {
       ::google::protobuf::internal::WireFormatLite::MessageSizeNoVirtual(
         this->entry(i));
   }
-  
+
   if (!unknown_fields().empty()) {
     total_size +=
       ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
@@ -902,7 +990,7 @@ void EntriesResponse::CopyFrom(const EntriesResponse& from) {
 }
 
 bool EntriesResponse::IsInitialized() const {
-  
+
   return true;
 }
 
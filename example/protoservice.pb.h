@@ -8,22 +8,23 @@
 
 #include <google/protobuf/stubs/common.h>
 
-#if GOOGLE_PROTOBUF_VERSION < 2004000
+#if GOOGLE_PROTOBUF_VERSION < 2005000
 #error This file was generated by a newer version of protoc which is
 #error incompatible with your Protocol Buffer headers.  Please update
 #error your headers.
 #endif
-#if 2004000 < GOOGLE_PROTOBUF_MIN_PROTOC_VERSION
+#if 2005000 < GOOGLE_PROTOBUF_MIN_PROTOC_VERSION
 #error This file was generated by an older version of protoc which is
 #error incompatible with your Protocol Buffer headers.  Please
 #error regenerate this file with a newer version of protoc.
 #endif
 
 #include <google/protobuf/generated_message_util.h>
+#include <google/protobuf/message.h>
 #include <google/protobuf/repeated_field.h>
 #include <google/protobuf/extension_set.h>
-#include <google/protobuf/generated_message_reflection.h>
 #include <google/protobuf/service.h>
+#include <google/protobuf/unknown_field_set.h>
 // @@protoc_insertion_point(includes)
 
 namespace pwd {
@@ -43,69 +44,72 @@ class EntriesRequest : public ::google::protobuf::Message {
  public:
   EntriesRequest();
   virtual ~EntriesRequest();
-  
+
   EntriesRequest(const EntriesRequest& from);
-  
+
   inline EntriesRequest& operator=(const EntriesRequest& from) {
     CopyFrom(from);
     return *this;
   }
-  
+
   inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
     return _unknown_fields_;
   }
-  
+
   inline ::google::protobuf::UnknownFieldSet* mutable_unknown_fields() {
     return &_unknown_fields_;
   }
-  
+
   static const ::google::protobuf::Descriptor* descriptor();
   static const EntriesRequest& default_instance();
-  
+
   void Swap(EntriesRequest* other);
-  
+
   // implements Message ----------------------------------------------
-  
+
   EntriesRequest* New() const;
+  EntriesRequest* New(::google::protobuf::Arena* arena) const;
   void CopyFrom(const ::google::protobuf::Message& from);
   void MergeFrom(const ::google::protobuf::Message& from);
   void CopyFrom(const EntriesRequest& from);
   void MergeFrom(const EntriesRequest& from);
   void Clear();
   bool IsInitialized() const;
-  
+
   int ByteSize() const;
   bool MergePartialFromCodedStream(
       ::google::protobuf::io::CodedInputStream* input);
   void SerializeWithCachedSizes(
       ::google::protobuf::io::CodedOutputStream* output) const;
   ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;
+  void SerializeReverse(
+      ::google::protobuf::io::ReverseCodedOutputStream* output) const;
   int GetCachedSize() const { return _cached_size_; }
   private:
   void SharedCtor();
   void SharedDtor();
   void SetCachedSize(int size) const;
   public:
-  
+
   ::google::protobuf::Metadata GetMetadata() const;
-  
+
   // nested types ----------------------------------------------------
-  
+
   // accessors -------------------------------------------------------
-  
+
   // @@protoc_insertion_point(class_scope:pwd.EntriesRequest)
  private:
-  
+
   ::google::protobuf::UnknownFieldSet _unknown_fields_;
-  
-  
+
+
   mutable int _cached_size_;
   ::google::protobuf::uint32 _has_bits_[1];
-  
+
   friend void  protobuf_AddDesc_protoservice_2eproto();
   friend void protobuf_AssignDesc_protoservice_2eproto();
   friend void protobuf_ShutdownFile_protoservice_2eproto();
-  
+
   void InitAsDefaultInstance();
   static EntriesRequest* default_instance_;
 };
@@ -115,56 +119,59 @@ class Entry : public ::google::protobuf::Message {
  public:
   Entry();
   virtual ~Entry();
-  
+
   Entry(const Entry& from);
-  
+
   inline Entry& operator=(const Entry& from) {
     CopyFrom(from);
     return *this;
   }
-  
+
   inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
     return _unknown_fields_;
   }
-  
+
   inline ::google::protobuf::UnknownFieldSet* mutable_unknown_fields() {
     return &_unknown_fields_;
   }
-  
+
   static const ::google::protobuf::Descriptor* descriptor();
   static const Entry& default_instance();
-  
+
   void Swap(Entry* other);
-  
+
   // implements Message ----------------------------------------------
-  
+
   Entry* New() const;
+  Entry* New(::google::protobuf::Arena* arena) const;
   void CopyFrom(const ::google::protobuf::Message& from);
   void MergeFrom(const ::google::protobuf::Message& from);
   void CopyFrom(const Entry& from);
   void MergeFrom(const Entry& from);
   void Clear();
   bool IsInitialized() const;
-  
+
   int ByteSize() const;
   bool MergePartialFromCodedStream(
       ::google::protobuf::io::CodedInputStream* input);
   void SerializeWithCachedSizes(
       ::google::protobuf::io::CodedOutputStream* output) const;
   ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;
+  void SerializeReverse(
+      ::google::protobuf::io::ReverseCodedOutputStream* output) const;
   int GetCachedSize() const { return _cached_size_; }
   private:
   void SharedCtor();
   void SharedDtor();
   void SetCachedSize(int size) const;
   public:
-  
+
   ::google::protobuf::Metadata GetMetadata() const;
-  
+
   // nested types ----------------------------------------------------
-  
+
   // accessors -------------------------------------------------------
-  
+
   // optional string name = 1;
   inline bool has_name() const;
   inline void clear_name();
@@ -175,21 +182,22 @@ class Entry : public ::google::protobuf::Message {
   inline void set_name(const char* value, size_t size);
   inline ::std::string* mutable_name();
   inline ::std::string* release_name();
-  
+  inline void set_allocated_name(::std::string* name);
+
   // optional int32 uid = 2;
   inline bool has_uid() const;
   inline void clear_uid();
   static const int kUidFieldNumber = 2;
   inline ::google::protobuf::int32 uid() const;
   inline void set_uid(::google::protobuf::int32 value);
-  
+
   // optional int32 gid = 3;
   inline bool has_gid() const;
   inline void clear_gid();
   static const int kGidFieldNumber = 3;
   inline ::google::protobuf::int32 gid() const;
   inline void set_gid(::google::protobuf::int32 value);
-  
+
   // optional string home = 4;
   inline bool has_home() const;
   inline void clear_home();
@@ -200,7 +208,8 @@ class Entry : public ::google::protobuf::Message {
   inline void set_home(const char* value, size_t size);
   inline ::std::string* mutable_home();
   inline ::std::string* release_home();
-  
+  inline void set_allocated_home(::std::string* home);
+
   // optional string shell = 5;
   inline bool has_shell() const;
   inline void clear_shell();
@@ -211,7 +220,8 @@ class Entry : public ::google::protobuf::Message {
   inline void set_shell(const char* value, size_t size);
   inline ::std::string* mutable_shell();
   inline ::std::string* release_shell();
-  
+  inline void set_allocated_shell(::std::string* shell);
+
   // @@protoc_insertion_point(class_scope:pwd.Entry)
  private:
   inline void set_has_name();
@@ -224,22 +234,22 @@ class Entry : public ::google::protobuf::Message {
   inline void clear_has_home();
   inline void set_has_shell();
   inline void clear_has_shell();
-  
+
   ::google::protobuf::UnknownFieldSet _unknown_fields_;
-  
+
   ::std::string* name_;
   ::google::protobuf::int32 uid_;
   ::google::protobuf::int32 gid_;
   ::std::string* home_;
   ::std::string* shell_;
-  
+
   mutable int _cached_size_;
   ::google::protobuf::uint32 _has_bits_[(5 + 31) / 32];
-  
+
   friend void  protobuf_AddDesc_protoservice_2eproto();
   friend void protobuf_AssignDesc_protoservice_2eproto();
   friend void protobuf_ShutdownFile_protoservice_2eproto();
-  
+
   void InitAsDefaultInstance();
   static Entry* default_instance_;
 };
@@ -249,56 +259,59 @@ class EntriesResponse : public ::google::protobuf::Message {
  public:
   EntriesResponse();
   virtual ~EntriesResponse();
-  
+
   EntriesResponse(const EntriesResponse& from);
-  
+
   inline EntriesResponse& operator=(const EntriesResponse& from) {
     CopyFrom(from);
     return *this;
   }
-  
+
   inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
     return _unknown_fields_;
   }
-  
+
   inline ::google::protobuf::UnknownFieldSet* mutable_unknown_fields() {
     return &_unknown_fields_;
   }
-  
+
   static const ::google::protobuf::Descriptor* descriptor();
   static const EntriesResponse& default_instance();
-  
+
   void Swap(EntriesResponse* other);
-  
+
   // implements Message ----------------------------------------------
-  
+
   EntriesResponse* New() const;
+  EntriesResponse* New(::google::protobuf::Arena* arena) const;
   void CopyFrom(const ::google::protobuf::Message& from);
   void MergeFrom(const ::google::protobuf::Message& from);
   void CopyFrom(const EntriesResponse& from);
   void MergeFrom(const EntriesResponse& from);
   void Clear();
   bool IsInitialized() const;
-  
+
   int ByteSize() const;
   bool MergePartialFromCodedStream(
       ::google::protobuf::io::CodedInputStream* input);
   void SerializeWithCachedSizes(
       ::google::protobuf::io::CodedOutputStream* output) const;
   ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;
+  void SerializeReverse(
+      ::google::protobuf::io::ReverseCodedOutputStream* output) const;
   int GetCachedSize() const { return _cached_size_; }
   private:
   void SharedCtor();
   void SharedDtor();
   void SetCachedSize(int size) const;
   public:
-  
+
   ::google::protobuf::Metadata GetMetadata() const;
-  
+
   // nested types ----------------------------------------------------
-  
+
   // accessors -------------------------------------------------------
-  
+
   // repeated .pwd.Entry entry = 1;
   inline int entry_size() const;
   inline void clear_entry();
@@ -310,21 +323,21 @@ class EntriesResponse : public ::google::protobuf::Message {
       entry() const;
   inline ::google::protobuf::RepeatedPtrField< ::pwd::Entry >*
       mutable_entry();
-  
+
   // @@protoc_insertion_point(class_scope:pwd.EntriesResponse)
  private:
-  
+
   ::google::protobuf::UnknownFieldSet _unknown_fields_;
-  
+
   ::google::protobuf::RepeatedPtrField< ::pwd::Entry > entry_;
-  
+
   mutable int _cached_size_;
   ::google::protobuf::uint32 _has_bits_[(1 + 31) / 32];
-  
+
   friend void  protobuf_AddDesc_protoservice_2eproto();
   friend void protobuf_AssignDesc_protoservice_2eproto();
   friend void protobuf_ShutdownFile_protoservice_2eproto();
-  
+
   void InitAsDefaultInstance();
   static EntriesResponse* default_instance_;
 };
@@ -338,18 +351,18 @@ class Pwd : public ::google::protobuf::Service {
   inline Pwd() {};
  public:
   virtual ~Pwd();
-  
+
   typedef Pwd_Stub Stub;
-  
+
   static const ::google::protobuf::ServiceDescriptor* descriptor();
-  
+
   virtual void GetEntries(::google::protobuf::RpcController* controller,
                        const ::pwd::EntriesRequest* request,
                        ::pwd::EntriesResponse* response,
                        ::google::protobuf::Closure* done);
-  
+
   // implements Service ----------------------------------------------
-  
+
   const ::google::protobuf::ServiceDescriptor* GetDescriptor();
   void CallMethod(const ::google::protobuf::MethodDescriptor* method,
                   ::google::protobuf::RpcController* controller,
@@ -371,11 +384,11 @@ class Pwd_Stub : public Pwd {
   Pwd_Stub(::google::protobuf::RpcChannel* channel,
                    ::google::protobuf::Service::ChannelOwnership ownership);
   ~Pwd_Stub();
-  
+
   inline ::google::protobuf::RpcChannel* channel() { return channel_; }
-  
+
   // implements Pwd ------------------------------------------
-  
+
   void GetEntries(::google::protobuf::RpcController* controller,
                        const ::pwd::EntriesRequest* request,
                        ::pwd::EntriesResponse* response,
@@ -455,6 +468,18 @@ inline ::std::string* Entry::release_name() {
     return temp;
   }
 }
+inline void Entry::set_allocated_name(::std::string* name) {
+  if (name_ != &::google::protobuf::internal::kEmptyString) {
+    delete name_;
+  }
+  if (name) {
+    set_has_name();
+    name_ = name;
+  } else {
+    clear_has_name();
+    name_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
 
 // optional int32 uid = 2;
 inline bool Entry::has_uid() const {
@@ -557,6 +582,18 @@ inline ::std::string* Entry::release_home() {
     return temp;
   }
 }
+inline void Entry::set_allocated_home(::std::string* home) {
+  if (home_ != &::google::protobuf::internal::kEmptyString) {
+    delete home_;
+  }
+  if (home) {
+    set_has_home();
+    home_ = home;
+  } else {
+    clear_has_home();
+    home_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
 
 // optional string shell = 5;
 inline bool Entry::has_shell() const {
@@ -615,6 +652,18 @@ inline ::std::string* Entry::release_shell() {
     return temp;
   }
 }
+inline void Entry::set_allocated_shell(::std::string* shell) {
+  if (shell_ != &::google::protobuf::internal::kEmptyString) {
+    delete shell_;
+  }
+  if (shell) {
+    set_has_shell();
+    shell_ = shell;
+  } else {
+    clear_has_shell();
+    shell_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
 
 // -------------------------------------------------------------------
 
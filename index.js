@@ -6,26 +6,81 @@ try {
   binding = require('./build/Debug/binding.node');
 }
 
-exports = module.exports = function load (buf) {
-  return new exports.Schema(buf);
+exports = module.exports = function load (buf, options) {
+  return new exports.Schema(buf, options);
 }
 
 exports.Schema = Schema;
 exports.Descriptor = Descriptor;
+exports.Channel = Channel;
+exports.Server = Server;
 
-function Schema (source) {
-  var schema = new binding.Schema(source);
+// Options:
+//   stats: collect per-type call counts, byte counts, errors and latency
+//          histograms for parse and serialize, see Schema#stats.
+//   unknownFields: keep fields that are not in the schema. Parsed objects
+//          carry them as a Buffer in the non-enumerable `_unknownFields`
+//          property, and serialize writes that Buffer back out, so
+//          messages pass through unchanged.
+function Schema (source, options) {
+  var schema = new binding.Schema(source, options);
+  Object.defineProperty(this, '_schema', { value: schema });
   for (var key in schema) {
     this[key] = new exports.Descriptor(this, schema[key]);
   }
 };
 
+// Returns the stats of every message type that has been parsed or
+// serialized since the schema was loaded or the stats were last reset.
+// Latencies are in nanoseconds.
+Schema.prototype.stats = function () {
+  var result = {};
+  for (var key in this) {
+    if (!this.hasOwnProperty(key)) continue;
+    var stats = this[key].stats();
+    if (stats.parse.calls || stats.serialize.calls) {
+      result[key] = stats;
+    }
+  }
+  return result;
+};
+
+Schema.prototype.resetStats = function () {
+  for (var key in this) {
+    if (this.hasOwnProperty(key)) this[key].resetStats();
+  }
+};
+
+// Calls the services of a Server, or of a C++ SocketServer, listening on
+// `address`, a Unix domain socket path or an IPv4 "host:port". Method
+// names are resolved in `schema`:
+//
+//   channel.call('pkg.Service.Method', request, function (err, response) {});
+//
+// The connection keeps the process alive until channel.close().
+function Channel (schema, address) {
+  return new binding.Channel(schema._schema, address);
+}
+
+// Serves services implemented in JS to Channels, on a Unix domain socket
+// path or an IPv4 "host:port". Service names are resolved in `schema`:
+//
+//   server.addService('pkg.Service', {
+//     Method: function (request, callback) { callback(null, response); }
+//   });
+//   server.listen(address);
+//
+// The socket keeps the process alive until server.close().
+function Server (schema) {
+  return new binding.Server(schema._schema);
+}
+
 function Descriptor (schema, descriptor) {
   var fields = descriptor.fields();
 
   Object.defineProperties(descriptor, {
     _objectAsArray: {
-      get: function () {
+      value: function () {
         var result = [];
         for (var i = 0; i < fields.length; i++) {
           result[i] = this[fields[i]];
@@ -34,7 +89,7 @@ function Descriptor (schema, descriptor) {
       }
     },
     _arrayAsObject: {
-      get: function () {
+      value: function () {
         var result = {};
         for (var i = 0; i < fields.length; i++) {
           result[fields[i]] = this[i];
@@ -74,9 +74,12 @@
         'src/google/protobuf/dynamic_message.h',
         'src/google/protobuf/generated_enum_reflection.h',
         'src/google/protobuf/generated_message_reflection.h',
+        'src/google/protobuf/generated_message_table_driven.h',
+        'src/google/protobuf/lazy_field.h',
         'src/google/protobuf/message.h',
         'src/google/protobuf/reflection_ops.h',
         'src/google/protobuf/service.h',
+        'src/google/protobuf/string_piece_field.h',
         'src/google/protobuf/text_format.h',
         'src/google/protobuf/wire_format.h',
         'src/google/protobuf/io/gzip_stream.h',
@@ -109,9 +112,12 @@
         'src/google/protobuf/extension_set.h',
         'src/google/protobuf/extension_set_heavy.cc',
         'src/google/protobuf/generated_message_reflection.cc',
+        'src/google/protobuf/generated_message_table_driven.cc',
+        'src/google/protobuf/lazy_field.cc',
         'src/google/protobuf/message.cc',
         'src/google/protobuf/reflection_ops.cc',
         'src/google/protobuf/service.cc',
+        'src/google/protobuf/string_piece_field.cc',
         'src/google/protobuf/text_format.cc',
         'src/google/protobuf/wire_format.cc',
         # This file pulls in zlib, but it's not actually used by protoc, so
@@ -0,0 +1,148 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <google/protobuf/arena.h>
+
+namespace google {
+namespace protobuf {
+
+#ifndef _MSC_VER
+const size_t Arena::kDefaultBlockSize;
+const size_t Arena::kMaxBlockSize;
+const size_t Arena::kHeaderSize;
+#endif
+
+Arena::Arena()
+  : initial_block_(NULL),
+    initial_block_size_(0) {
+  Init();
+}
+
+Arena::Arena(char* initial_block, size_t initial_block_size)
+  : initial_block_(initial_block),
+    initial_block_size_(initial_block_size) {
+  Init();
+}
+
+Arena::~Arena() {
+  Reset();
+}
+
+void Arena::Init() {
+  blocks_ = NULL;
+  cleanups_ = NULL;
+  next_block_size_ = kDefaultBlockSize;
+  space_allocated_ = 0;
+
+  if (initial_block_ != NULL) {
+    // The caller's buffer carries no alignment guarantee.
+    size_t skip = (8 - (reinterpret_cast<uintptr_t>(initial_block_) & 7)) & 7;
+    if (initial_block_size_ >= skip + kHeaderSize) {
+      Block* block = reinterpret_cast<Block*>(initial_block_ + skip);
+      block->next = NULL;
+      block->size = initial_block_size_ - skip - kHeaderSize;
+      block->pos = 0;
+      block->owned = false;
+      blocks_ = block;
+      space_allocated_ = initial_block_size_;
+    }
+  }
+}
+
+void* Arena::AllocateFromNewBlock(size_t size) {
+  size_t block_size = next_block_size_;
+  if (next_block_size_ < kMaxBlockSize) next_block_size_ *= 2;
+  if (size > block_size - kHeaderSize) block_size = size + kHeaderSize;
+
+  Block* block = reinterpret_cast<Block*>(operator new(block_size));
+  block->size = block_size - kHeaderSize;
+  block->pos = size;
+  block->owned = true;
+  space_allocated_ += block_size;
+
+  // Allocation continues from the head block.  An oversized allocation
+  // leaves its block full, so it goes behind a head that still has room.
+  if (blocks_ != NULL &&
+      block->size - block->pos < blocks_->size - blocks_->pos) {
+    block->next = blocks_->next;
+    blocks_->next = block;
+  } else {
+    block->next = blocks_;
+    blocks_ = block;
+  }
+
+  return block->data();
+}
+
+void Arena::AddCleanup(void* object, void (*cleanup)(void*)) {
+  Cleanup* node = reinterpret_cast<Cleanup*>(AllocateAligned(sizeof(Cleanup)));
+  node->next = cleanups_;
+  node->object = object;
+  node->cleanup = cleanup;
+  cleanups_ = node;
+}
+
+void Arena::RunCleanups() {
+  // Cleanup nodes live in the blocks, which stay put until all have run.
+  while (cleanups_ != NULL) {
+    Cleanup* node = cleanups_;
+    cleanups_ = node->next;
+    node->cleanup(node->object);
+  }
+}
+
+void Arena::Reset() {
+  RunCleanups();
+  while (blocks_ != NULL) {
+    Block* next = blocks_->next;
+    if (blocks_->owned) operator delete(blocks_);
+    blocks_ = next;
+  }
+  Init();
+}
+
+bool Arena::Contains(const void* object) const {
+  const char* p = reinterpret_cast<const char*>(object);
+  for (Block* block = blocks_; block != NULL; block = block->next) {
+    if (p >= block->data() && p < block->data() + block->pos) return true;
+  }
+  return false;
+}
+
+uint64 Arena::SpaceUsed() const {
+  uint64 used = 0;
+  for (Block* block = blocks_; block != NULL; block = block->next) {
+    used += block->pos;
+  }
+  return used;
+}
+
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,276 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Arena is a bump allocator for message trees that are built, used and
+// thrown away together, such as a message parsed to serve one request.
+// Objects are carved out of a chain of blocks and released all at once
+// when the arena is reset or destroyed, instead of being freed one by one.
+//
+//   Arena arena;
+//   Message* message = prototype->New(&arena);
+//   message->ParseFromString(data);
+//   ...
+//   // No delete: the arena frees the whole tree.
+//
+// The first block may be supplied by the caller, typically a stack buffer,
+// so that small trees never touch the heap.  An Arena is not thread-safe.
+
+#ifndef GOOGLE_PROTOBUF_ARENA_H__
+#define GOOGLE_PROTOBUF_ARENA_H__
+
+#include <new>
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+
+namespace internal {
+
+template <typename T>
+void arena_destruct_object(void* object) {
+  reinterpret_cast<T*>(object)->~T();
+}
+
+template <typename T>
+void arena_delete_object(void* object) {
+  delete reinterpret_cast<T*>(object);
+}
+
+}  // namespace internal
+
+class LIBPROTOBUF_EXPORT Arena {
+ public:
+  // Blocks start at kDefaultBlockSize bytes and double up to kMaxBlockSize.
+  static const size_t kDefaultBlockSize = 4096;
+  static const size_t kMaxBlockSize = 64 * 1024;
+
+  Arena();
+
+  // Uses the caller's buffer as the first block.  The buffer is not owned
+  // and must outlive the arena; it is reused after Reset().
+  Arena(char* initial_block, size_t initial_block_size);
+
+  // Runs all cleanups and frees all blocks.
+  ~Arena();
+
+  // Returns `size` bytes aligned to 8 bytes.  The memory is valid until the
+  // arena is reset or destroyed.
+  void* AllocateAligned(size_t size);
+
+  // Constructs a T in the arena.  Its destructor runs when the arena is
+  // reset or destroyed; it must not be deleted.
+  template <typename T>
+  T* Create() {
+    T* object = new(AllocateAligned(sizeof(T))) T();
+    AddCleanup(object, &internal::arena_destruct_object<T>);
+    return object;
+  }
+  template <typename T, typename Arg>
+  T* Create(const Arg& arg) {
+    T* object = new(AllocateAligned(sizeof(T))) T(arg);
+    AddCleanup(object, &internal::arena_destruct_object<T>);
+    return object;
+  }
+
+  // Creates a T in `arena`, or with new if `arena` is NULL.  Message classes
+  // generated with cc_enable_arenas are constructed with the arena, so that
+  // their strings and sub-messages are placed in it too.
+  template <typename T>
+  static T* New(Arena* arena);
+  template <typename T, typename Arg>
+  static T* New(Arena* arena, const Arg& arg);
+
+  // Takes ownership of a heap object, deleting it on reset or destruction.
+  template <typename T>
+  void Own(T* object) {
+    if (object != NULL) {
+      AddCleanup(object, &internal::arena_delete_object<T>);
+    }
+  }
+
+  // Registers `cleanup(object)` to run on reset or destruction.  Cleanups
+  // run in reverse order of registration.
+  void AddCleanup(void* object, void (*cleanup)(void*));
+
+  // Runs all cleanups and frees every block but the first, keeping the
+  // arena ready for reuse.
+  void Reset();
+
+  // Whether `object` lies in memory handed out by this arena.  Walks the
+  // block list, so it is meant for checks rather than hot paths.
+  bool Contains(const void* object) const;
+
+  // Bytes reserved in blocks, and bytes handed out from them.
+  uint64 SpaceAllocated() const { return space_allocated_; }
+  uint64 SpaceUsed() const;
+
+ private:
+  struct Block {
+    Block* next;
+    size_t size;
+    size_t pos;
+    bool owned;
+
+    char* data() { return reinterpret_cast<char*>(this) + kHeaderSize; }
+  };
+
+  struct Cleanup {
+    Cleanup* next;
+    void* object;
+    void (*cleanup)(void*);
+  };
+
+  static const size_t kHeaderSize = (sizeof(Block) + 7) & ~size_t(7);
+
+  Block* blocks_;
+  Cleanup* cleanups_;
+  char* initial_block_;
+  size_t initial_block_size_;
+  size_t next_block_size_;
+  uint64 space_allocated_;
+
+  void Init();
+  void* AllocateFromNewBlock(size_t size);
+  void RunCleanups();
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(Arena);
+};
+
+inline void* Arena::AllocateAligned(size_t size) {
+  size = (size + 7) & ~size_t(7);
+  Block* block = blocks_;
+  if (block != NULL && block->size - block->pos >= size) {
+    void* result = block->data() + block->pos;
+    block->pos += size;
+    return result;
+  }
+  return AllocateFromNewBlock(size);
+}
+
+namespace internal {
+
+// Is T a message class generated with cc_enable_arenas?  Those declare
+// InternalArenaConstructable_ and have a constructor taking an Arena*.
+template <typename T>
+class is_arena_constructable {
+  template <typename U>
+  static char Test(typename U::InternalArenaConstructable_*);
+  template <typename U>
+  static int Test(...);
+
+ public:
+  static const bool value = sizeof(Test<T>(0)) == sizeof(char);
+};
+
+template <typename T, bool = is_arena_constructable<T>::value>
+struct ArenaConstructor {
+  static T* Create(Arena* arena) { return arena->Create<T>(); }
+};
+
+template <typename T>
+struct ArenaConstructor<T, true> {
+  static T* Create(Arena* arena) { return arena->Create<T>(arena); }
+};
+
+// An STL allocator drawing from an arena, or from the heap if the arena is
+// NULL.  Arena memory is only reclaimed with the arena, so a container that
+// keeps growing leaves its old arrays behind until then.
+template <typename T>
+class ArenaAllocator {
+ public:
+  typedef T value_type;
+  typedef T* pointer;
+  typedef const T* const_pointer;
+  typedef T& reference;
+  typedef const T& const_reference;
+  typedef size_t size_type;
+  typedef ptrdiff_t difference_type;
+
+  template <typename U>
+  struct rebind {
+    typedef ArenaAllocator<U> other;
+  };
+
+  explicit ArenaAllocator(Arena* arena = NULL) : arena_(arena) {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) : arena_(other.arena()) {}
+
+  Arena* arena() const { return arena_; }
+
+  pointer address(reference x) const { return &x; }
+  const_pointer address(const_reference x) const { return &x; }
+  size_type max_size() const { return size_type(-1) / sizeof(T); }
+
+  pointer allocate(size_type n, const void* hint = NULL) {
+    void* memory = arena_ == NULL ? operator new(n * sizeof(T))
+                                  : arena_->AllocateAligned(n * sizeof(T));
+    return static_cast<pointer>(memory);
+  }
+  void deallocate(pointer p, size_type n) {
+    if (arena_ == NULL) operator delete(p);
+  }
+
+  void construct(pointer p, const T& value) { new(p) T(value); }
+  void destroy(pointer p) { p->~T(); }
+
+ private:
+  Arena* arena_;
+};
+
+template <typename T, typename U>
+inline bool operator==(const ArenaAllocator<T>& a,
+                       const ArenaAllocator<U>& b) {
+  return a.arena() == b.arena();
+}
+
+template <typename T, typename U>
+inline bool operator!=(const ArenaAllocator<T>& a,
+                       const ArenaAllocator<U>& b) {
+  return a.arena() != b.arena();
+}
+
+}  // namespace internal
+
+template <typename T>
+inline T* Arena::New(Arena* arena) {
+  if (arena == NULL) return new T;
+  return internal::ArenaConstructor<T>::Create(arena);
+}
+
+template <typename T, typename Arg>
+inline T* Arena::New(Arena* arena, const Arg& arg) {
+  if (arena == NULL) return new T(arg);
+  return arena->Create<T>(arg);
+}
+
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_ARENA_H__
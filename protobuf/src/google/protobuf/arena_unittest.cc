@@ -0,0 +1,418 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <string>
+#include <vector>
+
+#include <google/protobuf/arena.h>
+#include <google/protobuf/repeated_field.h>
+#include <google/protobuf/unittest.pb.h>
+#include <google/protobuf/unittest_arena.pb.h>
+#include <google/protobuf/unknown_field_set.h>
+
+#include <google/protobuf/testing/googletest.h>
+#include <gtest/gtest.h>
+
+namespace google {
+namespace protobuf {
+namespace {
+
+struct DestructionLog {
+  DestructionLog() : next_id(0) {}
+  int next_id;
+  std::vector<int> ids;
+};
+
+// Numbered in order of construction; logs its number when destroyed.
+class Tracked {
+ public:
+  explicit Tracked(DestructionLog* log) : log_(log), id_(log->next_id++) {}
+  ~Tracked() { log_->ids.push_back(id_); }
+
+ private:
+  DestructionLog* log_;
+  int id_;
+};
+
+TEST(ArenaTest, AllocateAligned) {
+  Arena arena;
+  for (int size = 1; size < 100; size++) {
+    void* p = arena.AllocateAligned(size);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(p) & 7);
+    memset(p, 0xff, size);
+  }
+  EXPECT_LE(arena.SpaceUsed(), arena.SpaceAllocated());
+}
+
+TEST(ArenaTest, LargeAllocation) {
+  Arena arena;
+  void* small = arena.AllocateAligned(8);
+  void* large = arena.AllocateAligned(1 << 20);
+  memset(large, 0, 1 << 20);
+  // The current block keeps serving small allocations.
+  void* next = arena.AllocateAligned(8);
+  EXPECT_EQ(reinterpret_cast<char*>(small) + 8, next);
+  EXPECT_LT(1 << 20, arena.SpaceAllocated());
+}
+
+TEST(ArenaTest, InitialBlock) {
+  char block[256];
+  Arena arena(block, sizeof(block));
+  char* p = reinterpret_cast<char*>(arena.AllocateAligned(16));
+  EXPECT_TRUE(p >= block && p < block + sizeof(block));
+  EXPECT_EQ(sizeof(block), arena.SpaceAllocated());
+
+  arena.AllocateAligned(1024);
+  EXPECT_LT(sizeof(block), arena.SpaceAllocated());
+
+  arena.Reset();
+  EXPECT_EQ(sizeof(block), arena.SpaceAllocated());
+  EXPECT_EQ(0, arena.SpaceUsed());
+  EXPECT_EQ(p, arena.AllocateAligned(16));
+}
+
+TEST(ArenaTest, TinyInitialBlock) {
+  char block[4];
+  Arena arena(block, sizeof(block));
+  EXPECT_EQ(0, arena.SpaceAllocated());
+  EXPECT_TRUE(arena.AllocateAligned(16) != NULL);
+}
+
+TEST(ArenaTest, CleanupOrder) {
+  DestructionLog log;
+  {
+    Arena arena;
+    arena.Create<Tracked>(&log);
+    arena.Own(new Tracked(&log));
+    arena.Create<Tracked>(&log);
+    EXPECT_TRUE(log.ids.empty());
+  }
+  ASSERT_EQ(3, log.ids.size());
+  EXPECT_EQ(2, log.ids[0]);
+  EXPECT_EQ(1, log.ids[1]);
+  EXPECT_EQ(0, log.ids[2]);
+}
+
+TEST(ArenaTest, ResetRunsCleanups) {
+  DestructionLog log;
+  Arena arena;
+  arena.Create<Tracked>(&log);
+  arena.Reset();
+  EXPECT_EQ(1, log.ids.size());
+  arena.Create<Tracked>(&log);
+  EXPECT_EQ(1, log.ids.size());
+}
+
+TEST(ArenaTest, RepeatedPtrField) {
+  Arena arena;
+  RepeatedPtrField<string>* field =
+      arena.Create<RepeatedPtrField<string>, Arena*>(&arena);
+  for (int i = 0; i < 100; i++) {
+    field->Add()->assign(200, 'a' + i % 26);
+  }
+  EXPECT_EQ(100, field->size());
+
+  // Values passed in become the arena's; values passed out are copies.
+  field->AddAllocated(new string("heap"));
+  string* released = field->ReleaseLast();
+  EXPECT_EQ("heap", *released);
+  delete released;
+
+  field->RemoveLast();
+  field->AddAllocated(new string("replaces a cleared element"));
+
+  string* extracted[2];
+  field->ExtractSubrange(0, 2, extracted);
+  EXPECT_EQ(string(200, 'a'), *extracted[0]);
+  delete extracted[0];
+  delete extracted[1];
+
+  field->DeleteSubrange(0, 10);
+  EXPECT_EQ(88, field->size());
+}
+
+TEST(ArenaTest, RepeatedPtrFieldSwap) {
+  Arena arena;
+  RepeatedPtrField<protobuf_unittest::TestAllTypes> heap_field;
+  RepeatedPtrField<protobuf_unittest::TestAllTypes> arena_field(&arena);
+  heap_field.Add()->set_optional_int32(1);
+  arena_field.Add()->set_optional_int32(2);
+  arena_field.Add()->set_optional_int32(3);
+
+  heap_field.Swap(&arena_field);
+  ASSERT_EQ(2, heap_field.size());
+  ASSERT_EQ(1, arena_field.size());
+  EXPECT_EQ(3, heap_field.Get(1).optional_int32());
+  EXPECT_EQ(1, arena_field.Get(0).optional_int32());
+}
+
+TEST(ArenaTest, NewWithoutArenaSupport) {
+  // Types without cc_enable_arenas are put on the heap for the arena to
+  // delete.
+  Arena arena;
+  protobuf_unittest::TestAllTypes prototype;
+  protobuf_unittest::TestAllTypes* message = prototype.New(&arena);
+  message->set_optional_string("owned by the arena");
+  message->add_repeated_nested_message()->set_bb(1);
+  EXPECT_TRUE(message->GetArena() == NULL);
+  EXPECT_FALSE(arena.Contains(message));
+}
+
+// Tests of messages generated with cc_enable_arenas.  The arena gets a large
+// caller-provided first block so tests can check where objects were placed.
+
+using protobuf_unittest::TestArenaMessage;
+
+class ArenaMessageTest : public testing::Test {
+ protected:
+  ArenaMessageTest() : arena_(block_, sizeof(block_)) {}
+
+  bool InArena(const void* object) const {
+    const char* p = reinterpret_cast<const char*>(object);
+    return p >= block_ && p < block_ + sizeof(block_);
+  }
+
+  char block_[16 * 1024];
+  Arena arena_;
+};
+
+TEST_F(ArenaMessageTest, New) {
+  TestArenaMessage* message = Arena::New<TestArenaMessage>(&arena_);
+  EXPECT_TRUE(InArena(message));
+  message->set_optional_string("a string longer than any small buffer");
+  EXPECT_TRUE(InArena(&message->optional_string()));
+  EXPECT_TRUE(InArena(message->mutable_optional_nested_message()));
+  EXPECT_EQ("hello", message->default_string());
+  message->mutable_default_string()->append(", world");
+  EXPECT_TRUE(InArena(&message->default_string()));
+  EXPECT_EQ("hello, world", message->default_string());
+
+  TestArenaMessage* other = message->New(&arena_);
+  EXPECT_TRUE(InArena(other));
+  other->set_optional_bytes("bytes");
+  EXPECT_TRUE(InArena(&other->optional_bytes()));
+
+  TestArenaMessage* heap = message->New(NULL);
+  heap->set_optional_string("heap");
+  EXPECT_FALSE(InArena(&heap->optional_string()));
+  delete heap;
+}
+
+TEST_F(ArenaMessageTest, ArenaConstructor) {
+  // Only the message itself is on the stack.
+  TestArenaMessage message(&arena_);
+  message.set_optional_string("string");
+  message.add_repeated_string("repeated");
+  message.add_repeated_nested_message()->set_name("nested");
+  EXPECT_TRUE(InArena(&message.optional_string()));
+  EXPECT_TRUE(InArena(&message.repeated_string(0)));
+  EXPECT_TRUE(InArena(&message.repeated_nested_message(0)));
+  EXPECT_TRUE(InArena(&message.repeated_nested_message(0).name()));
+}
+
+TEST_F(ArenaMessageTest, Parse) {
+  TestArenaMessage source;
+  source.set_optional_int32(1);
+  source.set_optional_string("string");
+  source.mutable_optional_nested_message()->set_name("nested");
+  source.mutable_optional_foreign_message()->set_c(2);
+  source.add_repeated_int32(3);
+  source.add_repeated_string("repeated");
+  source.add_repeated_nested_message()->set_bb(4);
+  source.add_repeated_foreign_message()->set_c(5);
+
+  TestArenaMessage* message = Arena::New<TestArenaMessage>(&arena_);
+  ASSERT_TRUE(message->ParseFromString(source.SerializeAsString()));
+  EXPECT_EQ(source.DebugString(), message->DebugString());
+  EXPECT_TRUE(InArena(&message->optional_string()));
+  EXPECT_TRUE(InArena(&message->optional_nested_message()));
+  EXPECT_TRUE(InArena(&message->optional_nested_message().name()));
+  EXPECT_TRUE(InArena(&message->optional_foreign_message()));
+  EXPECT_TRUE(InArena(&message->repeated_string(0)));
+  EXPECT_TRUE(InArena(&message->repeated_nested_message(0)));
+  EXPECT_TRUE(InArena(&message->repeated_foreign_message(0)));
+}
+
+TEST_F(ArenaMessageTest, UnknownFields) {
+  protobuf_unittest::TestEmptyMessage source;
+  UnknownFieldSet* source_fields = source.mutable_unknown_fields();
+  source_fields->AddVarint(1000, 1);
+  source_fields->AddLengthDelimited(1001, string(100, 'x'));
+  source_fields->AddGroup(1002)->AddLengthDelimited(1, "grouped");
+
+  TestArenaMessage* message = Arena::New<TestArenaMessage>(&arena_);
+  ASSERT_TRUE(message->ParseFromString(source.SerializeAsString()));
+  const UnknownFieldSet& fields = message->unknown_fields();
+  ASSERT_EQ(3, fields.field_count());
+  EXPECT_TRUE(InArena(&fields.field(0)));
+  EXPECT_TRUE(InArena(&fields.field(1).length_delimited()));
+  EXPECT_TRUE(InArena(&fields.field(2).group()));
+  EXPECT_TRUE(InArena(&fields.field(2).group().field(0).length_delimited()));
+  EXPECT_EQ(source.SerializeAsString(), message->SerializeAsString());
+
+  // Swapping with a heap message exchanges copies.
+  TestArenaMessage heap_message;
+  heap_message.mutable_unknown_fields()->AddVarint(2000, 2);
+  message->Swap(&heap_message);
+  EXPECT_EQ(source.SerializeAsString(), heap_message.SerializeAsString());
+  EXPECT_FALSE(InArena(&heap_message.unknown_fields().field(1)));
+  ASSERT_EQ(1, message->unknown_fields().field_count());
+  EXPECT_EQ(2000, message->unknown_fields().field(0).number());
+  EXPECT_TRUE(InArena(&message->unknown_fields().field(0)));
+
+  message->mutable_unknown_fields()->Clear();
+  arena_.Reset();
+}
+
+TEST_F(ArenaMessageTest, Reflection) {
+  TestArenaMessage* message = Arena::New<TestArenaMessage>(&arena_);
+  const Reflection* reflection = message->GetReflection();
+  const Descriptor* descriptor = message->GetDescriptor();
+  reflection->SetString(message,
+                        descriptor->FindFieldByName("optional_string"),
+                        "reflected");
+  reflection->AddMessage(
+      message, descriptor->FindFieldByName("repeated_nested_message"));
+  EXPECT_EQ("reflected", message->optional_string());
+  EXPECT_TRUE(InArena(&message->optional_string()));
+  EXPECT_TRUE(InArena(&message->repeated_nested_message(0)));
+}
+
+TEST_F(ArenaMessageTest, ReleaseReturnsHeapCopy) {
+  TestArenaMessage* message = Arena::New<TestArenaMessage>(&arena_);
+  message->set_optional_string("string");
+  message->mutable_optional_nested_message()->set_bb(1);
+
+  scoped_ptr<string> released_string(message->release_optional_string());
+  scoped_ptr<TestArenaMessage::NestedMessage> released_message(
+      message->release_optional_nested_message());
+  EXPECT_FALSE(InArena(released_string.get()));
+  EXPECT_FALSE(InArena(released_message.get()));
+  EXPECT_EQ("string", *released_string);
+  EXPECT_EQ(1, released_message->bb());
+  EXPECT_FALSE(message->has_optional_string());
+  EXPECT_FALSE(message->has_optional_nested_message());
+  EXPECT_TRUE(message->release_optional_nested_message() == NULL);
+}
+
+TEST_F(ArenaMessageTest, SetAllocatedIsOwnedByArena) {
+  TestArenaMessage* message = Arena::New<TestArenaMessage>(&arena_);
+  message->set_allocated_optional_string(new string("string"));
+  message->set_allocated_optional_nested_message(
+      new TestArenaMessage::NestedMessage);
+  // Replacing an arena-owned value must not delete it.
+  message->set_allocated_optional_string(new string("another"));
+  message->set_allocated_optional_nested_message(NULL);
+  EXPECT_EQ("another", message->optional_string());
+  EXPECT_FALSE(message->has_optional_nested_message());
+}
+
+TEST_F(ArenaMessageTest, GetArena) {
+  TestArenaMessage* message = Arena::New<TestArenaMessage>(&arena_);
+  EXPECT_EQ(&arena_, message->GetArena());
+  EXPECT_EQ(&arena_, message->mutable_optional_nested_message()->GetArena());
+  EXPECT_TRUE(message->New(NULL)->GetArena() == NULL);
+
+  TestArenaMessage heap_message;
+  EXPECT_TRUE(heap_message.GetArena() == NULL);
+}
+
+TEST_F(ArenaMessageTest, SetAllocatedArenaMessage) {
+  TestArenaMessage* message = Arena::New<TestArenaMessage>(&arena_);
+  TestArenaMessage::NestedMessage* nested =
+      Arena::New<TestArenaMessage::NestedMessage>(&arena_);
+  nested->set_bb(1);
+
+  // Adopted as it is: the arena must not also delete it.
+  message->set_allocated_optional_nested_message(nested);
+  EXPECT_EQ(nested, &message->optional_nested_message());
+  EXPECT_EQ(1, message->optional_nested_message().bb());
+  message->set_allocated_optional_nested_message(
+      new TestArenaMessage::NestedMessage);
+  arena_.Reset();
+}
+
+#ifdef PROTOBUF_HAS_DEATH_TEST
+
+TEST_F(ArenaMessageTest, SetAllocatedFromOtherArena) {
+  Arena other;
+  TestArenaMessage* message = Arena::New<TestArenaMessage>(&arena_);
+  TestArenaMessage heap_message;
+  TestArenaMessage::NestedMessage* nested =
+      Arena::New<TestArenaMessage::NestedMessage>(&other);
+  EXPECT_DEBUG_DEATH(message->set_allocated_optional_nested_message(nested),
+                     "GetArena");
+  EXPECT_DEBUG_DEATH(
+      heap_message.set_allocated_optional_nested_message(nested), "GetArena");
+  EXPECT_DEBUG_DEATH(
+      message->set_allocated_optional_string(Arena::New<string>(&arena_)),
+      "Contains");
+}
+
+TEST_F(ArenaMessageTest, AddAllocatedArenaElement) {
+  RepeatedPtrField<string> field(&arena_);
+  EXPECT_DEBUG_DEATH(field.AddAllocated(Arena::New<string>(&arena_)),
+                     "Contains");
+  EXPECT_DEBUG_DEATH(field.AddCleared(Arena::New<string>(&arena_)),
+                     "Contains");
+}
+
+#endif  // PROTOBUF_HAS_DEATH_TEST
+
+TEST_F(ArenaMessageTest, SwapAcrossArenas) {
+  TestArenaMessage* message = Arena::New<TestArenaMessage>(&arena_);
+  TestArenaMessage heap_message;
+  message->set_optional_string("arena");
+  message->add_repeated_nested_message()->set_bb(1);
+  heap_message.set_optional_string("heap");
+
+  message->Swap(&heap_message);
+  EXPECT_EQ("heap", message->optional_string());
+  EXPECT_EQ(0, message->repeated_nested_message_size());
+  EXPECT_TRUE(InArena(&message->optional_string()));
+  EXPECT_EQ("arena", heap_message.optional_string());
+  ASSERT_EQ(1, heap_message.repeated_nested_message_size());
+  EXPECT_EQ(1, heap_message.repeated_nested_message(0).bb());
+  EXPECT_FALSE(InArena(&heap_message.optional_string()));
+}
+
+TEST_F(ArenaMessageTest, Reset) {
+  for (int i = 0; i < 3; i++) {
+    TestArenaMessage* message = Arena::New<TestArenaMessage>(&arena_);
+    message->add_repeated_int32(i);
+    message->set_optional_string(string(100, 'x'));
+    message->mutable_optional_foreign_message()->set_c(i);
+    arena_.Reset();
+  }
+}
+
+}  // namespace
+}  // namespace protobuf
+}  // namespace google
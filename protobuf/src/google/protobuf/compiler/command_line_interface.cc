@@ -41,12 +41,19 @@
 #ifdef _MSC_VER
 #include <io.h>
 #include <direct.h>
+#include <process.h>
 #else
+#include <dlfcn.h>
 #include <unistd.h>
 #endif
 #include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
 #include <iostream>
 #include <ctype.h>
+#ifdef __APPLE__
+#include <mach-o/dyld.h>
+#endif
 
 #include <google/protobuf/stubs/hash.h>
 
@@ -178,6 +185,152 @@ bool TryCreateParentDirectory(const string& prefix, const string& filename) {
   return true;
 }
 
+// Reads the whole of the given file into *output.  Returns false if it
+// can't be read.
+bool ReadFileToString(const string& filename, string* output) {
+  int file_descriptor;
+  do {
+    file_descriptor = open(filename.c_str(), O_RDONLY | O_BINARY);
+  } while (file_descriptor < 0 && errno == EINTR);
+  if (file_descriptor < 0) return false;
+
+  io::FileInputStream input(file_descriptor);
+  input.SetCloseOnDelete(true);
+
+  output->clear();
+  const void* data;
+  int size;
+  while (input.Next(&data, &size)) {
+    output->append(static_cast<const char*>(data), size);
+  }
+  return input.GetErrno() == 0;
+}
+
+// Replaces the given file with the given data.  Returns false on error.
+bool WriteStringToFile(const string& filename, const string& data) {
+  int file_descriptor;
+  do {
+    file_descriptor =
+      open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0666);
+  } while (file_descriptor < 0 && errno == EINTR);
+  if (file_descriptor < 0) return false;
+
+  io::FileOutputStream output(file_descriptor);
+  bool success;
+  {
+    io::CodedOutputStream writer(&output);
+    writer.WriteString(data);
+    success = !writer.HadError();
+  }
+  return output.Close() && success;
+}
+
+// Appends a length-prefixed string to *output, and reads one back.
+void WriteLengthDelimited(const string& value,
+                          io::CodedOutputStream* output) {
+  output->WriteVarint32(value.size());
+  output->WriteString(value);
+}
+
+bool ReadLengthDelimited(io::CodedInputStream* input, string* value) {
+  uint32 size;
+  return input->ReadVarint32(&size) && input->ReadString(value, size);
+}
+
+// Appends one field of a cache key.  Fields are length-prefixed so that
+// no two different lists of fields make the same key.
+void AppendKeyField(const string& field, string* key) {
+  key->append(SimpleItoa(field.size()));
+  key->push_back(':');
+  key->append(field);
+}
+
+// Appends the identity of the file at path to *identity, the way plugin
+// servers identify their executables.  Returns false if there is no such
+// file.
+bool AppendFileIdentity(const string& path, string* identity) {
+  struct stat info;
+  if (stat(path.c_str(), &info) != 0) return false;
+  *identity += path + "\n" +
+      SimpleItoa(static_cast<unsigned long long>(info.st_dev)) + "\n" +
+      SimpleItoa(static_cast<unsigned long long>(info.st_ino)) + "\n" +
+      SimpleItoa(static_cast<long long>(info.st_size)) + "\n" +
+      SimpleItoa(static_cast<long long>(info.st_mtime)) + "\n";
+  return true;
+}
+
+// Returns the path of the executable or shared library that contains
+// libprotoc, and so the built-in generators, or "" if it is unknown.
+string GetGeneratorModulePath() {
+  string path;
+#if defined(_WIN32)
+  HMODULE module;
+  char buffer[MAX_PATH];
+  if (GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS |
+                         GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                         reinterpret_cast<LPCSTR>(&GetGeneratorModulePath),
+                         &module)) {
+    DWORD size = GetModuleFileNameA(module, buffer, sizeof(buffer));
+    if (size > 0 && size < sizeof(buffer)) path.assign(buffer, size);
+  }
+#else
+  Dl_info info;
+  if (dladdr(reinterpret_cast<void*>(&GetGeneratorModulePath), &info) != 0 &&
+      info.dli_fname != NULL) {
+    path = info.dli_fname;
+  }
+#endif
+  return path;
+}
+
+// Identifies the running protoc binary and, if the generators live in a
+// shared library such as libprotoc.so, that library too, so that cached
+// output does not outlive the generators that made it even when the
+// version string stays the same.  Generators that an embedding binary
+// links from elsewhere are not covered.  Returns false if the binary
+// cannot be found.
+bool GetExecutableIdentity(const string& argv0, string* identity) {
+  string path;
+#if defined(_WIN32)
+  char buffer[MAX_PATH];
+  DWORD size = GetModuleFileNameA(NULL, buffer, sizeof(buffer));
+  if (size > 0 && size < sizeof(buffer)) path.assign(buffer, size);
+#elif defined(__APPLE__)
+  char buffer[PATH_MAX];
+  uint32_t size = sizeof(buffer);
+  if (_NSGetExecutablePath(buffer, &size) == 0) path = buffer;
+#else
+  char buffer[PATH_MAX];
+  int size = readlink("/proc/self/exe", buffer, sizeof(buffer));
+  if (size > 0 && size < static_cast<int>(sizeof(buffer))) {
+    path.assign(buffer, size);
+  }
+#endif
+  if (path.empty()) path = argv0;
+
+  identity->clear();
+  if (!AppendFileIdentity(path, identity)) return false;
+
+  // dladdr() may name the executable itself by argv[0], which is then
+  // relative, so a module that can't be found is taken to be it.
+  string module = GetGeneratorModulePath();
+  if (!module.empty() && module != path) {
+    AppendFileIdentity(module, identity);
+  }
+  return true;
+}
+
+// A MultiFileErrorCollector that drops all errors.
+class IgnoringErrorCollector : public MultiFileErrorCollector {
+ public:
+  IgnoringErrorCollector() {}
+  ~IgnoringErrorCollector() {}
+
+  // implements MultiFileErrorCollector ------------------------------
+  void AddError(const string& filename, int line, int column,
+                const string& message) {}
+};
+
 }  // namespace
 
 // A MultiFileErrorCollector that prints errors to stderr.
@@ -239,8 +392,10 @@ class CommandLineInterface::GeneratorContextImpl : public GeneratorContext {
   ~GeneratorContextImpl();
 
   // Write all files in the directory to disk at the given output location,
-  // which must end in a '/'.
-  bool WriteAllToDisk(const string& prefix);
+  // which must end in a '/'.  If skip_unchanged is true, files which
+  // already exist with the right contents are left alone, keeping their
+  // modification times.
+  bool WriteAllToDisk(const string& prefix, bool skip_unchanged);
 
   // Write the contents of this directory to a ZIP-format archive with the
   // given name.
@@ -294,6 +449,280 @@ class CommandLineInterface::MemoryOutputStream
   scoped_ptr<io::StringOutputStream> inner_;
 };
 
+// A GeneratorContext for one job of a parallel run.  It records the files
+// written to it, in the order they are closed, so that they can later be
+// replayed into the real GeneratorContextImpl exactly as if the job had
+// written there directly.
+class CommandLineInterface::BufferedGeneratorContext
+    : public GeneratorContext {
+ public:
+  BufferedGeneratorContext(const vector<const FileDescriptor*>& parsed_files);
+  ~BufferedGeneratorContext();
+
+  // Writes every recorded file to generator_context, in order.
+  void Replay(GeneratorContext* generator_context) const;
+
+  // Converts the recorded files to a string, and appends files converted
+  // that way.  Used to keep output in a DiskCache.
+  void SerializeToString(string* output) const;
+  bool ParseFromString(const string& input);
+
+  // implements GeneratorContext --------------------------------------
+  io::ZeroCopyOutputStream* Open(const string& filename);
+  io::ZeroCopyOutputStream* OpenForInsert(
+      const string& filename, const string& insertion_point);
+  void ListParsedFiles(vector<const FileDescriptor*>* output) {
+    *output = parsed_files_;
+  }
+
+ private:
+  struct File {
+    string filename;
+    string insertion_point;
+    string data;
+  };
+
+  // Fills in a File and adds it to the context when closed.
+  class FileOutputStream : public io::ZeroCopyOutputStream {
+   public:
+    FileOutputStream(BufferedGeneratorContext* context, File* file)
+        : context_(context), file_(file),
+          inner_(new io::StringOutputStream(&file->data)) {}
+    ~FileOutputStream() {
+      inner_.reset();
+      context_->files_.push_back(file_);
+    }
+
+    // implements ZeroCopyOutputStream -------------------------------
+    bool Next(void** data, int* size) { return inner_->Next(data, size); }
+    void BackUp(int count)            {        inner_->BackUp(count);    }
+    int64 ByteCount() const           { return inner_->ByteCount();      }
+
+   private:
+    BufferedGeneratorContext* context_;
+    File* file_;
+    scoped_ptr<io::StringOutputStream> inner_;
+  };
+
+  vector<File*> files_;
+  const vector<const FileDescriptor*>& parsed_files_;
+};
+
+// Keeps parsed files and generated code between runs, in the directory
+// given by --cache_dir.  Each entry is a file named by a 128-bit hash of
+// its key, which spells out everything the entry depends on.  Entries are
+// written under a temporary name and renamed into place, so that runs
+// sharing the directory only ever see whole entries.  An entry that can't
+// be read or written just means doing the work again.
+class CommandLineInterface::DiskCache : public ParseCache {
+ public:
+  // The salt is added to every key, so that entries made by other versions
+  // of protoc are never used.
+  DiskCache(const string& directory, const string& salt)
+      : directory_(directory), salt_(salt), next_temporary_(0) {
+    AddTrailingSlash(&directory_);
+  }
+  ~DiskCache() {}
+
+  // Reads the entry with the given key, returning false if there is none.
+  bool Load(const string& key, string* value) {
+    return ReadFileToString(EntryPath(key), value);
+  }
+
+  // Writes the entry with the given key, replacing any that exists.
+  void Store(const string& key, const string& value) {
+    string path = EntryPath(key);
+    string temporary;
+    {
+      MutexLock lock(&mutex_);
+      temporary = path + ".tmp" + SimpleItoa(getpid()) + "-" +
+                  SimpleItoa(next_temporary_++);
+    }
+    if (!WriteStringToFile(temporary, value) ||
+        rename(temporary.c_str(), path.c_str()) != 0) {
+      remove(temporary.c_str());
+    }
+  }
+
+  // Returns a digest of the given file, comments included, and through
+  // their digests of everything it imports, so that keys needn't spell out
+  // whole import graphs.  Digests are remembered for the next call.
+  string FileDigest(const FileDescriptor* file) {
+    {
+      MutexLock lock(&mutex_);
+      map<const FileDescriptor*, string>::const_iterator iter =
+          file_digests_.find(file);
+      if (iter != file_digests_.end()) return iter->second;
+    }
+
+    FileDescriptorProto file_proto;
+    file->CopyTo(&file_proto);
+    file->CopySourceCodeInfoTo(&file_proto);
+
+    string key;
+    AppendKeyField(file_proto.SerializeAsString(), &key);
+    for (int i = 0; i < file->dependency_count(); i++) {
+      AppendKeyField(FileDigest(file->dependency(i)), &key);
+    }
+
+    string digest = Digest(key);
+    MutexLock lock(&mutex_);
+    file_digests_[file] = digest;
+    return digest;
+  }
+
+  // implements ParseCache --------------------------------------------
+  bool Find(const string& filename, const string& contents,
+            FileDescriptorProto* output) {
+    string value;
+    return Load(ParseKey(filename, contents), &value) &&
+           output->ParseFromString(value);
+  }
+  void Add(const string& filename, const string& contents,
+           const FileDescriptorProto& file) {
+    Store(ParseKey(filename, contents), file.SerializeAsString());
+  }
+
+ private:
+  static string ParseKey(const string& filename, const string& contents) {
+    string key;
+    AppendKeyField("parse", &key);
+    AppendKeyField(filename, &key);
+    AppendKeyField(contents, &key);
+    return key;
+  }
+
+  // Returns 128 bits of hash, in hex.
+  static string Digest(const string& data) {
+    static const uint64 kSecondSeed = GOOGLE_ULONGLONG(0x9e3779b97f4a7c15);
+    char buffer[kFastToBufferSize];
+    string digest = FastHex64ToBuffer(
+        HashString64(data.data(), data.size(), 0), buffer);
+    digest += FastHex64ToBuffer(
+        HashString64(data.data(), data.size(), kSecondSeed), buffer);
+    return digest;
+  }
+
+  string EntryPath(const string& key) const {
+    return directory_ + Digest(salt_ + key);
+  }
+
+  string directory_;
+  string salt_;
+  Mutex mutex_;
+  int next_temporary_;
+  map<const FileDescriptor*, string> file_digests_;
+};
+
+// Runs a list of GeneratorJobs on several threads, each job writing to its
+// own BufferedGeneratorContext.  Given a DiskCache, jobs whose output is
+// cached aren't run at all.
+class CommandLineInterface::ParallelGeneration {
+ public:
+  ParallelGeneration(CommandLineInterface* cli,
+                     const vector<const FileDescriptor*>& parsed_files,
+                     const vector<GeneratorJob>& jobs,
+                     DiskCache* cache)
+      : cli_(cli), parsed_files_(parsed_files), jobs_(jobs), cache_(cache),
+        results_(jobs.size()), next_(0), failed_(false) {}
+  ~ParallelGeneration() {
+    for (int i = 0; i < results_.size(); i++) {
+      delete results_[i].output;
+    }
+  }
+
+  // Runs jobs until none are left.  Once a job has failed, no new ones are
+  // started: their output could never be used.
+  void Run() {
+    while (true) {
+      int i;
+      {
+        MutexLock lock(&mutex_);
+        if (failed_ || next_ == jobs_.size()) return;
+        i = next_++;
+      }
+
+      Result* result = &results_[i];
+      result->output = new BufferedGeneratorContext(parsed_files_);
+
+      string cache_key;
+      if (cache_ != NULL) {
+        cache_key = CacheKey(jobs_[i]);
+        string cached;
+        if (!cache_key.empty() && cache_->Load(cache_key, &cached) &&
+            result->output->ParseFromString(cached)) {
+          result->success = true;
+          continue;
+        }
+      }
+
+      result->success = cli_->RunGeneratorJob(
+          parsed_files_, jobs_[i], result->output, &result->error);
+
+      if (result->success && !cache_key.empty()) {
+        string output;
+        result->output->SerializeToString(&output);
+        cache_->Store(cache_key, output);
+      }
+
+      if (!result->success) {
+        MutexLock lock(&mutex_);
+        failed_ = true;
+      }
+    }
+  }
+
+  // Replays the output of each job into its output directory, in job
+  // order, up to and including the first job that failed.  Returns false,
+  // printing the error, if there was one.
+  bool Finish() {
+    for (int i = 0; i < results_.size(); i++) {
+      const Result& result = results_[i];
+      result.output->Replay(jobs_[i].output_directory);
+      if (!result.success) {
+        cerr << result.error << endl;
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  // Returns the key under which the cache keeps the output of the given
+  // job: everything the output depends on.  Plugins can't be cached, since
+  // protoc can't tell when they change; this returns "" for them.
+  string CacheKey(const GeneratorJob& job) {
+    if (job.directive->generator == NULL) return "";
+
+    string key;
+    AppendKeyField("generate", &key);
+    AppendKeyField(job.directive->name, &key);
+    AppendKeyField(job.parameter, &key);
+    for (int i = 0; i < parsed_files_.size(); i++) {
+      AppendKeyField(parsed_files_[i]->name(), &key);
+    }
+    AppendKeyField(cache_->FileDigest(job.file), &key);
+    return key;
+  }
+
+  struct Result {
+    Result() : output(NULL), success(false) {}
+
+    BufferedGeneratorContext* output;
+    bool success;
+    string error;
+  };
+
+  CommandLineInterface* cli_;
+  const vector<const FileDescriptor*>& parsed_files_;
+  const vector<GeneratorJob>& jobs_;
+  DiskCache* cache_;
+  vector<Result> results_;
+  Mutex mutex_;
+  int next_;
+  bool failed_;
+};
+
 // -------------------------------------------------------------------
 
 CommandLineInterface::GeneratorContextImpl::GeneratorContextImpl(
@@ -307,7 +736,7 @@ CommandLineInterface::GeneratorContextImpl::~GeneratorContextImpl() {
 }
 
 bool CommandLineInterface::GeneratorContextImpl::WriteAllToDisk(
-    const string& prefix) {
+    const string& prefix, bool skip_unchanged) {
   if (had_error_) {
     return false;
   }
@@ -327,6 +756,14 @@ bool CommandLineInterface::GeneratorContextImpl::WriteAllToDisk(
     }
     string filename = prefix + relative_filename;
 
+    if (skip_unchanged) {
+      string existing;
+      if (ReadFileToString(filename, &existing) &&
+          existing == *iter->second) {
+        continue;
+      }
+    }
+
     // Create the output file.
     int file_descriptor;
     do {
@@ -561,11 +998,85 @@ CommandLineInterface::MemoryOutputStream::~MemoryOutputStream() {
   }
 }
 
+// -------------------------------------------------------------------
+
+CommandLineInterface::BufferedGeneratorContext::BufferedGeneratorContext(
+    const vector<const FileDescriptor*>& parsed_files)
+    : parsed_files_(parsed_files) {}
+
+CommandLineInterface::BufferedGeneratorContext::~BufferedGeneratorContext() {
+  STLDeleteElements(&files_);
+}
+
+void CommandLineInterface::BufferedGeneratorContext::Replay(
+    GeneratorContext* generator_context) const {
+  for (int i = 0; i < files_.size(); i++) {
+    const File* file = files_[i];
+    scoped_ptr<io::ZeroCopyOutputStream> output(
+        file->insertion_point.empty() ?
+        generator_context->Open(file->filename) :
+        generator_context->OpenForInsert(file->filename,
+                                         file->insertion_point));
+    io::CodedOutputStream writer(output.get());
+    writer.WriteString(file->data);
+  }
+}
+
+void CommandLineInterface::BufferedGeneratorContext::SerializeToString(
+    string* output) const {
+  io::StringOutputStream stream(output);
+  io::CodedOutputStream writer(&stream);
+  for (int i = 0; i < files_.size(); i++) {
+    WriteLengthDelimited(files_[i]->filename, &writer);
+    WriteLengthDelimited(files_[i]->insertion_point, &writer);
+    WriteLengthDelimited(files_[i]->data, &writer);
+  }
+}
+
+bool CommandLineInterface::BufferedGeneratorContext::ParseFromString(
+    const string& input) {
+  io::CodedInputStream reader(reinterpret_cast<const uint8*>(input.data()),
+                              input.size());
+  reader.SetTotalBytesLimit(kint32max, -1);
+
+  vector<File*> files;
+  while (!reader.ExpectAtEnd()) {
+    File* file = new File;
+    files.push_back(file);
+    if (!ReadLengthDelimited(&reader, &file->filename) ||
+        !ReadLengthDelimited(&reader, &file->insertion_point) ||
+        !ReadLengthDelimited(&reader, &file->data)) {
+      STLDeleteElements(&files);
+      return false;
+    }
+  }
+
+  files_.insert(files_.end(), files.begin(), files.end());
+  return true;
+}
+
+io::ZeroCopyOutputStream*
+CommandLineInterface::BufferedGeneratorContext::Open(const string& filename) {
+  File* file = new File;
+  file->filename = filename;
+  return new FileOutputStream(this, file);
+}
+
+io::ZeroCopyOutputStream*
+CommandLineInterface::BufferedGeneratorContext::OpenForInsert(
+    const string& filename, const string& insertion_point) {
+  File* file = new File;
+  file->filename = filename;
+  file->insertion_point = insertion_point;
+  return new FileOutputStream(this, file);
+}
+
 // ===================================================================
 
 CommandLineInterface::CommandLineInterface()
   : mode_(MODE_COMPILE),
     error_format_(ERROR_FORMAT_GCC),
+    jobs_(1),
     imports_in_descriptor_set_(false),
     source_info_in_descriptor_set_(false),
     disallow_services_(false),
@@ -623,16 +1134,62 @@ int CommandLineInterface::Run(int argc, const char* const argv[]) {
     }
   }
 
+  // Set up the cache.
+  scoped_ptr<DiskCache> cache;
+  if (!cache_dir_.empty()) {
+    if (mkdir(cache_dir_.c_str(), 0777) != 0 && errno != EEXIST) {
+      cerr << cache_dir_ << ": " << strerror(errno) << endl;
+      return 1;
+    }
+    string executable_identity;
+    if (!GetExecutableIdentity(executable_name_, &executable_identity)) {
+      cerr << executable_name_ << ": Cannot find the protoc binary to key "
+              "--cache_dir by." << endl;
+      return 1;
+    }
+    cache.reset(new DiskCache(cache_dir_, "libprotoc " +
+        protobuf::internal::VersionString(GOOGLE_PROTOBUF_VERSION) + "\n" +
+        version_info_ + "\n" + executable_identity));
+  }
+
   // Allocate the Importer.
   ErrorPrinter error_collector(error_format_, &source_tree);
-  Importer importer(&source_tree, &error_collector);
+  IgnoringErrorCollector ignoring_error_collector;
+  scoped_ptr<Importer> importer;
+
+  // Files taken from the cache have no source locations to report errors
+  // against.  If any input fails to import that way, start over without
+  // the cache so that the errors come out as usual.
+  if (cache != NULL) {
+    importer.reset(new Importer(&source_tree, &ignoring_error_collector));
+    importer->UseParseCache(cache.get());
+    if (jobs_ > 1) {
+      importer->Prefetch(input_files_, jobs_);
+    }
+    for (int i = 0; i < input_files_.size(); i++) {
+      if (importer->Import(input_files_[i]) == NULL) {
+        importer.reset();
+        break;
+      }
+    }
+  }
+
+  if (importer == NULL) {
+    importer.reset(new Importer(&source_tree, &error_collector));
+
+    // With -j, parse the files and their imports in parallel first;
+    // Import() then only has to build them.
+    if (jobs_ > 1) {
+      importer->Prefetch(input_files_, jobs_);
+    }
+  }
 
   vector<const FileDescriptor*> parsed_files;
 
   // Parse each file.
   for (int i = 0; i < input_files_.size(); i++) {
     // Import the file.
-    const FileDescriptor* parsed_file = importer.Import(input_files_[i]);
+    const FileDescriptor* parsed_file = importer->Import(input_files_[i]);
     if (parsed_file == NULL) return 1;
     parsed_files.push_back(parsed_file);
 
@@ -652,6 +1209,7 @@ int CommandLineInterface::Run(int argc, const char* const argv[]) {
 
   // Generate output.
   if (mode_ == MODE_COMPILE) {
+    vector<GeneratorJob> jobs;
     for (int i = 0; i < output_directives_.size(); i++) {
       string output_location = output_directives_[i].output_location;
       if (!HasSuffixString(output_location, ".zip") &&
@@ -665,10 +1223,12 @@ int CommandLineInterface::Run(int argc, const char* const argv[]) {
         *map_slot = new GeneratorContextImpl(parsed_files);
       }
 
-      if (!GenerateOutput(parsed_files, output_directives_[i], *map_slot)) {
-        STLDeleteValues(&output_directories);
-        return 1;
-      }
+      AddGeneratorJobs(parsed_files, output_directives_[i], *map_slot, &jobs);
+    }
+
+    if (!GenerateOutput(parsed_files, jobs, cache.get())) {
+      STLDeleteValues(&output_directories);
+      return 1;
     }
   }
 
@@ -678,7 +1238,7 @@ int CommandLineInterface::Run(int argc, const char* const argv[]) {
     const string& location = iter->first;
     GeneratorContextImpl* directory = iter->second;
     if (HasSuffixString(location, "/")) {
-      if (!directory->WriteAllToDisk(location)) {
+      if (!directory->WriteAllToDisk(location, cache != NULL)) {
         STLDeleteValues(&output_directories);
         return 1;
       }
@@ -715,7 +1275,7 @@ int CommandLineInterface::Run(int argc, const char* const argv[]) {
         return 1;
       }
     } else {
-      if (!EncodeOrDecode(importer.pool())) {
+      if (!EncodeOrDecode(importer->pool())) {
         return 1;
       }
     }
@@ -738,6 +1298,9 @@ void CommandLineInterface::Clear() {
   imports_in_descriptor_set_ = false;
   source_info_in_descriptor_set_ = false;
   disallow_services_ = false;
+  jobs_ = 1;
+  cache_dir_.clear();
+  plugin_server_dir_.clear();
 }
 
 bool CommandLineInterface::MakeInputsBeProtoPathRelative(
@@ -998,6 +1561,36 @@ CommandLineInterface::InterpretArgument(const string& name,
   } else if (name == "--disallow_services") {
     disallow_services_ = true;
 
+  } else if (name == "-j" || name == "--jobs") {
+    char* end;
+    jobs_ = strto32(value.c_str(), &end, 10);
+    if (value.empty() || *end != '\0' || jobs_ < 1) {
+      cerr << name << " requires a positive number of jobs." << endl;
+      return PARSE_ARGUMENT_FAIL;
+    }
+
+  } else if (name == "--cache_dir") {
+    if (!cache_dir_.empty()) {
+      cerr << name << " may only be passed once." << endl;
+      return PARSE_ARGUMENT_FAIL;
+    }
+    if (value.empty()) {
+      cerr << name << " requires a non-empty value." << endl;
+      return PARSE_ARGUMENT_FAIL;
+    }
+    cache_dir_ = value;
+
+  } else if (name == "--plugin_server_dir") {
+    if (!plugin_server_dir_.empty()) {
+      cerr << name << " may only be passed once." << endl;
+      return PARSE_ARGUMENT_FAIL;
+    }
+    if (value.empty()) {
+      cerr << name << " requires a non-empty value." << endl;
+      return PARSE_ARGUMENT_FAIL;
+    }
+    plugin_server_dir_ = value;
+
   } else if (name == "--encode" || name == "--decode" ||
              name == "--decode_raw") {
     if (mode_ != MODE_COMPILE) {
@@ -1151,7 +1744,15 @@ void CommandLineInterface::PrintHelpText() {
 "                              well as surrounding comments.\n"
 "  --error_format=FORMAT       Set the format in which to print errors.\n"
 "                              FORMAT may be 'gcc' (the default) or 'msvs'\n"
-"                              (Microsoft Visual Studio format)." << endl;
+"                              (Microsoft Visual Studio format).\n"
+"  -jN, --jobs=N               Parse files and run code generators on N\n"
+"                              threads.  Output and errors are the same as\n"
+"                              with one thread.\n"
+"  --cache_dir=DIR             Keep parsed files and generated code in DIR,\n"
+"                              reusing them in later runs whose inputs and\n"
+"                              options are unchanged.  Output files whose\n"
+"                              contents are unchanged are not rewritten.\n"
+"                              Plugin output is not cached." << endl;
   if (!plugin_prefix_.empty()) {
     cerr <<
 "  --plugin=EXECUTABLE         Specifies a plugin executable to use.\n"
@@ -1161,7 +1762,11 @@ void CommandLineInterface::PrintHelpText() {
 "                              Additionally, EXECUTABLE may be of the form\n"
 "                              NAME=PATH, in which case the given plugin name\n"
 "                              is mapped to the given executable even if\n"
-"                              the executable's own name differs." << endl;
+"                              the executable's own name differs.\n"
+"  --plugin_server_dir=DIR     Run plugins which support it as servers that\n"
+"                              stay running between runs, listening on\n"
+"                              sockets in DIR, so that they only start up\n"
+"                              once.  Not supported on Windows." << endl;
   }
 
   for (GeneratorMap::iterator iter = generators_by_flag_name_.begin();
@@ -1175,12 +1780,77 @@ void CommandLineInterface::PrintHelpText() {
   }
 }
 
-bool CommandLineInterface::GenerateOutput(
+void CommandLineInterface::AddGeneratorJobs(
     const vector<const FileDescriptor*>& parsed_files,
     const OutputDirective& output_directive,
-    GeneratorContext* generator_context) {
+    GeneratorContextImpl* generator_context,
+    vector<GeneratorJob>* jobs) {
+  GeneratorJob job;
+  job.directive = &output_directive;
+  job.file = NULL;
+  job.parameter = output_directive.parameter;
+  job.output_directory = generator_context;
+
+  if (output_directive.generator == NULL) {
+    // A plugin gets all the files at once.
+    jobs->push_back(job);
+    return;
+  }
+
+  // Regular generator.
+  const string& option_parameters =
+      generator_parameters_[output_directive.name];
+  if (!option_parameters.empty()) {
+    if (!job.parameter.empty()) {
+      job.parameter.append(",");
+    }
+    job.parameter.append(option_parameters);
+  }
+  for (int i = 0; i < parsed_files.size(); i++) {
+    job.file = parsed_files[i];
+    jobs->push_back(job);
+  }
+}
+
+bool CommandLineInterface::GenerateOutput(
+    const vector<const FileDescriptor*>& parsed_files,
+    const vector<GeneratorJob>& jobs,
+    DiskCache* cache) {
+  if (cache != NULL || (jobs_ > 1 && jobs.size() > 1)) {
+    // Generators only read the descriptors, which are immutable by now, so
+    // jobs can run concurrently.  Their output is buffered and applied in
+    // job order afterwards so that insertion points and errors behave as
+    // they do when run one at a time.  With a cache, even a single thread
+    // goes this way, since the buffered output is what gets cached.
+    ParallelGeneration generation(this, parsed_files, jobs, cache);
+    scoped_ptr<Closure> callback(
+        NewPermanentCallback(&generation, &ParallelGeneration::Run));
+    internal::RunOnThreads(callback.get(),
+                           jobs_ < jobs.size() ? jobs_ : jobs.size());
+    return generation.Finish();
+  }
+
+  for (int i = 0; i < jobs.size(); i++) {
+    string error;
+    if (!RunGeneratorJob(parsed_files, jobs[i], jobs[i].output_directory,
+                         &error)) {
+      cerr << error << endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool CommandLineInterface::RunGeneratorJob(
+    const vector<const FileDescriptor*>& parsed_files,
+    const GeneratorJob& job,
+    GeneratorContext* generator_context,
+    string* error) {
+  const OutputDirective& output_directive = *job.directive;
+
   // Call the generator.
-  string error;
+  string generator_error;
   if (output_directive.generator == NULL) {
     // This is a plugin.
     GOOGLE_CHECK(HasPrefixString(output_directive.name, "--") &&
@@ -1191,29 +1861,20 @@ bool CommandLineInterface::GenerateOutput(
     string plugin_name = plugin_prefix_ + "gen-" +
         output_directive.name.substr(2, output_directive.name.size() - 6);
 
-    if (!GeneratePluginOutput(parsed_files, plugin_name,
-                              output_directive.parameter,
-                              generator_context, &error)) {
-      cerr << output_directive.name << ": " << error << endl;
+    if (!GeneratePluginOutput(parsed_files, plugin_name, job.parameter,
+                              generator_context, &generator_error)) {
+      *error = output_directive.name + ": " + generator_error;
       return false;
     }
   } else {
     // Regular generator.
-    string parameters = output_directive.parameter;
-    if (!generator_parameters_[output_directive.name].empty()) {
-      if (!parameters.empty()) {
-        parameters.append(",");
-      }
-      parameters.append(generator_parameters_[output_directive.name]);
-    }
-    for (int i = 0; i < parsed_files.size(); i++) {
-      if (!output_directive.generator->Generate(parsed_files[i], parameters,
-                                                generator_context, &error)) {
-        // Generator returned an error.
-        cerr << output_directive.name << ": " << parsed_files[i]->name() << ": "
-             << error << endl;
-        return false;
-      }
+    if (!output_directive.generator->Generate(job.file, job.parameter,
+                                              generator_context,
+                                              &generator_error)) {
+      // Generator returned an error.
+      *error = output_directive.name + ": " + job.file->name() + ": " +
+               generator_error;
+      return false;
     }
   }
 
@@ -1243,18 +1904,34 @@ bool CommandLineInterface::GeneratePluginOutput(
   }
 
   // Invoke the plugin.
-  Subprocess subprocess;
-
-  if (plugins_.count(plugin_name) > 0) {
-    subprocess.Start(plugins_[plugin_name], Subprocess::EXACT_NAME);
-  } else {
-    subprocess.Start(plugin_name, Subprocess::SEARCH_PATH);
+  const string* plugin_path = FindOrNull(plugins_, plugin_name);
+  const string& program = plugin_path != NULL ? *plugin_path : plugin_name;
+  Subprocess::SearchMode search_mode = plugin_path != NULL ?
+      Subprocess::EXACT_NAME : Subprocess::SEARCH_PATH;
+
+  // With --plugin_server_dir, use a server for the plugin if it can run as
+  // one.  If the server fails in any way, run the plugin as usual, so that
+  // a real problem is reported the usual way.
+  bool served = false;
+  if (!plugin_server_dir_.empty()) {
+    PluginServerConnection server;
+    string server_error;
+    served = server.Connect(program, search_mode, plugin_server_dir_) &&
+             server.Communicate(request, &response, &server_error);
+    if (!served) {
+      response.Clear();
+    }
   }
 
-  string communicate_error;
-  if (!subprocess.Communicate(request, &response, &communicate_error)) {
-    *error = strings::Substitute("$0: $1", plugin_name, communicate_error);
-    return false;
+  if (!served) {
+    Subprocess subprocess;
+    subprocess.Start(program, search_mode);
+
+    string communicate_error;
+    if (!subprocess.Communicate(request, &response, &communicate_error)) {
+      *error = strings::Substitute("$0: $1", plugin_name, communicate_error);
+      return false;
+    }
   }
 
   // Write the files.  We do this even if there was a generator error in order
@@ -189,6 +189,9 @@ class LIBPROTOC_EXPORT CommandLineInterface {
   class ErrorPrinter;
   class GeneratorContextImpl;
   class MemoryOutputStream;
+  class BufferedGeneratorContext;
+  class ParallelGeneration;
+  class DiskCache;
 
   // Clear state from previous Run().
   void Clear();
@@ -231,9 +234,18 @@ class LIBPROTOC_EXPORT CommandLineInterface {
 
   // Generate the given output file from the given input.
   struct OutputDirective;  // see below
+  struct GeneratorJob;     // see below
+  void AddGeneratorJobs(const vector<const FileDescriptor*>& parsed_files,
+                        const OutputDirective& output_directive,
+                        GeneratorContextImpl* generator_context,
+                        vector<GeneratorJob>* jobs);
   bool GenerateOutput(const vector<const FileDescriptor*>& parsed_files,
-                      const OutputDirective& output_directive,
-                      GeneratorContext* generator_context);
+                      const vector<GeneratorJob>& jobs,
+                      DiskCache* cache);
+  bool RunGeneratorJob(const vector<const FileDescriptor*>& parsed_files,
+                       const GeneratorJob& job,
+                       GeneratorContext* generator_context,
+                       string* error);
   bool GeneratePluginOutput(const vector<const FileDescriptor*>& parsed_files,
                             const string& plugin_name,
                             const string& parameter,
@@ -320,6 +332,26 @@ class LIBPROTOC_EXPORT CommandLineInterface {
   };
   vector<OutputDirective> output_directives_;
 
+  // One call to a code generator: a compiled-in generator run over a single
+  // file, or a plugin run over all of them.  With -j, jobs run concurrently.
+  struct GeneratorJob {
+    const OutputDirective* directive;
+    const FileDescriptor* file;          // NULL for plugins
+    string parameter;                    // Including any --foo_opt values.
+    GeneratorContextImpl* output_directory;
+  };
+
+  // Number of threads to parse and generate with (-j).
+  int jobs_;
+
+  // If --cache_dir was given, the directory in which parsed files and
+  // generated code are kept between runs.  Otherwise, empty.
+  string cache_dir_;
+
+  // If --plugin_server_dir was given, the directory in which plugins
+  // running as servers listen.  Otherwise, empty.
+  string plugin_server_dir_;
+
   // When using --encode or --decode, this names the type we are encoding or
   // decoding.  (Empty string indicates --decode_raw.)
   string codec_type_;
@@ -37,8 +37,11 @@
 #include <fcntl.h>
 #ifdef _MSC_VER
 #include <io.h>
+#include <sys/utime.h>
 #else
+#include <dirent.h>
 #include <unistd.h>
+#include <utime.h>
 #endif
 #include <vector>
 
@@ -48,6 +51,7 @@
 #include <google/protobuf/compiler/command_line_interface.h>
 #include <google/protobuf/compiler/code_generator.h>
 #include <google/protobuf/compiler/mock_code_generator.h>
+#include <google/protobuf/compiler/plugin.pb.h>
 #include <google/protobuf/compiler/subprocess.h>
 #include <google/protobuf/io/printer.h>
 #include <google/protobuf/unittest.pb.h>
@@ -163,6 +167,21 @@ class CommandLineInterfaceTest : public testing::Test {
   void ReadDescriptorSet(const string& filename,
                          FileDescriptorSet* descriptor_set);
 
+  // Gets and sets the modification time of a file in temp_directory_.
+  time_t GetTempFileMtime(const string& filename);
+  void SetTempFileMtime(const string& filename, time_t mtime);
+
+#ifndef _WIN32
+  // Counts the files in the given temp directory whose names end in suffix.
+  int CountTempFiles(const string& dirname, const string& suffix);
+
+  // Makes a file in temp_directory_ executable.
+  void MakeTempFileExecutable(const string& filename);
+
+  // Returns the full path of a file in temp_directory_.
+  string TempPath(const string& filename);
+#endif
+
  private:
   // The object we are testing.
   CommandLineInterface cli_;
@@ -422,6 +441,45 @@ void CommandLineInterfaceTest::ReadDescriptorSet(
   }
 }
 
+time_t CommandLineInterfaceTest::GetTempFileMtime(const string& filename) {
+  string path = temp_directory_ + "/" + filename;
+  struct stat info;
+  EXPECT_EQ(0, stat(path.c_str(), &info)) << path;
+  return info.st_mtime;
+}
+
+void CommandLineInterfaceTest::SetTempFileMtime(const string& filename,
+                                                time_t mtime) {
+  string path = temp_directory_ + "/" + filename;
+  struct utimbuf times = { mtime, mtime };
+  EXPECT_EQ(0, utime(path.c_str(), &times)) << path;
+}
+
+#ifndef _WIN32
+int CommandLineInterfaceTest::CountTempFiles(const string& dirname,
+                                             const string& suffix) {
+  string path = temp_directory_ + "/" + dirname;
+  DIR* dir = opendir(path.c_str());
+  EXPECT_TRUE(dir != NULL) << path;
+  if (dir == NULL) return 0;
+  int count = 0;
+  while (struct dirent* entry = readdir(dir)) {
+    if (HasSuffixString(entry->d_name, suffix)) ++count;
+  }
+  closedir(dir);
+  return count;
+}
+
+void CommandLineInterfaceTest::MakeTempFileExecutable(const string& filename) {
+  string path = temp_directory_ + "/" + filename;
+  EXPECT_EQ(0, chmod(path.c_str(), 0755)) << path;
+}
+
+string CommandLineInterfaceTest::TempPath(const string& filename) {
+  return temp_directory_ + "/" + filename;
+}
+#endif
+
 // ===================================================================
 
 TEST_F(CommandLineInterfaceTest, BasicOutput) {
@@ -603,6 +661,123 @@ TEST_F(CommandLineInterfaceTest, Insert) {
       "foo.proto", "Foo");
 }
 
+TEST_F(CommandLineInterfaceTest, ParallelInsert) {
+  // Test that with -j, output from concurrent generators and plugins is
+  // combined as if they had run one at a time.
+
+  CreateTempFile("foo.proto",
+    "syntax = \"proto2\";\n"
+    "message Foo {}\n");
+
+  Run("protocol_compiler -j4 "
+      "--test_out=TestParameter:$tmpdir "
+      "--plug_out=TestPluginParameter:$tmpdir "
+      "--test_out=insert=test_generator,test_plugin:$tmpdir "
+      "--plug_out=insert=test_generator,test_plugin:$tmpdir "
+      "--proto_path=$tmpdir foo.proto");
+
+  ExpectNoErrors();
+  ExpectGeneratedWithInsertions(
+      "test_generator", "TestParameter", "test_generator,test_plugin",
+      "foo.proto", "Foo");
+  ExpectGeneratedWithInsertions(
+      "test_plugin", "TestPluginParameter", "test_generator,test_plugin",
+      "foo.proto", "Foo");
+}
+
+TEST_F(CommandLineInterfaceTest, BadJobs) {
+  CreateTempFile("foo.proto",
+    "syntax = \"proto2\";\n"
+    "message Foo {}\n");
+
+  Run("protocol_compiler --jobs=0 --test_out=$tmpdir "
+      "--proto_path=$tmpdir foo.proto");
+
+  ExpectErrorText("--jobs requires a positive number of jobs.\n");
+}
+
+TEST_F(CommandLineInterfaceTest, CacheDirKeepsUnchangedOutput) {
+  // Test that with --cache_dir, outputs whose contents haven't changed are
+  // not rewritten.
+
+  CreateTempFile("foo.proto",
+    "syntax = \"proto2\";\n"
+    "message Foo {}\n");
+
+  Run("protocol_compiler --cache_dir=$tmpdir/cache "
+      "--test_out=$tmpdir --proto_path=$tmpdir foo.proto");
+  ExpectNoErrors();
+  ExpectGenerated("test_generator", "", "foo.proto", "Foo");
+
+  // Backdate the output, then generate it again.
+  const char* output = "foo.proto.MockCodeGenerator.test_generator";
+  SetTempFileMtime(output, 1000000);
+
+  Run("protocol_compiler --cache_dir=$tmpdir/cache "
+      "--test_out=$tmpdir --proto_path=$tmpdir foo.proto");
+  ExpectNoErrors();
+  ExpectGenerated("test_generator", "", "foo.proto", "Foo");
+
+  EXPECT_EQ(1000000, GetTempFileMtime(output));
+
+  // Without --cache_dir, the output is always written.
+  Run("protocol_compiler "
+      "--test_out=$tmpdir --proto_path=$tmpdir foo.proto");
+  ExpectNoErrors();
+  EXPECT_NE(1000000, GetTempFileMtime(output));
+}
+
+TEST_F(CommandLineInterfaceTest, CacheDirNoticesChanges) {
+  // Test that cached output isn't used once an input changes.
+
+  CreateTempFile("foo.proto",
+    "syntax = \"proto2\";\n"
+    "import \"bar.proto\";\n"
+    "message Foo { optional Bar a = 1; }\n");
+  CreateTempFile("bar.proto",
+    "syntax = \"proto2\";\n"
+    "message Bar {}\n");
+
+  Run("protocol_compiler --cache_dir=$tmpdir/cache "
+      "--test_out=$tmpdir --proto_path=$tmpdir foo.proto");
+  ExpectNoErrors();
+  ExpectGenerated("test_generator", "", "foo.proto", "Foo");
+
+  CreateTempFile("foo.proto",
+    "syntax = \"proto2\";\n"
+    "import \"bar.proto\";\n"
+    "message Qux { optional Bar a = 1; }\n");
+
+  Run("protocol_compiler --cache_dir=$tmpdir/cache "
+      "--test_out=$tmpdir --proto_path=$tmpdir foo.proto");
+  ExpectNoErrors();
+  ExpectGenerated("test_generator", "", "foo.proto", "Qux");
+
+  // A change to an import matters too.
+  CreateTempFile("bar.proto",
+    "syntax = \"proto2\";\n"
+    "message Baz {}\n");
+
+  Run("protocol_compiler --cache_dir=$tmpdir/cache "
+      "--test_out=$tmpdir --proto_path=$tmpdir foo.proto");
+  ExpectErrorText("foo.proto:3:24: \"Bar\" is not defined.\n");
+}
+
+TEST_F(CommandLineInterfaceTest, CacheDirReportsErrors) {
+  // Test that errors are reported with their locations even when every
+  // file was parsed from the cache.
+
+  CreateTempFile("foo.proto",
+    "syntax = \"proto2\";\n"
+    "message Foo { optional Bar a = 1; }\n");
+
+  for (int i = 0; i < 2; i++) {
+    Run("protocol_compiler --cache_dir=$tmpdir/cache "
+        "--test_out=$tmpdir --proto_path=$tmpdir foo.proto");
+    ExpectErrorText("foo.proto:2:24: \"Bar\" is not defined.\n");
+  }
+}
+
 #if defined(_WIN32)
 
 TEST_F(CommandLineInterfaceTest, WindowsOutputPath) {
@@ -949,6 +1124,30 @@ TEST_F(CommandLineInterfaceTest, ParseErrorsMultipleFiles) {
     "foo.proto: Import \"baz.proto\" was not found or had errors.\n");
 }
 
+TEST_F(CommandLineInterfaceTest, ParallelParseErrors) {
+  // Test that with -j, parse errors are reported exactly as without it.
+
+  CreateTempFile("bar.proto",
+    "syntax = \"proto2\";\n"
+    "badsyntax\n");
+  CreateTempFile("baz.proto",
+    "syntax = \"proto2\";\n"
+    "import \"bar.proto\";\n");
+  CreateTempFile("foo.proto",
+    "syntax = \"proto2\";\n"
+    "import \"bar.proto\";\n"
+    "import \"baz.proto\";\n");
+
+  Run("protocol_compiler -j 4 --test_out=$tmpdir "
+      "--proto_path=$tmpdir foo.proto");
+
+  ExpectErrorText(
+    "bar.proto:2:1: Expected top-level statement (e.g. \"message\").\n"
+    "baz.proto: Import \"bar.proto\" was not found or had errors.\n"
+    "foo.proto: Import \"bar.proto\" was not found or had errors.\n"
+    "foo.proto: Import \"baz.proto\" was not found or had errors.\n");
+}
+
 TEST_F(CommandLineInterfaceTest, InputNotFoundError) {
   // Test what happens if the input file is not found.
 
@@ -1237,6 +1436,146 @@ TEST_F(CommandLineInterfaceTest, PluginReceivesSourceCodeInfo) {
       "Saw message type MockCodeGenerator_HasSourceCodeInfo: 1.");
 }
 
+#ifndef _WIN32
+TEST_F(CommandLineInterfaceTest, PluginServer) {
+  // Test that --plugin_server_dir leaves the plugin running and that later
+  // runs get the same output from it.
+
+  CreateTempFile("foo.proto",
+    "syntax = \"proto2\";\n"
+    "message Foo {}\n");
+  CreateTempDir("servers");
+
+  for (int i = 0; i < 2; i++) {
+    Run("protocol_compiler --plug_out=TestParameter:$tmpdir "
+        "--plugin_server_dir=$tmpdir/servers "
+        "--proto_path=$tmpdir foo.proto");
+
+    ExpectNoErrors();
+    ExpectGenerated("test_plugin", "TestParameter", "foo.proto", "Foo");
+  }
+
+  // The server is listening on a socket in the directory.  It exits on its
+  // own once TearDown() deletes the socket.
+  EXPECT_EQ(1, CountTempFiles("servers", ".sock"));
+}
+
+TEST_F(CommandLineInterfaceTest, PluginServerError) {
+  // Errors from a plugin server are reported just like errors from a plugin
+  // run directly.
+
+  CreateTempFile("foo.proto",
+    "syntax = \"proto2\";\n"
+    "message MockCodeGenerator_Error {}\n");
+  CreateTempDir("servers");
+
+  Run("protocol_compiler --plug_out=TestParameter:$tmpdir "
+      "--plugin_server_dir=$tmpdir/servers "
+      "--proto_path=$tmpdir foo.proto");
+
+  ExpectErrorSubstring(
+      "--plug_out: foo.proto: Saw message type MockCodeGenerator_Error.");
+}
+
+TEST_F(CommandLineInterfaceTest, PluginServerFail) {
+  // If the server dies mid-request, protoc runs the plugin directly, so the
+  // failure is reported the usual way.
+
+  CreateTempFile("foo.proto",
+    "syntax = \"proto2\";\n"
+    "message MockCodeGenerator_Exit {}\n");
+  CreateTempDir("servers");
+
+  Run("protocol_compiler --plug_out=TestParameter:$tmpdir "
+      "--plugin_server_dir=$tmpdir/servers "
+      "--proto_path=$tmpdir foo.proto");
+
+  ExpectErrorSubstring("Saw message type MockCodeGenerator_Exit.");
+  ExpectErrorSubstring(
+      "--plug_out: prefix-gen-plug: Plugin failed with status code 123.");
+}
+
+TEST_F(CommandLineInterfaceTest, PluginServerBadRequest) {
+  // A request the server can't build the files of closes the connection,
+  // so that protoc runs the plugin directly to report the error.
+
+  CreateTempDir("servers");
+  string error;
+
+  CodeGeneratorRequest request;
+  CodeGeneratorResponse response;
+  request.add_file_to_generate("missing.proto");
+  {
+    PluginServerConnection server;
+    ASSERT_TRUE(server.Connect("test_plugin", Subprocess::EXACT_NAME,
+                               TempPath("servers")));
+    EXPECT_FALSE(server.Communicate(request, &response, &error));
+    EXPECT_EQ("Plugin server closed the connection.", error);
+  }
+
+  // The server still answers on new connections.
+  request.Clear();
+  request.add_file_to_generate("foo.proto");
+  request.set_parameter("TestParameter");
+  FileDescriptorProto* file = request.add_proto_file();
+  file->set_name("foo.proto");
+  file->add_message_type()->set_name("Foo");
+
+  PluginServerConnection server;
+  ASSERT_TRUE(server.Connect("test_plugin", Subprocess::EXACT_NAME,
+                             TempPath("servers")));
+  ASSERT_TRUE(server.Communicate(request, &response, &error)) << error;
+  EXPECT_FALSE(response.has_error()) << response.error();
+  EXPECT_LT(0, response.file_size());
+}
+
+TEST_F(CommandLineInterfaceTest, PluginServerNotSupported) {
+  // A plugin which can't run as a server is run directly, and protoc only
+  // tries to start it as a server once.
+
+  CreateTempFile("foo.proto",
+    "syntax = \"proto2\";\n"
+    "message Foo {}\n");
+  CreateTempDir("servers");
+  // Leaves a .probe file for each attempt to start it as a server, and
+  // otherwise replies with an empty CodeGeneratorResponse.
+  CreateTempFile("plugins/noserve",
+    "#!/bin/sh\n"
+    "case \"$1\" in\n"
+    "  --protoc_server=*) : > \"$0.$$.probe\"; exit 1;;\n"
+    "esac\n"
+    "cat > /dev/null\n");
+  MakeTempFileExecutable("plugins/noserve");
+
+  for (int i = 0; i < 2; i++) {
+    Run("protocol_compiler --noserve_out=$tmpdir "
+        "--plugin=prefix-gen-noserve=$tmpdir/plugins/noserve "
+        "--plugin_server_dir=$tmpdir/servers "
+        "--proto_path=$tmpdir foo.proto");
+
+    ExpectNoErrors();
+  }
+
+  EXPECT_EQ(1, CountTempFiles("plugins", ".probe"));
+  EXPECT_EQ(1, CountTempFiles("servers", ".failed"));
+}
+
+TEST_F(CommandLineInterfaceTest, PluginServerDirMissing) {
+  // A server directory that can't be used just means no server.
+
+  CreateTempFile("foo.proto",
+    "syntax = \"proto2\";\n"
+    "message Foo {}\n");
+
+  Run("protocol_compiler --plug_out=TestParameter:$tmpdir "
+      "--plugin_server_dir=$tmpdir/no_such_dir "
+      "--proto_path=$tmpdir foo.proto");
+
+  ExpectNoErrors();
+  ExpectGenerated("test_plugin", "TestParameter", "foo.proto", "Foo");
+}
+#endif  // !_WIN32
+
 TEST_F(CommandLineInterfaceTest, GeneratorPluginNotFound) {
   // Test what happens if the plugin isn't found.
 
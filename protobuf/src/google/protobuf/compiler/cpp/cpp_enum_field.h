@@ -61,6 +61,7 @@ class EnumFieldGenerator : public FieldGenerator {
   void GenerateMergeFromCodedStream(io::Printer* printer) const;
   void GenerateSerializeWithCachedSizes(io::Printer* printer) const;
   void GenerateSerializeWithCachedSizesToArray(io::Printer* printer) const;
+  void GenerateSerializeReverse(io::Printer* printer) const;
   void GenerateByteSize(io::Printer* printer) const;
 
  private:
@@ -88,6 +89,7 @@ class RepeatedEnumFieldGenerator : public FieldGenerator {
   void GenerateMergeFromCodedStreamWithPacking(io::Printer* printer) const;
   void GenerateSerializeWithCachedSizes(io::Printer* printer) const;
   void GenerateSerializeWithCachedSizesToArray(io::Printer* printer) const;
+  void GenerateSerializeReverse(io::Printer* printer) const;
   void GenerateByteSize(io::Printer* printer) const;
 
  private:
@@ -39,6 +39,8 @@
 #include <google/protobuf/compiler/cpp/cpp_enum_field.h>
 #include <google/protobuf/compiler/cpp/cpp_message_field.h>
 #include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/lazy_field.h>
+#include <google/protobuf/string_piece_field.h>
 #include <google/protobuf/wire_format.h>
 #include <google/protobuf/io/printer.h>
 #include <google/protobuf/stubs/common.h>
@@ -112,8 +114,14 @@ FieldGenerator* FieldGeneratorMap::MakeGenerator(const FieldDescriptor* field,
   } else {
     switch (field->cpp_type()) {
       case FieldDescriptor::CPPTYPE_MESSAGE:
+        if (internal::IsLazyField(field)) {
+          return new LazyMessageFieldGenerator(field, options);
+        }
         return new MessageFieldGenerator(field, options);
       case FieldDescriptor::CPPTYPE_STRING:
+        if (internal::IsStringPieceField(field)) {
+          return new StringPieceFieldGenerator(field, options);
+        }
         switch (field->options().ctype()) {
           default:  // StringFieldGenerator handles unknown ctypes.
           case FieldOptions::STRING:
@@ -142,6 +142,12 @@ class FieldGenerator {
   virtual void GenerateSerializeWithCachedSizesToArray(
       io::Printer* printer) const = 0;
 
+  // Generate lines to write this field to the ReverseCodedOutputStream
+  // "output", which are placed within the message's SerializeReverse()
+  // method.  Everything is written back to front: repeated elements last
+  // one first, and the tag after the value.
+  virtual void GenerateSerializeReverse(io::Printer* printer) const = 0;
+
   // Generate lines to compute the serialized size of this field, which
   // are placed in the message's ByteSize() method.
   virtual void GenerateByteSize(io::Printer* printer) const = 0;
@@ -148,6 +148,27 @@ void FileGenerator::GenerateHeader(io::Printer* printer) {
       "#include <google/protobuf/generated_enum_reflection.h>\n");
   }
 
+  if (HasLazyFields(file_)) {
+    printer->Print(
+      "#include <google/protobuf/lazy_field.h>\n");
+  }
+
+  if (HasStringPieceFields(file_)) {
+    printer->Print(
+      "#include <google/protobuf/string_piece_field.h>\n");
+  }
+
+  if (SupportsArenas(file_) && file_->message_type_count() > 0) {
+    printer->Print(
+      "#include <google/protobuf/arena.h>\n");
+  }
+
+  if (file_->options().optimize_for() == FileOptions::TABLE_DRIVEN &&
+      file_->message_type_count() > 0) {
+    printer->Print(
+      "#include <google/protobuf/generated_message_table_driven.h>\n");
+  }
+
   if (HasGenericServices(file_)) {
     printer->Print(
       "#include <google/protobuf/service.h>\n");
@@ -39,6 +39,8 @@
 
 #include <google/protobuf/compiler/cpp/cpp_helpers.h>
 #include <google/protobuf/io/printer.h>
+#include <google/protobuf/lazy_field.h>
+#include <google/protobuf/string_piece_field.h>
 #include <google/protobuf/stubs/common.h>
 #include <google/protobuf/stubs/strutil.h>
 #include <google/protobuf/stubs/substitute.h>
@@ -432,6 +434,40 @@ bool HasEnumDefinitions(const FileDescriptor* file) {
   return false;
 }
 
+static bool HasLazyFields(const Descriptor* message_type) {
+  for (int i = 0; i < message_type->field_count(); ++i) {
+    if (internal::IsLazyField(message_type->field(i))) return true;
+  }
+  for (int i = 0; i < message_type->nested_type_count(); ++i) {
+    if (HasLazyFields(message_type->nested_type(i))) return true;
+  }
+  return false;
+}
+
+bool HasLazyFields(const FileDescriptor* file) {
+  for (int i = 0; i < file->message_type_count(); ++i) {
+    if (HasLazyFields(file->message_type(i))) return true;
+  }
+  return false;
+}
+
+static bool HasStringPieceFields(const Descriptor* message_type) {
+  for (int i = 0; i < message_type->field_count(); ++i) {
+    if (internal::IsStringPieceField(message_type->field(i))) return true;
+  }
+  for (int i = 0; i < message_type->nested_type_count(); ++i) {
+    if (HasStringPieceFields(message_type->nested_type(i))) return true;
+  }
+  return false;
+}
+
+bool HasStringPieceFields(const FileDescriptor* file) {
+  for (int i = 0; i < file->message_type_count(); ++i) {
+    if (HasStringPieceFields(file->message_type(i))) return true;
+  }
+  return false;
+}
+
 }  // namespace cpp
 }  // namespace compiler
 }  // namespace protobuf
@@ -130,6 +130,12 @@ inline bool HasUnknownFields(const FileDescriptor* file) {
 // Does this file have any enum type definitions?
 bool HasEnumDefinitions(const FileDescriptor* file);
 
+// Does this file have any fields stored in an internal::LazyField?
+bool HasLazyFields(const FileDescriptor* file);
+
+// Does this file have any fields stored in an internal::StringPieceField?
+bool HasStringPieceFields(const FileDescriptor* file);
+
 // Does this file have generated parsing, serialization, and other
 // standard methods for which reflection-based fallback implementations exist?
 inline bool HasGeneratedMethods(const FileDescriptor* file) {
@@ -153,11 +159,34 @@ inline bool HasUtf8Verification(const FileDescriptor* file) {
   return file->options().optimize_for() != FileOptions::LITE_RUNTIME;
 }
 
+// Can messages in this file be created in an Arena, and then place their
+// strings and sub-messages there too?
+inline bool SupportsArenas(const FileDescriptor* file) {
+  return file->options().cc_enable_arenas() && HasDescriptorMethods(file);
+}
+
+// Does this message parse and serialize itself by handing a table of its
+// fields to TableInterpreter?  MessageSets keep their generated methods.
+inline bool HasTableDrivenMethods(const Descriptor* descriptor) {
+  return descriptor->file()->options().optimize_for() ==
+             FileOptions::TABLE_DRIVEN &&
+         !descriptor->options().message_set_wire_format();
+}
+
 // Should we generate a separate, super-optimized code path for serializing to
 // flat arrays?  We don't do this in Lite mode because we'd rather reduce code
-// size.
+// size.  Table-driven messages have one that just calls TableInterpreter.
 inline bool HasFastArraySerialization(const FileDescriptor* file) {
-  return file->options().optimize_for() == FileOptions::SPEED;
+  return file->options().optimize_for() == FileOptions::SPEED ||
+         file->options().optimize_for() == FileOptions::TABLE_DRIVEN;
+}
+
+// Should we generate SerializeReverse(), which serializes in one pass without
+// ByteSize()?  Only for SPEED, for the same reason as above; other messages,
+// and MessageSets, inherit the MessageLite version, which uses ByteSize().
+inline bool HasReverseSerialization(const Descriptor* descriptor) {
+  return descriptor->file()->options().optimize_for() == FileOptions::SPEED &&
+         !descriptor->options().message_set_wire_format();
 }
 
 // Returns whether we have to generate code with static initializers.
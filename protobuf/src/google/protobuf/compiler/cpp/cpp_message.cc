@@ -47,6 +47,7 @@
 #include <google/protobuf/io/coded_stream.h>
 #include <google/protobuf/wire_format.h>
 #include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/lazy_field.h>
 
 
 namespace google {
@@ -108,7 +109,8 @@ struct ExtensionRangeSorter {
 // given field.
 inline static bool ShouldIgnoreRequiredFieldCheck(
     const FieldDescriptor* field) {
-  return false;
+  // Checking would mean parsing the field, defeating laziness.
+  return internal::IsLazyField(field);
 }
 
 // Returns true if the message type has any required fields.  If it doesn't,
@@ -479,6 +481,19 @@ GenerateClassDefinition(io::Printer* printer) {
     "}\n"
     "\n");
 
+  if (SupportsArenas(descriptor_->file())) {
+    printer->Print(vars,
+      "// Creates a message whose strings and sub-messages are allocated in\n"
+      "// arena.  Use New(arena) or ::google::protobuf::Arena::New() to place the message\n"
+      "// itself there too.\n"
+      "explicit $classname$(::google::protobuf::Arena* arena);\n"
+      "typedef void InternalArenaConstructable_;\n"
+      "\n"
+      "// The arena given to the constructor, or NULL.\n"
+      "inline ::google::protobuf::Arena* GetArena() const { return _arena_; }\n"
+      "\n");
+  }
+
   if (HasUnknownFields(descriptor_->file())) {
     printer->Print(
       "inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {\n"
@@ -523,6 +538,10 @@ GenerateClassDefinition(io::Printer* printer) {
     "// implements Message ----------------------------------------------\n"
     "\n"
     "$classname$* New() const;\n");
+  if (HasDescriptorMethods(descriptor_->file())) {
+    printer->Print(vars,
+      "$classname$* New(::google::protobuf::Arena* arena) const;\n");
+  }
 
   if (HasGeneratedMethods(descriptor_->file())) {
     if (HasDescriptorMethods(descriptor_->file())) {
@@ -549,6 +568,11 @@ GenerateClassDefinition(io::Printer* printer) {
       printer->Print(
         "::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;\n");
     }
+    if (HasReverseSerialization(descriptor_)) {
+      printer->Print(
+        "void SerializeReverse(\n"
+        "    ::google::protobuf::io::ReverseCodedOutputStream* output) const;\n");
+    }
   }
 
   printer->Print(vars,
@@ -648,6 +672,12 @@ GenerateClassDefinition(io::Printer* printer) {
       "\n");
   }
 
+  if (SupportsArenas(descriptor_->file())) {
+    printer->Print(
+      "::google::protobuf::Arena* _arena_;\n"
+      "\n");
+  }
+
   // Field members:
 
   vector<const FieldDescriptor*> fields;
@@ -703,6 +733,22 @@ GenerateClassDefinition(io::Printer* printer) {
       GlobalAssignDescriptorsName(descriptor_->file()->name()),
     "shutdownfilename", GlobalShutdownFileName(descriptor_->file()->name()));
 
+  if (HasTableDrivenMethods(descriptor_)) {
+    if (descriptor_->field_count() > 0) {
+      printer->Print(vars,
+        "static const ::google::protobuf::internal::TableField"
+        " _table_fields_[$field_count$];\n");
+    }
+    if (descriptor_->extension_range_count() > 0) {
+      printer->Print(
+        "static const int _table_extension_ranges_[$count$];\n",
+        "count", SimpleItoa(2 * descriptor_->extension_range_count()));
+    }
+    printer->Print(
+      "static const ::google::protobuf::internal::MessageTable _table_;\n"
+      "\n");
+  }
+
   printer->Print(
     "void InitAsDefaultInstance();\n"
     "static $classname$* default_instance_;\n",
@@ -787,8 +833,14 @@ GenerateDescriptorInitializer(io::Printer* printer, int index) {
     "    ::google::protobuf::DescriptorPool::generated_pool(),\n");
   printer->Print(vars,
     "    ::google::protobuf::MessageFactory::generated_factory(),\n");
-  printer->Print(vars,
-    "    sizeof($classname$));\n");
+  if (SupportsArenas(descriptor_->file())) {
+    printer->Print(vars,
+      "    sizeof($classname$),\n"
+      "    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET($classname$, _arena_));\n");
+  } else {
+    printer->Print(vars,
+      "    sizeof($classname$));\n");
+  }
 
   // Handle nested types.
   for (int i = 0; i < descriptor_->nested_type_count(); i++) {
@@ -918,6 +970,11 @@ GenerateClassMethods(io::Printer* printer) {
   GenerateStructors(printer);
   printer->Print("\n");
 
+  if (HasTableDrivenMethods(descriptor_)) {
+    GenerateTable(printer);
+    printer->Print("\n");
+  }
+
   if (HasGeneratedMethods(descriptor_->file())) {
     GenerateClear(printer);
     printer->Print("\n");
@@ -933,6 +990,11 @@ GenerateClassMethods(io::Printer* printer) {
       printer->Print("\n");
     }
 
+    if (HasReverseSerialization(descriptor_)) {
+      GenerateSerializeReverse(printer);
+      printer->Print("\n");
+    }
+
     GenerateByteSize(printer);
     printer->Print("\n");
 
@@ -992,6 +1054,136 @@ GenerateOffsets(io::Printer* printer) {
   printer->Print("};\n");
 }
 
+void MessageGenerator::
+GenerateTable(io::Printer* printer) {
+  map<string, string> vars;
+  vars["classname"] = classname_;
+  vars["field_count"] = SimpleItoa(descriptor_->field_count());
+  vars["range_count"] = SimpleItoa(descriptor_->extension_range_count());
+
+  if (descriptor_->field_count() > 0) {
+    printer->Print(vars,
+      "const ::google::protobuf::internal::TableField"
+      " $classname$::_table_fields_[$field_count$] = {\n");
+    printer->Indent();
+
+    scoped_array<const FieldDescriptor*> ordered_fields(
+      SortFieldsByNumber(descriptor_));
+
+    for (int i = 0; i < descriptor_->field_count(); i++) {
+      const FieldDescriptor* field = ordered_fields[i];
+      map<string, string> field_vars(vars);
+      field_vars["name"] = FieldName(field);
+      string type = field->type_name();
+      UpperString(&type);
+      field_vars["type"] = "TYPE_" + type;
+      field_vars["default_value"] = "NULL";
+      field_vars["enum_is_valid"] = "NULL";
+      field_vars["prototype"] = "NULL";
+
+      bool packed = field->is_packable() && field->options().packed();
+      if (packed) {
+        field_vars["tag"] = SimpleItoa(WireFormatLite::MakeTag(
+            field->number(), WireFormatLite::WIRETYPE_LENGTH_DELIMITED));
+        field_vars["label"] = "PACKED";
+        // Packed fields keep the size of their data where the has-bit would
+        // be.
+        field_vars["has_bit"] =
+            "GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(" + classname_ +
+            ", _" + FieldName(field) + "_cached_byte_size_)";
+      } else {
+        field_vars["tag"] = SimpleItoa(WireFormat::MakeTag(field));
+        field_vars["label"] = field->is_repeated() ? "REPEATED" : "SINGULAR";
+        field_vars["has_bit"] =
+            field->is_repeated() ? "-1" : SimpleItoa(field->index());
+      }
+
+      switch (field->cpp_type()) {
+        case FieldDescriptor::CPPTYPE_STRING:
+          if (!field->is_repeated() &&
+              !field->default_value_string().empty()) {
+            field_vars["default_value"] = "&_default_" + FieldName(field) + "_";
+          }
+          break;
+        case FieldDescriptor::CPPTYPE_ENUM:
+          field_vars["enum_is_valid"] =
+              "&" + ClassName(field->enum_type(), true) + "_IsValid";
+          break;
+        case FieldDescriptor::CPPTYPE_MESSAGE:
+          field_vars["prototype"] =
+              "&::google::protobuf::internal::TablePrototype< " +
+              ClassName(field->message_type(), true) + " >";
+          break;
+        default:
+          break;
+      }
+
+      PrintFieldComment(printer, field);
+      printer->Print(field_vars,
+        "{ $tag$u, ::google::protobuf::internal::WireFormatLite::$type$,\n"
+        "  ::google::protobuf::internal::TableField::$label$,\n"
+        "  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET($classname$, $name$_),\n"
+        "  $has_bit$, $default_value$, $enum_is_valid$, $prototype$ },\n");
+    }
+
+    printer->Outdent();
+    printer->Print("};\n");
+  }
+
+  if (descriptor_->extension_range_count() > 0) {
+    vector<const Descriptor::ExtensionRange*> sorted_extensions;
+    for (int i = 0; i < descriptor_->extension_range_count(); ++i) {
+      sorted_extensions.push_back(descriptor_->extension_range(i));
+    }
+    sort(sorted_extensions.begin(), sorted_extensions.end(),
+         ExtensionRangeSorter());
+
+    printer->Print(
+      "const int $classname$::_table_extension_ranges_[$count$] = {\n",
+      "classname", classname_,
+      "count", SimpleItoa(2 * descriptor_->extension_range_count()));
+    for (int i = 0; i < sorted_extensions.size(); i++) {
+      printer->Print(
+        "  $start$, $end$,\n",
+        "start", SimpleItoa(sorted_extensions[i]->start),
+        "end", SimpleItoa(sorted_extensions[i]->end));
+    }
+    printer->Print("};\n");
+  }
+
+  printer->Print(vars,
+    "const ::google::protobuf::internal::MessageTable $classname$::_table_ = {\n");
+  if (descriptor_->field_count() > 0) {
+    printer->Print(vars, "  _table_fields_, $field_count$,\n");
+  } else {
+    printer->Print("  NULL, 0,\n");
+  }
+  if (descriptor_->extension_range_count() > 0) {
+    printer->Print(vars, "  _table_extension_ranges_, $range_count$,\n");
+  } else {
+    printer->Print("  NULL, 0,\n");
+  }
+  printer->Print(vars,
+    "  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET($classname$, _has_bits_[0]),\n"
+    "  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET($classname$, _cached_size_),\n"
+    "  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET($classname$, _unknown_fields_),\n");
+  if (descriptor_->extension_range_count() > 0) {
+    printer->Print(vars,
+      "  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET($classname$, _extensions_),\n");
+  } else {
+    printer->Print("  -1,\n");
+  }
+  if (SupportsArenas(descriptor_->file())) {
+    printer->Print(vars,
+      "  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET($classname$, _arena_),\n");
+  } else {
+    printer->Print("  -1,\n");
+  }
+  printer->Print(vars,
+    "  &::google::protobuf::internal::TablePrototype< $classname$ >,\n"
+    "};\n");
+}
+
 void MessageGenerator::
 GenerateSharedConstructorCode(io::Printer* printer) {
   printer->Print(
@@ -1001,6 +1193,10 @@ GenerateSharedConstructorCode(io::Printer* printer) {
 
   printer->Print(
     "_cached_size_ = 0;\n");
+  if (SupportsArenas(descriptor_->file())) {
+    printer->Print(
+      "_arena_ = NULL;\n");
+  }
 
   for (int i = 0; i < descriptor_->field_count(); i++) {
     field_generators_.get(descriptor_->field(i))
@@ -1020,6 +1216,11 @@ GenerateSharedDestructorCode(io::Printer* printer) {
     "void $classname$::SharedDtor() {\n",
     "classname", classname_);
   printer->Indent();
+  if (SupportsArenas(descriptor_->file())) {
+    printer->Print(
+      "// The arena destroys our strings and sub-messages itself.\n"
+      "if (_arena_ != NULL) return;\n");
+  }
   // Write the destructors for each field.
   for (int i = 0; i < descriptor_->field_count(); i++) {
     field_generators_.get(descriptor_->field(i))
@@ -1040,8 +1241,11 @@ GenerateSharedDestructorCode(io::Printer* printer) {
   for (int i = 0; i < descriptor_->field_count(); i++) {
     const FieldDescriptor* field = descriptor_->field(i);
 
-    if (!field->is_repeated() &&
-        field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+    if (internal::IsLazyField(field)) {
+      printer->Print("  $name$_.Destroy();\n",
+                     "name", FieldName(field));
+    } else if (!field->is_repeated() &&
+               field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
       printer->Print("  delete $name$_;\n",
                      "name", FieldName(field));
     }
@@ -1081,8 +1285,19 @@ GenerateStructors(io::Printer* printer) {
   for (int i = 0; i < descriptor_->field_count(); i++) {
     const FieldDescriptor* field = descriptor_->field(i);
 
-    if (!field->is_repeated() &&
-        field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+    if (internal::IsLazyField(field)) {
+      PrintHandlingOptionalStaticInitializers(
+        descriptor_->file(), printer,
+        // With static initializers.
+        "  $name$_.InitAsDefaultInstance(&$type$::default_instance());\n",
+        // Without.
+        "  $name$_.InitAsDefaultInstance(\n"
+        "      $type$::internal_default_instance());\n",
+        // Vars.
+        "name", FieldName(field),
+        "type", FieldMessageTypeName(field));
+    } else if (!field->is_repeated() &&
+               field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
       PrintHandlingOptionalStaticInitializers(
         descriptor_->file(), printer,
         // With static initializers.
@@ -1110,6 +1325,33 @@ GenerateStructors(io::Printer* printer) {
     "classname", classname_,
     "superclass", superclass);
 
+  // Generate the arena constructor.  Unknown fields, and repeated string and
+  // message fields, allocate their elements in the arena, too.
+  if (SupportsArenas(descriptor_->file())) {
+    printer->Print(
+      "$classname$::$classname$(::google::protobuf::Arena* arena)\n"
+      "  : $superclass$()",
+      "classname", classname_,
+      "superclass", superclass);
+    if (HasUnknownFields(descriptor_->file())) {
+      printer->Print(",\n    _unknown_fields_(arena)");
+    }
+    for (int i = 0; i < descriptor_->field_count(); i++) {
+      const FieldDescriptor* field = descriptor_->field(i);
+      if (field->is_repeated() &&
+          (field->cpp_type() == FieldDescriptor::CPPTYPE_STRING ||
+           field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE)) {
+        printer->Print(",\n    $name$_(arena)", "name", FieldName(field));
+      }
+    }
+    printer->Print(
+      " {\n"
+      "  SharedCtor();\n"
+      "  _arena_ = arena;\n"
+      "}\n"
+      "\n");
+  }
+
   // Generate the shared constructor code.
   GenerateSharedConstructorCode(printer);
 
@@ -1173,6 +1415,26 @@ GenerateStructors(io::Printer* printer) {
     "classname", classname_,
     "adddescriptorsname",
     GlobalAddDescriptorsName(descriptor_->file()->name()));
+
+  // Without arena support, fall back on Message::New(arena), which has the
+  // arena own a heap message.  Declaring the overload either way keeps it
+  // from being hidden by New().
+  if (SupportsArenas(descriptor_->file())) {
+    printer->Print(
+      "\n"
+      "$classname$* $classname$::New(::google::protobuf::Arena* arena) const {\n"
+      "  return ::google::protobuf::Arena::New<$classname$>(arena);\n"
+      "}\n",
+      "classname", classname_);
+  } else if (HasDescriptorMethods(descriptor_->file())) {
+    printer->Print(
+      "\n"
+      "$classname$* $classname$::New(::google::protobuf::Arena* arena) const {\n"
+      "  return static_cast< $classname$*>(\n"
+      "      ::google::protobuf::Message::New(arena));\n"
+      "}\n",
+      "classname", classname_);
+  }
 }
 
 void MessageGenerator::
@@ -1269,6 +1531,17 @@ GenerateSwap(io::Printer* printer) {
   printer->Indent();
 
   if (HasGeneratedMethods(descriptor_->file())) {
+    if (SupportsArenas(descriptor_->file())) {
+      printer->Print(
+        "if (_arena_ != other->_arena_) {\n"
+        "  // Sub-objects can't move between arenas, so swap by copying.\n"
+        "  $classname$ temp(*this);\n"
+        "  CopyFrom(*other);\n"
+        "  other->CopyFrom(temp);\n"
+        "  return;\n"
+        "}\n",
+        "classname", classname_);
+    }
     for (int i = 0; i < descriptor_->field_count(); i++) {
       const FieldDescriptor* field = descriptor_->field(i);
       field_generators_.get(field).GenerateSwappingCode(printer);
@@ -1439,6 +1712,17 @@ GenerateCopyFrom(io::Printer* printer) {
 
 void MessageGenerator::
 GenerateMergeFromCodedStream(io::Printer* printer) {
+  if (HasTableDrivenMethods(descriptor_)) {
+    printer->Print(
+      "bool $classname$::MergePartialFromCodedStream(\n"
+      "    ::google::protobuf::io::CodedInputStream* input) {\n"
+      "  return ::google::protobuf::internal::TableInterpreter::\n"
+      "      MergePartialFromCodedStream(_table_, this, input);\n"
+      "}\n",
+      "classname", classname_);
+    return;
+  }
+
   if (descriptor_->options().message_set_wire_format()) {
     // Special-case MessageSet.
     printer->Print(
@@ -1712,6 +1996,17 @@ void MessageGenerator::GenerateSerializeOneExtensionRange(
 
 void MessageGenerator::
 GenerateSerializeWithCachedSizes(io::Printer* printer) {
+  if (HasTableDrivenMethods(descriptor_)) {
+    printer->Print(
+      "void $classname$::SerializeWithCachedSizes(\n"
+      "    ::google::protobuf::io::CodedOutputStream* output) const {\n"
+      "  ::google::protobuf::internal::TableInterpreter::\n"
+      "      SerializeWithCachedSizes(_table_, *this, output);\n"
+      "}\n",
+      "classname", classname_);
+    return;
+  }
+
   if (descriptor_->options().message_set_wire_format()) {
     // Special-case MessageSet.
     printer->Print(
@@ -1744,6 +2039,17 @@ GenerateSerializeWithCachedSizes(io::Printer* printer) {
 
 void MessageGenerator::
 GenerateSerializeWithCachedSizesToArray(io::Printer* printer) {
+  if (HasTableDrivenMethods(descriptor_)) {
+    printer->Print(
+      "::google::protobuf::uint8* $classname$::SerializeWithCachedSizesToArray(\n"
+      "    ::google::protobuf::uint8* target) const {\n"
+      "  return ::google::protobuf::internal::TableInterpreter::\n"
+      "      SerializeWithCachedSizesToArray(_table_, *this, target);\n"
+      "}\n",
+      "classname", classname_);
+    return;
+  }
+
   if (descriptor_->options().message_set_wire_format()) {
     // Special-case MessageSet.
     printer->Print(
@@ -1830,8 +2136,87 @@ GenerateSerializeWithCachedSizesBody(io::Printer* printer, bool to_array) {
   }
 }
 
+void MessageGenerator::
+GenerateSerializeReverse(io::Printer* printer) {
+  printer->Print(
+    "void $classname$::SerializeReverse(\n"
+    "    ::google::protobuf::io::ReverseCodedOutputStream* output) const {\n",
+    "classname", classname_);
+  printer->Indent();
+
+  // Everything is written back to front, so this is
+  // GenerateSerializeWithCachedSizesBody() in reverse: unknown fields first,
+  // then the fields and extension ranges from the highest number down.
+  bool need_separator = false;
+  if (HasUnknownFields(descriptor_->file())) {
+    printer->Print(
+      "if (!unknown_fields().empty()) {\n"
+      "  ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsReverse(\n"
+      "      unknown_fields(), output);\n"
+      "}\n");
+    need_separator = true;
+  }
+
+  scoped_array<const FieldDescriptor*> ordered_fields(
+    SortFieldsByNumber(descriptor_));
+
+  vector<const Descriptor::ExtensionRange*> sorted_extensions;
+  for (int i = 0; i < descriptor_->extension_range_count(); ++i) {
+    sorted_extensions.push_back(descriptor_->extension_range(i));
+  }
+  sort(sorted_extensions.begin(), sorted_extensions.end(),
+       ExtensionRangeSorter());
+
+  int i = descriptor_->field_count();
+  int j = sorted_extensions.size();
+  while (i > 0 || j > 0) {
+    if (need_separator) printer->Print("\n");
+    need_separator = true;
+
+    if (i > 0 &&
+        (j == 0 || ordered_fields[i - 1]->number() >=
+                       sorted_extensions[j - 1]->end)) {
+      const FieldDescriptor* field = ordered_fields[--i];
+      PrintFieldComment(printer, field);
+      if (!field->is_repeated()) {
+        printer->Print(
+          "if (has_$name$()) {\n",
+          "name", FieldName(field));
+        printer->Indent();
+      }
+      field_generators_.get(field).GenerateSerializeReverse(printer);
+      if (!field->is_repeated()) {
+        printer->Outdent();
+        printer->Print("}\n");
+      }
+    } else {
+      const Descriptor::ExtensionRange* range = sorted_extensions[--j];
+      map<string, string> vars;
+      vars["start"] = SimpleItoa(range->start);
+      vars["end"] = SimpleItoa(range->end);
+      printer->Print(vars,
+        "// Extension range [$start$, $end$)\n"
+        "_extensions_.SerializeReverse($start$, $end$, output);\n");
+    }
+  }
+
+  printer->Outdent();
+  printer->Print(
+    "}\n");
+}
+
 void MessageGenerator::
 GenerateByteSize(io::Printer* printer) {
+  if (HasTableDrivenMethods(descriptor_)) {
+    printer->Print(
+      "int $classname$::ByteSize() const {\n"
+      "  return ::google::protobuf::internal::TableInterpreter::ByteSize(\n"
+      "      _table_, *this);\n"
+      "}\n",
+      "classname", classname_);
+    return;
+  }
+
   if (descriptor_->options().message_set_wire_format()) {
     // Special-case MessageSet.
     printer->Print(
@@ -130,6 +130,9 @@ class MessageGenerator {
   // Generate the shared destructor code.
   void GenerateSharedDestructorCode(io::Printer* printer);
 
+  // Generate the tables describing a table-driven message.
+  void GenerateTable(io::Printer* printer);
+
   // Generate standard Message methods.
   void GenerateClear(io::Printer* printer);
   void GenerateMergeFromCodedStream(io::Printer* printer);
@@ -137,6 +140,7 @@ class MessageGenerator {
   void GenerateSerializeWithCachedSizesToArray(io::Printer* printer);
   void GenerateSerializeWithCachedSizesBody(io::Printer* printer,
                                             bool to_array);
+  void GenerateSerializeReverse(io::Printer* printer);
   void GenerateByteSize(io::Printer* printer);
   void GenerateMergeFrom(io::Printer* printer);
   void GenerateCopyFrom(io::Printer* printer);
@@ -53,6 +53,20 @@ void SetMessageVariables(const FieldDescriptor* descriptor,
       (HasFastArraySerialization(descriptor->message_type()->file()) ?
        "MaybeToArray" :
        "");
+  // Messages created in an Arena allocate their sub-messages there.
+  (*variables)["new_message"] = SupportsArenas(descriptor->file())
+      ? "::google::protobuf::Arena::New< " + (*variables)["type"] + " >(_arena_)"
+      : "new " + (*variables)["type"];
+}
+
+// Documents which values set_allocated_*() accepts on arena messages.
+void PrintSetAllocatedComment(const FieldDescriptor* descriptor,
+                              io::Printer* printer) {
+  if (!SupportsArenas(descriptor->file())) return;
+  printer->Print(
+    "// Takes a heap message, which an arena message's arena then owns");
+  printer->Print(SupportsArenas(descriptor->message_type()->file()) ?
+    ",\n// or one created in this message's arena.\n" : ".\n");
 }
 
 }  // namespace
@@ -78,7 +92,9 @@ GenerateAccessorDeclarations(io::Printer* printer) const {
   printer->Print(variables_,
     "inline const $type$& $name$() const$deprecation$;\n"
     "inline $type$* mutable_$name$()$deprecation$;\n"
-    "inline $type$* release_$name$()$deprecation$;\n"
+    "inline $type$* release_$name$()$deprecation$;\n");
+  PrintSetAllocatedComment(descriptor_, printer);
+  printer->Print(variables_,
     "inline void set_allocated_$name$($type$* $name$)$deprecation$;\n");
 }
 
@@ -98,17 +114,48 @@ GenerateInlineAccessorDefinitions(io::Printer* printer) const {
     "}\n"
     "inline $type$* $classname$::mutable_$name$() {\n"
     "  set_has_$name$();\n"
-    "  if ($name$_ == NULL) $name$_ = new $type$;\n"
+    "  if ($name$_ == NULL) $name$_ = $new_message$;\n"
     "  return $name$_;\n"
     "}\n"
     "inline $type$* $classname$::release_$name$() {\n"
     "  clear_has_$name$();\n"
     "  $type$* temp = $name$_;\n"
-    "  $name$_ = NULL;\n"
+    "  $name$_ = NULL;\n");
+  if (SupportsArenas(descriptor_->file())) {
+    // The arena keeps the original; the caller gets a heap copy it can free.
+    printer->Print(variables_,
+      "  if (temp != NULL && _arena_ != NULL) temp = new $type$(*temp);\n");
+  }
+  printer->Print(variables_,
     "  return temp;\n"
     "}\n"
-    "inline void $classname$::set_allocated_$name$($type$* $name$) {\n"
-    "  delete $name$_;\n"
+    "inline void $classname$::set_allocated_$name$($type$* $name$) {\n");
+  if (SupportsArenas(descriptor_->file())) {
+    if (SupportsArenas(descriptor_->message_type()->file())) {
+      printer->Print(variables_,
+        "  GOOGLE_DCHECK($name$ == NULL || $name$->GetArena() == NULL ||\n"
+        "                $name$->GetArena() == _arena_);\n"
+        "  if (_arena_ == NULL) {\n"
+        "    delete $name$_;\n"
+        "  } else if ($name$ != NULL && $name$->GetArena() != _arena_) {\n"
+        "    _arena_->Own($name$);\n"
+        "  }\n");
+    } else {
+      // Without arena support the type can't say where it lives.
+      printer->Print(variables_,
+        "  GOOGLE_DCHECK($name$ == NULL || _arena_ == NULL ||\n"
+        "                !_arena_->Contains($name$));\n"
+        "  if (_arena_ == NULL) {\n"
+        "    delete $name$_;\n"
+        "  } else if ($name$ != NULL) {\n"
+        "    _arena_->Own($name$);\n"
+        "  }\n");
+    }
+  } else {
+    printer->Print(variables_,
+      "  delete $name$_;\n");
+  }
+  printer->Print(variables_,
     "  $name$_ = $name$;\n"
     "  if ($name$) {\n"
     "    set_has_$name$();\n"
@@ -168,6 +215,14 @@ GenerateSerializeWithCachedSizesToArray(io::Printer* printer) const {
     "    $number$, this->$name$(), target);\n");
 }
 
+void MessageFieldGenerator::
+GenerateSerializeReverse(io::Printer* printer) const {
+  printer->Print(variables_,
+    "::google::protobuf::internal::WireFormatLite::\n"
+    "  Write$declared_type$NoVirtualReverse(\n"
+    "    $number$, this->$name$(), output);\n");
+}
+
 void MessageFieldGenerator::
 GenerateByteSize(io::Printer* printer) const {
   printer->Print(variables_,
@@ -178,6 +233,119 @@ GenerateByteSize(io::Printer* printer) const {
 
 // ===================================================================
 
+LazyMessageFieldGenerator::
+LazyMessageFieldGenerator(const FieldDescriptor* descriptor,
+                          const Options& options)
+  : descriptor_(descriptor) {
+  SetMessageVariables(descriptor, &variables_, options);
+  variables_["arena"] =
+      SupportsArenas(descriptor->file()) ? "_arena_" : "NULL";
+}
+
+LazyMessageFieldGenerator::~LazyMessageFieldGenerator() {}
+
+void LazyMessageFieldGenerator::
+GeneratePrivateMembers(io::Printer* printer) const {
+  printer->Print(variables_,
+    "::google::protobuf::internal::LazyField $name$_;\n");
+}
+
+void LazyMessageFieldGenerator::
+GenerateAccessorDeclarations(io::Printer* printer) const {
+  printer->Print(variables_,
+    "inline const $type$& $name$() const$deprecation$;\n"
+    "inline $type$* mutable_$name$()$deprecation$;\n"
+    "inline $type$* release_$name$()$deprecation$;\n");
+  PrintSetAllocatedComment(descriptor_, printer);
+  printer->Print(variables_,
+    "inline void set_allocated_$name$($type$* $name$)$deprecation$;\n");
+}
+
+void LazyMessageFieldGenerator::
+GenerateInlineAccessorDefinitions(io::Printer* printer) const {
+  printer->Print(variables_,
+    "inline const $type$& $classname$::$name$() const {\n"
+    "  return static_cast<const $type$&>(\n"
+    "      $name$_.Get($type$::default_instance(), $arena$));\n"
+    "}\n"
+    "inline $type$* $classname$::mutable_$name$() {\n"
+    "  set_has_$name$();\n"
+    "  return static_cast< $type$*>(\n"
+    "      $name$_.Mutable($type$::default_instance(), $arena$));\n"
+    "}\n"
+    "inline $type$* $classname$::release_$name$() {\n"
+    "  clear_has_$name$();\n"
+    "  return static_cast< $type$*>(\n"
+    "      $name$_.Release($type$::default_instance(), $arena$));\n"
+    "}\n"
+    "inline void $classname$::set_allocated_$name$($type$* $name$) {\n"
+    "  $name$_.SetAllocated($name$, $arena$);\n"
+    "  if ($name$) {\n"
+    "    set_has_$name$();\n"
+    "  } else {\n"
+    "    clear_has_$name$();\n"
+    "  }\n"
+    "}\n");
+}
+
+void LazyMessageFieldGenerator::
+GenerateClearingCode(io::Printer* printer) const {
+  printer->Print(variables_, "$name$_.Clear();\n");
+}
+
+void LazyMessageFieldGenerator::
+GenerateMergingCode(io::Printer* printer) const {
+  // Unparsed bytes are merged without parsing them.
+  printer->Print(variables_,
+    "set_has_$name$();\n"
+    "$name$_.MergeFrom(from.$name$_, $type$::default_instance(), $arena$);\n");
+}
+
+void LazyMessageFieldGenerator::
+GenerateSwappingCode(io::Printer* printer) const {
+  printer->Print(variables_, "$name$_.Swap(&other->$name$_);\n");
+}
+
+void LazyMessageFieldGenerator::
+GenerateConstructorCode(io::Printer* printer) const {
+  // LazyField's own constructor leaves it empty.
+}
+
+void LazyMessageFieldGenerator::
+GenerateMergeFromCodedStream(io::Printer* printer) const {
+  printer->Print(variables_,
+    "DO_($name$_.MergeFromCodedStream(input, $arena$));\n"
+    "set_has_$name$();\n");
+}
+
+void LazyMessageFieldGenerator::
+GenerateSerializeWithCachedSizes(io::Printer* printer) const {
+  printer->Print(variables_,
+    "$name$_.WriteMessage($number$, output);\n");
+}
+
+void LazyMessageFieldGenerator::
+GenerateSerializeWithCachedSizesToArray(io::Printer* printer) const {
+  printer->Print(variables_,
+    "target = $name$_.WriteMessageToArray($number$, target);\n");
+}
+
+void LazyMessageFieldGenerator::
+GenerateSerializeReverse(io::Printer* printer) const {
+  printer->Print(variables_,
+    "$name$_.WriteMessageReverse($number$, output);\n");
+}
+
+void LazyMessageFieldGenerator::
+GenerateByteSize(io::Printer* printer) const {
+  printer->Print(variables_,
+    "total_size += $tag_size$ +\n"
+    "  ::google::protobuf::internal::WireFormatLite::LengthDelimitedSize(\n"
+    "    $name$_.ByteSize());\n");
+}
+
+// ===================================================================
+
 RepeatedMessageFieldGenerator::
 RepeatedMessageFieldGenerator(const FieldDescriptor* descriptor,
                               const Options& options)
@@ -281,6 +449,16 @@ GenerateSerializeWithCachedSizesToArray(io::Printer* printer) const {
     "}\n");
 }
 
+void RepeatedMessageFieldGenerator::
+GenerateSerializeReverse(io::Printer* printer) const {
+  printer->Print(variables_,
+    "for (int i = this->$name$_size() - 1; i >= 0; i--) {\n"
+    "  ::google::protobuf::internal::WireFormatLite::\n"
+    "    Write$declared_type$NoVirtualReverse(\n"
+    "      $number$, this->$name$(i), output);\n"
+    "}\n");
+}
+
 void RepeatedMessageFieldGenerator::
 GenerateByteSize(io::Printer* printer) const {
   printer->Print(variables_,
@@ -175,6 +175,13 @@ GenerateSerializeWithCachedSizesToArray(io::Printer* printer) const {
       "$number$, this->$name$(), target);\n");
 }
 
+void PrimitiveFieldGenerator::
+GenerateSerializeReverse(io::Printer* printer) const {
+  printer->Print(variables_,
+    "::google::protobuf::internal::WireFormatLite::Write$declared_type$Reverse("
+      "$number$, this->$name$(), output);\n");
+}
+
 void PrimitiveFieldGenerator::
 GenerateByteSize(io::Printer* printer) const {
   int fixed_size = FixedSize(descriptor_->type());
@@ -345,6 +352,32 @@ GenerateSerializeWithCachedSizesToArray(io::Printer* printer) const {
   printer->Print("}\n");
 }
 
+void RepeatedPrimitiveFieldGenerator::
+GenerateSerializeReverse(io::Printer* printer) const {
+  if (descriptor_->options().packed()) {
+    // Write the elements, then their size and the tag in front of them.
+    printer->Print(variables_,
+      "if (this->$name$_size() > 0) {\n"
+      "  int end = output->ByteCount();\n"
+      "  for (int i = this->$name$_size() - 1; i >= 0; i--) {\n"
+      "    ::google::protobuf::internal::WireFormatLite::\n"
+      "      Write$declared_type$NoTagReverse(this->$name$(i), output);\n"
+      "  }\n"
+      "  output->WriteVarint32(output->ByteCount() - end);\n"
+      "  ::google::protobuf::internal::WireFormatLite::WriteTagReverse(\n"
+      "    $number$,\n"
+      "    ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED,\n"
+      "    output);\n"
+      "}\n");
+  } else {
+    printer->Print(variables_,
+      "for (int i = this->$name$_size() - 1; i >= 0; i--) {\n"
+      "  ::google::protobuf::internal::WireFormatLite::\n"
+      "    Write$declared_type$Reverse($number$, this->$name$(i), output);\n"
+      "}\n");
+  }
+}
+
 void RepeatedPrimitiveFieldGenerator::
 GenerateByteSize(io::Printer* printer) const {
   printer->Print(variables_,
@@ -61,6 +61,7 @@ class PrimitiveFieldGenerator : public FieldGenerator {
   void GenerateMergeFromCodedStream(io::Printer* printer) const;
   void GenerateSerializeWithCachedSizes(io::Printer* printer) const;
   void GenerateSerializeWithCachedSizesToArray(io::Printer* printer) const;
+  void GenerateSerializeReverse(io::Printer* printer) const;
   void GenerateByteSize(io::Printer* printer) const;
 
  private:
@@ -88,6 +89,7 @@ class RepeatedPrimitiveFieldGenerator : public FieldGenerator {
   void GenerateMergeFromCodedStreamWithPacking(io::Printer* printer) const;
   void GenerateSerializeWithCachedSizes(io::Printer* printer) const;
   void GenerateSerializeWithCachedSizesToArray(io::Printer* printer) const;
+  void GenerateSerializeReverse(io::Printer* printer) const;
   void GenerateByteSize(io::Printer* printer) const;
 
  private:
@@ -57,6 +57,18 @@ void SetStringVariables(const FieldDescriptor* descriptor,
       : "_default_" + FieldName(descriptor) + "_";
   (*variables)["pointer_type"] =
       descriptor->type() == FieldDescriptor::TYPE_BYTES ? "void" : "char";
+  // Messages created in an Arena allocate their strings there.
+  if (SupportsArenas(descriptor->file())) {
+    (*variables)["new_string"] =
+        "::google::protobuf::Arena::New< ::std::string>(_arena_)";
+    (*variables)["new_default_string"] =
+        "::google::protobuf::Arena::New< ::std::string>(_arena_, *" +
+        (*variables)["default_variable"] + ")";
+  } else {
+    (*variables)["new_string"] = "new ::std::string";
+    (*variables)["new_default_string"] =
+        "new ::std::string(*" + (*variables)["default_variable"] + ")";
+  }
 }
 
 }  // namespace
@@ -83,13 +95,12 @@ GeneratePrivateMembers(io::Printer* printer) const {
 void StringFieldGenerator::
 GenerateAccessorDeclarations(io::Printer* printer) const {
   // If we're using StringFieldGenerator for a field with a ctype, it's
-  // because that ctype isn't actually implemented.  In particular, this is
-  // true of ctype=CORD and ctype=STRING_PIECE in the open source release.
-  // We aren't releasing Cord because it has too many Google-specific
-  // dependencies and we aren't releasing StringPiece because it's hardly
-  // useful outside of Google and because it would get confusing to have
-  // multiple instances of the StringPiece class in different libraries (PCRE
-  // already includes it for their C++ bindings, which came from Google).
+  // because that ctype isn't implemented for it.  ctype=CORD isn't implemented
+  // at all in the open source release, because Cord has too many
+  // Google-specific dependencies.  ctype=STRING_PIECE is implemented by
+  // StringPieceFieldGenerator, but only where internal::IsStringPieceField()
+  // says so; repeated fields, extensions and fields of lite or table-driven
+  // files still end up here.
   //
   // In any case, we make all the accessors private while still actually
   // using a string to represent the field internally.  This way, we can
@@ -113,7 +124,13 @@ GenerateAccessorDeclarations(io::Printer* printer) const {
     "inline void set_$name$(const $pointer_type$* value, size_t size)"
                  "$deprecation$;\n"
     "inline ::std::string* mutable_$name$()$deprecation$;\n"
-    "inline ::std::string* release_$name$()$deprecation$;\n"
+    "inline ::std::string* release_$name$()$deprecation$;\n");
+  if (SupportsArenas(descriptor_->file())) {
+    printer->Print(variables_,
+      "// Takes a heap string, which an arena message's arena then owns.\n"
+      "// Use mutable_$name$() to build the value in the arena instead.\n");
+  }
+  printer->Print(variables_,
     "inline void set_allocated_$name$(::std::string* $name$)$deprecation$;\n");
 
 
@@ -133,14 +150,14 @@ GenerateInlineAccessorDefinitions(io::Printer* printer) const {
     "inline void $classname$::set_$name$(const ::std::string& value) {\n"
     "  set_has_$name$();\n"
     "  if ($name$_ == $default_variable$) {\n"
-    "    $name$_ = new ::std::string;\n"
+    "    $name$_ = $new_string$;\n"
     "  }\n"
     "  $name$_->assign(value);\n"
     "}\n"
     "inline void $classname$::set_$name$(const char* value) {\n"
     "  set_has_$name$();\n"
     "  if ($name$_ == $default_variable$) {\n"
-    "    $name$_ = new ::std::string;\n"
+    "    $name$_ = $new_string$;\n"
     "  }\n"
     "  $name$_->assign(value);\n"
     "}\n"
@@ -148,7 +165,7 @@ GenerateInlineAccessorDefinitions(io::Printer* printer) const {
     "void $classname$::set_$name$(const $pointer_type$* value, size_t size) {\n"
     "  set_has_$name$();\n"
     "  if ($name$_ == $default_variable$) {\n"
-    "    $name$_ = new ::std::string;\n"
+    "    $name$_ = $new_string$;\n"
     "  }\n"
     "  $name$_->assign(reinterpret_cast<const char*>(value), size);\n"
     "}\n"
@@ -157,10 +174,10 @@ GenerateInlineAccessorDefinitions(io::Printer* printer) const {
     "  if ($name$_ == $default_variable$) {\n");
   if (descriptor_->default_value_string().empty()) {
     printer->Print(variables_,
-      "    $name$_ = new ::std::string;\n");
+      "    $name$_ = $new_string$;\n");
   } else {
     printer->Print(variables_,
-      "    $name$_ = new ::std::string(*$default_variable$);\n");
+      "    $name$_ = $new_default_string$;\n");
   }
   printer->Print(variables_,
     "  }\n"
@@ -172,14 +189,32 @@ GenerateInlineAccessorDefinitions(io::Printer* printer) const {
     "    return NULL;\n"
     "  } else {\n"
     "    ::std::string* temp = $name$_;\n"
-    "    $name$_ = const_cast< ::std::string*>($default_variable$);\n"
+    "    $name$_ = const_cast< ::std::string*>($default_variable$);\n");
+  if (SupportsArenas(descriptor_->file())) {
+    // The arena keeps the original; the caller gets a heap copy it can free.
+    printer->Print(variables_,
+      "    if (_arena_ != NULL) temp = new ::std::string(*temp);\n");
+  }
+  printer->Print(variables_,
     "    return temp;\n"
     "  }\n"
     "}\n"
-    "inline void $classname$::set_allocated_$name$(::std::string* $name$) {\n"
-    "  if ($name$_ != $default_variable$) {\n"
-    "    delete $name$_;\n"
-    "  }\n"
+    "inline void $classname$::set_allocated_$name$(::std::string* $name$) {\n");
+  if (SupportsArenas(descriptor_->file())) {
+    printer->Print(variables_,
+      "  GOOGLE_DCHECK($name$ == NULL || _arena_ == NULL ||\n"
+      "                !_arena_->Contains($name$));\n"
+      "  if ($name$_ != $default_variable$ && _arena_ == NULL) {\n"
+      "    delete $name$_;\n"
+      "  }\n"
+      "  if ($name$ != NULL && _arena_ != NULL) _arena_->Own($name$);\n");
+  } else {
+    printer->Print(variables_,
+      "  if ($name$_ != $default_variable$) {\n"
+      "    delete $name$_;\n"
+      "  }\n");
+  }
+  printer->Print(variables_,
     "  if ($name$) {\n"
     "    set_has_$name$();\n"
     "    $name$_ = $name$;\n"
@@ -298,6 +333,20 @@ GenerateSerializeWithCachedSizesToArray(io::Printer* printer) const {
     "    $number$, this->$name$(), target);\n");
 }
 
+void StringFieldGenerator::
+GenerateSerializeReverse(io::Printer* printer) const {
+  if (HasUtf8Verification(descriptor_->file()) &&
+      descriptor_->type() == FieldDescriptor::TYPE_STRING) {
+    printer->Print(variables_,
+      "::google::protobuf::internal::WireFormat::VerifyUTF8String(\n"
+      "  this->$name$().data(), this->$name$().length(),\n"
+      "  ::google::protobuf::internal::WireFormat::SERIALIZE);\n");
+  }
+  printer->Print(variables_,
+    "::google::protobuf::internal::WireFormatLite::Write$declared_type$Reverse(\n"
+    "  $number$, this->$name$(), output);\n");
+}
+
 void StringFieldGenerator::
 GenerateByteSize(io::Printer* printer) const {
   printer->Print(variables_,
@@ -308,6 +357,148 @@ GenerateByteSize(io::Printer* printer) const {
 
 // ===================================================================
 
+StringPieceFieldGenerator::
+StringPieceFieldGenerator(const FieldDescriptor* descriptor,
+                          const Options& options)
+  : descriptor_(descriptor) {
+  SetStringVariables(descriptor, &variables_, options);
+  variables_["arena"] =
+      SupportsArenas(descriptor->file()) ? "_arena_" : "NULL";
+}
+
+StringPieceFieldGenerator::~StringPieceFieldGenerator() {}
+
+void StringPieceFieldGenerator::
+GeneratePrivateMembers(io::Printer* printer) const {
+  printer->Print(variables_,
+    "::google::protobuf::internal::StringPieceField $name$_;\n");
+}
+
+void StringPieceFieldGenerator::
+GenerateAccessorDeclarations(io::Printer* printer) const {
+  printer->Print(variables_,
+    "inline ::google::protobuf::StringPiece $name$() const$deprecation$;\n"
+    "inline void set_$name$(const ::google::protobuf::StringPiece& value)"
+                 "$deprecation$;\n"
+    "inline void set_$name$(const $pointer_type$* value, size_t size)"
+                 "$deprecation$;\n"
+    "inline void set_aliased_$name$("
+        "const ::google::protobuf::StringPiece& value)$deprecation$;\n");
+}
+
+void StringPieceFieldGenerator::
+GenerateInlineAccessorDefinitions(io::Printer* printer) const {
+  printer->Print(variables_,
+    "inline ::google::protobuf::StringPiece $classname$::$name$() const {\n"
+    "  return $name$_.Get();\n"
+    "}\n"
+    "inline void $classname$::set_$name$(\n"
+    "    const ::google::protobuf::StringPiece& value) {\n"
+    "  set_has_$name$();\n"
+    "  $name$_.Set(value.data(), value.size(), $arena$);\n"
+    "}\n"
+    "inline "
+    "void $classname$::set_$name$(const $pointer_type$* value, size_t size) {\n"
+    "  set_has_$name$();\n"
+    "  $name$_.Set(reinterpret_cast<const char*>(value),\n"
+    "              static_cast<int>(size), $arena$);\n"
+    "}\n"
+    "inline void $classname$::set_aliased_$name$(\n"
+    "    const ::google::protobuf::StringPiece& value) {\n"
+    "  set_has_$name$();\n"
+    "  $name$_.SetAliased(value.data(), value.size());\n"
+    "}\n");
+}
+
+void StringPieceFieldGenerator::
+GenerateClearingCode(io::Printer* printer) const {
+  printer->Print(variables_,
+    "$name$_.SetAliased($default$, $default_length$);\n");
+}
+
+void StringPieceFieldGenerator::
+GenerateMergingCode(io::Printer* printer) const {
+  // Copies never alias, whatever the source does.
+  printer->Print(variables_, "set_$name$(from.$name$());\n");
+}
+
+void StringPieceFieldGenerator::
+GenerateSwappingCode(io::Printer* printer) const {
+  printer->Print(variables_, "$name$_.Swap(&other->$name$_);\n");
+}
+
+void StringPieceFieldGenerator::
+GenerateConstructorCode(io::Printer* printer) const {
+  if (!descriptor_->default_value_string().empty()) {
+    printer->Print(variables_,
+      "$name$_.SetAliased($default$, $default_length$);\n");
+  }
+}
+
+void StringPieceFieldGenerator::
+GenerateDestructorCode(io::Printer* printer) const {
+  printer->Print(variables_, "$name$_.Destroy();\n");
+}
+
+void StringPieceFieldGenerator::
+GenerateMergeFromCodedStream(io::Printer* printer) const {
+  printer->Print(variables_,
+    "DO_($name$_.Read(input, $arena$));\n"
+    "set_has_$name$();\n");
+  if (HasUtf8Verification(descriptor_->file()) &&
+      descriptor_->type() == FieldDescriptor::TYPE_STRING) {
+    printer->Print(variables_,
+      "::google::protobuf::internal::WireFormat::VerifyUTF8String(\n"
+      "  this->$name$().data(), this->$name$().size(),\n"
+      "  ::google::protobuf::internal::WireFormat::PARSE);\n");
+  }
+}
+
+void StringPieceFieldGenerator::
+GenerateSerializeWithCachedSizes(io::Printer* printer) const {
+  if (HasUtf8Verification(descriptor_->file()) &&
+      descriptor_->type() == FieldDescriptor::TYPE_STRING) {
+    printer->Print(variables_,
+      "::google::protobuf::internal::WireFormat::VerifyUTF8String(\n"
+      "  this->$name$().data(), this->$name$().size(),\n"
+      "  ::google::protobuf::internal::WireFormat::SERIALIZE);\n");
+  }
+  printer->Print(variables_, "$name$_.Write($number$, output);\n");
+}
+
+void StringPieceFieldGenerator::
+GenerateSerializeWithCachedSizesToArray(io::Printer* printer) const {
+  if (HasUtf8Verification(descriptor_->file()) &&
+      descriptor_->type() == FieldDescriptor::TYPE_STRING) {
+    printer->Print(variables_,
+      "::google::protobuf::internal::WireFormat::VerifyUTF8String(\n"
+      "  this->$name$().data(), this->$name$().size(),\n"
+      "  ::google::protobuf::internal::WireFormat::SERIALIZE);\n");
+  }
+  printer->Print(variables_,
+    "target = $name$_.WriteToArray($number$, target);\n");
+}
+
+void StringPieceFieldGenerator::
+GenerateSerializeReverse(io::Printer* printer) const {
+  if (HasUtf8Verification(descriptor_->file()) &&
+      descriptor_->type() == FieldDescriptor::TYPE_STRING) {
+    printer->Print(variables_,
+      "::google::protobuf::internal::WireFormat::VerifyUTF8String(\n"
+      "  this->$name$().data(), this->$name$().size(),\n"
+      "  ::google::protobuf::internal::WireFormat::SERIALIZE);\n");
+  }
+  printer->Print(variables_, "$name$_.WriteReverse($number$, output);\n");
+}
+
+void StringPieceFieldGenerator::
+GenerateByteSize(io::Printer* printer) const {
+  printer->Print(variables_,
+    "total_size += $tag_size$ + $name$_.ByteSize();\n");
+}
+
+// ===================================================================
+
 RepeatedStringFieldGenerator::
 RepeatedStringFieldGenerator(const FieldDescriptor* descriptor,
                              const Options& options)
@@ -475,6 +666,23 @@ GenerateSerializeWithCachedSizesToArray(io::Printer* printer) const {
     "}\n");
 }
 
+void RepeatedStringFieldGenerator::
+GenerateSerializeReverse(io::Printer* printer) const {
+  printer->Print(variables_,
+    "for (int i = this->$name$_size() - 1; i >= 0; i--) {\n");
+  if (HasUtf8Verification(descriptor_->file()) &&
+      descriptor_->type() == FieldDescriptor::TYPE_STRING) {
+    printer->Print(variables_,
+      "  ::google::protobuf::internal::WireFormat::VerifyUTF8String(\n"
+      "    this->$name$(i).data(), this->$name$(i).length(),\n"
+      "    ::google::protobuf::internal::WireFormat::SERIALIZE);\n");
+  }
+  printer->Print(variables_,
+    "  ::google::protobuf::internal::WireFormatLite::\n"
+    "    Write$declared_type$Reverse($number$, this->$name$(i), output);\n"
+    "}\n");
+}
+
 void RepeatedStringFieldGenerator::
 GenerateByteSize(io::Printer* printer) const {
   printer->Print(variables_,
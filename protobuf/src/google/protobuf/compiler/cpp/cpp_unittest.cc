@@ -638,6 +638,108 @@ TEST(GeneratedMessageTest, PackedFieldsSerializationToStream) {
   TestUtil::ExpectPackedFieldsSet(message2);
 }
 
+// Test the generated SerializeReverse(), which must produce exactly what
+// forward serialization does.
+TEST(GeneratedMessageTest, SerializationReverse) {
+  unittest::TestAllTypes message1, message2;
+  TestUtil::SetAllFields(&message1);
+  string data;
+  EXPECT_TRUE(message1.SerializeReverseToString(&data));
+  EXPECT_EQ(message1.SerializeAsString(), data);
+  EXPECT_TRUE(message2.ParseFromString(data));
+  TestUtil::ExpectAllFieldsSet(message2);
+}
+
+TEST(GeneratedMessageTest, PackedFieldsSerializationReverse) {
+  unittest::TestPackedTypes message1, message2;
+  TestUtil::SetPackedFields(&message1);
+  string data;
+  EXPECT_TRUE(message1.SerializeReverseToString(&data));
+  EXPECT_EQ(message1.SerializeAsString(), data);
+  EXPECT_TRUE(message2.ParseFromString(data));
+  TestUtil::ExpectPackedFieldsSet(message2);
+}
+
+TEST(GeneratedMessageTest, ExtensionsSerializationReverse) {
+  unittest::TestAllExtensions message;
+  TestUtil::SetAllExtensions(&message);
+  string data;
+  EXPECT_TRUE(message.SerializeReverseToString(&data));
+  EXPECT_EQ(message.SerializeAsString(), data);
+
+  unittest::TestPackedExtensions packed_message;
+  TestUtil::SetPackedExtensions(&packed_message);
+  EXPECT_TRUE(packed_message.SerializeReverseToString(&data));
+  EXPECT_EQ(packed_message.SerializeAsString(), data);
+
+  // Fields and extension ranges interleave.
+  unittest::TestFieldOrderings ordered_message;
+  TestUtil::SetAllFieldsAndExtensions(&ordered_message);
+  EXPECT_TRUE(ordered_message.SerializeReverseToString(&data));
+  TestUtil::ExpectAllFieldsAndExtensionsInOrder(data);
+}
+
+TEST(GeneratedMessageTest, UnknownFieldsSerializationReverse) {
+  unittest::TestAllTypes message;
+  TestUtil::SetAllFields(&message);
+  string expected = message.SerializeAsString();
+
+  // Everything is unknown to TestEmptyMessage, groups included.
+  unittest::TestEmptyMessage empty_message;
+  ASSERT_TRUE(empty_message.ParseFromString(expected));
+  string data;
+  EXPECT_TRUE(empty_message.SerializeReverseToString(&data));
+  EXPECT_EQ(expected, data);
+}
+
+TEST(GeneratedMessageTest, SerializationReverseIgnoresCachedSizes) {
+  unittest::TestAllTypes message;
+  TestUtil::SetAllFields(&message);
+  message.ByteSize();
+  // Grow a sub-message after its size was cached.
+  message.mutable_optional_nested_message()->set_bb(kint32max);
+  message.mutable_repeated_nested_message(0)->set_bb(kint32max);
+
+  string data;
+  EXPECT_TRUE(message.SerializeReverseToString(&data));
+  EXPECT_EQ(message.SerializeAsString(), data);
+}
+
+TEST(GeneratedMessageTest, LazyFieldSerializationReverse) {
+  unittest::TestLazyMessage message;
+  TestUtil::SetAllFields(message.mutable_sub_message());
+  string expected = message.SerializeAsString();
+
+  // Once parsed, the field holds bytes, which are written as they are.
+  unittest::TestLazyMessage parsed;
+  ASSERT_TRUE(parsed.ParseFromString(expected));
+  string data;
+  EXPECT_TRUE(parsed.SerializeReverseToString(&data));
+  EXPECT_EQ(expected, data);
+
+  // Once modified, it holds a message again.
+  parsed.mutable_sub_message()->set_optional_int32(12345);
+  EXPECT_TRUE(parsed.SerializeReverseToString(&data));
+  EXPECT_EQ(parsed.SerializeAsString(), data);
+}
+
+TEST(GeneratedMessageTest, OptimizedForSizeSerializationReverse) {
+  // Messages without a generated SerializeReverse() fall back to ByteSize(),
+  // also when embedded in one that has it.
+  protobuf_unittest::TestEmbedOptimizedForSize message;
+  message.mutable_optional_message()->set_i(1);
+  message.mutable_optional_message()->mutable_msg()->set_c(2);
+  message.add_repeated_message()->set_i(3);
+  message.add_repeated_message()->SetExtension(
+      protobuf_unittest::TestOptimizedForSize::test_extension, 4);
+
+  string data;
+  EXPECT_TRUE(message.SerializeReverseToString(&data));
+  EXPECT_EQ(message.SerializeAsString(), data);
+  EXPECT_TRUE(message.optional_message().SerializeReverseToString(&data));
+  EXPECT_EQ(message.optional_message().SerializeAsString(), data);
+}
+
 
 TEST(GeneratedMessageTest, Required) {
   // Test that IsInitialized() returns false if required fields are missing.
@@ -50,6 +50,8 @@
 #include <google/protobuf/io/tokenizer.h>
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include <google/protobuf/stubs/strutil.h>
+#include <google/protobuf/stubs/map-util.h>
+#include <google/protobuf/stubs/stl_util.h>
 
 namespace google {
 namespace protobuf {
@@ -77,6 +79,7 @@ static bool IsWindowsAbsolutePath(const string& text) {
 }
 
 MultiFileErrorCollector::~MultiFileErrorCollector() {}
+ParseCache::~ParseCache() {}
 
 // This class serves two purposes:
 // - It implements the ErrorCollector interface (used by Tokenizer and Parser)
@@ -108,19 +111,214 @@ class SourceTreeDescriptorDatabase::SingleFileErrorCollector
   bool had_errors_;
 };
 
+// The result of parsing a file in Prefetch().
+struct SourceTreeDescriptorDatabase::ParsedFile {
+  struct Error {
+    int line;
+    int column;
+    string message;
+  };
+
+  bool found;      // Could the file be opened?
+  bool success;    // Did it parse without errors?
+  bool delivered;  // Has FindFileByName() taken the file?
+  FileDescriptorProto file;
+  vector<Error> errors;
+  SourceLocationTable source_locations;
+};
+
+// Holds on to a file's errors so that FindFileByName() can report them
+// later, from the calling thread and in the usual order.
+class SourceTreeDescriptorDatabase::BufferedErrorCollector
+    : public io::ErrorCollector {
+ public:
+  BufferedErrorCollector(ParsedFile* parsed_file)
+    : parsed_file_(parsed_file) {}
+  ~BufferedErrorCollector() {}
+
+  // implements ErrorCollector ---------------------------------------
+  void AddError(int line, int column, const string& message) {
+    ParsedFile::Error error = { line, column, message };
+    parsed_file_->errors.push_back(error);
+  }
+
+ private:
+  ParsedFile* parsed_file_;
+};
+
+// One level of the import graph.  Each thread running Run() takes the
+// next unparsed file until there are none left.
+class SourceTreeDescriptorDatabase::PrefetchRound {
+ public:
+  PrefetchRound(SourceTreeDescriptorDatabase* owner,
+                const vector<string>& filenames)
+    : owner_(owner),
+      filenames_(filenames),
+      results_(filenames.size(), NULL),
+      next_(0) {}
+
+  void Run() {
+    while (true) {
+      int i;
+      {
+        MutexLock lock(&mutex_);
+        if (next_ == filenames_.size()) return;
+        i = next_++;
+      }
+      results_[i] = owner_->ParseFile(filenames_[i]);
+    }
+  }
+
+  ParsedFile* result(int i) const { return results_[i]; }
+
+ private:
+  SourceTreeDescriptorDatabase* owner_;
+  const vector<string>& filenames_;
+  vector<ParsedFile*> results_;
+  Mutex mutex_;
+  int next_;
+};
+
 // ===================================================================
 
 SourceTreeDescriptorDatabase::SourceTreeDescriptorDatabase(
     SourceTree* source_tree)
   : source_tree_(source_tree),
     error_collector_(NULL),
+    parse_cache_(NULL),
     using_validation_error_collector_(false),
     validation_error_collector_(this) {}
 
-SourceTreeDescriptorDatabase::~SourceTreeDescriptorDatabase() {}
+SourceTreeDescriptorDatabase::~SourceTreeDescriptorDatabase() {
+  STLDeleteValues(&parsed_files_);
+}
+
+void SourceTreeDescriptorDatabase::Prefetch(const vector<string>& filenames,
+                                            int num_threads) {
+  // Each round parses one level of the import graph in parallel; the
+  // imports found there, if not seen before, make up the next round.
+  vector<string> round;
+  for (int i = 0; i < filenames.size(); i++) {
+    if (InsertIfNotPresent(&parsed_files_, filenames[i],
+                           static_cast<ParsedFile*>(NULL))) {
+      round.push_back(filenames[i]);
+    }
+  }
+
+  while (!round.empty()) {
+    PrefetchRound work(this, round);
+    scoped_ptr<Closure> callback(
+        NewPermanentCallback(&work, &PrefetchRound::Run));
+    int round_threads = num_threads < round.size() ? num_threads : round.size();
+    internal::RunOnThreads(callback.get(), round_threads);
+
+    vector<string> next;
+    for (int i = 0; i < round.size(); i++) {
+      ParsedFile* parsed_file = work.result(i);
+      parsed_files_[round[i]] = parsed_file;
+
+      for (int j = 0; j < parsed_file->file.dependency_size(); j++) {
+        const string& dependency = parsed_file->file.dependency(j);
+        if (InsertIfNotPresent(&parsed_files_, dependency,
+                               static_cast<ParsedFile*>(NULL))) {
+          next.push_back(dependency);
+        }
+      }
+    }
+    round.swap(next);
+  }
+}
+
+SourceTreeDescriptorDatabase::ParsedFile*
+SourceTreeDescriptorDatabase::ParseFile(const string& filename) {
+  ParsedFile* parsed_file = new ParsedFile;
+  parsed_file->success = false;
+  parsed_file->delivered = false;
+
+  scoped_ptr<io::ZeroCopyInputStream> input(source_tree_->Open(filename));
+  parsed_file->found = input != NULL;
+  if (!parsed_file->found) return parsed_file;
+
+  parsed_file->file.set_name(filename);
+  string contents;
+  if (FindInParseCache(filename, &input, &contents, &parsed_file->file)) {
+    parsed_file->success = true;
+    return parsed_file;
+  }
+
+  // Set up the tokenizer and parser.
+  BufferedErrorCollector file_error_collector(parsed_file);
+  io::Tokenizer tokenizer(input.get(), &file_error_collector);
+
+  Parser parser;
+  parser.RecordErrorsTo(&file_error_collector);
+  if (using_validation_error_collector_) {
+    parser.RecordSourceLocationsTo(&parsed_file->source_locations);
+  }
+
+  // Parse it.
+  parsed_file->success = parser.Parse(&tokenizer, &parsed_file->file) &&
+                         parsed_file->errors.empty();
+  if (parsed_file->success && parse_cache_ != NULL) {
+    parse_cache_->Add(filename, contents, parsed_file->file);
+  }
+  return parsed_file;
+}
+
+bool SourceTreeDescriptorDatabase::FindInParseCache(
+    const string& filename, scoped_ptr<io::ZeroCopyInputStream>* input,
+    string* contents, FileDescriptorProto* output) {
+  if (parse_cache_ == NULL) return false;
+
+  const void* data;
+  int size;
+  while ((*input)->Next(&data, &size)) {
+    contents->append(static_cast<const char*>(data), size);
+  }
+  if (parse_cache_->Find(filename, *contents, output)) return true;
+
+  input->reset(new io::ArrayInputStream(contents->data(), contents->size()));
+  return false;
+}
 
 bool SourceTreeDescriptorDatabase::FindFileByName(
     const string& filename, FileDescriptorProto* output) {
+  ParsedFileMap::iterator iter = parsed_files_.find(filename);
+  if (iter != parsed_files_.end()) {
+    ParsedFile* parsed_file = iter->second;
+    if (!parsed_file->delivered) {
+      parsed_file->delivered = true;
+
+      if (error_collector_ != NULL) {
+        if (!parsed_file->found) {
+          error_collector_->AddError(filename, -1, 0, "File not found.");
+        }
+        for (int i = 0; i < parsed_file->errors.size(); i++) {
+          const ParsedFile::Error& error = parsed_file->errors[i];
+          error_collector_->AddError(filename, error.line, error.column,
+                                     error.message);
+        }
+      }
+
+      // Swapping keeps the addresses of everything inside the file, which
+      // the source locations are keyed on; only the file itself moves.
+      int line, column;
+      if (parsed_file->source_locations.Find(
+              &parsed_file->file, DescriptorPool::ErrorCollector::NAME,
+              &line, &column)) {
+        parsed_file->source_locations.Add(
+            output, DescriptorPool::ErrorCollector::NAME, line, column);
+      }
+      output->Swap(&parsed_file->file);
+      return parsed_file->success;
+    }
+
+    // Asked for again, most likely because it failed to build the first
+    // time.  Parse it afresh as if it had never been prefetched.
+    delete parsed_file;
+    parsed_files_.erase(iter);
+  }
+
   scoped_ptr<io::ZeroCopyInputStream> input(source_tree_->Open(filename));
   if (input == NULL) {
     if (error_collector_ != NULL) {
@@ -129,6 +327,10 @@ bool SourceTreeDescriptorDatabase::FindFileByName(
     return false;
   }
 
+  output->set_name(filename);
+  string contents;
+  if (FindInParseCache(filename, &input, &contents, output)) return true;
+
   // Set up the tokenizer and parser.
   SingleFileErrorCollector file_error_collector(filename, error_collector_);
   io::Tokenizer tokenizer(input.get(), &file_error_collector);
@@ -142,9 +344,11 @@ bool SourceTreeDescriptorDatabase::FindFileByName(
   }
 
   // Parse it.
-  output->set_name(filename);
-  return parser.Parse(&tokenizer, output) &&
-         !file_error_collector.had_errors();
+  if (!parser.Parse(&tokenizer, output) || file_error_collector.had_errors()) {
+    return false;
+  }
+  if (parse_cache_ != NULL) parse_cache_->Add(filename, contents, *output);
+  return true;
 }
 
 bool SourceTreeDescriptorDatabase::FindFileContainingSymbol(
@@ -175,8 +379,14 @@ void SourceTreeDescriptorDatabase::ValidationErrorCollector::AddError(
     const string& message) {
   if (owner_->error_collector_ == NULL) return;
 
+  const SourceLocationTable* source_locations = &owner_->source_locations_;
+  ParsedFileMap::const_iterator iter = owner_->parsed_files_.find(filename);
+  if (iter != owner_->parsed_files_.end()) {
+    source_locations = &iter->second->source_locations;
+  }
+
   int line, column;
-  owner_->source_locations_.Find(descriptor, location, &line, &column);
+  source_locations->Find(descriptor, location, &line, &column);
   owner_->error_collector_->AddError(filename, line, column, message);
 }
 
@@ -195,6 +405,14 @@ const FileDescriptor* Importer::Import(const string& filename) {
   return pool_.FindFileByName(filename);
 }
 
+void Importer::Prefetch(const vector<string>& filenames, int num_threads) {
+  database_.Prefetch(filenames, num_threads);
+}
+
+void Importer::UseParseCache(ParseCache* parse_cache) {
+  database_.UseParseCache(parse_cache);
+}
+
 // ===================================================================
 
 SourceTree::~SourceTree() {}
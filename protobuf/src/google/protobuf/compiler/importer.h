@@ -37,6 +37,7 @@
 #ifndef GOOGLE_PROTOBUF_COMPILER_IMPORTER_H__
 #define GOOGLE_PROTOBUF_COMPILER_IMPORTER_H__
 
+#include <map>
 #include <string>
 #include <vector>
 #include <set>
@@ -55,6 +56,7 @@ namespace compiler {
 // Defined in this file.
 class Importer;
 class MultiFileErrorCollector;
+class ParseCache;
 class SourceTree;
 class DiskSourceTree;
 
@@ -95,6 +97,23 @@ class LIBPROTOBUF_EXPORT SourceTreeDescriptorDatabase : public DescriptorDatabas
     return &validation_error_collector_;
   }
 
+  // Parses the given files, and every file they import, using up to
+  // num_threads threads.  The results are kept until FindFileByName() asks
+  // for them; any errors are reported then, exactly as if the file were
+  // being parsed at that point.  If num_threads > 1 the SourceTree's Open()
+  // must be safe to call from several threads at once.
+  void Prefetch(const vector<string>& filenames, int num_threads);
+
+  // Looks each file up in the given cache before parsing it, and adds it
+  // to the cache if it parses without errors.  Files taken from the cache
+  // have no source locations, so errors found while building them carry no
+  // line numbers; callers wanting precise errors can build again without
+  // the cache.  The cache must outlive the database, and must be
+  // thread-safe if Prefetch() is used with more than one thread.
+  void UseParseCache(ParseCache* parse_cache) {
+    parse_cache_ = parse_cache;
+  }
+
   // implements DescriptorDatabase -----------------------------------
   bool FindFileByName(const string& filename, FileDescriptorProto* output);
   bool FindFileContainingSymbol(const string& symbol_name,
@@ -105,9 +124,29 @@ class LIBPROTOBUF_EXPORT SourceTreeDescriptorDatabase : public DescriptorDatabas
 
  private:
   class SingleFileErrorCollector;
+  class BufferedErrorCollector;
+  struct ParsedFile;
+  class PrefetchRound;
+  friend class PrefetchRound;
 
   SourceTree* source_tree_;
   MultiFileErrorCollector* error_collector_;
+  ParseCache* parse_cache_;
+
+  // Files parsed by Prefetch(), by name.  Entries stay after being handed
+  // out so that validation errors can still find their source locations.
+  typedef map<string, ParsedFile*> ParsedFileMap;
+  ParsedFileMap parsed_files_;
+
+  // Parses one file on a Prefetch() thread.
+  ParsedFile* ParseFile(const string& filename);
+
+  // If there is a parse cache, reads the file in *input into *contents and
+  // looks it up, returning true if it was found.  Otherwise *input is
+  // replaced with a stream over *contents, ready to be parsed.
+  bool FindInParseCache(const string& filename,
+                        scoped_ptr<io::ZeroCopyInputStream>* input,
+                        string* contents, FileDescriptorProto* output);
 
   class LIBPROTOBUF_EXPORT ValidationErrorCollector : public DescriptorPool::ErrorCollector {
    public:
@@ -160,6 +199,17 @@ class LIBPROTOBUF_EXPORT Importer {
   // DescriptorPool so that they can be cross-linked).
   const FileDescriptor* Import(const string& filename);
 
+  // Parses the given files and everything they import on up to num_threads
+  // threads, so that later calls to Import() only have to build them.
+  // Building still happens one file at a time, in dependency order, and
+  // errors are reported by Import() just as they would be without this.
+  // See SourceTreeDescriptorDatabase::Prefetch().
+  void Prefetch(const vector<string>& filenames, int num_threads);
+
+  // Looks files up in the given cache instead of parsing them where
+  // possible.  See SourceTreeDescriptorDatabase::UseParseCache().
+  void UseParseCache(ParseCache* parse_cache);
+
   // The DescriptorPool in which all imported FileDescriptors and their
   // contents are stored.
   inline const DescriptorPool* pool() const {
@@ -189,6 +239,27 @@ class LIBPROTOBUF_EXPORT MultiFileErrorCollector {
   GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(MultiFileErrorCollector);
 };
 
+// Remembers the results of parsing .proto files, for instance across runs
+// of protoc.  A result depends only on the file's name and contents, so
+// implementations key on both.
+class LIBPROTOBUF_EXPORT ParseCache {
+ public:
+  inline ParseCache() {}
+  virtual ~ParseCache();
+
+  // Fills in *output with the cached result of parsing the given file, or
+  // returns false if there is none.
+  virtual bool Find(const string& filename, const string& contents,
+                    FileDescriptorProto* output) = 0;
+
+  // Records the result of parsing the given file without errors.
+  virtual void Add(const string& filename, const string& contents,
+                   const FileDescriptorProto& file) = 0;
+
+ private:
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(ParseCache);
+};
+
 // Abstract interface which represents a directory tree containing proto files.
 // Used by the default implementation of Importer to resolve import statements
 // Most users will probably want to use the DiskSourceTree implementation,
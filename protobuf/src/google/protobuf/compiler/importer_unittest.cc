@@ -36,6 +36,7 @@
 
 #include <google/protobuf/compiler/importer.h>
 #include <google/protobuf/descriptor.h>
+#include <google/protobuf/descriptor.pb.h>
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 
 #include <google/protobuf/stubs/map-util.h>
@@ -96,6 +97,34 @@ class MockSourceTree : public SourceTree {
   hash_map<string, const char*> files_;
 };
 
+// A ParseCache backed by a map, keyed on both name and contents.
+class MockParseCache : public ParseCache {
+ public:
+  MockParseCache() {}
+  ~MockParseCache() {}
+
+  map<pair<string, string>, FileDescriptorProto> files_;
+
+  // implements ParseCache -------------------------------------------
+  bool Find(const string& filename, const string& contents,
+            FileDescriptorProto* output) {
+    MutexLock lock(&mutex_);
+    const FileDescriptorProto* file =
+        FindOrNull(files_, make_pair(filename, contents));
+    if (file == NULL) return false;
+    output->CopyFrom(*file);
+    return true;
+  }
+  void Add(const string& filename, const string& contents,
+           const FileDescriptorProto& file) {
+    MutexLock lock(&mutex_);
+    files_[make_pair(filename, contents)] = file;
+  }
+
+ private:
+  Mutex mutex_;
+};
+
 // ===================================================================
 
 class ImporterTest : public testing::Test {
@@ -210,6 +239,129 @@ TEST_F(ImporterTest, RecursiveImport) {
     error_collector_.text_);
 }
 
+TEST_F(ImporterTest, Prefetch) {
+  // Prefetching parses the whole import graph up front.
+  AddFile("foo.proto",
+    "syntax = \"proto2\";\n"
+    "import \"bar.proto\";\n"
+    "import \"baz.proto\";\n"
+    "message Foo { optional Bar bar = 1; optional Baz baz = 2; }\n");
+  AddFile("bar.proto",
+    "syntax = \"proto2\";\n"
+    "import \"baz.proto\";\n"
+    "message Bar { optional Baz baz = 1; }\n");
+  AddFile("baz.proto",
+    "syntax = \"proto2\";\n"
+    "message Baz {}\n");
+
+  vector<string> filenames;
+  filenames.push_back("foo.proto");
+  importer_.Prefetch(filenames, 4);
+  EXPECT_EQ("", error_collector_.text_);
+
+  const FileDescriptor* foo = importer_.Import("foo.proto");
+  EXPECT_EQ("", error_collector_.text_);
+  ASSERT_TRUE(foo != NULL);
+  ASSERT_EQ(2, foo->dependency_count());
+  EXPECT_EQ("bar.proto", foo->dependency(0)->name());
+  EXPECT_EQ("baz.proto", foo->dependency(1)->name());
+  EXPECT_EQ(foo->dependency(1), foo->dependency(0)->dependency(0));
+  EXPECT_EQ(foo->dependency(1)->message_type(0),
+            foo->message_type(0)->field(1)->message_type());
+
+  // Importing again should return same object.
+  EXPECT_EQ(foo, importer_.Import("foo.proto"));
+}
+
+TEST_F(ImporterTest, PrefetchReportsErrorsOnImport) {
+  // Prefetched files report the same errors, at the same locations and in
+  // the same order, as files parsed on demand.
+  AddFile("foo.proto",
+    "syntax = \"proto2\";\n"
+    "import \"bar.proto\";\n"
+    "import \"qux.proto\";\n"
+    "import \"missing.proto\";\n"
+    "message Foo { optional Qux qux = 1; }\n");
+  AddFile("bar.proto",
+    "syntax = \"proto2\";\n"
+    "message Bar { optional int32 = 1; }\n");
+  AddFile("qux.proto",
+    "syntax = \"proto2\";\n"
+    "import \"baz.proto\";\n"
+    "package Baz;\n");
+  AddFile("baz.proto",
+    "syntax = \"proto2\";\n"
+    "message Baz {}\n");
+
+  MockErrorCollector expected_errors;
+  Importer expected_importer(&source_tree_, &expected_errors);
+  EXPECT_TRUE(expected_importer.Import("foo.proto") == NULL);
+
+  vector<string> filenames;
+  filenames.push_back("foo.proto");
+  importer_.Prefetch(filenames, 4);
+  EXPECT_EQ("", error_collector_.text_);
+
+  EXPECT_TRUE(importer_.Import("foo.proto") == NULL);
+  EXPECT_EQ(expected_errors.text_, error_collector_.text_);
+  EXPECT_SUBSTRING("missing.proto:-1:0: File not found.",
+                   error_collector_.text_);
+  EXPECT_SUBSTRING("bar.proto:1:29: Expected field name.",
+                   error_collector_.text_);
+  EXPECT_SUBSTRING("foo.proto:4:23: \"Qux\" is not defined.",
+                   error_collector_.text_);
+  EXPECT_SUBSTRING("qux.proto:2:8: \"Baz\" is already defined",
+                   error_collector_.text_);
+}
+
+TEST_F(ImporterTest, ParseCache) {
+  // Files which parse cleanly are added to the cache, and later found there
+  // instead of being parsed, with or without Prefetch().
+  const char* foo_text =
+    "syntax = \"proto2\";\n"
+    "import \"bar.proto\";\n"
+    "message Foo { optional Bar bar = 1; }\n";
+  const char* bar_text =
+    "syntax = \"proto2\";\n"
+    "message Bar {}\n";
+  AddFile("foo.proto", foo_text);
+  AddFile("bar.proto", bar_text);
+
+  MockParseCache parse_cache;
+  importer_.UseParseCache(&parse_cache);
+  ASSERT_TRUE(importer_.Import("foo.proto") != NULL);
+  EXPECT_EQ("", error_collector_.text_);
+  ASSERT_EQ(2, parse_cache.files_.size());
+
+  // Tamper with the cached Bar to show that it is what gets used.
+  FileDescriptorProto* bar =
+      &parse_cache.files_[make_pair(string("bar.proto"), string(bar_text))];
+  EXPECT_EQ("bar.proto", bar->name());
+  bar->mutable_message_type(0)->set_name("Cached");
+  bar->add_message_type()->set_name("Bar");
+
+  for (int num_threads = 1; num_threads <= 4; num_threads += 3) {
+    MockErrorCollector error_collector;
+    Importer importer(&source_tree_, &error_collector);
+    importer.UseParseCache(&parse_cache);
+
+    vector<string> filenames;
+    filenames.push_back("foo.proto");
+    if (num_threads > 1) importer.Prefetch(filenames, num_threads);
+
+    const FileDescriptor* foo = importer.Import("foo.proto");
+    EXPECT_EQ("", error_collector.text_);
+    ASSERT_TRUE(foo != NULL);
+    ASSERT_EQ(1, foo->dependency_count());
+    EXPECT_EQ("Cached", foo->dependency(0)->message_type(0)->name());
+  }
+
+  // A file with errors isn't cached.
+  AddFile("bad.proto", "syntax = \"proto2\";\nmessage {}\n");
+  EXPECT_TRUE(importer_.Import("bad.proto") == NULL);
+  EXPECT_EQ(2, parse_cache.files_.size());
+}
+
 // TODO(sanjay): The MapField tests below more properly belong in
 // descriptor_unittest, but are more convenient to test here.
 TEST_F(ImporterTest, MapFieldValid) {
@@ -45,6 +45,15 @@
 #define STDOUT_FILENO 1
 #endif
 #else
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
 #include <unistd.h>
 #endif
 
@@ -52,7 +61,9 @@
 #include <google/protobuf/compiler/plugin.pb.h>
 #include <google/protobuf/compiler/code_generator.h>
 #include <google/protobuf/descriptor.h>
+#include <google/protobuf/io/coded_stream.h>
 #include <google/protobuf/io/zero_copy_stream_impl.h>
+#include <google/protobuf/stubs/strutil.h>
 
 
 namespace google {
@@ -92,30 +103,20 @@ class GeneratorResponseContext : public GeneratorContext {
   const vector<const FileDescriptor*>& parsed_files_;
 };
 
-int PluginMain(int argc, char* argv[], const CodeGenerator* generator) {
-
-  if (argc > 1) {
-    cerr << argv[0] << ": Unknown option: " << argv[1] << endl;
-    return 1;
-  }
-
-#ifdef _WIN32
-  _setmode(STDIN_FILENO, _O_BINARY);
-  _setmode(STDOUT_FILENO, _O_BINARY);
-#endif
-
-  CodeGeneratorRequest request;
-  if (!request.ParseFromFileDescriptor(STDIN_FILENO)) {
-    cerr << argv[0] << ": protoc sent unparseable request to plugin." << endl;
-    return 1;
-  }
-
+// Runs the generator over the files in the request.  Generator errors are
+// reported in the response; returns false, with a message in *error if
+// there is more to say, if the request itself is bad.
+static bool GenerateResponse(const char* program,
+                             const CodeGeneratorRequest& request,
+                             const CodeGenerator* generator,
+                             CodeGeneratorResponse* response,
+                             string* error) {
   DescriptorPool pool;
   for (int i = 0; i < request.proto_file_size(); i++) {
     const FileDescriptor* file = pool.BuildFile(request.proto_file(i));
     if (file == NULL) {
       // BuildFile() already wrote an error message.
-      return 1;
+      return false;
     }
   }
 
@@ -123,15 +124,14 @@ int PluginMain(int argc, char* argv[], const CodeGenerator* generator) {
   for (int i = 0; i < request.file_to_generate_size(); i++) {
     parsed_files.push_back(pool.FindFileByName(request.file_to_generate(i)));
     if (parsed_files.back() == NULL) {
-      cerr << argv[0] << ": protoc asked plugin to generate a file but "
-              "did not provide a descriptor for the file: "
-           << request.file_to_generate(i) << endl;
-      return 1;
+      *error = string(program) + ": protoc asked plugin to generate a file "
+               "but did not provide a descriptor for the file: " +
+               request.file_to_generate(i);
+      return false;
     }
   }
 
-  CodeGeneratorResponse response;
-  GeneratorResponseContext context(&response, parsed_files);
+  GeneratorResponseContext context(response, parsed_files);
 
   for (int i = 0; i < parsed_files.size(); i++) {
     const FileDescriptor* file = parsed_files[i];
@@ -145,11 +145,174 @@ int PluginMain(int argc, char* argv[], const CodeGenerator* generator) {
               "description.";
     }
     if (!error.empty()) {
-      response.set_error(file->name() + ": " + error);
+      response->set_error(file->name() + ": " + error);
       break;
     }
   }
 
+  return true;
+}
+
+#ifndef _WIN32
+
+// A server exits after this long without a connection.
+static const int kServerIdleSeconds = 10 * 60;
+
+// Answers requests on one connection until protoc closes it.
+static void ServeConnection(const char* program, int connection,
+                            const CodeGenerator* generator) {
+  io::FileInputStream input(connection);
+  io::FileOutputStream output(connection);
+
+  while (true) {
+    CodeGeneratorRequest request;
+    {
+      io::CodedInputStream reader(&input);
+      reader.SetTotalBytesLimit(kint32max, -1);
+      uint32 size;
+      if (!reader.ReadVarint32(&size)) return;
+      io::CodedInputStream::Limit limit = reader.PushLimit(size);
+      if (!request.ParseFromCodedStream(&reader) ||
+          !reader.ConsumedEntireMessage()) {
+        cerr << program << ": protoc sent unparseable request to plugin."
+             << endl;
+        return;
+      }
+      reader.PopLimit(limit);
+    }
+
+    // A request the plugin can't handle closes the connection rather than
+    // being answered, so that protoc runs the plugin directly and reports
+    // the problem the usual way.  The details go to our log.
+    CodeGeneratorResponse response;
+    string error;
+    if (!GenerateResponse(program, request, generator, &response, &error)) {
+      if (!error.empty()) cerr << error << endl;
+      return;
+    }
+
+    {
+      io::CodedOutputStream writer(&output);
+      writer.WriteVarint32(response.ByteSize());
+      response.SerializeWithCachedSizes(&writer);
+    }
+    if (!output.Flush()) return;
+  }
+}
+
+// Returns true if socket_path is still the socket we listen on.
+static bool OwnsSocket(const string& socket_path, const struct stat& owned) {
+  struct stat info;
+  return stat(socket_path.c_str(), &info) == 0 &&
+         info.st_dev == owned.st_dev && info.st_ino == owned.st_ino;
+}
+
+// Runs the plugin as a server listening on socket_path.  See plugin.h.
+static int ServePlugin(const char* program, const string& socket_path,
+                       const CodeGenerator* generator) {
+  // Listen under a temporary name, then move the socket into place.  That
+  // way a socket left by a server which died, or one made by a server
+  // started at the same time as this one, is simply replaced.
+  string temporary = socket_path + "." + SimpleItoa(getpid());
+  struct sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (temporary.size() >= sizeof(address.sun_path)) {
+    cerr << program << ": Socket path too long: " << socket_path << endl;
+    return 1;
+  }
+  strcpy(address.sun_path, temporary.c_str());
+
+  int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+  unlink(temporary.c_str());
+  struct stat owned;
+  if (listener == -1 ||
+      bind(listener, reinterpret_cast<struct sockaddr*>(&address),
+           sizeof(address)) == -1 ||
+      listen(listener, 16) == -1 ||
+      rename(temporary.c_str(), socket_path.c_str()) == -1 ||
+      stat(socket_path.c_str(), &owned) == -1) {
+    cerr << program << ": " << socket_path << ": " << strerror(errno) << endl;
+    unlink(temporary.c_str());
+    return 1;
+  }
+
+  // Tell protoc we're ready, and let go of its pipe.
+  cout << "ready" << endl;
+  int null_fd = open("/dev/null", O_WRONLY);
+  dup2(null_fd, STDOUT_FILENO);
+  close(null_fd);
+
+  // A protoc which gives up on a request mustn't kill us.
+  signal(SIGPIPE, SIG_IGN);
+
+  // Poll once a second, so as to notice soon if the socket is taken away.
+  int idle_seconds = 0;
+  while (idle_seconds < kServerIdleSeconds &&
+         OwnsSocket(socket_path, owned)) {
+    struct pollfd poll_fd;
+    poll_fd.fd = listener;
+    poll_fd.events = POLLIN;
+    int result = poll(&poll_fd, 1, 1000);
+    if (result == 0 || (result == -1 && errno == EINTR)) {
+      ++idle_seconds;
+      continue;
+    }
+
+    int connection = accept(listener, NULL, NULL);
+    if (connection == -1) continue;
+    idle_seconds = 0;
+    ServeConnection(program, connection, generator);
+    close(connection);
+  }
+
+  if (OwnsSocket(socket_path, owned)) {
+    unlink(socket_path.c_str());
+  }
+  close(listener);
+  return 0;
+}
+
+#endif  // !_WIN32
+
+int PluginMain(int argc, char* argv[], const CodeGenerator* generator) {
+
+  if (argc == 2 && HasPrefixString(argv[1], "--protoc_server=")) {
+#ifdef _WIN32
+    cerr << argv[0] << ": Plugin servers are not supported on Windows."
+         << endl;
+    return 1;
+#else
+    return ServePlugin(argv[0], StripPrefixString(argv[1], "--protoc_server="),
+                       generator);
+#endif
+  }
+
+  if (argc > 1) {
+    cerr << argv[0] << ": Unknown option: " << argv[1] << endl;
+    return 1;
+  }
+
+#ifdef _WIN32
+  _setmode(STDIN_FILENO, _O_BINARY);
+  _setmode(STDOUT_FILENO, _O_BINARY);
+#endif
+
+  CodeGeneratorRequest request;
+  if (!request.ParseFromFileDescriptor(STDIN_FILENO)) {
+    cerr << argv[0] << ": protoc sent unparseable request to plugin." << endl;
+    return 1;
+  }
+
+  CodeGeneratorResponse response;
+  string error;
+  if (!GenerateResponse(argv[0], request, generator, &response, &error)) {
+    if (!error.empty()) {
+      cerr << error << endl;
+    }
+    return 1;
+  }
+
   if (!response.SerializeToFileDescriptor(STDOUT_FILENO)) {
     cerr << argv[0] << ": Error writing to stdout." << endl;
     return 1;
@@ -51,6 +51,18 @@
 //     protoc --plugin=protoc-gen-NAME=path/to/mybinary --NAME_out=OUT_DIR
 //   On Windows, make sure to include the .exe suffix:
 //     protoc --plugin=protoc-gen-NAME=path/to/mybinary.exe --NAME_out=OUT_DIR
+//
+// Plugins using PluginMain() can also run as servers, which stay running
+// between runs of protoc and so only pay their start-up cost once.  protoc
+// starts them, passing --protoc_server=SOCKET, when given
+// --plugin_server_dir.  A server listens on the Unix domain socket SOCKET
+// and reads requests, each a varint32 length followed by a
+// CodeGeneratorRequest, answering each the same way with a
+// CodeGeneratorResponse.  A request it can't build the files of closes the
+// connection instead, so that protoc runs the plugin directly and reports
+// the error as usual.  It exits after ten idle minutes, or once SOCKET
+// is removed or taken over by another server.  Servers aren't supported on
+// Windows.
 
 #ifndef GOOGLE_PROTOBUF_COMPILER_PLUGIN_H__
 #define GOOGLE_PROTOBUF_COMPILER_PLUGIN_H__
@@ -221,6 +221,11 @@ CodeGeneratorRequest* CodeGeneratorRequest::New() const {
   return new CodeGeneratorRequest;
 }
 
+CodeGeneratorRequest* CodeGeneratorRequest::New(::google::protobuf::Arena* arena) const {
+  return static_cast< CodeGeneratorRequest*>(
+      ::google::protobuf::Message::New(arena));
+}
+
 void CodeGeneratorRequest::Clear() {
   if (_has_bits_[1 / 32] & (0xffu << (1 % 32))) {
     if (has_parameter()) {
@@ -375,6 +380,39 @@ void CodeGeneratorRequest::SerializeWithCachedSizes(
   return target;
 }
 
+void CodeGeneratorRequest::SerializeReverse(
+    ::google::protobuf::io::ReverseCodedOutputStream* output) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsReverse(
+        unknown_fields(), output);
+  }
+
+  // repeated .google.protobuf.FileDescriptorProto proto_file = 15;
+  for (int i = this->proto_file_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualReverse(
+        15, this->proto_file(i), output);
+  }
+
+  // optional string parameter = 2;
+  if (has_parameter()) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8String(
+      this->parameter().data(), this->parameter().length(),
+      ::google::protobuf::internal::WireFormat::SERIALIZE);
+    ::google::protobuf::internal::WireFormatLite::WriteStringReverse(
+      2, this->parameter(), output);
+  }
+
+  // repeated string file_to_generate = 1;
+  for (int i = this->file_to_generate_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8String(
+      this->file_to_generate(i).data(), this->file_to_generate(i).length(),
+      ::google::protobuf::internal::WireFormat::SERIALIZE);
+    ::google::protobuf::internal::WireFormatLite::
+      WriteStringReverse(1, this->file_to_generate(i), output);
+  }
+}
+
 int CodeGeneratorRequest::ByteSize() const {
   int total_size = 0;
 
@@ -546,6 +584,11 @@ CodeGeneratorResponse_File* CodeGeneratorResponse_File::New() const {
   return new CodeGeneratorResponse_File;
 }
 
+CodeGeneratorResponse_File* CodeGeneratorResponse_File::New(::google::protobuf::Arena* arena) const {
+  return static_cast< CodeGeneratorResponse_File*>(
+      ::google::protobuf::Message::New(arena));
+}
+
 void CodeGeneratorResponse_File::Clear() {
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
     if (has_name()) {
@@ -714,6 +757,41 @@ void CodeGeneratorResponse_File::SerializeWithCachedSizes(
   return target;
 }
 
+void CodeGeneratorResponse_File::SerializeReverse(
+    ::google::protobuf::io::ReverseCodedOutputStream* output) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsReverse(
+        unknown_fields(), output);
+  }
+
+  // optional string content = 15;
+  if (has_content()) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8String(
+      this->content().data(), this->content().length(),
+      ::google::protobuf::internal::WireFormat::SERIALIZE);
+    ::google::protobuf::internal::WireFormatLite::WriteStringReverse(
+      15, this->content(), output);
+  }
+
+  // optional string insertion_point = 2;
+  if (has_insertion_point()) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8String(
+      this->insertion_point().data(), this->insertion_point().length(),
+      ::google::protobuf::internal::WireFormat::SERIALIZE);
+    ::google::protobuf::internal::WireFormatLite::WriteStringReverse(
+      2, this->insertion_point(), output);
+  }
+
+  // optional string name = 1;
+  if (has_name()) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8String(
+      this->name().data(), this->name().length(),
+      ::google::protobuf::internal::WireFormat::SERIALIZE);
+    ::google::protobuf::internal::WireFormatLite::WriteStringReverse(
+      1, this->name(), output);
+  }
+}
+
 int CodeGeneratorResponse_File::ByteSize() const {
   int total_size = 0;
 
@@ -876,6 +954,11 @@ CodeGeneratorResponse* CodeGeneratorResponse::New() const {
   return new CodeGeneratorResponse;
 }
 
+CodeGeneratorResponse* CodeGeneratorResponse::New(::google::protobuf::Arena* arena) const {
+  return static_cast< CodeGeneratorResponse*>(
+      ::google::protobuf::Message::New(arena));
+}
+
 void CodeGeneratorResponse::Clear() {
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
     if (has_error()) {
@@ -991,6 +1074,30 @@ void CodeGeneratorResponse::SerializeWithCachedSizes(
   return target;
 }
 
+void CodeGeneratorResponse::SerializeReverse(
+    ::google::protobuf::io::ReverseCodedOutputStream* output) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsReverse(
+        unknown_fields(), output);
+  }
+
+  // repeated .google.protobuf.compiler.CodeGeneratorResponse.File file = 15;
+  for (int i = this->file_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualReverse(
+        15, this->file(i), output);
+  }
+
+  // optional string error = 1;
+  if (has_error()) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8String(
+      this->error().data(), this->error().length(),
+      ::google::protobuf::internal::WireFormat::SERIALIZE);
+    ::google::protobuf::internal::WireFormatLite::WriteStringReverse(
+      1, this->error(), output);
+  }
+}
+
 int CodeGeneratorResponse::ByteSize() const {
   int total_size = 0;
 
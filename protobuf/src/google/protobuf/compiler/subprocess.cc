@@ -37,19 +37,53 @@
 
 #ifndef _WIN32
 #include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
 #include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
 #include <sys/wait.h>
 #include <signal.h>
 #endif
 
 #include <google/protobuf/stubs/common.h>
+#include <google/protobuf/stubs/hash.h>
+#include <google/protobuf/stubs/once.h>
 #include <google/protobuf/message.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl.h>
+#include <google/protobuf/stubs/strutil.h>
 #include <google/protobuf/stubs/substitute.h>
 
 namespace google {
 namespace protobuf {
 namespace compiler {
 
+namespace {
+
+// Subprocesses may be started and run from several threads at once (e.g.
+// by protoc -j).  This guards the process-wide state that involves: the
+// pipes being handed to a new child, and the SIGPIPE handler.
+Mutex* subprocess_mutex_ = NULL;
+GOOGLE_PROTOBUF_DECLARE_ONCE(subprocess_mutex_init_);
+
+void DeleteSubprocessMutex() {
+  delete subprocess_mutex_;
+}
+
+void InitSubprocessMutex() {
+  subprocess_mutex_ = new Mutex;
+  internal::OnShutdown(&DeleteSubprocessMutex);
+}
+
+Mutex* SubprocessMutex() {
+  GoogleOnceInit(&subprocess_mutex_init_, &InitSubprocessMutex);
+  return subprocess_mutex_;
+}
+
+}  // namespace
+
 #ifdef _WIN32
 
 static void CloseHandleOrDie(HANDLE handle) {
@@ -73,6 +107,10 @@ Subprocess::~Subprocess() {
 }
 
 void Subprocess::Start(const string& program, SearchMode search_mode) {
+  // The child's ends of the pipes are inheritable until we close them
+  // below, so no other thread may start a process in the meantime.
+  MutexLock lock(SubprocessMutex());
+
   // Create the pipes.
   HANDLE stdin_pipe_read;
   HANDLE stdin_pipe_write;
@@ -273,8 +311,52 @@ string Subprocess::Win32ErrorMessage(DWORD error_code) {
 
 // ===================================================================
 
+PluginServerConnection::PluginServerConnection() {}
+PluginServerConnection::~PluginServerConnection() {}
+
+bool PluginServerConnection::Connect(const string& program,
+                                     Subprocess::SearchMode search_mode,
+                                     const string& socket_directory) {
+  return false;
+}
+
+bool PluginServerConnection::Communicate(const Message& input,
+                                         Message* output,
+                                         string* error) {
+  *error = "Plugin servers are not supported on Windows.";
+  return false;
+}
+
+// ===================================================================
+
 #else  // _WIN32
 
+namespace {
+
+// The "sighandler_t" typedef is GNU-specific, so define our own.
+typedef void SignalHandler(int);
+
+// SIGPIPE stays ignored while any Communicate() is in progress; the
+// original handler is saved by the first and restored by the last.
+int sigpipe_ignore_count_ = 0;
+SignalHandler* old_pipe_handler_ = NULL;
+
+void IgnoreSigpipe() {
+  MutexLock lock(SubprocessMutex());
+  if (sigpipe_ignore_count_++ == 0) {
+    old_pipe_handler_ = signal(SIGPIPE, SIG_IGN);
+  }
+}
+
+void RestoreSigpipe() {
+  MutexLock lock(SubprocessMutex());
+  if (--sigpipe_ignore_count_ == 0) {
+    signal(SIGPIPE, old_pipe_handler_);
+  }
+}
+
+}  // namespace
+
 Subprocess::Subprocess()
     : child_pid_(-1), child_stdin_(-1), child_stdout_(-1) {}
 
@@ -288,8 +370,12 @@ Subprocess::~Subprocess() {
 }
 
 void Subprocess::Start(const string& program, SearchMode search_mode) {
-  // Note that we assume that there are no other threads, thus we don't have to
-  // do crazy stuff like using socket pairs or avoiding libc locks.
+  // Other threads may be starting subprocesses too.  Each child must only
+  // inherit its own pipes, or it could hold another child's stdin open and
+  // neither would ever see EOF.  So the pipes are created and the child's
+  // ends closed under a lock, and our ends are close-on-exec.  Between
+  // fork() and exec() the child only makes async-signal-safe calls.
+  MutexLock lock(SubprocessMutex());
 
   // [0] is read end, [1] is write end.
   int stdin_pipe[2];
@@ -297,6 +383,8 @@ void Subprocess::Start(const string& program, SearchMode search_mode) {
 
   GOOGLE_CHECK(pipe(stdin_pipe) != -1);
   GOOGLE_CHECK(pipe(stdout_pipe) != -1);
+  GOOGLE_CHECK(fcntl(stdin_pipe[1], F_SETFD, FD_CLOEXEC) != -1);
+  GOOGLE_CHECK(fcntl(stdout_pipe[0], F_SETFD, FD_CLOEXEC) != -1);
 
   char* argv[2] = { strdup(program.c_str()), NULL };
 
@@ -349,11 +437,8 @@ bool Subprocess::Communicate(const Message& input, Message* output,
 
   GOOGLE_CHECK_NE(child_stdin_, -1) << "Must call Start() first.";
 
-  // The "sighandler_t" typedef is GNU-specific, so define our own.
-  typedef void SignalHandler(int);
-
   // Make sure SIGPIPE is disabled so that if the child dies it doesn't kill us.
-  SignalHandler* old_pipe_handler = signal(SIGPIPE, SIG_IGN);
+  IgnoreSigpipe();
 
   string input_data = input.SerializeAsString();
   string output_data;
@@ -429,7 +514,7 @@ bool Subprocess::Communicate(const Message& input, Message* output,
   }
 
   // Restore SIGPIPE handling.
-  signal(SIGPIPE, old_pipe_handler);
+  RestoreSigpipe();
 
   if (WIFEXITED(status)) {
     if (WEXITSTATUS(status) != 0) {
@@ -456,6 +541,263 @@ bool Subprocess::Communicate(const Message& input, Message* output,
   return true;
 }
 
+// ===================================================================
+
+namespace {
+
+// What a plugin server prints on stdout once it is listening, and the
+// flag which starts one.  See PluginMain().
+const char kServerReady[] = "ready\n";
+const char kServerFlag[] = "--protoc_server=";
+
+// Appended to the socket path to name the file which records that the
+// executable failed to start as a server.
+const char kServerFailedSuffix[] = ".failed";
+
+// Finds the file execvp() would run for the given program.
+bool FindExecutable(const string& program, Subprocess::SearchMode search_mode,
+                    string* executable) {
+  if (search_mode == Subprocess::EXACT_NAME ||
+      program.find('/') != string::npos) {
+    *executable = program;
+    return access(program.c_str(), X_OK) == 0;
+  }
+
+  const char* path = getenv("PATH");
+  vector<string> directories;
+  SplitStringAllowEmpty(path == NULL ? ":/bin:/usr/bin" : path, ":",
+                        &directories);
+  for (int i = 0; i < directories.size(); i++) {
+    *executable = (directories[i].empty() ? "." : directories[i]) + "/" +
+                  program;
+    if (access(executable->c_str(), X_OK) == 0) return true;
+  }
+  return false;
+}
+
+// Returns the socket on which a server for the given executable listens.
+// The name changes whenever the executable does, so that an out-of-date
+// server is never used; it exits by itself once idle.
+string ServerSocketPath(const string& directory, const string& executable,
+                        const struct stat& info) {
+  static const uint64 kSecondSeed = GOOGLE_ULONGLONG(0x9e3779b97f4a7c15);
+  string key = executable + "\n" +
+      SimpleItoa(static_cast<unsigned long long>(info.st_dev)) + "\n" +
+      SimpleItoa(static_cast<unsigned long long>(info.st_ino)) + "\n" +
+      SimpleItoa(static_cast<long long>(info.st_size)) + "\n" +
+      SimpleItoa(static_cast<long long>(info.st_mtime));
+
+  char buffer[kFastToBufferSize];
+  string path = directory;
+  if (!path.empty() && path[path.size() - 1] != '/') path += '/';
+  path += FastHex64ToBuffer(HashString64(key.data(), key.size(), 0), buffer);
+  path += FastHex64ToBuffer(
+      HashString64(key.data(), key.size(), kSecondSeed), buffer);
+  return path + ".sock";
+}
+
+// Writes all of data to fd.  Returns false on error.
+bool WriteFully(int fd, const string& data) {
+  int pos = 0;
+  while (pos < data.size()) {
+    int n = write(fd, data.data() + pos, data.size() - pos);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return false;
+    pos += n;
+  }
+  return true;
+}
+
+}  // namespace
+
+PluginServerConnection::PluginServerConnection() : socket_(-1) {}
+
+PluginServerConnection::~PluginServerConnection() {
+  if (socket_ != -1) {
+    close(socket_);
+  }
+}
+
+bool PluginServerConnection::Connect(const string& program,
+                                     Subprocess::SearchMode search_mode,
+                                     const string& socket_directory) {
+  string executable;
+  struct stat info;
+  if (!FindExecutable(program, search_mode, &executable) ||
+      stat(executable.c_str(), &info) != 0) {
+    return false;
+  }
+
+  string socket_path = ServerSocketPath(socket_directory, executable, info);
+  if (socket_path.size() >= sizeof(((struct sockaddr_un*) NULL)->sun_path)) {
+    return false;
+  }
+
+  // Don't start a program again which couldn't be a server last time.  The
+  // record is keyed like the socket, so a changed executable is retried.
+  if (access((socket_path + kServerFailedSuffix).c_str(), F_OK) == 0) {
+    return false;
+  }
+
+  if (ConnectTo(socket_path)) return true;
+  return StartServer(executable, socket_path) && ConnectTo(socket_path);
+}
+
+bool PluginServerConnection::ConnectTo(const string& socket_path) {
+  struct sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  strcpy(address.sun_path, socket_path.c_str());
+
+  socket_ = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (socket_ == -1) return false;
+  GOOGLE_CHECK(fcntl(socket_, F_SETFD, FD_CLOEXEC) != -1);
+
+  int result;
+  do {
+    result = connect(socket_, reinterpret_cast<struct sockaddr*>(&address),
+                     sizeof(address));
+  } while (result == -1 && errno == EINTR);
+
+  if (result == -1) {
+    close(socket_);
+    socket_ = -1;
+    return false;
+  }
+  return true;
+}
+
+bool PluginServerConnection::StartServer(const string& executable,
+                                         const string& socket_path) {
+  // The server reports that it is ready on its stdout, which is a pipe to
+  // us until then.  It outlives us, so its stderr goes to a log file rather
+  // than ours: anything waiting for our output to end would hang.
+  int ready_pipe[2];
+  pid_t pid;
+  {
+    // See Subprocess::Start().
+    MutexLock lock(SubprocessMutex());
+
+    int null_fd = open("/dev/null", O_RDONLY);
+    int log_fd = open((socket_path + ".log").c_str(),
+                      O_WRONLY | O_CREAT | O_APPEND, 0666);
+    if (null_fd == -1 || log_fd == -1 || pipe(ready_pipe) == -1) {
+      if (null_fd != -1) close(null_fd);
+      if (log_fd != -1) close(log_fd);
+      return false;
+    }
+    GOOGLE_CHECK(fcntl(ready_pipe[0], F_SETFD, FD_CLOEXEC) != -1);
+
+    string flag = kServerFlag + socket_path;
+    char* argv[3] = { strdup(executable.c_str()), strdup(flag.c_str()), NULL };
+
+    pid = fork();
+    if (pid == 0) {
+      // We are the child.  Leave protoc's session, so that the server isn't
+      // killed along with protoc by e.g. ^C at a terminal.
+      setsid();
+
+      dup2(null_fd, STDIN_FILENO);
+      dup2(ready_pipe[1], STDOUT_FILENO);
+      dup2(log_fd, STDERR_FILENO);
+      close(null_fd);
+      close(log_fd);
+      close(ready_pipe[0]);
+      close(ready_pipe[1]);
+
+      // Nor should it hold open anything else protoc's caller gave us, such
+      // as the pipe a build tool reads our output from.
+      long max_fd = sysconf(_SC_OPEN_MAX);
+      if (max_fd < 0 || max_fd > 65536) max_fd = 65536;
+      for (int fd = STDERR_FILENO + 1; fd < max_fd; fd++) {
+        close(fd);
+      }
+
+      execv(argv[0], argv);
+      _exit(1);
+    }
+
+    free(argv[0]);
+    free(argv[1]);
+    close(null_fd);
+    close(log_fd);
+    close(ready_pipe[1]);
+
+    if (pid == -1) {
+      close(ready_pipe[0]);
+      return false;
+    }
+  }
+
+  // A server closes its stdout once it's ready; a program which can't be a
+  // server closes it by exiting.
+  string output;
+  char buffer[64];
+  int n;
+  while ((n = read(ready_pipe[0], buffer, sizeof(buffer))) != 0) {
+    if (n < 0 && errno == EINTR) continue;
+    if (n < 0) break;
+    output.append(buffer, n);
+  }
+  close(ready_pipe[0]);
+
+  if (output != kServerReady) {
+    int status;
+    while (waitpid(pid, &status, 0) == -1 && errno == EINTR) {}
+    int failed_fd = open((socket_path + kServerFailedSuffix).c_str(),
+                         O_WRONLY | O_CREAT, 0666);
+    if (failed_fd != -1) close(failed_fd);
+    return false;
+  }
+  return true;
+}
+
+bool PluginServerConnection::Communicate(const Message& input,
+                                         Message* output,
+                                         string* error) {
+  GOOGLE_CHECK_NE(socket_, -1) << "Must call Connect() first.";
+
+  // Make sure SIGPIPE is disabled so that if the server dies it doesn't
+  // kill us.
+  IgnoreSigpipe();
+
+  string request;
+  {
+    io::StringOutputStream stream(&request);
+    io::CodedOutputStream writer(&stream);
+    writer.WriteVarint32(input.ByteSize());
+    input.SerializeWithCachedSizes(&writer);
+  }
+
+  bool success = WriteFully(socket_, request);
+  if (!success) {
+    *error = strerror(errno);
+  } else {
+    io::FileInputStream stream(socket_);
+    io::CodedInputStream reader(&stream);
+    reader.SetTotalBytesLimit(kint32max, -1);
+
+    uint32 size;
+    if (!reader.ReadVarint32(&size)) {
+      *error = "Plugin server closed the connection.";
+      success = false;
+    } else {
+      io::CodedInputStream::Limit limit = reader.PushLimit(size);
+      if (!output->ParseFromCodedStream(&reader) ||
+          !reader.ConsumedEntireMessage()) {
+        *error = "Plugin output is unparseable.";
+        success = false;
+      }
+      reader.PopLimit(limit);
+    }
+  }
+
+  // Restore SIGPIPE handling.
+  RestoreSigpipe();
+
+  return success;
+}
+
 #endif  // !_WIN32
 
 }  // namespace compiler
@@ -101,6 +101,46 @@ class LIBPROTOC_EXPORT Subprocess {
 #endif  // !_WIN32
 };
 
+// Talks to a plugin running as a server: a process which outlives protoc
+// and handles any number of requests, so that the plugin's start-up cost
+// is paid once rather than on every run.  A server listens on a Unix
+// domain socket in a directory of the caller's choosing, named after the
+// plugin's executable, and is started the first time it is needed.  Each
+// request and response is a varint32 length followed by the message.  See
+// PluginMain() for the plugin's side.
+//
+// Not supported on Windows, where Connect() always fails.
+class LIBPROTOC_EXPORT PluginServerConnection {
+ public:
+  PluginServerConnection();
+  ~PluginServerConnection();
+
+  // Connects to the server for the given program, starting one if needed.
+  // Returns false if that's not possible, e.g. because the program can't
+  // run as a server, in which case the caller should use a Subprocess.  A
+  // program which fails to start as a server is noted in socket_directory
+  // and not started as one again until it changes.
+  bool Connect(const string& program, Subprocess::SearchMode search_mode,
+               const string& socket_directory);
+
+  // Sends the input message to the server and parses its reply into
+  // *output.  Returns true if successful.  On any sort of error, returns
+  // false and sets *error to a description of the problem.
+  bool Communicate(const Message& input, Message* output, string* error);
+
+ private:
+#ifndef _WIN32
+  // Starts a server for the given executable, listening on socket_path,
+  // and waits until it is ready.  Returns false if it fails to start.
+  static bool StartServer(const string& executable, const string& socket_path);
+
+  // Connects socket_ to the given path.
+  bool ConnectTo(const string& socket_path);
+
+  int socket_;
+#endif  // !_WIN32
+};
+
 }  // namespace compiler
 }  // namespace protobuf
 
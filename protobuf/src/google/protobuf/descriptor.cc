@@ -170,13 +170,13 @@ string ToCamelCase(const string& input) {
   return result;
 }
 
-// A DescriptorPool contains a bunch of hash_maps to implement the
+// A DescriptorPool contains a bunch of hash tables to implement the
 // various Find*By*() methods.  Since hashtable lookups are O(1), it's
-// most efficient to construct a fixed set of large hash_maps used by
+// most efficient to construct a fixed set of large tables used by
 // all objects in the pool rather than construct one or more small
-// hash_maps for each object.
+// tables for each object.
 //
-// The keys to these hash_maps are (parent, name) or (parent, number)
+// The keys to these tables are (parent, name) or (parent, number)
 // pairs.  Unfortunately STL doesn't provide hash functions for pair<>,
 // so we must invent our own.
 //
@@ -193,21 +193,12 @@ struct PointerStringPairEqual {
   }
 };
 
+// FlatHashMap scrambles these further, so a cheap combination will do.
 template<typename PairType>
 struct PointerIntegerPairHash {
   size_t operator()(const PairType& p) const {
-    // FIXME(kenton):  What is the best way to compute this hash?  I have
-    // no idea!  This seems a bit better than an XOR.
     return reinterpret_cast<intptr_t>(p.first) * ((1 << 16) - 1) + p.second;
   }
-
-  // Used only by MSVC and platforms where hash_map is not available.
-  static const size_t bucket_size = 4;
-  static const size_t min_buckets = 8;
-  inline bool operator()(const PairType& a, const PairType& b) const {
-    return a.first < b.first ||
-          (a.first == b.first && a.second < b.second);
-  }
 };
 
 typedef pair<const Descriptor*, int> DescriptorIntPair;
@@ -215,21 +206,141 @@ typedef pair<const EnumDescriptor*, int> EnumIntPair;
 
 struct PointerStringPairHash {
   size_t operator()(const PointerStringPair& p) const {
-    // FIXME(kenton):  What is the best way to compute this hash?  I have
-    // no idea!  This seems a bit better than an XOR.
-    hash<const char*> cstring_hash;
     return reinterpret_cast<intptr_t>(p.first) * ((1 << 16) - 1) +
-           cstring_hash(p.second);
+           HashString(p.second, strlen(p.second));
   }
+};
 
-  // Used only by MSVC and platforms where hash_map is not available.
-  static const size_t bucket_size = 4;
-  static const size_t min_buckets = 8;
-  inline bool operator()(const PointerStringPair& a,
-                         const PointerStringPair& b) const {
-    if (a.first < b.first) return true;
-    if (a.first > b.first) return false;
-    return strcmp(a.second, b.second) < 0;
+struct CStringHash {
+  size_t operator()(const char* str) const {
+    return HashString(str, strlen(str));
+  }
+};
+
+// An open-addressing hash table with linear probing, used instead of
+// hash_map for the symbol tables.  Entries live in one flat array and
+// carry their key's hash, so a probe rarely has to look beyond the entry
+// itself -- with node-based buckets, every probe chases a pointer.  Keys
+// and values must be cheap to copy, as they are moved when the table
+// grows or an entry is erased.
+//
+// Implements just enough of the hash_map interface for the helpers in
+// map-util.h.  find() returns NULL, which is end(), if the key is absent;
+// insert() and erase() invalidate all pointers into the table.
+template <typename Key, typename Value, typename HashFcn, typename EqualKey>
+class FlatHashMap {
+ public:
+  typedef pair<Key, Value> value_type;
+  typedef value_type* iterator;
+  typedef const value_type* const_iterator;
+
+  FlatHashMap() : size_(0), shift_(64) {}
+
+  int size() const { return size_; }
+
+  const_iterator end() const { return NULL; }
+  iterator end() { return NULL; }
+
+  const_iterator find(const Key& key) const {
+    int i = FindIndex(key, Hash(key));
+    return i < 0 ? NULL : &entries_[i].value;
+  }
+
+  iterator find(const Key& key) {
+    int i = FindIndex(key, Hash(key));
+    return i < 0 ? NULL : &entries_[i].value;
+  }
+
+  pair<iterator, bool> insert(const value_type& value) {
+    size_t hash = Hash(value.first);
+    int existing = FindIndex(value.first, hash);
+    if (existing >= 0) return make_pair(&entries_[existing].value, false);
+
+    // Grow at half full, as lookups that miss -- which resolving relative
+    // names does a lot of -- probe until they reach an empty entry.
+    if ((size_ + 1) * 2 > static_cast<int>(entries_.size())) {
+      Resize(entries_.empty() ? 8 : entries_.size() * 2);
+    }
+
+    int i = Bucket(hash);
+    while (entries_[i].hash != 0) i = Next(i);
+    entries_[i].hash = hash;
+    entries_[i].value = value;
+    size_++;
+    return make_pair(&entries_[i].value, true);
+  }
+
+  void erase(const Key& key) {
+    int hole = FindIndex(key, Hash(key));
+    if (hole < 0) return;
+
+    // Shift later entries of the run back into the hole, so that no
+    // tombstones are needed.
+    for (int i = Next(hole); entries_[i].hash != 0; i = Next(i)) {
+      int home = Bucket(entries_[i].hash);
+      // Move the entry unless its home lies cyclically within (hole, i].
+      if ((hole < i) ? (home <= hole || home > i) : (home <= hole && home > i)) {
+        entries_[hole] = entries_[i];
+        hole = i;
+      }
+    }
+    entries_[hole] = Entry();
+    size_--;
+  }
+
+ private:
+  struct Entry {
+    Entry() : hash(0) {}
+    size_t hash;  // 0 if the entry is empty.
+    value_type value;
+  };
+
+  vector<Entry> entries_;
+  int size_;
+  int shift_;  // 64 - log2(entries_.size())
+  HashFcn hash_;
+  EqualKey equal_;
+
+  size_t Hash(const Key& key) const {
+    size_t hash = hash_(key);
+    return hash == 0 ? 1 : hash;
+  }
+
+  // Returns the index of the key's entry, or -1 if there is none.
+  int FindIndex(const Key& key, size_t hash) const {
+    if (size_ == 0) return -1;
+    for (int i = Bucket(hash); ; i = Next(i)) {
+      const Entry& entry = entries_[i];
+      if (entry.hash == 0) return -1;
+      if (entry.hash == hash && equal_(entry.value.first, key)) return i;
+    }
+  }
+
+  // Takes the top bits of a multiplicative scramble of the hash, which
+  // spreads out hashes that differ only in their high bits.
+  int Bucket(size_t hash) const {
+    return static_cast<int>(
+      (static_cast<uint64>(hash) * GOOGLE_ULONGLONG(0x9e3779b97f4a7c15)) >>
+      shift_);
+  }
+
+  int Next(int i) const {
+    return (i + 1) & (entries_.size() - 1);
+  }
+
+  void Resize(int capacity) {
+    vector<Entry> old;
+    old.swap(entries_);
+    entries_.resize(capacity);
+    shift_ = 64;
+    for (int n = capacity; n > 1; n >>= 1) shift_--;
+
+    for (int j = 0; j < old.size(); j++) {
+      if (old[j].hash == 0) continue;
+      int i = Bucket(old[j].hash);
+      while (entries_[i].hash != 0) i = Next(i);
+      entries_[i] = old[j];
+    }
   }
 };
 
@@ -292,23 +403,25 @@ struct Symbol {
 
 const Symbol kNullSymbol;
 
-typedef hash_map<const char*, Symbol,
-                 hash<const char*>, streq>
+typedef FlatHashMap<const char*, Symbol,
+                    CStringHash, streq>
   SymbolsByNameMap;
-typedef hash_map<PointerStringPair, Symbol,
-                 PointerStringPairHash, PointerStringPairEqual>
+typedef FlatHashMap<PointerStringPair, Symbol,
+                    PointerStringPairHash, PointerStringPairEqual>
   SymbolsByParentMap;
-typedef hash_map<const char*, const FileDescriptor*,
-                 hash<const char*>, streq>
+typedef FlatHashMap<const char*, const FileDescriptor*,
+                    CStringHash, streq>
   FilesByNameMap;
-typedef hash_map<PointerStringPair, const FieldDescriptor*,
-                 PointerStringPairHash, PointerStringPairEqual>
+typedef FlatHashMap<PointerStringPair, const FieldDescriptor*,
+                    PointerStringPairHash, PointerStringPairEqual>
   FieldsByNameMap;
-typedef hash_map<DescriptorIntPair, const FieldDescriptor*,
-                 PointerIntegerPairHash<DescriptorIntPair> >
+typedef FlatHashMap<DescriptorIntPair, const FieldDescriptor*,
+                    PointerIntegerPairHash<DescriptorIntPair>,
+                    equal_to<DescriptorIntPair> >
   FieldsByNumberMap;
-typedef hash_map<EnumIntPair, const EnumValueDescriptor*,
-                 PointerIntegerPairHash<EnumIntPair> >
+typedef FlatHashMap<EnumIntPair, const EnumValueDescriptor*,
+                    PointerIntegerPairHash<EnumIntPair>,
+                    equal_to<EnumIntPair> >
   EnumValuesByNumberMap;
 // This is a map rather than a hash_map, since we use it to iterate
 // through all the extensions that extend a given Descriptor, and an
@@ -542,9 +655,7 @@ class FileDescriptorTables {
 DescriptorPool::Tables::Tables()
     // Start some hash_map and hash_set objects with a small # of buckets
     : known_bad_files_(3),
-      extensions_loaded_from_db_(3),
-      symbols_by_name_(3),
-      files_by_name_(3) {}
+      extensions_loaded_from_db_(3) {}
 
 
 DescriptorPool::Tables::~Tables() {
@@ -559,13 +670,7 @@ DescriptorPool::Tables::~Tables() {
   STLDeleteElements(&file_tables_);
 }
 
-FileDescriptorTables::FileDescriptorTables()
-    // Initialize all the hash tables to start out with a small # of buckets
-    : symbols_by_parent_(3),
-      fields_by_lowercase_name_(3),
-      fields_by_camelcase_name_(3),
-      fields_by_number_(3),
-      enum_values_by_number_(3) {
+FileDescriptorTables::FileDescriptorTables() {
 }
 
 FileDescriptorTables::~FileDescriptorTables() {}
@@ -666,7 +771,7 @@ inline Symbol FileDescriptorTables::FindNestedSymbolOfType(
 
 Symbol DescriptorPool::Tables::FindByNameHelper(
     const DescriptorPool* pool, const string& name) const {
-  MutexLockMaybe lock(pool->mutex_);
+  MutexLockMaybe lock(pool->lookup_mutex());
   Symbol result = FindSymbol(name);
 
   if (result.IsNull() && pool->underlay_ != NULL) {
@@ -849,7 +954,8 @@ DescriptorPool::DescriptorPool()
     underlay_(NULL),
     tables_(new Tables),
     enforce_dependencies_(true),
-    allow_unknown_(false) {}
+    allow_unknown_(false),
+    sealed_(false) {}
 
 DescriptorPool::DescriptorPool(DescriptorDatabase* fallback_database,
                                ErrorCollector* error_collector)
@@ -859,7 +965,8 @@ DescriptorPool::DescriptorPool(DescriptorDatabase* fallback_database,
     underlay_(NULL),
     tables_(new Tables),
     enforce_dependencies_(true),
-    allow_unknown_(false) {
+    allow_unknown_(false),
+    sealed_(false) {
 }
 
 DescriptorPool::DescriptorPool(const DescriptorPool* underlay)
@@ -869,7 +976,8 @@ DescriptorPool::DescriptorPool(const DescriptorPool* underlay)
     underlay_(underlay),
     tables_(new Tables),
     enforce_dependencies_(true),
-    allow_unknown_(false) {}
+    allow_unknown_(false),
+    sealed_(false) {}
 
 DescriptorPool::~DescriptorPool() {
   if (mutex_ != NULL) delete mutex_;
@@ -882,8 +990,26 @@ void DescriptorPool::InternalDontEnforceDependencies() {
   enforce_dependencies_ = false;
 }
 
-bool DescriptorPool::InternalIsFileLoaded(const string& filename) const {
+void DescriptorPool::Seal() {
   MutexLockMaybe lock(mutex_);
+  if (sealed_) return;
+
+  // Nothing is loaded lazily once sealed, so load everything now.
+  vector<string> names;
+  if (fallback_database_ != NULL &&
+      fallback_database_->FindAllFileNames(&names)) {
+    for (int i = 0; i < names.size(); i++) {
+      if (tables_->FindFile(names[i]) == NULL) {
+        TryFindFileInFallbackDatabase(names[i]);
+      }
+    }
+  }
+
+  sealed_ = true;
+}
+
+bool DescriptorPool::InternalIsFileLoaded(const string& filename) const {
+  MutexLockMaybe lock(lookup_mutex());
   return tables_->FindFile(filename) != NULL;
 }
 
@@ -962,7 +1088,7 @@ void DescriptorPool::InternalAddGeneratedFile(
 //   there's nothing more important to do (read: never).
 
 const FileDescriptor* DescriptorPool::FindFileByName(const string& name) const {
-  MutexLockMaybe lock(mutex_);
+  MutexLockMaybe lock(lookup_mutex());
   const FileDescriptor* result = tables_->FindFile(name);
   if (result != NULL) return result;
   if (underlay_ != NULL) {
@@ -978,7 +1104,7 @@ const FileDescriptor* DescriptorPool::FindFileByName(const string& name) const {
 
 const FileDescriptor* DescriptorPool::FindFileContainingSymbol(
     const string& symbol_name) const {
-  MutexLockMaybe lock(mutex_);
+  MutexLockMaybe lock(lookup_mutex());
   Symbol result = tables_->FindSymbol(symbol_name);
   if (!result.IsNull()) return result.GetFile();
   if (underlay_ != NULL) {
@@ -1048,7 +1174,7 @@ const MethodDescriptor* DescriptorPool::FindMethodByName(
 
 const FieldDescriptor* DescriptorPool::FindExtensionByNumber(
     const Descriptor* extendee, int number) const {
-  MutexLockMaybe lock(mutex_);
+  MutexLockMaybe lock(lookup_mutex());
   const FieldDescriptor* result = tables_->FindExtension(extendee, number);
   if (result != NULL) {
     return result;
@@ -1068,11 +1194,11 @@ const FieldDescriptor* DescriptorPool::FindExtensionByNumber(
 
 void DescriptorPool::FindAllExtensions(
     const Descriptor* extendee, vector<const FieldDescriptor*>* out) const {
-  MutexLockMaybe lock(mutex_);
+  MutexLockMaybe lock(lookup_mutex());
 
   // Initialize tables_->extensions_ from the fallback database first
   // (but do this only once per descriptor).
-  if (fallback_database_ != NULL &&
+  if (fallback_database_ != NULL && !sealed_ &&
       tables_->extensions_loaded_from_db_.count(extendee) == 0) {
     vector<int> numbers;
     if (fallback_database_->FindAllExtensionNumbers(extendee->full_name(),
@@ -1095,14 +1221,28 @@ void DescriptorPool::FindAllExtensions(
 
 // -------------------------------------------------------------------
 
+namespace {
+
+bool FieldNumberLess(const FieldDescriptor* field, int number) {
+  return field->number() < number;
+}
+
+bool FieldsByNumberLess(const FieldDescriptor* a, const FieldDescriptor* b) {
+  return a->number() < b->number();
+}
+
+}  // namespace
+
 const FieldDescriptor*
-Descriptor::FindFieldByNumber(int key) const {
-  const FieldDescriptor* result =
-    file()->tables_->FindFieldByNumber(this, key);
-  if (result == NULL || result->is_extension()) {
+Descriptor::FindSparseFieldByNumber(int key) const {
+  const FieldDescriptor* const* begin = sparse_fields_;
+  const FieldDescriptor* const* end = begin + sparse_field_count_;
+  const FieldDescriptor* const* it =
+    lower_bound(begin, end, key, FieldNumberLess);
+  if (it == end || (*it)->number() != key) {
     return NULL;
   } else {
-    return result;
+    return *it;
   }
 }
 
@@ -1318,7 +1458,7 @@ bool Descriptor::IsExtensionNumber(int number) const {
 // -------------------------------------------------------------------
 
 bool DescriptorPool::TryFindFileInFallbackDatabase(const string& name) const {
-  if (fallback_database_ == NULL) return false;
+  if (fallback_database_ == NULL || sealed_) return false;
 
   if (tables_->known_bad_files_.count(name) > 0) return false;
 
@@ -1355,7 +1495,7 @@ bool DescriptorPool::IsSubSymbolOfBuiltType(const string& name) const {
 }
 
 bool DescriptorPool::TryFindSymbolInFallbackDatabase(const string& name) const {
-  if (fallback_database_ == NULL) return false;
+  if (fallback_database_ == NULL || sealed_) return false;
 
   // We skip looking in the fallback database if the name is a sub-symbol of
   // any descriptor that already exists in the descriptor pool (except for
@@ -1395,7 +1535,7 @@ bool DescriptorPool::TryFindSymbolInFallbackDatabase(const string& name) const {
 
 bool DescriptorPool::TryFindExtensionInFallbackDatabase(
     const Descriptor* containing_type, int field_number) const {
-  if (fallback_database_ == NULL) return false;
+  if (fallback_database_ == NULL || sealed_) return false;
 
   FileDescriptorProto file_proto;
   if (!fallback_database_->FindFileContainingExtension(
@@ -2333,6 +2473,8 @@ class DescriptorBuilder {
   // Validate*Options methods.
   void CrossLinkFile(FileDescriptor* file, const FileDescriptorProto& proto);
   void CrossLinkMessage(Descriptor* message, const DescriptorProto& proto);
+  // Builds the tables behind Descriptor::FindFieldByNumber().
+  void BuildFieldsByNumber(Descriptor* message);
   void CrossLinkField(FieldDescriptor* field,
                       const FieldDescriptorProto& proto);
   void CrossLinkEnum(EnumDescriptor* enum_type,
@@ -2503,6 +2645,7 @@ const FileDescriptor* DescriptorPool::BuildFile(
        "DescriptorDatabase.  You must instead find a way to get your file "
        "into the underlying database.";
   GOOGLE_CHECK(mutex_ == NULL);   // Implied by the above GOOGLE_CHECK.
+  GOOGLE_CHECK(!sealed_) << "Cannot call BuildFile on a sealed DescriptorPool.";
   return DescriptorBuilder(this, tables_.get(), NULL).BuildFile(proto);
 }
 
@@ -2514,6 +2657,7 @@ const FileDescriptor* DescriptorPool::BuildFileCollectingErrors(
        "DescriptorDatabase.  You must instead find a way to get your file "
        "into the underlying database.";
   GOOGLE_CHECK(mutex_ == NULL);   // Implied by the above GOOGLE_CHECK.
+  GOOGLE_CHECK(!sealed_) << "Cannot call BuildFile on a sealed DescriptorPool.";
   return DescriptorBuilder(this, tables_.get(),
                            error_collector).BuildFile(proto);
 }
@@ -2591,7 +2735,7 @@ Symbol DescriptorBuilder::FindSymbolNotEnforcingDepsHelper(
     const DescriptorPool* pool, const string& name) {
   // If we are looking at an underlay, we must lock its mutex_, since we are
   // accessing the underlay's tables_ directly.
-  MutexLockMaybe lock((pool == pool_) ? NULL : pool->mutex_);
+  MutexLockMaybe lock((pool == pool_) ? NULL : pool->lookup_mutex());
 
   Symbol result = pool->tables_->FindSymbol(name);
   if (result.IsNull() && pool->underlay_ != NULL) {
@@ -3266,6 +3410,12 @@ void DescriptorBuilder::BuildMessage(const DescriptorProto& proto,
   result->is_placeholder_  = false;
   result->is_unqualified_placeholder_ = false;
 
+  // Filled in by BuildFieldsByNumber().
+  result->dense_field_limit_ = 0;
+  result->dense_fields_ = NULL;
+  result->sparse_field_count_ = 0;
+  result->sparse_fields_ = NULL;
+
   BUILD_ARRAY(proto, result, field          , BuildField         , result);
   BUILD_ARRAY(proto, result, nested_type    , BuildMessage       , result);
   BUILD_ARRAY(proto, result, enum_type      , BuildEnum          , result);
@@ -3780,6 +3930,52 @@ void DescriptorBuilder::CrossLinkMessage(
   for (int i = 0; i < message->extension_count(); i++) {
     CrossLinkField(&message->extensions_[i], proto.extension(i));
   }
+
+  BuildFieldsByNumber(message);
+}
+
+void DescriptorBuilder::BuildFieldsByNumber(Descriptor* message) {
+  if (message->field_count() == 0) return;
+
+  // A pointer per number is cheap while the numbers are about as many as
+  // the fields, as they usually are; any that are much larger go in the
+  // sorted array instead.
+  int max_number = 0;
+  for (int i = 0; i < message->field_count(); i++) {
+    max_number = max(max_number, message->field(i)->number());
+  }
+  int limit = min(max_number + 1, 2 * message->field_count() + 16);
+
+  message->dense_field_limit_ = limit;
+  message->dense_fields_ =
+    tables_->AllocateArray<const FieldDescriptor*>(limit);
+  fill(message->dense_fields_, message->dense_fields_ + limit,
+       static_cast<const FieldDescriptor*>(NULL));
+
+  int sparse_count = 0;
+  for (int i = 0; i < message->field_count(); i++) {
+    const FieldDescriptor* field = message->field(i);
+    if (field->number() >= limit) {
+      sparse_count++;
+    } else if (field->number() >= 0 &&
+               message->dense_fields_[field->number()] == NULL) {
+      // If numbers are duplicated the first field wins, as it does in
+      // fields_by_number_; the file fails to build anyway.
+      message->dense_fields_[field->number()] = field;
+    }
+  }
+
+  if (sparse_count == 0) return;
+  message->sparse_field_count_ = sparse_count;
+  message->sparse_fields_ =
+    tables_->AllocateArray<const FieldDescriptor*>(sparse_count);
+  for (int i = 0, j = 0; i < message->field_count(); i++) {
+    if (message->field(i)->number() >= limit) {
+      message->sparse_fields_[j++] = message->field(i);
+    }
+  }
+  stable_sort(message->sparse_fields_,
+              message->sparse_fields_ + sparse_count, FieldsByNumberLess);
 }
 
 void DescriptorBuilder::CrossLinkField(
@@ -273,6 +273,9 @@ class LIBPROTOBUF_EXPORT Descriptor {
   // to this descriptor from the file root.
   void GetLocationPath(vector<int>* output) const;
 
+  // FindFieldByNumber() for numbers outside the dense table.
+  const FieldDescriptor* FindSparseFieldByNumber(int number) const;
+
   const string* name_;
   const string* full_name_;
   const FileDescriptor* file_;
@@ -294,6 +297,15 @@ class LIBPROTOBUF_EXPORT Descriptor {
   ExtensionRange* extension_ranges_;
   int extension_count_;
   FieldDescriptor* extensions_;
+
+  // The fields by number, for FindFieldByNumber(), which parsing calls for
+  // every tag it reads:  dense_fields_[n] is the field numbered n, or NULL,
+  // for 0 <= n < dense_field_limit_.  The fields numbered above that are
+  // in sparse_fields_, sorted by number.
+  int dense_field_limit_;
+  const FieldDescriptor** dense_fields_;
+  int sparse_field_count_;
+  const FieldDescriptor** sparse_fields_;
   // IMPORTANT:  If you add a new field, make sure to search for all instances
   // of Allocate<Descriptor>() and AllocateArray<Descriptor>() in descriptor.cc
   // and update them to initialize the field.
@@ -1078,6 +1090,7 @@ class LIBPROTOBUF_EXPORT DescriptorPool {
   //   them slower even when they don't have to fall back to the database.
   //   In fact, even the Find*By*() methods of descriptor objects owned by
   //   this pool will be slower, since they will have to obtain locks too.
+  //   Seal() the pool once it is fully loaded to avoid this.
   // - An ErrorCollector may optionally be given to collect validation errors
   //   in files loaded from the database.  If not given, errors will be printed
   //   to GOOGLE_LOG(ERROR).  Remember that files are built on-demand, so this
@@ -1199,6 +1212,24 @@ class LIBPROTOBUF_EXPORT DescriptorPool {
   // debugging purposes.
   void AllowUnknownDependencies() { allow_unknown_ = true; }
 
+  // Freezing the pool -----------------------------------------------
+
+  // Declares that the pool will not change any more, after which the
+  // Find*By*() methods take no locks and can be called from any number of
+  // threads without contending with each other.  If the pool has a fallback
+  // database, every file the database can enumerate (see
+  // DescriptorDatabase::FindAllFileNames()) is built first; the database is
+  // not consulted afterwards, so anything not found by then, including
+  // files added to the database later, stays missing.  BuildFile*() must
+  // not be called on a sealed pool (it will assert-fail).
+  //
+  // Seal() is not itself thread-safe: call it before sharing the pool with
+  // the threads that look things up in it.
+  void Seal();
+
+  // Returns true if Seal() has been called.
+  bool sealed() const { return sealed_; }
+
   // Internal stuff --------------------------------------------------
   // These methods MUST NOT be called from outside the proto2 library.
   // These methods may contain hidden pitfalls and may be removed in a
@@ -1282,6 +1313,10 @@ class LIBPROTOBUF_EXPORT DescriptorPool {
   const FileDescriptor* BuildFileFromDatabase(
     const FileDescriptorProto& proto) const;
 
+  // The mutex to lock while accessing tables_: NULL once the pool is
+  // sealed, since tables_ no longer changes.
+  Mutex* lookup_mutex() const { return sealed_ ? NULL : mutex_; }
+
   // If fallback_database_ is NULL, this is NULL.  Otherwise, this is a mutex
   // which must be locked while accessing tables_.
   Mutex* mutex_;
@@ -1298,6 +1333,7 @@ class LIBPROTOBUF_EXPORT DescriptorPool {
 
   bool enforce_dependencies_;
   bool allow_unknown_;
+  bool sealed_;
 
   GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(DescriptorPool);
 };
@@ -1438,6 +1474,14 @@ inline bool FieldDescriptor::is_packable() const {
   return is_repeated() && IsTypePackable(type());
 }
 
+inline const FieldDescriptor* Descriptor::FindFieldByNumber(int number) const {
+  if (static_cast<unsigned int>(number) <
+      static_cast<unsigned int>(dense_field_limit_)) {
+    return dense_fields_[number];
+  }
+  return FindSparseFieldByNumber(number);
+}
+
 // To save space, index() is computed by looking at the descriptor's position
 // in the parent's array of children.
 inline int FieldDescriptor::index() const {
@@ -266,7 +266,7 @@ void protobuf_AssignDesc_google_2fprotobuf_2fdescriptor_2eproto() {
       ::google::protobuf::MessageFactory::generated_factory(),
       sizeof(MethodDescriptorProto));
   FileOptions_descriptor_ = file->message_type(8);
-  static const int FileOptions_offsets_[10] = {
+  static const int FileOptions_offsets_[11] = {
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(FileOptions, java_package_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(FileOptions, java_outer_classname_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(FileOptions, java_multiple_files_),
@@ -276,6 +276,7 @@ void protobuf_AssignDesc_google_2fprotobuf_2fdescriptor_2eproto() {
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(FileOptions, cc_generic_services_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(FileOptions, java_generic_services_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(FileOptions, py_generic_services_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(FileOptions, cc_enable_arenas_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(FileOptions, uninterpreted_option_),
   };
   FileOptions_reflection_ =
@@ -621,7 +622,7 @@ void protobuf_AddDesc_google_2fprotobuf_2fdescriptor_2eproto() {
     "\025MethodDescriptorProto\022\014\n\004name\030\001 \001(\t\022\022\n\n"
     "input_type\030\002 \001(\t\022\023\n\013output_type\030\003 \001(\t\022/\n"
     "\007options\030\004 \001(\0132\036.google.protobuf.MethodO"
-    "ptions\"\351\003\n\013FileOptions\022\024\n\014java_package\030\001"
+    "ptions\"\234\004\n\013FileOptions\022\024\n\014java_package\030\001"
     " \001(\t\022\034\n\024java_outer_classname\030\010 \001(\t\022\"\n\023ja"
     "va_multiple_files\030\n \001(\010:\005false\022,\n\035java_g"
     "enerate_equals_and_hash\030\024 \001(\010:\005false\022F\n\014"
@@ -629,47 +630,48 @@ void protobuf_AddDesc_google_2fprotobuf_2fdescriptor_2eproto() {
     "eOptions.OptimizeMode:\005SPEED\022\022\n\ngo_packa"
     "ge\030\013 \001(\t\022\"\n\023cc_generic_services\030\020 \001(\010:\005f"
     "alse\022$\n\025java_generic_services\030\021 \001(\010:\005fal"
-    "se\022\"\n\023py_generic_services\030\022 \001(\010:\005false\022C"
-    "\n\024uninterpreted_option\030\347\007 \003(\0132$.google.p"
-    "rotobuf.UninterpretedOption\":\n\014OptimizeM"
-    "ode\022\t\n\005SPEED\020\001\022\r\n\tCODE_SIZE\020\002\022\020\n\014LITE_RU"
-    "NTIME\020\003*\t\010\350\007\020\200\200\200\200\002\"\270\001\n\016MessageOptions\022&\n"
-    "\027message_set_wire_format\030\001 \001(\010:\005false\022.\n"
-    "\037no_standard_descriptor_accessor\030\002 \001(\010:\005"
-    "false\022C\n\024uninterpreted_option\030\347\007 \003(\0132$.g"
-    "oogle.protobuf.UninterpretedOption*\t\010\350\007\020"
-    "\200\200\200\200\002\"\276\002\n\014FieldOptions\022:\n\005ctype\030\001 \001(\0162#."
-    "google.protobuf.FieldOptions.CType:\006STRI"
-    "NG\022\016\n\006packed\030\002 \001(\010\022\023\n\004lazy\030\005 \001(\010:\005false\022"
-    "\031\n\ndeprecated\030\003 \001(\010:\005false\022\034\n\024experiment"
-    "al_map_key\030\t \001(\t\022\023\n\004weak\030\n \001(\010:\005false\022C\n"
-    "\024uninterpreted_option\030\347\007 \003(\0132$.google.pr"
-    "otobuf.UninterpretedOption\"/\n\005CType\022\n\n\006S"
-    "TRING\020\000\022\010\n\004CORD\020\001\022\020\n\014STRING_PIECE\020\002*\t\010\350\007"
-    "\020\200\200\200\200\002\"x\n\013EnumOptions\022\031\n\013allow_alias\030\002 \001"
-    "(\010:\004true\022C\n\024uninterpreted_option\030\347\007 \003(\0132"
-    "$.google.protobuf.UninterpretedOption*\t\010"
-    "\350\007\020\200\200\200\200\002\"b\n\020EnumValueOptions\022C\n\024uninterp"
-    "reted_option\030\347\007 \003(\0132$.google.protobuf.Un"
-    "interpretedOption*\t\010\350\007\020\200\200\200\200\002\"`\n\016ServiceO"
-    "ptions\022C\n\024uninterpreted_option\030\347\007 \003(\0132$."
-    "google.protobuf.UninterpretedOption*\t\010\350\007"
-    "\020\200\200\200\200\002\"_\n\rMethodOptions\022C\n\024uninterpreted"
-    "_option\030\347\007 \003(\0132$.google.protobuf.Uninter"
-    "pretedOption*\t\010\350\007\020\200\200\200\200\002\"\236\002\n\023Uninterprete"
-    "dOption\022;\n\004name\030\002 \003(\0132-.google.protobuf."
-    "UninterpretedOption.NamePart\022\030\n\020identifi"
-    "er_value\030\003 \001(\t\022\032\n\022positive_int_value\030\004 \001"
-    "(\004\022\032\n\022negative_int_value\030\005 \001(\003\022\024\n\014double"
-    "_value\030\006 \001(\001\022\024\n\014string_value\030\007 \001(\014\022\027\n\017ag"
-    "gregate_value\030\010 \001(\t\0323\n\010NamePart\022\021\n\tname_"
-    "part\030\001 \002(\t\022\024\n\014is_extension\030\002 \002(\010\"\261\001\n\016Sou"
-    "rceCodeInfo\022:\n\010location\030\001 \003(\0132(.google.p"
-    "rotobuf.SourceCodeInfo.Location\032c\n\010Locat"
-    "ion\022\020\n\004path\030\001 \003(\005B\002\020\001\022\020\n\004span\030\002 \003(\005B\002\020\001\022"
-    "\030\n\020leading_comments\030\003 \001(\t\022\031\n\021trailing_co"
-    "mments\030\004 \001(\tB)\n\023com.google.protobufB\020Des"
-    "criptorProtosH\001", 4135);
+    "se\022\"\n\023py_generic_services\030\022 \001(\010:\005false\022\037"
+    "\n\020cc_enable_arenas\030\037 \001(\010:\005false\022C\n\024unint"
+    "erpreted_option\030\347\007 \003(\0132$.google.protobuf"
+    ".UninterpretedOption\"L\n\014OptimizeMode\022\t\n\005"
+    "SPEED\020\001\022\r\n\tCODE_SIZE\020\002\022\020\n\014LITE_RUNTIME\020\003"
+    "\022\020\n\014TABLE_DRIVEN\020\004*\t\010\350\007\020\200\200\200\200\002\"\270\001\n\016Messag"
+    "eOptions\022&\n\027message_set_wire_format\030\001 \001("
+    "\010:\005false\022.\n\037no_standard_descriptor_acces"
+    "sor\030\002 \001(\010:\005false\022C\n\024uninterpreted_option"
+    "\030\347\007 \003(\0132$.google.protobuf.UninterpretedO"
+    "ption*\t\010\350\007\020\200\200\200\200\002\"\276\002\n\014FieldOptions\022:\n\005cty"
+    "pe\030\001 \001(\0162#.google.protobuf.FieldOptions."
+    "CType:\006STRING\022\016\n\006packed\030\002 \001(\010\022\023\n\004lazy\030\005 "
+    "\001(\010:\005false\022\031\n\ndeprecated\030\003 \001(\010:\005false\022\034\n"
+    "\024experimental_map_key\030\t \001(\t\022\023\n\004weak\030\n \001("
+    "\010:\005false\022C\n\024uninterpreted_option\030\347\007 \003(\0132"
+    "$.google.protobuf.UninterpretedOption\"/\n"
+    "\005CType\022\n\n\006STRING\020\000\022\010\n\004CORD\020\001\022\020\n\014STRING_P"
+    "IECE\020\002*\t\010\350\007\020\200\200\200\200\002\"x\n\013EnumOptions\022\031\n\013allo"
+    "w_alias\030\002 \001(\010:\004true\022C\n\024uninterpreted_opt"
+    "ion\030\347\007 \003(\0132$.google.protobuf.Uninterpret"
+    "edOption*\t\010\350\007\020\200\200\200\200\002\"b\n\020EnumValueOptions\022"
+    "C\n\024uninterpreted_option\030\347\007 \003(\0132$.google."
+    "protobuf.UninterpretedOption*\t\010\350\007\020\200\200\200\200\002\""
+    "`\n\016ServiceOptions\022C\n\024uninterpreted_optio"
+    "n\030\347\007 \003(\0132$.google.protobuf.Uninterpreted"
+    "Option*\t\010\350\007\020\200\200\200\200\002\"_\n\rMethodOptions\022C\n\024un"
+    "interpreted_option\030\347\007 \003(\0132$.google.proto"
+    "buf.UninterpretedOption*\t\010\350\007\020\200\200\200\200\002\"\236\002\n\023U"
+    "ninterpretedOption\022;\n\004name\030\002 \003(\0132-.googl"
+    "e.protobuf.UninterpretedOption.NamePart\022"
+    "\030\n\020identifier_value\030\003 \001(\t\022\032\n\022positive_in"
+    "t_value\030\004 \001(\004\022\032\n\022negative_int_value\030\005 \001("
+    "\003\022\024\n\014double_value\030\006 \001(\001\022\024\n\014string_value\030"
+    "\007 \001(\014\022\027\n\017aggregate_value\030\010 \001(\t\0323\n\010NamePa"
+    "rt\022\021\n\tname_part\030\001 \002(\t\022\024\n\014is_extension\030\002 "
+    "\002(\010\"\261\001\n\016SourceCodeInfo\022:\n\010location\030\001 \003(\013"
+    "2(.google.protobuf.SourceCodeInfo.Locati"
+    "on\032c\n\010Location\022\020\n\004path\030\001 \003(\005B\002\020\001\022\020\n\004span"
+    "\030\002 \003(\005B\002\020\001\022\030\n\020leading_comments\030\003 \001(\t\022\031\n\021"
+    "trailing_comments\030\004 \001(\tB)\n\023com.google.pr"
+    "otobufB\020DescriptorProtosH\001", 4186);
   ::google::protobuf::MessageFactory::InternalRegisterGeneratedFile(
     "google/protobuf/descriptor.proto", &protobuf_RegisterTypes);
   FileDescriptorSet::default_instance_ = new FileDescriptorSet();
@@ -777,6 +779,11 @@ FileDescriptorSet* FileDescriptorSet::New() const {
   return new FileDescriptorSet;
 }
 
+FileDescriptorSet* FileDescriptorSet::New(::google::protobuf::Arena* arena) const {
+  return static_cast< FileDescriptorSet*>(
+      ::google::protobuf::Message::New(arena));
+}
+
 void FileDescriptorSet::Clear() {
   file_.Clear();
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
@@ -850,6 +857,21 @@ void FileDescriptorSet::SerializeWithCachedSizes(
   return target;
 }
 
+void FileDescriptorSet::SerializeReverse(
+    ::google::protobuf::io::ReverseCodedOutputStream* output) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsReverse(
+        unknown_fields(), output);
+  }
+
+  // repeated .google.protobuf.FileDescriptorProto file = 1;
+  for (int i = this->file_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualReverse(
+        1, this->file(i), output);
+  }
+}
+
 int FileDescriptorSet::ByteSize() const {
   int total_size = 0;
 
@@ -1007,6 +1029,11 @@ FileDescriptorProto* FileDescriptorProto::New() const {
   return new FileDescriptorProto;
 }
 
+FileDescriptorProto* FileDescriptorProto::New(::google::protobuf::Arena* arena) const {
+  return static_cast< FileDescriptorProto*>(
+      ::google::protobuf::Message::New(arena));
+}
+
 void FileDescriptorProto::Clear() {
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
     if (has_name()) {
@@ -1420,6 +1447,95 @@ void FileDescriptorProto::SerializeWithCachedSizes(
   return target;
 }
 
+void FileDescriptorProto::SerializeReverse(
+    ::google::protobuf::io::ReverseCodedOutputStream* output) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsReverse(
+        unknown_fields(), output);
+  }
+
+  // repeated int32 weak_dependency = 11;
+  for (int i = this->weak_dependency_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteInt32Reverse(11, this->weak_dependency(i), output);
+  }
+
+  // repeated int32 public_dependency = 10;
+  for (int i = this->public_dependency_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteInt32Reverse(10, this->public_dependency(i), output);
+  }
+
+  // optional .google.protobuf.SourceCodeInfo source_code_info = 9;
+  if (has_source_code_info()) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualReverse(
+        9, this->source_code_info(), output);
+  }
+
+  // optional .google.protobuf.FileOptions options = 8;
+  if (has_options()) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualReverse(
+        8, this->options(), output);
+  }
+
+  // repeated .google.protobuf.FieldDescriptorProto extension = 7;
+  for (int i = this->extension_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualReverse(
+        7, this->extension(i), output);
+  }
+
+  // repeated .google.protobuf.ServiceDescriptorProto service = 6;
+  for (int i = this->service_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualReverse(
+        6, this->service(i), output);
+  }
+
+  // repeated .google.protobuf.EnumDescriptorProto enum_type = 5;
+  for (int i = this->enum_type_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualReverse(
+        5, this->enum_type(i), output);
+  }
+
+  // repeated .google.protobuf.DescriptorProto message_type = 4;
+  for (int i = this->message_type_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualReverse(
+        4, this->message_type(i), output);
+  }
+
+  // repeated string dependency = 3;
+  for (int i = this->dependency_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8String(
+      this->dependency(i).data(), this->dependency(i).length(),
+      ::google::protobuf::internal::WireFormat::SERIALIZE);
+    ::google::protobuf::internal::WireFormatLite::
+      WriteStringReverse(3, this->dependency(i), output);
+  }
+
+  // optional string package = 2;
+  if (has_package()) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8String(
+      this->package().data(), this->package().length(),
+      ::google::protobuf::internal::WireFormat::SERIALIZE);
+    ::google::protobuf::internal::WireFormatLite::WriteStringReverse(
+      2, this->package(), output);
+  }
+
+  // optional string name = 1;
+  if (has_name()) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8String(
+      this->name().data(), this->name().length(),
+      ::google::protobuf::internal::WireFormat::SERIALIZE);
+    ::google::protobuf::internal::WireFormatLite::WriteStringReverse(
+      1, this->name(), output);
+  }
+}
+
 int FileDescriptorProto::ByteSize() const {
   int total_size = 0;
 
@@ -1683,6 +1799,11 @@ DescriptorProto_ExtensionRange* DescriptorProto_ExtensionRange::New() const {
   return new DescriptorProto_ExtensionRange;
 }
 
+DescriptorProto_ExtensionRange* DescriptorProto_ExtensionRange::New(::google::protobuf::Arena* arena) const {
+  return static_cast< DescriptorProto_ExtensionRange*>(
+      ::google::protobuf::Message::New(arena));
+}
+
 void DescriptorProto_ExtensionRange::Clear() {
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
     start_ = 0;
@@ -1782,6 +1903,24 @@ void DescriptorProto_ExtensionRange::SerializeWithCachedSizes(
   return target;
 }
 
+void DescriptorProto_ExtensionRange::SerializeReverse(
+    ::google::protobuf::io::ReverseCodedOutputStream* output) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsReverse(
+        unknown_fields(), output);
+  }
+
+  // optional int32 end = 2;
+  if (has_end()) {
+    ::google::protobuf::internal::WireFormatLite::WriteInt32Reverse(2, this->end(), output);
+  }
+
+  // optional int32 start = 1;
+  if (has_start()) {
+    ::google::protobuf::internal::WireFormatLite::WriteInt32Reverse(1, this->start(), output);
+  }
+}
+
 int DescriptorProto_ExtensionRange::ByteSize() const {
   int total_size = 0;
 
@@ -1941,6 +2080,11 @@ DescriptorProto* DescriptorProto::New() const {
   return new DescriptorProto;
 }
 
+DescriptorProto* DescriptorProto::New(::google::protobuf::Arena* arena) const {
+  return static_cast< DescriptorProto*>(
+      ::google::protobuf::Message::New(arena));
+}
+
 void DescriptorProto::Clear() {
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
     if (has_name()) {
@@ -2202,6 +2346,65 @@ void DescriptorProto::SerializeWithCachedSizes(
   return target;
 }
 
+void DescriptorProto::SerializeReverse(
+    ::google::protobuf::io::ReverseCodedOutputStream* output) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsReverse(
+        unknown_fields(), output);
+  }
+
+  // optional .google.protobuf.MessageOptions options = 7;
+  if (has_options()) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualReverse(
+        7, this->options(), output);
+  }
+
+  // repeated .google.protobuf.FieldDescriptorProto extension = 6;
+  for (int i = this->extension_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualReverse(
+        6, this->extension(i), output);
+  }
+
+  // repeated .google.protobuf.DescriptorProto.ExtensionRange extension_range = 5;
+  for (int i = this->extension_range_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualReverse(
+        5, this->extension_range(i), output);
+  }
+
+  // repeated .google.protobuf.EnumDescriptorProto enum_type = 4;
+  for (int i = this->enum_type_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualReverse(
+        4, this->enum_type(i), output);
+  }
+
+  // repeated .google.protobuf.DescriptorProto nested_type = 3;
+  for (int i = this->nested_type_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualReverse(
+        3, this->nested_type(i), output);
+  }
+
+  // repeated .google.protobuf.FieldDescriptorProto field = 2;
+  for (int i = this->field_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualReverse(
+        2, this->field(i), output);
+  }
+
+  // optional string name = 1;
+  if (has_name()) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8String(
+      this->name().data(), this->name().length(),
+      ::google::protobuf::internal::WireFormat::SERIALIZE);
+    ::google::protobuf::internal::WireFormatLite::WriteStringReverse(
+      1, this->name(), output);
+  }
+}
+
 int DescriptorProto::ByteSize() const {
   int total_size = 0;
 
@@ -2518,6 +2721,11 @@ FieldDescriptorProto* FieldDescriptorProto::New() const {
   return new FieldDescriptorProto;
 }
 
+FieldDescriptorProto* FieldDescriptorProto::New(::google::protobuf::Arena* arena) const {
+  return static_cast< FieldDescriptorProto*>(
+      ::google::protobuf::Message::New(arena));
+}
+
 void FieldDescriptorProto::Clear() {
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
     if (has_name()) {
@@ -2852,6 +3060,74 @@ void FieldDescriptorProto::SerializeWithCachedSizes(
   return target;
 }
 
+void FieldDescriptorProto::SerializeReverse(
+    ::google::protobuf::io::ReverseCodedOutputStream* output) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsReverse(
+        unknown_fields(), output);
+  }
+
+  // optional .google.protobuf.FieldOptions options = 8;
+  if (has_options()) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualReverse(
+        8, this->options(), output);
+  }
+
+  // optional string default_value = 7;
+  if (has_default_value()) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8String(
+      this->default_value().data(), this->default_value().length(),
+      ::google::protobuf::internal::WireFormat::SERIALIZE);
+    ::google::protobuf::internal::WireFormatLite::WriteStringReverse(
+      7, this->default_value(), output);
+  }
+
+  // optional string type_name = 6;
+  if (has_type_name()) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8String(
+      this->type_name().data(), this->type_name().length(),
+      ::google::protobuf::internal::WireFormat::SERIALIZE);
+    ::google::protobuf::internal::WireFormatLite::WriteStringReverse(
+      6, this->type_name(), output);
+  }
+
+  // optional .google.protobuf.FieldDescriptorProto.Type type = 5;
+  if (has_type()) {
+    ::google::protobuf::internal::WireFormatLite::WriteEnumReverse(
+      5, this->type(), output);
+  }
+
+  // optional .google.protobuf.FieldDescriptorProto.Label label = 4;
+  if (has_label()) {
+    ::google::protobuf::internal::WireFormatLite::WriteEnumReverse(
+      4, this->label(), output);
+  }
+
+  // optional int32 number = 3;
+  if (has_number()) {
+    ::google::protobuf::internal::WireFormatLite::WriteInt32Reverse(3, this->number(), output);
+  }
+
+  // optional string extendee = 2;
+  if (has_extendee()) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8String(
+      this->extendee().data(), this->extendee().length(),
+      ::google::protobuf::internal::WireFormat::SERIALIZE);
+    ::google::protobuf::internal::WireFormatLite::WriteStringReverse(
+      2, this->extendee(), output);
+  }
+
+  // optional string name = 1;
+  if (has_name()) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8String(
+      this->name().data(), this->name().length(),
+      ::google::protobuf::internal::WireFormat::SERIALIZE);
+    ::google::protobuf::internal::WireFormatLite::WriteStringReverse(
+      1, this->name(), output);
+  }
+}
+
 int FieldDescriptorProto::ByteSize() const {
   int total_size = 0;
 
@@ -3074,6 +3350,11 @@ EnumDescriptorProto* EnumDescriptorProto::New() const {
   return new EnumDescriptorProto;
 }
 
+EnumDescriptorProto* EnumDescriptorProto::New(::google::protobuf::Arena* arena) const {
+  return static_cast< EnumDescriptorProto*>(
+      ::google::protobuf::Message::New(arena));
+}
+
 void EnumDescriptorProto::Clear() {
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
     if (has_name()) {
@@ -3219,6 +3500,37 @@ void EnumDescriptorProto::SerializeWithCachedSizes(
   return target;
 }
 
+void EnumDescriptorProto::SerializeReverse(
+    ::google::protobuf::io::ReverseCodedOutputStream* output) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsReverse(
+        unknown_fields(), output);
+  }
+
+  // optional .google.protobuf.EnumOptions options = 3;
+  if (has_options()) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualReverse(
+        3, this->options(), output);
+  }
+
+  // repeated .google.protobuf.EnumValueDescriptorProto value = 2;
+  for (int i = this->value_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualReverse(
+        2, this->value(i), output);
+  }
+
+  // optional string name = 1;
+  if (has_name()) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8String(
+      this->name().data(), this->name().length(),
+      ::google::protobuf::internal::WireFormat::SERIALIZE);
+    ::google::protobuf::internal::WireFormatLite::WriteStringReverse(
+      1, this->name(), output);
+  }
+}
+
 int EnumDescriptorProto::ByteSize() const {
   int total_size = 0;
 
@@ -3391,6 +3703,11 @@ EnumValueDescriptorProto* EnumValueDescriptorProto::New() const {
   return new EnumValueDescriptorProto;
 }
 
+EnumValueDescriptorProto* EnumValueDescriptorProto::New(::google::protobuf::Arena* arena) const {
+  return static_cast< EnumValueDescriptorProto*>(
+      ::google::protobuf::Message::New(arena));
+}
+
 void EnumValueDescriptorProto::Clear() {
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
     if (has_name()) {
@@ -3534,6 +3851,35 @@ void EnumValueDescriptorProto::SerializeWithCachedSizes(
   return target;
 }
 
+void EnumValueDescriptorProto::SerializeReverse(
+    ::google::protobuf::io::ReverseCodedOutputStream* output) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsReverse(
+        unknown_fields(), output);
+  }
+
+  // optional .google.protobuf.EnumValueOptions options = 3;
+  if (has_options()) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualReverse(
+        3, this->options(), output);
+  }
+
+  // optional int32 number = 2;
+  if (has_number()) {
+    ::google::protobuf::internal::WireFormatLite::WriteInt32Reverse(2, this->number(), output);
+  }
+
+  // optional string name = 1;
+  if (has_name()) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8String(
+      this->name().data(), this->name().length(),
+      ::google::protobuf::internal::WireFormat::SERIALIZE);
+    ::google::protobuf::internal::WireFormatLite::WriteStringReverse(
+      1, this->name(), output);
+  }
+}
+
 int EnumValueDescriptorProto::ByteSize() const {
   int total_size = 0;
 
@@ -3703,6 +4049,11 @@ ServiceDescriptorProto* ServiceDescriptorProto::New() const {
   return new ServiceDescriptorProto;
 }
 
+ServiceDescriptorProto* ServiceDescriptorProto::New(::google::protobuf::Arena* arena) const {
+  return static_cast< ServiceDescriptorProto*>(
+      ::google::protobuf::Message::New(arena));
+}
+
 void ServiceDescriptorProto::Clear() {
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
     if (has_name()) {
@@ -3848,6 +4199,37 @@ void ServiceDescriptorProto::SerializeWithCachedSizes(
   return target;
 }
 
+void ServiceDescriptorProto::SerializeReverse(
+    ::google::protobuf::io::ReverseCodedOutputStream* output) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsReverse(
+        unknown_fields(), output);
+  }
+
+  // optional .google.protobuf.ServiceOptions options = 3;
+  if (has_options()) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualReverse(
+        3, this->options(), output);
+  }
+
+  // repeated .google.protobuf.MethodDescriptorProto method = 2;
+  for (int i = this->method_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualReverse(
+        2, this->method(i), output);
+  }
+
+  // optional string name = 1;
+  if (has_name()) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8String(
+      this->name().data(), this->name().length(),
+      ::google::protobuf::internal::WireFormat::SERIALIZE);
+    ::google::protobuf::internal::WireFormatLite::WriteStringReverse(
+      1, this->name(), output);
+  }
+}
+
 int ServiceDescriptorProto::ByteSize() const {
   int total_size = 0;
 
@@ -4028,6 +4410,11 @@ MethodDescriptorProto* MethodDescriptorProto::New() const {
   return new MethodDescriptorProto;
 }
 
+MethodDescriptorProto* MethodDescriptorProto::New(::google::protobuf::Arena* arena) const {
+  return static_cast< MethodDescriptorProto*>(
+      ::google::protobuf::Message::New(arena));
+}
+
 void MethodDescriptorProto::Clear() {
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
     if (has_name()) {
@@ -4226,18 +4613,60 @@ void MethodDescriptorProto::SerializeWithCachedSizes(
   return target;
 }
 
-int MethodDescriptorProto::ByteSize() const {
-  int total_size = 0;
+void MethodDescriptorProto::SerializeReverse(
+    ::google::protobuf::io::ReverseCodedOutputStream* output) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsReverse(
+        unknown_fields(), output);
+  }
 
-  if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
-    // optional string name = 1;
-    if (has_name()) {
-      total_size += 1 +
-        ::google::protobuf::internal::WireFormatLite::StringSize(
-          this->name());
-    }
+  // optional .google.protobuf.MethodOptions options = 4;
+  if (has_options()) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualReverse(
+        4, this->options(), output);
+  }
 
-    // optional string input_type = 2;
+  // optional string output_type = 3;
+  if (has_output_type()) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8String(
+      this->output_type().data(), this->output_type().length(),
+      ::google::protobuf::internal::WireFormat::SERIALIZE);
+    ::google::protobuf::internal::WireFormatLite::WriteStringReverse(
+      3, this->output_type(), output);
+  }
+
+  // optional string input_type = 2;
+  if (has_input_type()) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8String(
+      this->input_type().data(), this->input_type().length(),
+      ::google::protobuf::internal::WireFormat::SERIALIZE);
+    ::google::protobuf::internal::WireFormatLite::WriteStringReverse(
+      2, this->input_type(), output);
+  }
+
+  // optional string name = 1;
+  if (has_name()) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8String(
+      this->name().data(), this->name().length(),
+      ::google::protobuf::internal::WireFormat::SERIALIZE);
+    ::google::protobuf::internal::WireFormatLite::WriteStringReverse(
+      1, this->name(), output);
+  }
+}
+
+int MethodDescriptorProto::ByteSize() const {
+  int total_size = 0;
+
+  if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
+    // optional string name = 1;
+    if (has_name()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::StringSize(
+          this->name());
+    }
+
+    // optional string input_type = 2;
     if (has_input_type()) {
       total_size += 1 +
         ::google::protobuf::internal::WireFormatLite::StringSize(
@@ -4353,6 +4782,7 @@ bool FileOptions_OptimizeMode_IsValid(int value) {
     case 1:
     case 2:
     case 3:
+    case 4:
       return true;
     default:
       return false;
@@ -4363,6 +4793,7 @@ bool FileOptions_OptimizeMode_IsValid(int value) {
 const FileOptions_OptimizeMode FileOptions::SPEED;
 const FileOptions_OptimizeMode FileOptions::CODE_SIZE;
 const FileOptions_OptimizeMode FileOptions::LITE_RUNTIME;
+const FileOptions_OptimizeMode FileOptions::TABLE_DRIVEN;
 const FileOptions_OptimizeMode FileOptions::OptimizeMode_MIN;
 const FileOptions_OptimizeMode FileOptions::OptimizeMode_MAX;
 const int FileOptions::OptimizeMode_ARRAYSIZE;
@@ -4377,6 +4808,7 @@ const int FileOptions::kGoPackageFieldNumber;
 const int FileOptions::kCcGenericServicesFieldNumber;
 const int FileOptions::kJavaGenericServicesFieldNumber;
 const int FileOptions::kPyGenericServicesFieldNumber;
+const int FileOptions::kCcEnableArenasFieldNumber;
 const int FileOptions::kUninterpretedOptionFieldNumber;
 #endif  // !_MSC_VER
 
@@ -4405,6 +4837,7 @@ void FileOptions::SharedCtor() {
   cc_generic_services_ = false;
   java_generic_services_ = false;
   py_generic_services_ = false;
+  cc_enable_arenas_ = false;
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
 }
 
@@ -4447,6 +4880,11 @@ FileOptions* FileOptions::New() const {
   return new FileOptions;
 }
 
+FileOptions* FileOptions::New(::google::protobuf::Arena* arena) const {
+  return static_cast< FileOptions*>(
+      ::google::protobuf::Message::New(arena));
+}
+
 void FileOptions::Clear() {
   _extensions_.Clear();
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
@@ -4473,6 +4911,7 @@ void FileOptions::Clear() {
   }
   if (_has_bits_[8 / 32] & (0xffu << (8 % 32))) {
     py_generic_services_ = false;
+    cc_enable_arenas_ = false;
   }
   uninterpreted_option_.Clear();
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
@@ -4632,6 +5071,22 @@ bool FileOptions::MergePartialFromCodedStream(
         } else {
           goto handle_uninterpreted;
         }
+        if (input->ExpectTag(248)) goto parse_cc_enable_arenas;
+        break;
+      }
+
+      // optional bool cc_enable_arenas = 31 [default = false];
+      case 31: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
+         parse_cc_enable_arenas:
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   bool, ::google::protobuf::internal::WireFormatLite::TYPE_BOOL>(
+                 input, &cc_enable_arenas_)));
+          set_has_cc_enable_arenas();
+        } else {
+          goto handle_uninterpreted;
+        }
         if (input->ExpectTag(7994)) goto parse_uninterpreted_option;
         break;
       }
@@ -4732,6 +5187,11 @@ void FileOptions::SerializeWithCachedSizes(
     ::google::protobuf::internal::WireFormatLite::WriteBool(20, this->java_generate_equals_and_hash(), output);
   }
 
+  // optional bool cc_enable_arenas = 31 [default = false];
+  if (has_cc_enable_arenas()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBool(31, this->cc_enable_arenas(), output);
+  }
+
   // repeated .google.protobuf.UninterpretedOption uninterpreted_option = 999;
   for (int i = 0; i < this->uninterpreted_option_size(); i++) {
     ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
@@ -4811,6 +5271,11 @@ void FileOptions::SerializeWithCachedSizes(
     target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(20, this->java_generate_equals_and_hash(), target);
   }
 
+  // optional bool cc_enable_arenas = 31 [default = false];
+  if (has_cc_enable_arenas()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(31, this->cc_enable_arenas(), target);
+  }
+
   // repeated .google.protobuf.UninterpretedOption uninterpreted_option = 999;
   for (int i = 0; i < this->uninterpreted_option_size(); i++) {
     target = ::google::protobuf::internal::WireFormatLite::
@@ -4829,6 +5294,87 @@ void FileOptions::SerializeWithCachedSizes(
   return target;
 }
 
+void FileOptions::SerializeReverse(
+    ::google::protobuf::io::ReverseCodedOutputStream* output) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsReverse(
+        unknown_fields(), output);
+  }
+
+  // Extension range [1000, 536870912)
+  _extensions_.SerializeReverse(1000, 536870912, output);
+
+  // repeated .google.protobuf.UninterpretedOption uninterpreted_option = 999;
+  for (int i = this->uninterpreted_option_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualReverse(
+        999, this->uninterpreted_option(i), output);
+  }
+
+  // optional bool cc_enable_arenas = 31 [default = false];
+  if (has_cc_enable_arenas()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBoolReverse(31, this->cc_enable_arenas(), output);
+  }
+
+  // optional bool java_generate_equals_and_hash = 20 [default = false];
+  if (has_java_generate_equals_and_hash()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBoolReverse(20, this->java_generate_equals_and_hash(), output);
+  }
+
+  // optional bool py_generic_services = 18 [default = false];
+  if (has_py_generic_services()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBoolReverse(18, this->py_generic_services(), output);
+  }
+
+  // optional bool java_generic_services = 17 [default = false];
+  if (has_java_generic_services()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBoolReverse(17, this->java_generic_services(), output);
+  }
+
+  // optional bool cc_generic_services = 16 [default = false];
+  if (has_cc_generic_services()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBoolReverse(16, this->cc_generic_services(), output);
+  }
+
+  // optional string go_package = 11;
+  if (has_go_package()) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8String(
+      this->go_package().data(), this->go_package().length(),
+      ::google::protobuf::internal::WireFormat::SERIALIZE);
+    ::google::protobuf::internal::WireFormatLite::WriteStringReverse(
+      11, this->go_package(), output);
+  }
+
+  // optional bool java_multiple_files = 10 [default = false];
+  if (has_java_multiple_files()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBoolReverse(10, this->java_multiple_files(), output);
+  }
+
+  // optional .google.protobuf.FileOptions.OptimizeMode optimize_for = 9 [default = SPEED];
+  if (has_optimize_for()) {
+    ::google::protobuf::internal::WireFormatLite::WriteEnumReverse(
+      9, this->optimize_for(), output);
+  }
+
+  // optional string java_outer_classname = 8;
+  if (has_java_outer_classname()) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8String(
+      this->java_outer_classname().data(), this->java_outer_classname().length(),
+      ::google::protobuf::internal::WireFormat::SERIALIZE);
+    ::google::protobuf::internal::WireFormatLite::WriteStringReverse(
+      8, this->java_outer_classname(), output);
+  }
+
+  // optional string java_package = 1;
+  if (has_java_package()) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8String(
+      this->java_package().data(), this->java_package().length(),
+      ::google::protobuf::internal::WireFormat::SERIALIZE);
+    ::google::protobuf::internal::WireFormatLite::WriteStringReverse(
+      1, this->java_package(), output);
+  }
+}
+
 int FileOptions::ByteSize() const {
   int total_size = 0;
 
@@ -4887,6 +5433,11 @@ int FileOptions::ByteSize() const {
       total_size += 2 + 1;
     }
 
+    // optional bool cc_enable_arenas = 31 [default = false];
+    if (has_cc_enable_arenas()) {
+      total_size += 2 + 1;
+    }
+
   }
   // repeated .google.protobuf.UninterpretedOption uninterpreted_option = 999;
   total_size += 2 * this->uninterpreted_option_size();
@@ -4954,6 +5505,9 @@ void FileOptions::MergeFrom(const FileOptions& from) {
     if (from.has_py_generic_services()) {
       set_py_generic_services(from.py_generic_services());
     }
+    if (from.has_cc_enable_arenas()) {
+      set_cc_enable_arenas(from.cc_enable_arenas());
+    }
   }
   _extensions_.MergeFrom(from._extensions_);
   mutable_unknown_fields()->MergeFrom(from.unknown_fields());
@@ -4991,6 +5545,7 @@ void FileOptions::Swap(FileOptions* other) {
     std::swap(cc_generic_services_, other->cc_generic_services_);
     std::swap(java_generic_services_, other->java_generic_services_);
     std::swap(py_generic_services_, other->py_generic_services_);
+    std::swap(cc_enable_arenas_, other->cc_enable_arenas_);
     uninterpreted_option_.Swap(&other->uninterpreted_option_);
     std::swap(_has_bits_[0], other->_has_bits_[0]);
     _unknown_fields_.Swap(&other->_unknown_fields_);
@@ -5067,6 +5622,11 @@ MessageOptions* MessageOptions::New() const {
   return new MessageOptions;
 }
 
+MessageOptions* MessageOptions::New(::google::protobuf::Arena* arena) const {
+  return static_cast< MessageOptions*>(
+      ::google::protobuf::Message::New(arena));
+}
+
 void MessageOptions::Clear() {
   _extensions_.Clear();
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
@@ -5209,6 +5769,34 @@ void MessageOptions::SerializeWithCachedSizes(
   return target;
 }
 
+void MessageOptions::SerializeReverse(
+    ::google::protobuf::io::ReverseCodedOutputStream* output) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsReverse(
+        unknown_fields(), output);
+  }
+
+  // Extension range [1000, 536870912)
+  _extensions_.SerializeReverse(1000, 536870912, output);
+
+  // repeated .google.protobuf.UninterpretedOption uninterpreted_option = 999;
+  for (int i = this->uninterpreted_option_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualReverse(
+        999, this->uninterpreted_option(i), output);
+  }
+
+  // optional bool no_standard_descriptor_accessor = 2 [default = false];
+  if (has_no_standard_descriptor_accessor()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBoolReverse(2, this->no_standard_descriptor_accessor(), output);
+  }
+
+  // optional bool message_set_wire_format = 1 [default = false];
+  if (has_message_set_wire_format()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBoolReverse(1, this->message_set_wire_format(), output);
+  }
+}
+
 int MessageOptions::ByteSize() const {
   int total_size = 0;
 
@@ -5407,6 +5995,11 @@ FieldOptions* FieldOptions::New() const {
   return new FieldOptions;
 }
 
+FieldOptions* FieldOptions::New(::google::protobuf::Arena* arena) const {
+  return static_cast< FieldOptions*>(
+      ::google::protobuf::Message::New(arena));
+}
+
 void FieldOptions::Clear() {
   _extensions_.Clear();
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
@@ -5678,6 +6271,59 @@ void FieldOptions::SerializeWithCachedSizes(
   return target;
 }
 
+void FieldOptions::SerializeReverse(
+    ::google::protobuf::io::ReverseCodedOutputStream* output) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsReverse(
+        unknown_fields(), output);
+  }
+
+  // Extension range [1000, 536870912)
+  _extensions_.SerializeReverse(1000, 536870912, output);
+
+  // repeated .google.protobuf.UninterpretedOption uninterpreted_option = 999;
+  for (int i = this->uninterpreted_option_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualReverse(
+        999, this->uninterpreted_option(i), output);
+  }
+
+  // optional bool weak = 10 [default = false];
+  if (has_weak()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBoolReverse(10, this->weak(), output);
+  }
+
+  // optional string experimental_map_key = 9;
+  if (has_experimental_map_key()) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8String(
+      this->experimental_map_key().data(), this->experimental_map_key().length(),
+      ::google::protobuf::internal::WireFormat::SERIALIZE);
+    ::google::protobuf::internal::WireFormatLite::WriteStringReverse(
+      9, this->experimental_map_key(), output);
+  }
+
+  // optional bool lazy = 5 [default = false];
+  if (has_lazy()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBoolReverse(5, this->lazy(), output);
+  }
+
+  // optional bool deprecated = 3 [default = false];
+  if (has_deprecated()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBoolReverse(3, this->deprecated(), output);
+  }
+
+  // optional bool packed = 2;
+  if (has_packed()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBoolReverse(2, this->packed(), output);
+  }
+
+  // optional .google.protobuf.FieldOptions.CType ctype = 1 [default = STRING];
+  if (has_ctype()) {
+    ::google::protobuf::internal::WireFormatLite::WriteEnumReverse(
+      1, this->ctype(), output);
+  }
+}
+
 int FieldOptions::ByteSize() const {
   int total_size = 0;
 
@@ -5879,6 +6525,11 @@ EnumOptions* EnumOptions::New() const {
   return new EnumOptions;
 }
 
+EnumOptions* EnumOptions::New(::google::protobuf::Arena* arena) const {
+  return static_cast< EnumOptions*>(
+      ::google::protobuf::Message::New(arena));
+}
+
 void EnumOptions::Clear() {
   _extensions_.Clear();
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
@@ -5994,6 +6645,29 @@ void EnumOptions::SerializeWithCachedSizes(
   return target;
 }
 
+void EnumOptions::SerializeReverse(
+    ::google::protobuf::io::ReverseCodedOutputStream* output) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsReverse(
+        unknown_fields(), output);
+  }
+
+  // Extension range [1000, 536870912)
+  _extensions_.SerializeReverse(1000, 536870912, output);
+
+  // repeated .google.protobuf.UninterpretedOption uninterpreted_option = 999;
+  for (int i = this->uninterpreted_option_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualReverse(
+        999, this->uninterpreted_option(i), output);
+  }
+
+  // optional bool allow_alias = 2 [default = true];
+  if (has_allow_alias()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBoolReverse(2, this->allow_alias(), output);
+  }
+}
+
 int EnumOptions::ByteSize() const {
   int total_size = 0;
 
@@ -6145,6 +6819,11 @@ EnumValueOptions* EnumValueOptions::New() const {
   return new EnumValueOptions;
 }
 
+EnumValueOptions* EnumValueOptions::New(::google::protobuf::Arena* arena) const {
+  return static_cast< EnumValueOptions*>(
+      ::google::protobuf::Message::New(arena));
+}
+
 void EnumValueOptions::Clear() {
   _extensions_.Clear();
   uninterpreted_option_.Clear();
@@ -6232,6 +6911,24 @@ void EnumValueOptions::SerializeWithCachedSizes(
   return target;
 }
 
+void EnumValueOptions::SerializeReverse(
+    ::google::protobuf::io::ReverseCodedOutputStream* output) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsReverse(
+        unknown_fields(), output);
+  }
+
+  // Extension range [1000, 536870912)
+  _extensions_.SerializeReverse(1000, 536870912, output);
+
+  // repeated .google.protobuf.UninterpretedOption uninterpreted_option = 999;
+  for (int i = this->uninterpreted_option_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualReverse(
+        999, this->uninterpreted_option(i), output);
+  }
+}
+
 int EnumValueOptions::ByteSize() const {
   int total_size = 0;
 
@@ -6370,6 +7067,11 @@ ServiceOptions* ServiceOptions::New() const {
   return new ServiceOptions;
 }
 
+ServiceOptions* ServiceOptions::New(::google::protobuf::Arena* arena) const {
+  return static_cast< ServiceOptions*>(
+      ::google::protobuf::Message::New(arena));
+}
+
 void ServiceOptions::Clear() {
   _extensions_.Clear();
   uninterpreted_option_.Clear();
@@ -6457,6 +7159,24 @@ void ServiceOptions::SerializeWithCachedSizes(
   return target;
 }
 
+void ServiceOptions::SerializeReverse(
+    ::google::protobuf::io::ReverseCodedOutputStream* output) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsReverse(
+        unknown_fields(), output);
+  }
+
+  // Extension range [1000, 536870912)
+  _extensions_.SerializeReverse(1000, 536870912, output);
+
+  // repeated .google.protobuf.UninterpretedOption uninterpreted_option = 999;
+  for (int i = this->uninterpreted_option_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualReverse(
+        999, this->uninterpreted_option(i), output);
+  }
+}
+
 int ServiceOptions::ByteSize() const {
   int total_size = 0;
 
@@ -6595,6 +7315,11 @@ MethodOptions* MethodOptions::New() const {
   return new MethodOptions;
 }
 
+MethodOptions* MethodOptions::New(::google::protobuf::Arena* arena) const {
+  return static_cast< MethodOptions*>(
+      ::google::protobuf::Message::New(arena));
+}
+
 void MethodOptions::Clear() {
   _extensions_.Clear();
   uninterpreted_option_.Clear();
@@ -6682,6 +7407,24 @@ void MethodOptions::SerializeWithCachedSizes(
   return target;
 }
 
+void MethodOptions::SerializeReverse(
+    ::google::protobuf::io::ReverseCodedOutputStream* output) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsReverse(
+        unknown_fields(), output);
+  }
+
+  // Extension range [1000, 536870912)
+  _extensions_.SerializeReverse(1000, 536870912, output);
+
+  // repeated .google.protobuf.UninterpretedOption uninterpreted_option = 999;
+  for (int i = this->uninterpreted_option_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualReverse(
+        999, this->uninterpreted_option(i), output);
+  }
+}
+
 int MethodOptions::ByteSize() const {
   int total_size = 0;
 
@@ -6826,6 +7569,11 @@ UninterpretedOption_NamePart* UninterpretedOption_NamePart::New() const {
   return new UninterpretedOption_NamePart;
 }
 
+UninterpretedOption_NamePart* UninterpretedOption_NamePart::New(::google::protobuf::Arena* arena) const {
+  return static_cast< UninterpretedOption_NamePart*>(
+      ::google::protobuf::Message::New(arena));
+}
+
 void UninterpretedOption_NamePart::Clear() {
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
     if (has_name_part()) {
@@ -6939,6 +7687,28 @@ void UninterpretedOption_NamePart::SerializeWithCachedSizes(
   return target;
 }
 
+void UninterpretedOption_NamePart::SerializeReverse(
+    ::google::protobuf::io::ReverseCodedOutputStream* output) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsReverse(
+        unknown_fields(), output);
+  }
+
+  // required bool is_extension = 2;
+  if (has_is_extension()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBoolReverse(2, this->is_extension(), output);
+  }
+
+  // required string name_part = 1;
+  if (has_name_part()) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8String(
+      this->name_part().data(), this->name_part().length(),
+      ::google::protobuf::internal::WireFormat::SERIALIZE);
+    ::google::protobuf::internal::WireFormatLite::WriteStringReverse(
+      1, this->name_part(), output);
+  }
+}
+
 int UninterpretedOption_NamePart::ByteSize() const {
   int total_size = 0;
 
@@ -7105,6 +7875,11 @@ UninterpretedOption* UninterpretedOption::New() const {
   return new UninterpretedOption;
 }
 
+UninterpretedOption* UninterpretedOption::New(::google::protobuf::Arena* arena) const {
+  return static_cast< UninterpretedOption*>(
+      ::google::protobuf::Message::New(arena));
+}
+
 void UninterpretedOption::Clear() {
   if (_has_bits_[1 / 32] & (0xffu << (1 % 32))) {
     if (has_identifier_value()) {
@@ -7375,6 +8150,60 @@ void UninterpretedOption::SerializeWithCachedSizes(
   return target;
 }
 
+void UninterpretedOption::SerializeReverse(
+    ::google::protobuf::io::ReverseCodedOutputStream* output) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsReverse(
+        unknown_fields(), output);
+  }
+
+  // optional string aggregate_value = 8;
+  if (has_aggregate_value()) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8String(
+      this->aggregate_value().data(), this->aggregate_value().length(),
+      ::google::protobuf::internal::WireFormat::SERIALIZE);
+    ::google::protobuf::internal::WireFormatLite::WriteStringReverse(
+      8, this->aggregate_value(), output);
+  }
+
+  // optional bytes string_value = 7;
+  if (has_string_value()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBytesReverse(
+      7, this->string_value(), output);
+  }
+
+  // optional double double_value = 6;
+  if (has_double_value()) {
+    ::google::protobuf::internal::WireFormatLite::WriteDoubleReverse(6, this->double_value(), output);
+  }
+
+  // optional int64 negative_int_value = 5;
+  if (has_negative_int_value()) {
+    ::google::protobuf::internal::WireFormatLite::WriteInt64Reverse(5, this->negative_int_value(), output);
+  }
+
+  // optional uint64 positive_int_value = 4;
+  if (has_positive_int_value()) {
+    ::google::protobuf::internal::WireFormatLite::WriteUInt64Reverse(4, this->positive_int_value(), output);
+  }
+
+  // optional string identifier_value = 3;
+  if (has_identifier_value()) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8String(
+      this->identifier_value().data(), this->identifier_value().length(),
+      ::google::protobuf::internal::WireFormat::SERIALIZE);
+    ::google::protobuf::internal::WireFormatLite::WriteStringReverse(
+      3, this->identifier_value(), output);
+  }
+
+  // repeated .google.protobuf.UninterpretedOption.NamePart name = 2;
+  for (int i = this->name_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualReverse(
+        2, this->name(i), output);
+  }
+}
+
 int UninterpretedOption::ByteSize() const {
   int total_size = 0;
 
@@ -7587,6 +8416,11 @@ SourceCodeInfo_Location* SourceCodeInfo_Location::New() const {
   return new SourceCodeInfo_Location;
 }
 
+SourceCodeInfo_Location* SourceCodeInfo_Location::New(::google::protobuf::Arena* arena) const {
+  return static_cast< SourceCodeInfo_Location*>(
+      ::google::protobuf::Message::New(arena));
+}
+
 void SourceCodeInfo_Location::Clear() {
   if (_has_bits_[2 / 32] & (0xffu << (2 % 32))) {
     if (has_leading_comments()) {
@@ -7806,6 +8640,60 @@ void SourceCodeInfo_Location::SerializeWithCachedSizes(
   return target;
 }
 
+void SourceCodeInfo_Location::SerializeReverse(
+    ::google::protobuf::io::ReverseCodedOutputStream* output) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsReverse(
+        unknown_fields(), output);
+  }
+
+  // optional string trailing_comments = 4;
+  if (has_trailing_comments()) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8String(
+      this->trailing_comments().data(), this->trailing_comments().length(),
+      ::google::protobuf::internal::WireFormat::SERIALIZE);
+    ::google::protobuf::internal::WireFormatLite::WriteStringReverse(
+      4, this->trailing_comments(), output);
+  }
+
+  // optional string leading_comments = 3;
+  if (has_leading_comments()) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8String(
+      this->leading_comments().data(), this->leading_comments().length(),
+      ::google::protobuf::internal::WireFormat::SERIALIZE);
+    ::google::protobuf::internal::WireFormatLite::WriteStringReverse(
+      3, this->leading_comments(), output);
+  }
+
+  // repeated int32 span = 2 [packed = true];
+  if (this->span_size() > 0) {
+    int end = output->ByteCount();
+    for (int i = this->span_size() - 1; i >= 0; i--) {
+      ::google::protobuf::internal::WireFormatLite::
+        WriteInt32NoTagReverse(this->span(i), output);
+    }
+    output->WriteVarint32(output->ByteCount() - end);
+    ::google::protobuf::internal::WireFormatLite::WriteTagReverse(
+      2,
+      ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED,
+      output);
+  }
+
+  // repeated int32 path = 1 [packed = true];
+  if (this->path_size() > 0) {
+    int end = output->ByteCount();
+    for (int i = this->path_size() - 1; i >= 0; i--) {
+      ::google::protobuf::internal::WireFormatLite::
+        WriteInt32NoTagReverse(this->path(i), output);
+    }
+    output->WriteVarint32(output->ByteCount() - end);
+    ::google::protobuf::internal::WireFormatLite::WriteTagReverse(
+      1,
+      ::google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED,
+      output);
+  }
+}
+
 int SourceCodeInfo_Location::ByteSize() const {
   int total_size = 0;
 
@@ -7990,6 +8878,11 @@ SourceCodeInfo* SourceCodeInfo::New() const {
   return new SourceCodeInfo;
 }
 
+SourceCodeInfo* SourceCodeInfo::New(::google::protobuf::Arena* arena) const {
+  return static_cast< SourceCodeInfo*>(
+      ::google::protobuf::Message::New(arena));
+}
+
 void SourceCodeInfo::Clear() {
   location_.Clear();
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
@@ -8063,6 +8956,21 @@ void SourceCodeInfo::SerializeWithCachedSizes(
   return target;
 }
 
+void SourceCodeInfo::SerializeReverse(
+    ::google::protobuf::io::ReverseCodedOutputStream* output) const {
+  if (!unknown_fields().empty()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsReverse(
+        unknown_fields(), output);
+  }
+
+  // repeated .google.protobuf.SourceCodeInfo.Location location = 1;
+  for (int i = this->location_size() - 1; i >= 0; i--) {
+    ::google::protobuf::internal::WireFormatLite::
+      WriteMessageNoVirtualReverse(
+        1, this->location(i), output);
+  }
+}
+
 int SourceCodeInfo::ByteSize() const {
   int total_size = 0;
 
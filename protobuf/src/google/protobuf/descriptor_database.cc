@@ -211,6 +211,15 @@ bool SimpleDescriptorDatabase::DescriptorIndex<Value>::FindAllExtensionNumbers(
   return success;
 }
 
+template <typename Value>
+void SimpleDescriptorDatabase::DescriptorIndex<Value>::FindAllFileNames(
+    vector<string>* output) {
+  for (typename map<string, Value>::const_iterator it = by_name_.begin();
+       it != by_name_.end(); ++it) {
+    output->push_back(it->first);
+  }
+}
+
 template <typename Value>
 typename map<string, Value>::iterator
 SimpleDescriptorDatabase::DescriptorIndex<Value>::FindLastLessOrEqual(
@@ -289,6 +298,11 @@ bool SimpleDescriptorDatabase::FindAllExtensionNumbers(
   return index_.FindAllExtensionNumbers(extendee_type, output);
 }
 
+bool SimpleDescriptorDatabase::FindAllFileNames(vector<string>* output) {
+  index_.FindAllFileNames(output);
+  return true;
+}
+
 bool SimpleDescriptorDatabase::MaybeCopy(const FileDescriptorProto* file,
                                          FileDescriptorProto* output) {
   if (file == NULL) return false;
@@ -380,6 +394,11 @@ bool EncodedDescriptorDatabase::FindAllExtensionNumbers(
   return index_.FindAllExtensionNumbers(extendee_type, output);
 }
 
+bool EncodedDescriptorDatabase::FindAllFileNames(vector<string>* output) {
+  index_.FindAllFileNames(output);
+  return true;
+}
+
 bool EncodedDescriptorDatabase::MaybeParse(
     pair<const void*, int> encoded_file,
     FileDescriptorProto* output) {
@@ -537,5 +556,19 @@ bool MergedDescriptorDatabase::FindAllExtensionNumbers(
   return success;
 }
 
+bool MergedDescriptorDatabase::FindAllFileNames(vector<string>* output) {
+  set<string> merged_results;
+  vector<string> results;
+
+  for (int i = 0; i < sources_.size(); i++) {
+    if (!sources_[i]->FindAllFileNames(&results)) return false;
+    merged_results.insert(results.begin(), results.end());
+    results.clear();
+  }
+
+  output->insert(output->end(), merged_results.begin(), merged_results.end());
+  return true;
+}
+
 }  // namespace protobuf
 }  // namespace google
@@ -101,6 +101,16 @@ class LIBPROTOBUF_EXPORT DescriptorDatabase {
     return false;
   }
 
+  // Appends the names of all files in the database to output, in an
+  // undefined order.  Returns true if the database was able to enumerate
+  // its files, otherwise returns false and leaves output unchanged.
+  //
+  // This method has a default implementation that always returns
+  // false.
+  virtual bool FindAllFileNames(vector<string>* output) {
+    return false;
+  }
+
  private:
   GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(DescriptorDatabase);
 };
@@ -150,6 +160,7 @@ class LIBPROTOBUF_EXPORT SimpleDescriptorDatabase : public DescriptorDatabase {
                                    FileDescriptorProto* output);
   bool FindAllExtensionNumbers(const string& extendee_type,
                                vector<int>* output);
+  bool FindAllFileNames(vector<string>* output);
 
  private:
   // So that it can use DescriptorIndex.
@@ -175,6 +186,7 @@ class LIBPROTOBUF_EXPORT SimpleDescriptorDatabase : public DescriptorDatabase {
     Value FindExtension(const string& containing_type, int field_number);
     bool FindAllExtensionNumbers(const string& containing_type,
                                  vector<int>* output);
+    void FindAllFileNames(vector<string>* output);
 
    private:
     map<string, Value> by_name_;
@@ -295,6 +307,7 @@ class LIBPROTOBUF_EXPORT EncodedDescriptorDatabase : public DescriptorDatabase {
                                    FileDescriptorProto* output);
   bool FindAllExtensionNumbers(const string& extendee_type,
                                vector<int>* output);
+  bool FindAllFileNames(vector<string>* output);
 
  private:
   SimpleDescriptorDatabase::DescriptorIndex<pair<const void*, int> > index_;
@@ -355,6 +368,9 @@ class LIBPROTOBUF_EXPORT MergedDescriptorDatabase : public DescriptorDatabase {
   // of the databases returned true.
   bool FindAllExtensionNumbers(const string& extendee_type,
                                vector<int>* output);
+  // Merges the results of calling all databases.  Returns true iff all
+  // of the databases returned true.
+  bool FindAllFileNames(vector<string>* output);
 
  private:
   vector<DescriptorDatabase*> sources_;
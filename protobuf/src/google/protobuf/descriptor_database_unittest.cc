@@ -434,6 +434,18 @@ TEST_P(DescriptorDatabaseTest, FindAllExtensionNumbers) {
   }
 }
 
+TEST_P(DescriptorDatabaseTest, FindAllFileNames) {
+  AddToDatabase("name: \"foo.proto\" message_type { name:\"Foo\" }");
+  AddToDatabase("name: \"bar.proto\" message_type { name:\"Bar\" }");
+
+  vector<string> names;
+  EXPECT_TRUE(database_->FindAllFileNames(&names));
+  ASSERT_EQ(2, names.size());
+  sort(names.begin(), names.end());
+  EXPECT_EQ("bar.proto", names[0]);
+  EXPECT_EQ("foo.proto", names[1]);
+}
+
 TEST_P(DescriptorDatabaseTest, ConflictingFileError) {
   AddToDatabase(
     "name: \"foo.proto\" "
@@ -743,6 +755,17 @@ TEST_F(MergedDescriptorDatabaseTest, FindAllExtensionNumbers) {
   }
 }
 
+TEST_F(MergedDescriptorDatabaseTest, FindAllFileNames) {
+  // baz.proto is in both databases but only listed once.
+  vector<string> names;
+  EXPECT_TRUE(forward_merged_.FindAllFileNames(&names));
+  ASSERT_EQ(3, names.size());
+  sort(names.begin(), names.end());
+  EXPECT_EQ("bar.proto", names[0]);
+  EXPECT_EQ("baz.proto", names[1]);
+  EXPECT_EQ("foo.proto", names[2]);
+}
+
 }  // anonymous namespace
 }  // namespace protobuf
 }  // namespace google
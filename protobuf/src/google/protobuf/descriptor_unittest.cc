@@ -539,6 +539,37 @@ TEST_F(DescriptorTest, FindFieldByNumber) {
   EXPECT_EQ(quux2_, message2_->FindFieldByNumber(6));
   EXPECT_TRUE(message2_->FindFieldByNumber(15) == NULL);
   EXPECT_TRUE(message2_->FindFieldByNumber(500000000) == NULL);
+
+  EXPECT_TRUE(message_->FindFieldByNumber(0) == NULL);
+  EXPECT_TRUE(message_->FindFieldByNumber(-1) == NULL);
+}
+
+TEST_F(DescriptorTest, FindFieldByNumberSparse) {
+  // Fields 1 to 5 are looked up in a table indexed by number, the rest
+  // by binary search.
+  FileDescriptorProto file_proto;
+  file_proto.set_name("sparse.proto");
+  DescriptorProto* message_proto = AddMessage(&file_proto, "Sparse");
+  for (int i = 10; i > 0; i--) {
+    int number = i <= 5 ? i : i * 1000;
+    AddField(message_proto, "field" + SimpleItoa(number), number,
+             FieldDescriptorProto::LABEL_OPTIONAL,
+             FieldDescriptorProto::TYPE_INT32);
+  }
+
+  DescriptorPool pool;
+  const FileDescriptor* file = pool.BuildFile(file_proto);
+  ASSERT_TRUE(file != NULL);
+  const Descriptor* message = file->message_type(0);
+
+  for (int i = 0; i < message->field_count(); i++) {
+    const FieldDescriptor* field = message->field(i);
+    EXPECT_EQ(field, message->FindFieldByNumber(field->number()));
+  }
+  EXPECT_TRUE(message->FindFieldByNumber(6) == NULL);
+  EXPECT_TRUE(message->FindFieldByNumber(5999) == NULL);
+  EXPECT_TRUE(message->FindFieldByNumber(6001) == NULL);
+  EXPECT_TRUE(message->FindFieldByNumber(100000) == NULL);
 }
 
 TEST_F(DescriptorTest, FieldName) {
@@ -4435,6 +4466,58 @@ TEST_F(DatabaseBackedPoolTest, DoesntFallbackOnWrongType) {
   EXPECT_EQ(0, call_counter.call_count_);
 }
 
+TEST_F(DatabaseBackedPoolTest, SealLoadsAllFiles) {
+  MockErrorCollector error_collector;
+  DescriptorPool pool(&database_, &error_collector);
+  pool.Seal();
+  EXPECT_TRUE(pool.sealed());
+
+  EXPECT_TRUE(pool.InternalIsFileLoaded("foo.proto"));
+  EXPECT_TRUE(pool.InternalIsFileLoaded("bar.proto"));
+
+  // baz.proto has an undeclared dependency, so it fails to build.
+  EXPECT_FALSE(pool.InternalIsFileLoaded("baz.proto"));
+  EXPECT_NE("", error_collector.text_);
+  EXPECT_TRUE(pool.FindMessageTypeByName("Baz") == NULL);
+
+  const Descriptor* foo = pool.FindMessageTypeByName("Foo");
+  ASSERT_TRUE(foo != NULL);
+  EXPECT_TRUE(pool.FindMessageTypeByName("Bar") != NULL);
+  EXPECT_TRUE(pool.FindExtensionByNumber(foo, 5) != NULL);
+
+  vector<const FieldDescriptor*> extensions;
+  pool.FindAllExtensions(foo, &extensions);
+  ASSERT_EQ(1, extensions.size());
+  EXPECT_EQ("foo_ext", extensions[0]->name());
+}
+
+TEST_F(DatabaseBackedPoolTest, SealedPoolDoesntUseDb) {
+  // CallCountingDatabase can't enumerate its files, so sealing the pool
+  // freezes it with only what has been looked up so far.
+  CallCountingDatabase call_counter(&database_);
+  DescriptorPool pool(&call_counter);
+
+  ASSERT_TRUE(pool.FindFileByName("bar.proto") != NULL);
+  pool.Seal();
+  call_counter.Clear();
+
+  const Descriptor* foo = pool.FindMessageTypeByName("Foo");
+  ASSERT_TRUE(foo != NULL);
+  EXPECT_TRUE(pool.FindMessageTypeByName("Bar") != NULL);
+  EXPECT_TRUE(pool.FindExtensionByNumber(foo, 5) != NULL);
+
+  EXPECT_TRUE(pool.FindFileByName("baz.proto") == NULL);
+  EXPECT_TRUE(pool.FindMessageTypeByName("Baz") == NULL);
+  EXPECT_TRUE(pool.FindFileContainingSymbol("Baz") == NULL);
+  EXPECT_TRUE(pool.FindExtensionByNumber(foo, 6) == NULL);
+
+  vector<const FieldDescriptor*> extensions;
+  pool.FindAllExtensions(foo, &extensions);
+  EXPECT_EQ(1, extensions.size());
+
+  EXPECT_EQ(0, call_counter.call_count_);
+}
+
 // ===================================================================
 
 class AbortingErrorCollector : public DescriptorPool::ErrorCollector {
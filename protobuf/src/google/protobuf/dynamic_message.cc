@@ -63,19 +63,26 @@
 // I don't have the book on me right now so I'm not sure.
 
 #include <algorithm>
+#include <set>
+#include <vector>
 #include <google/protobuf/stubs/hash.h>
 
 #include <google/protobuf/stubs/common.h>
+#include <google/protobuf/stubs/atomicops.h>
 
 #include <google/protobuf/dynamic_message.h>
+#include <google/protobuf/arena.h>
 #include <google/protobuf/descriptor.h>
 #include <google/protobuf/descriptor.pb.h>
 #include <google/protobuf/generated_message_util.h>
 #include <google/protobuf/generated_message_reflection.h>
+#include <google/protobuf/lazy_field.h>
 #include <google/protobuf/reflection_ops.h>
+#include <google/protobuf/string_piece_field.h>
 #include <google/protobuf/repeated_field.h>
 #include <google/protobuf/extension_set.h>
 #include <google/protobuf/wire_format.h>
+#include <google/protobuf/stubs/stl_util.h>
 
 namespace google {
 namespace protobuf {
@@ -83,6 +90,10 @@ namespace protobuf {
 using internal::WireFormat;
 using internal::ExtensionSet;
 using internal::GeneratedMessageReflection;
+using internal::IsLazyField;
+using internal::LazyField;
+using internal::IsStringPieceField;
+using internal::StringPieceField;
 
 
 // ===================================================================
@@ -125,9 +136,10 @@ int FieldSpaceUsed(const FieldDescriptor* field) {
       case FD::CPPTYPE_ENUM   : return sizeof(int     );
 
       case FD::CPPTYPE_MESSAGE:
-        return sizeof(Message*);
+        return IsLazyField(field) ? sizeof(LazyField) : sizeof(Message*);
 
       case FD::CPPTYPE_STRING:
+        if (IsStringPieceField(field)) return sizeof(StringPieceField);
         switch (field->options().ctype()) {
           default:  // TODO(kenton):  Support other string reps.
           case FieldOptions::STRING:
@@ -159,6 +171,47 @@ inline int AlignOffset(int offset) {
 
 #define bitsizeof(T) (sizeof(T) * 8)
 
+// Fields are laid out in groups, in this order, rather than in declaration
+// order.  See GetPrototypeNoLock().
+enum FieldGroup {
+  GROUP_SCALAR_64,   // singular int64, uint64, double
+  GROUP_SCALAR_32,   // singular int32, uint32, float, enum
+  GROUP_SCALAR_8,    // singular bool
+  GROUP_POINTER,     // singular string and message
+  GROUP_REPEATED,
+};
+
+FieldGroup GetFieldGroup(const FieldDescriptor* field) {
+  if (field->is_repeated()) return GROUP_REPEATED;
+  switch (field->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_STRING:
+    case FieldDescriptor::CPPTYPE_MESSAGE:
+      return GROUP_POINTER;
+    default:
+      switch (FieldSpaceUsed(field)) {
+        case 8: return GROUP_SCALAR_64;
+        case 4: return GROUP_SCALAR_32;
+        default: return GROUP_SCALAR_8;
+      }
+  }
+}
+
+// Places the fields of `group` at `offset` onwards, in declaration order,
+// and returns the offset past the last of them.
+int LayoutFieldGroup(const Descriptor* type, FieldGroup group,
+                     int* offsets, int offset) {
+  for (int i = 0; i < type->field_count(); i++) {
+    const FieldDescriptor* field = type->field(i);
+    if (GetFieldGroup(field) != group) continue;
+    // Make sure field is aligned to avoid bus errors.
+    int field_size = FieldSpaceUsed(field);
+    offset = AlignTo(offset, min(kSafeAlignment, field_size));
+    offsets[i] = offset;
+    offset += field_size;
+  }
+  return offset;
+}
+
 }  // namespace
 
 // ===================================================================
@@ -167,6 +220,7 @@ class DynamicMessage : public Message {
  public:
   struct TypeInfo {
     int size;
+    int arena_offset;
     int has_bits_offset;
     int unknown_fields_offset;
     int extensions_offset;
@@ -193,7 +247,9 @@ class DynamicMessage : public Message {
     }
   };
 
-  DynamicMessage(const TypeInfo* type_info);
+  // Sub-messages, strings and repeated fields of a message constructed
+  // with an arena are allocated in that arena.
+  DynamicMessage(const TypeInfo* type_info, Arena* arena);
   ~DynamicMessage();
 
   // Called on the prototype after construction to initialize message fields.
@@ -202,6 +258,8 @@ class DynamicMessage : public Message {
   // implements Message ----------------------------------------------
 
   Message* New() const;
+  Message* New(Arena* arena) const;
+  Arena* GetArena() const { return arena(); }
 
   int GetCachedSize() const;
   void SetCachedSize(int size) const;
@@ -225,13 +283,18 @@ class DynamicMessage : public Message {
     return reinterpret_cast<const uint8*>(this) + offset;
   }
 
+  inline Arena* arena() const {
+    return *reinterpret_cast<Arena* const*>(
+      OffsetToPointer(type_info_->arena_offset));
+  }
+
   const TypeInfo* type_info_;
 
   // TODO(kenton):  Make this an atomic<int> when C++ supports it.
   mutable int cached_byte_size_;
 };
 
-DynamicMessage::DynamicMessage(const TypeInfo* type_info)
+DynamicMessage::DynamicMessage(const TypeInfo* type_info, Arena* arena)
   : type_info_(type_info),
     cached_byte_size_(0) {
   // We need to call constructors for various fields manually and set
@@ -245,7 +308,9 @@ DynamicMessage::DynamicMessage(const TypeInfo* type_info)
 
   const Descriptor* descriptor = type_info_->type;
 
-  new(OffsetToPointer(type_info_->unknown_fields_offset)) UnknownFieldSet;
+  new(OffsetToPointer(type_info_->arena_offset)) Arena*(arena);
+
+  new(OffsetToPointer(type_info_->unknown_fields_offset)) UnknownFieldSet(arena);
 
   if (type_info_->extensions_offset != -1) {
     new(OffsetToPointer(type_info_->extensions_offset)) ExtensionSet;
@@ -282,6 +347,14 @@ DynamicMessage::DynamicMessage(const TypeInfo* type_info)
         break;
 
       case FieldDescriptor::CPPTYPE_STRING:
+        if (IsStringPieceField(field)) {
+          // The default value lives as long as the descriptor.
+          const string& default_value = field->default_value_string();
+          new(field_ptr) StringPieceField;
+          reinterpret_cast<StringPieceField*>(field_ptr)->SetAliased(
+              default_value.data(), default_value.size());
+          break;
+        }
         switch (field->options().ctype()) {
           default:  // TODO(kenton):  Support other string reps.
           case FieldOptions::STRING:
@@ -296,17 +369,19 @@ DynamicMessage::DynamicMessage(const TypeInfo* type_info)
                 new(field_ptr) string*(default_value);
               }
             } else {
-              new(field_ptr) RepeatedPtrField<string>();
+              new(field_ptr) RepeatedPtrField<string>(arena);
             }
             break;
         }
         break;
 
       case FieldDescriptor::CPPTYPE_MESSAGE: {
-        if (!field->is_repeated()) {
+        if (IsLazyField(field)) {
+          new(field_ptr) LazyField;
+        } else if (!field->is_repeated()) {
           new(field_ptr) Message*(NULL);
         } else {
-          new(field_ptr) RepeatedPtrField<Message>();
+          new(field_ptr) RepeatedPtrField<Message>(arena);
         }
         break;
       }
@@ -330,7 +405,9 @@ DynamicMessage::~DynamicMessage() {
   // Additionally, if any singular embedded messages have been allocated, we
   // need to delete them, UNLESS we are the prototype message of this type,
   // in which case any embedded messages are other prototypes and shouldn't
-  // be touched.
+  // be touched.  Strings and embedded messages of an arena message belong
+  // to the arena, which destroys them itself.
+  bool owns_objects = arena() == NULL;
   for (int i = 0; i < descriptor->field_count(); i++) {
     const FieldDescriptor* field = descriptor->field(i);
     void* field_ptr = OffsetToPointer(type_info_->offsets[i]);
@@ -369,22 +446,30 @@ DynamicMessage::~DynamicMessage() {
           break;
       }
 
+    } else if (IsStringPieceField(field)) {
+      if (owns_objects) {
+        reinterpret_cast<StringPieceField*>(field_ptr)->Destroy();
+      }
     } else if (field->cpp_type() == FieldDescriptor::CPPTYPE_STRING) {
       switch (field->options().ctype()) {
         default:  // TODO(kenton):  Support other string reps.
         case FieldOptions::STRING: {
           string* ptr = *reinterpret_cast<string**>(field_ptr);
-          if (ptr != &field->default_value_string()) {
+          if (owns_objects && ptr != &field->default_value_string()) {
             delete ptr;
           }
           break;
         }
       }
     } else if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
-      if (!is_prototype()) {
-        Message* message = *reinterpret_cast<Message**>(field_ptr);
-        if (message != NULL) {
-          delete message;
+      if (owns_objects && !is_prototype()) {
+        if (IsLazyField(field)) {
+          reinterpret_cast<LazyField*>(field_ptr)->Destroy();
+        } else {
+          Message* message = *reinterpret_cast<Message**>(field_ptr);
+          if (message != NULL) {
+            delete message;
+          }
         }
       }
     }
@@ -409,8 +494,14 @@ void DynamicMessage::CrossLinkPrototypes() {
       // prototype for the field's type.
       // For singular fields, the field is just a pointer which should
       // point to the prototype.
-      *reinterpret_cast<const Message**>(field_ptr) =
+      const Message* prototype =
         factory->GetPrototypeNoLock(field->message_type());
+      if (IsLazyField(field)) {
+        reinterpret_cast<LazyField*>(field_ptr)
+            ->InitAsDefaultInstance(prototype);
+      } else {
+        *reinterpret_cast<const Message**>(field_ptr) = prototype;
+      }
     }
   }
 }
@@ -418,7 +509,18 @@ void DynamicMessage::CrossLinkPrototypes() {
 Message* DynamicMessage::New() const {
   void* new_base = operator new(type_info_->size);
   memset(new_base, 0, type_info_->size);
-  return new(new_base) DynamicMessage(type_info_);
+  return new(new_base) DynamicMessage(type_info_, NULL);
+}
+
+Message* DynamicMessage::New(Arena* arena) const {
+  if (arena == NULL) return New();
+  void* new_base = arena->AllocateAligned(type_info_->size);
+  memset(new_base, 0, type_info_->size);
+  DynamicMessage* message = new(new_base) DynamicMessage(type_info_, arena);
+  // Repeated scalar arrays, extensions and unknown fields are still on the
+  // heap; the destructor frees them.
+  arena->AddCleanup(message, &internal::arena_destruct_object<DynamicMessage>);
+  return message;
 }
 
 int DynamicMessage::GetCachedSize() const {
@@ -441,9 +543,118 @@ Metadata DynamicMessage::GetMetadata() const {
 
 // ===================================================================
 
+namespace {
+
+#ifdef GOOGLE_PROTOBUF_NO_THREAD_SAFETY
+typedef intptr_t PublishedWord;
+
+inline intptr_t AcquireLoad(volatile const intptr_t* ptr) { return *ptr; }
+inline void ReleaseStore(volatile intptr_t* ptr, intptr_t value) {
+  *ptr = value;
+}
+#else
+typedef internal::AtomicWord PublishedWord;
+
+inline intptr_t AcquireLoad(volatile const PublishedWord* ptr) {
+  return internal::Acquire_Load(ptr);
+}
+inline void ReleaseStore(volatile PublishedWord* ptr, intptr_t value) {
+  internal::Release_Store(ptr, value);
+}
+#endif
+
+// Built prototypes by Descriptor, readable without a lock while one writer
+// at a time inserts: an open-addressing table whose entries are written
+// before their key is published.  It never grows in place; a full table is
+// copied into a larger one, which is then published instead.
+class PublishedPrototypes {
+ public:
+  explicit PublishedPrototypes(int capacity)
+    : mask_(capacity - 1), size_(0), entries_(new Entry[capacity]) {
+    for (int i = 0; i < capacity; i++) {
+      entries_[i].key = 0;
+      entries_[i].prototype = NULL;
+    }
+  }
+
+  ~PublishedPrototypes() {
+    delete [] entries_;
+  }
+
+  int capacity() const { return mask_ + 1; }
+
+  // Whether another entry still keeps the table at most half full.
+  bool HasRoom() const { return (size_ + 1) * 2 <= capacity(); }
+
+  const Message* Find(const Descriptor* type) const {
+    intptr_t key = reinterpret_cast<intptr_t>(type);
+    for (int i = Hash(type) & mask_; ; i = (i + 1) & mask_) {
+      intptr_t entry_key = AcquireLoad(&entries_[i].key);
+      if (entry_key == key) return entries_[i].prototype;
+      if (entry_key == 0) return NULL;
+    }
+  }
+
+  // Requires HasRoom().
+  void Insert(const Descriptor* type, const Message* prototype) {
+    int i = Hash(type) & mask_;
+    while (entries_[i].key != 0) i = (i + 1) & mask_;
+    entries_[i].prototype = prototype;
+    ReleaseStore(&entries_[i].key, reinterpret_cast<intptr_t>(type));
+    size_++;
+  }
+
+  void CopyTo(PublishedPrototypes* other) const {
+    for (int i = 0; i < capacity(); i++) {
+      if (entries_[i].key != 0) {
+        other->Insert(reinterpret_cast<const Descriptor*>(entries_[i].key),
+                      entries_[i].prototype);
+      }
+    }
+  }
+
+ private:
+  struct Entry {
+    PublishedWord key;
+    const Message* prototype;
+  };
+
+  int mask_;
+  int size_;
+  Entry* entries_;
+
+  static int Hash(const Descriptor* type) {
+    uint64 bits = reinterpret_cast<uintptr_t>(type);
+    return static_cast<int>((bits * GOOGLE_ULONGLONG(0x9E3779B97F4A7C15)) >> 33);
+  }
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(PublishedPrototypes);
+};
+
+}  // namespace
+
 struct DynamicMessageFactory::PrototypeMap {
   typedef hash_map<const Descriptor*, const DynamicMessage::TypeInfo*> Map;
   Map map_;
+
+  // Prototypes taken from the generated factory when delegating to it.
+  hash_map<const Descriptor*, const Message*> generated_;
+
+  // Prototypes built or taken since the last PublishPrototypes().
+  vector<pair<const Descriptor*, const Message*> > unpublished_;
+
+  // The current table, and the ones it replaced, which readers may still
+  // be using and so live as long as the factory.  Each is twice the size
+  // of the last, so together they are at most twice the current one.
+  PublishedWord published_;
+  vector<const PublishedPrototypes*> retired_;
+
+  PrototypeMap() : published_(0) {}
+
+  const PublishedPrototypes* published() const {
+    return reinterpret_cast<const PublishedPrototypes*>(
+        AcquireLoad(&published_));
+  }
 };
 
 DynamicMessageFactory::DynamicMessageFactory()
@@ -461,18 +672,92 @@ DynamicMessageFactory::~DynamicMessageFactory() {
        iter != prototypes_->map_.end(); ++iter) {
     delete iter->second;
   }
+  delete prototypes_->published();
+  STLDeleteElements(&prototypes_->retired_);
 }
 
 const Message* DynamicMessageFactory::GetPrototype(const Descriptor* type) {
+  // Prototypes never change once built, so published ones are looked up
+  // without the lock.
+  const PublishedPrototypes* published = prototypes_->published();
+  if (published != NULL) {
+    const Message* result = published->Find(type);
+    if (result != NULL) return result;
+  }
+
+  MutexLock lock(&prototypes_mutex_);
+  const Message* result = GetPrototypeNoLock(type);
+  PublishPrototypes();
+  return result;
+}
+
+void DynamicMessageFactory::PrebuildPrototypes(const FileDescriptor* file) {
   MutexLock lock(&prototypes_mutex_);
-  return GetPrototypeNoLock(type);
+  set<const FileDescriptor*> visited;
+  PrebuildPrototypesNoLock(file, &visited);
+  PublishPrototypes();
+}
+
+void DynamicMessageFactory::PrebuildPrototypesNoLock(
+    const FileDescriptor* file, set<const FileDescriptor*>* visited) {
+  if (!visited->insert(file).second) return;
+  for (int i = 0; i < file->dependency_count(); i++) {
+    PrebuildPrototypesNoLock(file->dependency(i), visited);
+  }
+  for (int i = 0; i < file->message_type_count(); i++) {
+    PrebuildPrototypesNoLock(file->message_type(i));
+  }
+}
+
+void DynamicMessageFactory::PrebuildPrototypesNoLock(const Descriptor* type) {
+  GetPrototypeNoLock(type);
+  for (int i = 0; i < type->nested_type_count(); i++) {
+    PrebuildPrototypesNoLock(type->nested_type(i));
+  }
+}
+
+// Called once the types being built are complete, as their prototypes
+// must be before anyone else can see them.
+void DynamicMessageFactory::PublishPrototypes() {
+  vector<pair<const Descriptor*, const Message*> >* unpublished =
+    &prototypes_->unpublished_;
+  if (unpublished->empty()) return;
+
+  const PublishedPrototypes* published = prototypes_->published();
+  PublishedPrototypes* table = const_cast<PublishedPrototypes*>(published);
+
+  int needed = prototypes_->map_.size() + prototypes_->generated_.size();
+  if (table == NULL || table->capacity() < needed * 2) {
+    int capacity = 16;
+    while (capacity < needed * 2) capacity *= 2;
+    table = new PublishedPrototypes(capacity);
+    if (published != NULL) published->CopyTo(table);
+  }
+
+  for (int i = 0; i < unpublished->size(); i++) {
+    table->Insert((*unpublished)[i].first, (*unpublished)[i].second);
+  }
+  unpublished->clear();
+
+  if (table != published) {
+    ReleaseStore(&prototypes_->published_, reinterpret_cast<intptr_t>(table));
+    if (published != NULL) prototypes_->retired_.push_back(published);
+  }
 }
 
 const Message* DynamicMessageFactory::GetPrototypeNoLock(
     const Descriptor* type) {
   if (delegate_to_generated_factory_ &&
       type->file()->pool() == DescriptorPool::generated_pool()) {
-    return MessageFactory::generated_factory()->GetPrototype(type);
+    // Published like built prototypes, so that later lookups take no lock.
+    const Message** generated = &prototypes_->generated_[type];
+    if (*generated == NULL) {
+      *generated = MessageFactory::generated_factory()->GetPrototype(type);
+      if (*generated != NULL) {
+        prototypes_->unpublished_.push_back(make_pair(type, *generated));
+      }
+    }
+    return *generated;
   }
 
   const DynamicMessage::TypeInfo** target = &prototypes_->map_[type];
@@ -500,17 +785,37 @@ const Message* DynamicMessageFactory::GetPrototypeNoLock(
   int* offsets = new int[type->field_count()];
   type_info->offsets.reset(offsets);
 
-  // Decide all field offsets by packing in order.
+  // Decide all field offsets.  Fields are grouped by kind so that each
+  // group is no more aligned than the one before it, which leaves no padding
+  // between fields, and the singular scalars share cache lines with the
+  // has_bits that are checked on every access to them.  The containers,
+  // which are touched less often and are mostly pointers to elsewhere
+  // anyway, come last.
+  //
   // We place the DynamicMessage object itself at the beginning of the allocated
   // space.
   int size = sizeof(DynamicMessage);
   size = AlignOffset(size);
 
-  // Next the has_bits, which is an array of uint32s.
+  // The arena the message was created in, if any.
+  type_info->arena_offset = size;
+  size += sizeof(Arena*);
+  size = AlignOffset(size);
+
+  size = LayoutFieldGroup(type, GROUP_SCALAR_64, offsets, size);
+
+  // Next the has_bits, which is an array of uint32s, followed by the
+  // smaller scalars.
   type_info->has_bits_offset = size;
   int has_bits_array_size =
     DivideRoundingUp(type->field_count(), bitsizeof(uint32));
   size += has_bits_array_size * sizeof(uint32);
+
+  size = LayoutFieldGroup(type, GROUP_SCALAR_32, offsets, size);
+  size = LayoutFieldGroup(type, GROUP_SCALAR_8, offsets, size);
+  size = AlignOffset(size);
+  size = LayoutFieldGroup(type, GROUP_POINTER, offsets, size);
+  size = LayoutFieldGroup(type, GROUP_REPEATED, offsets, size);
   size = AlignOffset(size);
 
   // The ExtensionSet, if any.
@@ -523,15 +828,6 @@ const Message* DynamicMessageFactory::GetPrototypeNoLock(
     type_info->extensions_offset = -1;
   }
 
-  // All the fields.
-  for (int i = 0; i < type->field_count(); i++) {
-    // Make sure field is aligned to avoid bus errors.
-    int field_size = FieldSpaceUsed(type->field(i));
-    size = AlignTo(size, min(kSafeAlignment, field_size));
-    offsets[i] = size;
-    size += field_size;
-  }
-
   // Add the UnknownFieldSet to the end.
   size = AlignOffset(size);
   type_info->unknown_fields_offset = size;
@@ -545,8 +841,9 @@ const Message* DynamicMessageFactory::GetPrototypeNoLock(
   // Allocate the prototype.
   void* base = operator new(size);
   memset(base, 0, size);
-  DynamicMessage* prototype = new(base) DynamicMessage(type_info);
+  DynamicMessage* prototype = new(base) DynamicMessage(type_info, NULL);
   type_info->prototype = prototype;
+  prototypes_->unpublished_.push_back(make_pair(type, prototype));
 
   // Construct the reflection object.
   type_info->reflection.reset(
@@ -559,7 +856,8 @@ const Message* DynamicMessageFactory::GetPrototypeNoLock(
       type_info->extensions_offset,
       type_info->pool,
       this,
-      type_info->size));
+      type_info->size,
+      type_info->arena_offset));
 
   // Cross link prototypes.
   prototype->CrossLinkPrototypes();
@@ -38,6 +38,7 @@
 #ifndef GOOGLE_PROTOBUF_DYNAMIC_MESSAGE_H__
 #define GOOGLE_PROTOBUF_DYNAMIC_MESSAGE_H__
 
+#include <set>
 #include <google/protobuf/message.h>
 #include <google/protobuf/stubs/common.h>
 
@@ -88,6 +89,8 @@ class LIBPROTOBUF_EXPORT DynamicMessageFactory : public MessageFactory {
   // then it should delegate to MessageFactory::generated_factory() instead
   // of constructing a dynamic implementation of the message.  In theory there
   // is no down side to doing this, so it may become the default in the future.
+  // Call it before the first GetPrototype(), as prototypes already returned
+  // keep being returned.
   void SetDelegateToGeneratedFactory(bool enable) {
     delegate_to_generated_factory_ = enable;
   }
@@ -105,12 +108,26 @@ class LIBPROTOBUF_EXPORT DynamicMessageFactory : public MessageFactory {
   // prototype, so these must be destroyed before the DynamicMessageFactory
   // is destroyed.
   //
+  // New(Arena*) on the prototype allocates the message, and every
+  // sub-message, string and repeated field array under it, in the arena.
+  // Such a tree is freed in one go when the arena is reset or destroyed,
+  // which must also happen before the factory is destroyed.
+  //
   // The given descriptor must outlive the returned message, and hence must
   // outlive the DynamicMessageFactory.
   //
-  // The method is thread-safe.
+  // The method is thread-safe.  Once a type's prototype has been published
+  // (see PrebuildPrototypes()), looking it up takes no lock.
   const Message* GetPrototype(const Descriptor* type);
 
+  // Builds the prototypes of all message types, nested ones included, in
+  // `file` and the files it depends on, and publishes them so that later
+  // GetPrototype() calls for them never block.  Otherwise prototypes are
+  // built and published on first use.
+  //
+  // The method is thread-safe.
+  void PrebuildPrototypes(const FileDescriptor* file);
+
  private:
   const DescriptorPool* pool_;
   bool delegate_to_generated_factory_;
@@ -127,6 +144,12 @@ class LIBPROTOBUF_EXPORT DynamicMessageFactory : public MessageFactory {
   friend class DynamicMessage;
   const Message* GetPrototypeNoLock(const Descriptor* type);
 
+  // Called with prototypes_mutex_ held.
+  void PrebuildPrototypesNoLock(const FileDescriptor* file,
+                                set<const FileDescriptor*>* visited);
+  void PrebuildPrototypesNoLock(const Descriptor* type);
+  void PublishPrototypes();
+
   GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(DynamicMessageFactory);
 };
 
@@ -40,12 +40,19 @@
 // reflection_ops_unittest, cover the rest of the functionality used by
 // DynamicMessage.
 
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+#include <vector>
+
 #include <google/protobuf/stubs/common.h>
+#include <google/protobuf/arena.h>
 #include <google/protobuf/dynamic_message.h>
 #include <google/protobuf/descriptor.h>
 #include <google/protobuf/descriptor.pb.h>
 #include <google/protobuf/test_util.h>
 #include <google/protobuf/unittest.pb.h>
+#include <google/protobuf/stubs/strutil.h>
 
 #include <google/protobuf/testing/googletest.h>
 #include <gtest/gtest.h>
@@ -162,5 +169,292 @@ TEST_F(DynamicMessageTest, SpaceUsed) {
   EXPECT_LT(initial_space_used, message->SpaceUsed());
 }
 
+// Collects every message type of a file, nested ones included.
+void AddMessageTypes(const Descriptor* type, vector<const Descriptor*>* out) {
+  out->push_back(type);
+  for (int i = 0; i < type->nested_type_count(); i++) {
+    AddMessageTypes(type->nested_type(i), out);
+  }
+}
+
+vector<const Descriptor*> MessageTypes(const FileDescriptor* file) {
+  vector<const Descriptor*> types;
+  for (int i = 0; i < file->message_type_count(); i++) {
+    AddMessageTypes(file->message_type(i), &types);
+  }
+  return types;
+}
+
+TEST_F(DynamicMessageTest, PrebuildPrototypes) {
+  DynamicMessageFactory factory(&pool_);
+  factory.PrebuildPrototypes(descriptor_->file());
+
+  vector<const Descriptor*> types = MessageTypes(descriptor_->file());
+  ASSERT_LT(16, types.size());
+  for (int i = 0; i < types.size(); i++) {
+    const Message* prototype = factory.GetPrototype(types[i]);
+    ASSERT_TRUE(prototype != NULL);
+    EXPECT_EQ(types[i], prototype->GetDescriptor());
+    EXPECT_EQ(prototype, factory.GetPrototype(types[i]));
+  }
+
+  // Dependencies are built too.
+  const Descriptor* imported =
+    pool_.FindMessageTypeByName("protobuf_unittest_import.ImportMessage");
+  ASSERT_TRUE(imported != NULL);
+  EXPECT_EQ(imported, factory.GetPrototype(imported)->GetDescriptor());
+}
+
+TEST_F(DynamicMessageTest, PrototypesPublishedOnFirstUse) {
+  // Types built one at a time stay stable as the table grows.
+  DynamicMessageFactory factory(&pool_);
+  vector<const Descriptor*> types = MessageTypes(descriptor_->file());
+  vector<const Message*> prototypes;
+  for (int i = 0; i < types.size(); i++) {
+    prototypes.push_back(factory.GetPrototype(types[i]));
+  }
+  for (int i = 0; i < types.size(); i++) {
+    EXPECT_EQ(prototypes[i], factory.GetPrototype(types[i]));
+  }
+}
+
+TEST_F(DynamicMessageTest, DelegatedPrototypesPublished) {
+  // Prototypes from the generated factory are published like built ones and
+  // stay stable as the table grows.
+  DynamicMessageFactory factory;
+  factory.SetDelegateToGeneratedFactory(true);
+  vector<const Descriptor*> types =
+    MessageTypes(unittest::TestAllTypes::descriptor()->file());
+  for (int i = 0; i < types.size(); i++) {
+    EXPECT_EQ(MessageFactory::generated_factory()->GetPrototype(types[i]),
+              factory.GetPrototype(types[i]));
+  }
+  for (int i = 0; i < types.size(); i++) {
+    EXPECT_EQ(MessageFactory::generated_factory()->GetPrototype(types[i]),
+              factory.GetPrototype(types[i]));
+  }
+  EXPECT_EQ(&unittest::TestAllTypes::default_instance(),
+            factory.GetPrototype(unittest::TestAllTypes::descriptor()));
+}
+
+#ifdef HAVE_PTHREAD
+struct PrototypeLookup {
+  DynamicMessageFactory* factory;
+  const vector<const Descriptor*>* types;
+  vector<const Message*> prototypes;
+};
+
+void* LookUpPrototypes(void* arg) {
+  PrototypeLookup* lookup = reinterpret_cast<PrototypeLookup*>(arg);
+  const vector<const Descriptor*>& types = *lookup->types;
+  for (int round = 0; round < 100; round++) {
+    for (int i = 0; i < types.size(); i++) {
+      const Message* prototype = lookup->factory->GetPrototype(types[i]);
+      if (round == 0) lookup->prototypes.push_back(prototype);
+    }
+  }
+  return NULL;
+}
+
+TEST_F(DynamicMessageTest, ConcurrentGetPrototype) {
+  DynamicMessageFactory factory(&pool_);
+  vector<const Descriptor*> types = MessageTypes(descriptor_->file());
+
+  PrototypeLookup lookups[4];
+  pthread_t threads[4];
+  for (int i = 0; i < 4; i++) {
+    lookups[i].factory = &factory;
+    lookups[i].types = &types;
+    ASSERT_EQ(0, pthread_create(&threads[i], NULL, &LookUpPrototypes,
+                                &lookups[i]));
+  }
+  for (int i = 0; i < 4; i++) {
+    pthread_join(threads[i], NULL);
+  }
+
+  for (int i = 0; i < types.size(); i++) {
+    const Message* prototype = factory.GetPrototype(types[i]);
+    for (int j = 0; j < 4; j++) {
+      EXPECT_EQ(prototype, lookups[j].prototypes[i]);
+    }
+  }
+}
+#endif  // HAVE_PTHREAD
+
+TEST_F(DynamicMessageTest, CompactLayout) {
+  // Declaration order must not cost padding: fields alternating between
+  // sizes take no more room than the same fields declared largest first.
+  static const FieldDescriptorProto::Type kInterleaved[] = {
+    FieldDescriptorProto::TYPE_BOOL,   FieldDescriptorProto::TYPE_INT64,
+    FieldDescriptorProto::TYPE_STRING, FieldDescriptorProto::TYPE_INT32,
+    FieldDescriptorProto::TYPE_BOOL,   FieldDescriptorProto::TYPE_DOUBLE,
+    FieldDescriptorProto::TYPE_FLOAT,  FieldDescriptorProto::TYPE_FIXED64,
+  };
+  static const FieldDescriptorProto::Type kSorted[] = {
+    FieldDescriptorProto::TYPE_INT64,  FieldDescriptorProto::TYPE_DOUBLE,
+    FieldDescriptorProto::TYPE_FIXED64, FieldDescriptorProto::TYPE_INT32,
+    FieldDescriptorProto::TYPE_FLOAT,  FieldDescriptorProto::TYPE_BOOL,
+    FieldDescriptorProto::TYPE_BOOL,   FieldDescriptorProto::TYPE_STRING,
+  };
+
+  FileDescriptorProto file;
+  file.set_name("layout.proto");
+  DescriptorProto* interleaved = file.add_message_type();
+  DescriptorProto* sorted = file.add_message_type();
+  interleaved->set_name("Interleaved");
+  sorted->set_name("Sorted");
+  for (int i = 0; i < GOOGLE_ARRAYSIZE(kInterleaved); i++) {
+    FieldDescriptorProto* field = interleaved->add_field();
+    field->set_name("f" + SimpleItoa(i));
+    field->set_number(i + 1);
+    field->set_label(FieldDescriptorProto::LABEL_OPTIONAL);
+    field->set_type(kInterleaved[i]);
+    field = sorted->add_field();
+    field->set_name("f" + SimpleItoa(i));
+    field->set_number(i + 1);
+    field->set_label(FieldDescriptorProto::LABEL_OPTIONAL);
+    field->set_type(kSorted[i]);
+  }
+  ASSERT_TRUE(pool_.BuildFile(file) != NULL);
+
+  const Message* interleaved_prototype =
+    factory_.GetPrototype(pool_.FindMessageTypeByName("Interleaved"));
+  const Message* sorted_prototype =
+    factory_.GetPrototype(pool_.FindMessageTypeByName("Sorted"));
+  EXPECT_EQ(sorted_prototype->SpaceUsed(), interleaved_prototype->SpaceUsed());
+
+  scoped_ptr<Message> message(interleaved_prototype->New());
+  const Reflection* reflection = message->GetReflection();
+  const Descriptor* descriptor = message->GetDescriptor();
+  reflection->SetBool(message.get(), descriptor->field(0), true);
+  reflection->SetInt64(message.get(), descriptor->field(1), -1);
+  reflection->SetString(message.get(), descriptor->field(2), "two");
+  reflection->SetInt32(message.get(), descriptor->field(3), 3);
+  reflection->SetBool(message.get(), descriptor->field(4), true);
+  reflection->SetDouble(message.get(), descriptor->field(5), 5.5);
+  reflection->SetFloat(message.get(), descriptor->field(6), 6.5);
+  reflection->SetUInt64(message.get(), descriptor->field(7), 7);
+  EXPECT_TRUE(reflection->GetBool(*message, descriptor->field(0)));
+  EXPECT_EQ(-1, reflection->GetInt64(*message, descriptor->field(1)));
+  EXPECT_EQ("two", reflection->GetString(*message, descriptor->field(2)));
+  EXPECT_EQ(3, reflection->GetInt32(*message, descriptor->field(3)));
+  EXPECT_TRUE(reflection->GetBool(*message, descriptor->field(4)));
+  EXPECT_EQ(5.5, reflection->GetDouble(*message, descriptor->field(5)));
+  EXPECT_EQ(6.5, reflection->GetFloat(*message, descriptor->field(6)));
+  EXPECT_EQ(7, reflection->GetUInt64(*message, descriptor->field(7)));
+}
+
+TEST_F(DynamicMessageTest, Arena) {
+  // Check that a message allocated in an arena behaves like any other.
+  Arena arena;
+  Message* message = prototype_->New(&arena);
+  TestUtil::ReflectionTester reflection_tester(descriptor_);
+
+  reflection_tester.SetAllFieldsViaReflection(message);
+  reflection_tester.ExpectAllFieldsSetViaReflection(*message);
+  reflection_tester.ModifyRepeatedFieldsViaReflection(message);
+
+  message->Clear();
+  reflection_tester.ExpectClearViaReflection(*message);
+  reflection_tester.SetAllFieldsViaReflection(message);
+  reflection_tester.ExpectAllFieldsSetViaReflection(*message);
+  EXPECT_LT(0, arena.SpaceUsed());
+}
+
+TEST_F(DynamicMessageTest, ArenaExtensions) {
+  Arena arena;
+  Message* message = extensions_prototype_->New(&arena);
+  TestUtil::ReflectionTester reflection_tester(extensions_descriptor_);
+
+  reflection_tester.SetAllFieldsViaReflection(message);
+  reflection_tester.ExpectAllFieldsSetViaReflection(*message);
+}
+
+TEST_F(DynamicMessageTest, ArenaParse) {
+  scoped_ptr<Message> source(prototype_->New());
+  TestUtil::ReflectionTester reflection_tester(descriptor_);
+  reflection_tester.SetAllFieldsViaReflection(source.get());
+  string data = source->SerializeAsString();
+
+  // A stack block that is too small for the whole tree, so that parsing
+  // also has to chain heap blocks.
+  char block[1024];
+  Arena arena(block, sizeof(block));
+  for (int i = 0; i < 3; i++) {
+    Message* message = prototype_->New(&arena);
+    ASSERT_TRUE(message->ParseFromString(data));
+    reflection_tester.ExpectAllFieldsSetViaReflection(*message);
+    EXPECT_EQ(data, message->SerializeAsString());
+    EXPECT_LT(sizeof(block), arena.SpaceAllocated());
+    arena.Reset();
+    EXPECT_EQ(sizeof(block), arena.SpaceAllocated());
+  }
+}
+
+TEST_F(DynamicMessageTest, ArenaUnknownFields) {
+  scoped_ptr<Message> source(prototype_->New());
+  UnknownFieldSet* source_fields =
+      source->GetReflection()->MutableUnknownFields(source.get());
+  source_fields->AddLengthDelimited(1000, "unknown");
+  source_fields->AddGroup(1001)->AddVarint(1, 2);
+  string data = source->SerializeAsString();
+
+  Arena arena;
+  Message* message = prototype_->New(&arena);
+  ASSERT_TRUE(message->ParseFromString(data));
+  const UnknownFieldSet& fields =
+      message->GetReflection()->GetUnknownFields(*message);
+  ASSERT_EQ(2, fields.field_count());
+  EXPECT_TRUE(arena.Contains(&fields.field(0)));
+  EXPECT_TRUE(arena.Contains(&fields.field(0).length_delimited()));
+  EXPECT_TRUE(arena.Contains(&fields.field(1).group()));
+  EXPECT_EQ(data, message->SerializeAsString());
+}
+
+TEST_F(DynamicMessageTest, ArenaRelease) {
+  // Released objects are heap copies the caller may delete.
+  Arena arena;
+  Message* message = prototype_->New(&arena);
+  TestUtil::ReflectionTester reflection_tester(descriptor_);
+
+  reflection_tester.SetAllFieldsViaReflection(message);
+  reflection_tester.ReleaseLastRepeatedsViaReflection(message, false);
+  reflection_tester.ExpectMessagesReleasedViaReflection(
+      message, TestUtil::ReflectionTester::CAN_BE_NULL);
+
+  reflection_tester.SetAllFieldsViaReflection(message);
+  const Reflection* reflection = message->GetReflection();
+  const FieldDescriptor* field =
+      descriptor_->FindFieldByName("optional_nested_message");
+  const Message* sub_message = &reflection->GetMessage(*message, field);
+  scoped_ptr<Message> released(reflection->ReleaseMessage(message, field));
+  EXPECT_NE(sub_message, released.get());
+  EXPECT_EQ(sub_message->SerializeAsString(), released->SerializeAsString());
+
+  reflection_tester.SetAllFieldsViaReflection(message);
+  reflection_tester.RemoveLastRepeatedsViaReflection(message);
+  reflection_tester.SwapRepeatedsViaReflection(message);
+}
+
+TEST_F(DynamicMessageTest, ArenaSwap) {
+  // Swapping between the heap and an arena, or between two arenas, copies.
+  Arena arena1;
+  Arena arena2;
+  scoped_ptr<Message> heap_message(prototype_->New());
+  Message* arena_message1 = prototype_->New(&arena1);
+  Message* arena_message2 = prototype_->New(&arena2);
+  TestUtil::ReflectionTester reflection_tester(descriptor_);
+
+  reflection_tester.SetAllFieldsViaReflection(heap_message.get());
+  heap_message->GetReflection()->Swap(heap_message.get(), arena_message1);
+  reflection_tester.ExpectClearViaReflection(*heap_message);
+  reflection_tester.ExpectAllFieldsSetViaReflection(*arena_message1);
+
+  arena_message1->GetReflection()->Swap(arena_message1, arena_message2);
+  reflection_tester.ExpectClearViaReflection(*arena_message1);
+  reflection_tester.ExpectAllFieldsSetViaReflection(*arena_message2);
+
+}
+
 }  // namespace protobuf
 }  // namespace google
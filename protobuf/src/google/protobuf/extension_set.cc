@@ -1066,6 +1066,23 @@ void ExtensionSet::SerializeWithCachedSizes(
   }
 }
 
+void ExtensionSet::SerializeReverse(
+    int start_field_number, int end_field_number,
+    io::ReverseCodedOutputStream* output) const {
+  map<int, Extension>::const_iterator iter =
+      extensions_.lower_bound(end_field_number);
+  while (iter != extensions_.begin()) {
+    --iter;
+    if (iter->first < start_field_number) break;
+    int size = iter->second.ByteSize(iter->first);
+    if (size == 0) continue;
+    io::ArrayOutputStream array_output(output->Reserve(size), size);
+    io::CodedOutputStream coded_output(&array_output);
+    iter->second.SerializeFieldWithCachedSizes(iter->first, &coded_output);
+    GOOGLE_CHECK(!coded_output.HadError());
+  }
+}
+
 int ExtensionSet::ByteSize() const {
   int total_size = 0;
 
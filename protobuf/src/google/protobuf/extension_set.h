@@ -59,6 +59,7 @@ namespace protobuf {
   namespace io {
     class CodedInputStream;                              // coded_stream.h
     class CodedOutputStream;                             // coded_stream.h
+    class ReverseCodedOutputStream;                      // coded_stream.h
   }
   namespace internal {
     class FieldSkipper;                                  // wire_format_lite.h
@@ -374,6 +375,13 @@ class LIBPROTOBUF_EXPORT ExtensionSet {
                                          int end_field_number,
                                          uint8* target) const;
 
+  // Like SerializeWithCachedSizes, but writes back to front, for
+  // MessageLite::SerializeReverse().  Each extension is sized just before it
+  // is written, so ByteSize() need not have been called.
+  void SerializeReverse(int start_field_number,
+                        int end_field_number,
+                        io::ReverseCodedOutputStream* output) const;
+
   // Like above but serializes in MessageSet format.
   void SerializeMessageSetWithCachedSizes(io::CodedOutputStream* output) const;
   uint8* SerializeMessageSetWithCachedSizesToArray(uint8* target) const;
@@ -39,6 +39,8 @@
 #include <google/protobuf/repeated_field.h>
 #include <google/protobuf/extension_set.h>
 #include <google/protobuf/generated_message_util.h>
+#include <google/protobuf/lazy_field.h>
+#include <google/protobuf/string_piece_field.h>
 #include <google/protobuf/stubs/common.h>
 
 namespace google {
@@ -174,7 +176,8 @@ GeneratedMessageReflection::GeneratedMessageReflection(
     int extensions_offset,
     const DescriptorPool* descriptor_pool,
     MessageFactory* factory,
-    int object_size)
+    int object_size,
+    int arena_offset)
   : descriptor_       (descriptor),
     default_instance_ (default_instance),
     offsets_          (offsets),
@@ -182,6 +185,7 @@ GeneratedMessageReflection::GeneratedMessageReflection(
     unknown_fields_offset_(unknown_fields_offset),
     extensions_offset_(extensions_offset),
     object_size_      (object_size),
+    arena_offset_     (arena_offset),
     descriptor_pool_  ((descriptor_pool == NULL) ?
                          DescriptorPool::generated_pool() :
                          descriptor_pool),
@@ -267,6 +271,11 @@ int GeneratedMessageReflection::SpaceUsed(const Message& message) const {
           break;
 
         case FieldDescriptor::CPPTYPE_STRING: {
+          if (IsStringPieceField(field)) {
+            total_size += GetRaw<StringPieceField>(message, field)
+                            .SpaceUsedExcludingSelf();
+            break;
+          }
           switch (field->options().ctype()) {
             default:  // TODO(kenton):  Support other string reps.
             case FieldOptions::STRING: {
@@ -292,6 +301,9 @@ int GeneratedMessageReflection::SpaceUsed(const Message& message) const {
           if (&message == default_instance_) {
             // For singular fields, the prototype just stores a pointer to the
             // external type's prototype, so there is no extra memory usage.
+          } else if (IsLazyField(field)) {
+            total_size +=
+                GetRaw<LazyField>(message, field).SpaceUsedExcludingSelf();
           } else {
             const Message* sub_message = GetRaw<const Message*>(message, field);
             if (sub_message != NULL) {
@@ -327,6 +339,16 @@ void GeneratedMessageReflection::Swap(
     << "\").  Note that the exact same class is required; not just the same "
        "descriptor.";
 
+  if (GetArena(*message1) != GetArena(*message2)) {
+    // Sub-objects can't move between arenas, so swap by copying.
+    Message* temp = message1->New();
+    temp->MergeFrom(*message1);
+    message1->CopyFrom(*message2);
+    message2->CopyFrom(*temp);
+    delete temp;
+    return;
+  }
+
   uint32* has_bits1 = MutableHasBits(message1);
   uint32* has_bits2 = MutableHasBits(message2);
   int has_bits_size = (descriptor_->field_count() + 31) / 32;
@@ -382,11 +404,21 @@ void GeneratedMessageReflection::Swap(
           SWAP_VALUES(ENUM  , int   );
 #undef SWAP_VALUES
         case FieldDescriptor::CPPTYPE_MESSAGE:
-          std::swap(*MutableRaw<Message*>(message1, field),
-                    *MutableRaw<Message*>(message2, field));
+          if (IsLazyField(field)) {
+            MutableRaw<LazyField>(message1, field)->Swap(
+                MutableRaw<LazyField>(message2, field));
+          } else {
+            std::swap(*MutableRaw<Message*>(message1, field),
+                      *MutableRaw<Message*>(message2, field));
+          }
           break;
 
         case FieldDescriptor::CPPTYPE_STRING:
+          if (IsStringPieceField(field)) {
+            MutableRaw<StringPieceField>(message1, field)->Swap(
+                MutableRaw<StringPieceField>(message2, field));
+            break;
+          }
           switch (field->options().ctype()) {
             default:  // TODO(kenton):  Support other string reps.
             case FieldOptions::STRING:
@@ -489,6 +521,12 @@ void GeneratedMessageReflection::ClearField(
           break;
 
         case FieldDescriptor::CPPTYPE_STRING: {
+          if (IsStringPieceField(field)) {
+            const string& default_value = field->default_value_string();
+            MutableRaw<StringPieceField>(message, field)->SetAliased(
+                default_value.data(), default_value.size());
+            break;
+          }
           switch (field->options().ctype()) {
             default:  // TODO(kenton):  Support other string reps.
             case FieldOptions::STRING:
@@ -507,7 +545,11 @@ void GeneratedMessageReflection::ClearField(
         }
 
         case FieldDescriptor::CPPTYPE_MESSAGE:
-          (*MutableRaw<Message*>(message, field))->Clear();
+          if (IsLazyField(field)) {
+            MutableRaw<LazyField>(message, field)->Clear();
+          } else {
+            (*MutableRaw<Message*>(message, field))->Clear();
+          }
           break;
       }
     }
@@ -763,6 +805,8 @@ string GeneratedMessageReflection::GetString(
   if (field->is_extension()) {
     return GetExtensionSet(message).GetString(field->number(),
                                               field->default_value_string());
+  } else if (IsStringPieceField(field)) {
+    return GetField<StringPieceField>(message, field).Get().ToString();
   } else {
     switch (field->options().ctype()) {
       default:  // TODO(kenton):  Support other string reps.
@@ -782,6 +826,9 @@ const string& GeneratedMessageReflection::GetStringReference(
   if (field->is_extension()) {
     return GetExtensionSet(message).GetString(field->number(),
                                               field->default_value_string());
+  } else if (IsStringPieceField(field)) {
+    GetField<StringPieceField>(message, field).Get().CopyToString(scratch);
+    return *scratch;
   } else {
     switch (field->options().ctype()) {
       default:  // TODO(kenton):  Support other string reps.
@@ -802,13 +849,18 @@ void GeneratedMessageReflection::SetString(
   if (field->is_extension()) {
     return MutableExtensionSet(message)->SetString(field->number(),
                                                    field->type(), value, field);
+  } else if (IsStringPieceField(field)) {
+    MutableField<StringPieceField>(message, field)->Set(
+        value.data(), value.size(), GetArena(*message));
   } else {
     switch (field->options().ctype()) {
       default:  // TODO(kenton):  Support other string reps.
       case FieldOptions::STRING: {
         string** ptr = MutableField<string*>(message, field);
         if (*ptr == DefaultRaw<const string*>(field)) {
-          *ptr = new string(value);
+          Arena* arena = GetArena(*message);
+          *ptr = arena == NULL ? new string(value)
+                               : arena->Create<string>(value);
         } else {
           (*ptr)->assign(value);
         }
@@ -987,6 +1039,9 @@ const Message& GeneratedMessageReflection::GetMessage(
     return static_cast<const Message&>(
         GetExtensionSet(message).GetMessage(
           field->number(), field->message_type(), factory));
+  } else if (IsLazyField(field)) {
+    return GetRaw<LazyField>(message, field).Get(
+        DefaultRaw<LazyField>(field).prototype(), GetArena(message));
   } else {
     const Message* result;
     result = GetRaw<const Message*>(message, field);
@@ -1007,12 +1062,15 @@ Message* GeneratedMessageReflection::MutableMessage(
   if (field->is_extension()) {
     return static_cast<Message*>(
         MutableExtensionSet(message)->MutableMessage(field, factory));
+  } else if (IsLazyField(field)) {
+    return MutableField<LazyField>(message, field)->Mutable(
+        DefaultRaw<LazyField>(field).prototype(), GetArena(*message));
   } else {
     Message* result;
     Message** result_holder = MutableField<Message*>(message, field);
     if (*result_holder == NULL) {
       const Message* default_message = DefaultRaw<const Message*>(field);
-      *result_holder = default_message->New();
+      *result_holder = default_message->New(GetArena(*message));
     }
     result = *result_holder;
     return result;
@@ -1030,11 +1088,21 @@ Message* GeneratedMessageReflection::ReleaseMessage(
   if (field->is_extension()) {
     return static_cast<Message*>(
         MutableExtensionSet(message)->ReleaseMessage(field, factory));
+  } else if (IsLazyField(field)) {
+    ClearBit(message, field);
+    return MutableRaw<LazyField>(message, field)->Release(
+        DefaultRaw<LazyField>(field).prototype(), GetArena(*message));
   } else {
     ClearBit(message, field);
     Message** result = MutableRaw<Message*>(message, field);
     Message* ret = *result;
     *result = NULL;
+    if (ret != NULL && GetArena(*message) != NULL) {
+      // The caller takes ownership, so hand out a heap copy.
+      Message* copy = ret->New();
+      copy->CopyFrom(*ret);
+      ret = copy;
+    }
     return ret;
   }
 }
@@ -1090,8 +1158,8 @@ Message* GeneratedMessageReflection::AddMessage(
       } else {
         prototype = &repeated->Get<GenericTypeHandler<Message> >(0);
       }
-      result = prototype->New();
-      repeated->AddAllocated<GenericTypeHandler<Message> >(result);
+      result = prototype->New(repeated->arena());
+      repeated->UnsafeArenaAddAllocated<GenericTypeHandler<Message> >(result);
     }
     return result;
   }
@@ -1207,6 +1275,13 @@ inline ExtensionSet* GeneratedMessageReflection::MutableExtensionSet(
   return reinterpret_cast<ExtensionSet*>(ptr);
 }
 
+inline Arena* GeneratedMessageReflection::GetArena(
+    const Message& message) const {
+  if (arena_offset_ == -1) return NULL;
+  const void* ptr = reinterpret_cast<const uint8*>(&message) + arena_offset_;
+  return *reinterpret_cast<Arena* const*>(ptr);
+}
+
 // Simple accessors for manipulating has_bits_.
 inline bool GeneratedMessageReflection::HasBit(
     const Message& message, const FieldDescriptor* field) const {
@@ -125,6 +125,10 @@ class LIBPROTOBUF_EXPORT GeneratedMessageReflection : public Reflection {
   //   factory:       MessageFactory to use to construct extension messages.
   //   object_size:   The size of a message object of this type, as measured
   //                  by sizeof().
+  //   arena_offset:  Offset in the message of the Arena* it was created in,
+  //                  or -1 if messages of this type are never arena-allocated.
+  //                  Sub-messages and strings of an arena message are
+  //                  allocated in the same arena.
   GeneratedMessageReflection(const Descriptor* descriptor,
                              const Message* default_instance,
                              const int offsets[],
@@ -133,7 +137,8 @@ class LIBPROTOBUF_EXPORT GeneratedMessageReflection : public Reflection {
                              int extensions_offset,
                              const DescriptorPool* pool,
                              MessageFactory* factory,
-                             int object_size);
+                             int object_size,
+                             int arena_offset = -1);
   ~GeneratedMessageReflection();
 
   // implements Reflection -------------------------------------------
@@ -299,6 +304,7 @@ class LIBPROTOBUF_EXPORT GeneratedMessageReflection : public Reflection {
   int unknown_fields_offset_;
   int extensions_offset_;
   int object_size_;
+  int arena_offset_;
 
   const DescriptorPool* descriptor_pool_;
   MessageFactory* message_factory_;
@@ -316,6 +322,7 @@ class LIBPROTOBUF_EXPORT GeneratedMessageReflection : public Reflection {
   inline uint32* MutableHasBits(Message* message) const;
   inline const ExtensionSet& GetExtensionSet(const Message& message) const;
   inline ExtensionSet* MutableExtensionSet(Message* message) const;
+  inline Arena* GetArena(const Message& message) const;
 
   inline bool HasBit(const Message& message,
                      const FieldDescriptor* field) const;
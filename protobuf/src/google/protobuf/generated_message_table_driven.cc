@@ -0,0 +1,832 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <google/protobuf/generated_message_table_driven.h>
+
+#include <string>
+
+#include <google/protobuf/arena.h>
+#include <google/protobuf/extension_set.h>
+#include <google/protobuf/generated_message_util.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/message.h>
+#include <google/protobuf/repeated_field.h>
+#include <google/protobuf/unknown_field_set.h>
+#include <google/protobuf/wire_format.h>
+#include <google/protobuf/wire_format_lite_inl.h>
+
+namespace google {
+namespace protobuf {
+namespace internal {
+
+namespace {
+
+// Members are found the way GeneratedMessageReflection finds them.  In
+// particular, pointers to sub-messages, which really point to some subclass
+// of Message, are read and written as plain Message pointers.
+template <typename Type>
+inline const Type& GetRaw(const Message& message, int offset) {
+  const void* ptr = reinterpret_cast<const uint8*>(&message) + offset;
+  return *reinterpret_cast<const Type*>(ptr);
+}
+
+template <typename Type>
+inline Type* MutableRaw(Message* message, int offset) {
+  void* ptr = reinterpret_cast<uint8*>(message) + offset;
+  return reinterpret_cast<Type*>(ptr);
+}
+
+// Members that are updated even though the message is const, like
+// _cached_size_.
+template <typename Type>
+inline Type* MutableRaw(const Message& message, int offset) {
+  return MutableRaw<Type>(const_cast<Message*>(&message), offset);
+}
+
+inline bool HasBit(const MessageTable& table, const Message& message,
+                   const TableField& field) {
+  const uint32* has_bits = &GetRaw<uint32>(message, table.has_bits_offset);
+  return (has_bits[field.has_bit / 32] & (1u << (field.has_bit % 32))) != 0;
+}
+
+inline void SetBit(const MessageTable& table, Message* message,
+                   const TableField& field) {
+  uint32* has_bits = MutableRaw<uint32>(message, table.has_bits_offset);
+  has_bits[field.has_bit / 32] |= 1u << (field.has_bit % 32);
+}
+
+// The arena that owns message's strings and sub-messages, or NULL.
+inline Arena* GetArena(const MessageTable& table, const Message& message) {
+  if (table.arena_offset == -1) return NULL;
+  return GetRaw<Arena*>(message, table.arena_offset);
+}
+
+inline int FieldNumber(const TableField& field) {
+  return WireFormatLite::GetTagFieldNumber(field.tag);
+}
+
+inline WireFormatLite::FieldType TypeOf(const TableField& field) {
+  return static_cast<WireFormatLite::FieldType>(field.type);
+}
+
+inline const string* DefaultString(const TableField& field) {
+  if (field.default_value == NULL) return &kEmptyString;
+  return *field.default_value;
+}
+
+// Finds the field with the given number.  Fields usually arrive in order,
+// so the one after the field found last time (*hint) is tried first.
+inline const TableField* FindField(const MessageTable& table, int number,
+                                   int* hint) {
+  const TableField* fields = table.fields;
+  int i = *hint;
+  if (i < table.field_count && FieldNumber(fields[i]) == number) {
+    *hint = i + 1;
+    return &fields[i];
+  }
+
+  int low = 0;
+  int high = table.field_count;
+  while (low < high) {
+    int middle = low + (high - low) / 2;
+    if (FieldNumber(fields[middle]) < number) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  if (low < table.field_count && FieldNumber(fields[low]) == number) {
+    *hint = low + 1;
+    return &fields[low];
+  }
+  return NULL;
+}
+
+inline bool InExtensionRange(const MessageTable& table, int number) {
+  for (int i = 0; i < table.extension_range_count; i++) {
+    if (table.extension_ranges[2 * i] <= number &&
+        number < table.extension_ranges[2 * i + 1]) {
+      return true;
+    }
+  }
+  return false;
+}
+
+inline bool IsPackable(const TableField& field) {
+  switch (TypeOf(field)) {
+    case WireFormatLite::TYPE_STRING:
+    case WireFormatLite::TYPE_BYTES:
+    case WireFormatLite::TYPE_GROUP:
+    case WireFormatLite::TYPE_MESSAGE:
+      return false;
+    default:
+      return true;
+  }
+}
+
+// Reads a value of an enum field.  Returns false in *known, after adding
+// the value to the unknown fields, if the enum type doesn't define it.
+inline bool ReadEnum(const MessageTable& table, const TableField& field,
+                     Message* message, io::CodedInputStream* input,
+                     int* value, bool* known) {
+  if (!WireFormatLite::ReadPrimitive<int, WireFormatLite::TYPE_ENUM>(
+          input, value)) {
+    return false;
+  }
+  *known = field.enum_is_valid(*value);
+  if (!*known) {
+    MutableRaw<UnknownFieldSet>(message, table.unknown_fields_offset)
+        ->AddVarint(FieldNumber(field), *value);
+  }
+  return true;
+}
+
+}  // namespace
+
+// The types below are those of scalar fields that are read and written the
+// same way whatever their label: all but enums (which are validated),
+// strings and messages.  HANDLE_TYPE(TYPE, METHOD, CPPTYPE) is called with
+// e.g. SINT32, SInt32, int32.
+#define FOR_EACH_PRIMITIVE_TYPE(HANDLE_TYPE)                                \
+  HANDLE_TYPE(   INT32,    Int32,  int32)                                   \
+  HANDLE_TYPE(   INT64,    Int64,  int64)                                   \
+  HANDLE_TYPE(  SINT32,   SInt32,  int32)                                   \
+  HANDLE_TYPE(  SINT64,   SInt64,  int64)                                   \
+  HANDLE_TYPE(  UINT32,   UInt32, uint32)                                   \
+  HANDLE_TYPE(  UINT64,   UInt64, uint64)                                   \
+  HANDLE_TYPE( FIXED32,  Fixed32, uint32)                                   \
+  HANDLE_TYPE( FIXED64,  Fixed64, uint64)                                   \
+  HANDLE_TYPE(SFIXED32, SFixed32,  int32)                                   \
+  HANDLE_TYPE(SFIXED64, SFixed64,  int64)                                   \
+  HANDLE_TYPE(   FLOAT,    Float,  float)                                   \
+  HANDLE_TYPE(  DOUBLE,   Double, double)                                   \
+  HANDLE_TYPE(    BOOL,     Bool,   bool)
+
+// ===================================================================
+// Parsing
+
+bool TableInterpreter::MergePartialFromCodedStream(
+    const MessageTable& table, Message* message,
+    io::CodedInputStream* input) {
+  int hint = 0;
+  uint32 tag;
+  while ((tag = input->ReadTag()) != 0) {
+    int number = WireFormatLite::GetTagFieldNumber(tag);
+    const TableField* field = FindField(table, number, &hint);
+
+    if (field != NULL) {
+      if (tag == field->tag) {
+        if (!ParseField(table, *field, message, input)) return false;
+        continue;
+      }
+
+      // Repeated scalars are accepted both packed and unpacked, whichever
+      // way they were declared.
+      if (field->label != TableField::SINGULAR && IsPackable(*field)) {
+        TableField other = *field;
+        other.tag = tag;
+        WireFormatLite::WireType wire_type =
+            WireFormatLite::GetTagWireType(tag);
+        if (field->label == TableField::PACKED &&
+            wire_type ==
+                WireFormatLite::WireTypeForFieldType(TypeOf(*field))) {
+          other.label = TableField::REPEATED;
+        } else if (field->label == TableField::REPEATED &&
+                   wire_type == WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+          other.label = TableField::PACKED;
+        }
+        if (other.label != field->label) {
+          if (!ParseField(table, other, message, input)) return false;
+          continue;
+        }
+      }
+    }
+
+    // Is this an end-group tag?  If so, this must be the end of the message.
+    if (WireFormatLite::GetTagWireType(tag) ==
+        WireFormatLite::WIRETYPE_END_GROUP) {
+      return true;
+    }
+
+    if (table.extensions_offset != -1 && InExtensionRange(table, number)) {
+      if (!MutableRaw<ExtensionSet>(message, table.extensions_offset)
+               ->ParseField(tag, input,
+                            &table.default_instance(),
+                            MutableRaw<UnknownFieldSet>(
+                                message, table.unknown_fields_offset))) {
+        return false;
+      }
+      continue;
+    }
+
+    if (!WireFormat::SkipField(input, tag,
+                               MutableRaw<UnknownFieldSet>(
+                                   message, table.unknown_fields_offset))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TableInterpreter::ParseField(const MessageTable& table,
+                                  const TableField& field, Message* message,
+                                  io::CodedInputStream* input) {
+  if (field.label == TableField::SINGULAR) {
+    switch (TypeOf(field)) {
+#define HANDLE_TYPE(TYPE, METHOD, CPPTYPE)                                  \
+      case WireFormatLite::TYPE_##TYPE:                                     \
+        if (!WireFormatLite::ReadPrimitive<CPPTYPE,                         \
+                                           WireFormatLite::TYPE_##TYPE>(    \
+                input, MutableRaw<CPPTYPE>(message, field.offset))) {       \
+          return false;                                                     \
+        }                                                                   \
+        break;
+      FOR_EACH_PRIMITIVE_TYPE(HANDLE_TYPE)
+#undef HANDLE_TYPE
+
+      case WireFormatLite::TYPE_ENUM: {
+        int value;
+        bool known;
+        if (!ReadEnum(table, field, message, input, &value, &known)) {
+          return false;
+        }
+        if (!known) return true;
+        *MutableRaw<int>(message, field.offset) = value;
+        break;
+      }
+
+      case WireFormatLite::TYPE_STRING:
+      case WireFormatLite::TYPE_BYTES: {
+        string** value = MutableRaw<string*>(message, field.offset);
+        if (*value == DefaultString(field)) {
+          *value = Arena::New<string>(GetArena(table, *message));
+        }
+        if (TypeOf(field) == WireFormatLite::TYPE_STRING) {
+          if (!WireFormatLite::ReadString(input, *value)) return false;
+          WireFormat::VerifyUTF8String((*value)->data(), (*value)->length(),
+                                       WireFormat::PARSE);
+        } else {
+          if (!WireFormatLite::ReadBytes(input, *value)) return false;
+        }
+        break;
+      }
+
+      case WireFormatLite::TYPE_GROUP:
+      case WireFormatLite::TYPE_MESSAGE: {
+        Message** value = MutableRaw<Message*>(message, field.offset);
+        if (*value == NULL) {
+          *value = field.prototype().New(GetArena(table, *message));
+        }
+        if (TypeOf(field) == WireFormatLite::TYPE_GROUP) {
+          if (!WireFormatLite::ReadGroup(FieldNumber(field), input, *value)) {
+            return false;
+          }
+        } else {
+          if (!WireFormatLite::ReadMessage(input, *value)) return false;
+        }
+        break;
+      }
+    }
+    SetBit(table, message, field);
+    return true;
+  }
+
+  if (field.label == TableField::PACKED) {
+    switch (TypeOf(field)) {
+#define HANDLE_TYPE(TYPE, METHOD, CPPTYPE)                                  \
+      case WireFormatLite::TYPE_##TYPE:                                     \
+        return WireFormatLite::ReadPackedPrimitive<                         \
+                   CPPTYPE, WireFormatLite::TYPE_##TYPE>(                   \
+            input,                                                          \
+            MutableRaw<RepeatedField<CPPTYPE> >(message, field.offset));
+      FOR_EACH_PRIMITIVE_TYPE(HANDLE_TYPE)
+#undef HANDLE_TYPE
+
+      case WireFormatLite::TYPE_ENUM:
+        // Like generated code, this drops values the enum type doesn't know.
+        return WireFormatLite::ReadPackedEnumNoInline(
+            input, field.enum_is_valid,
+            MutableRaw<RepeatedField<int> >(message, field.offset));
+
+      default:
+        GOOGLE_LOG(FATAL) << "Can't get here.";
+        return false;
+    }
+  }
+
+  // Repeated, one value per tag.
+  switch (TypeOf(field)) {
+#define HANDLE_TYPE(TYPE, METHOD, CPPTYPE)                                  \
+    case WireFormatLite::TYPE_##TYPE:                                       \
+      return WireFormatLite::ReadRepeatedPrimitive<                         \
+                 CPPTYPE, WireFormatLite::TYPE_##TYPE>(                     \
+          io::CodedOutputStream::VarintSize32(field.tag), field.tag, input, \
+          MutableRaw<RepeatedField<CPPTYPE> >(message, field.offset));
+    FOR_EACH_PRIMITIVE_TYPE(HANDLE_TYPE)
+#undef HANDLE_TYPE
+
+    case WireFormatLite::TYPE_ENUM: {
+      int value;
+      bool known;
+      if (!ReadEnum(table, field, message, input, &value, &known)) {
+        return false;
+      }
+      if (known) {
+        MutableRaw<RepeatedField<int> >(message, field.offset)->Add(value);
+      }
+      return true;
+    }
+
+    case WireFormatLite::TYPE_STRING:
+    case WireFormatLite::TYPE_BYTES: {
+      string* value =
+          MutableRaw<RepeatedPtrField<string> >(message, field.offset)->Add();
+      if (TypeOf(field) == WireFormatLite::TYPE_STRING) {
+        if (!WireFormatLite::ReadString(input, value)) return false;
+        WireFormat::VerifyUTF8String(value->data(), value->length(),
+                                     WireFormat::PARSE);
+        return true;
+      } else {
+        return WireFormatLite::ReadBytes(input, value);
+      }
+    }
+
+    case WireFormatLite::TYPE_GROUP:
+    case WireFormatLite::TYPE_MESSAGE: {
+      RepeatedPtrFieldBase* repeated =
+          MutableRaw<RepeatedPtrFieldBase>(message, field.offset);
+      Message* value =
+          repeated->AddFromCleared<GenericTypeHandler<Message> >();
+      if (value == NULL) {
+        value = field.prototype().New(repeated->arena());
+        repeated->UnsafeArenaAddAllocated<GenericTypeHandler<Message> >(value);
+      }
+      if (TypeOf(field) == WireFormatLite::TYPE_GROUP) {
+        return WireFormatLite::ReadGroup(FieldNumber(field), input, value);
+      } else {
+        return WireFormatLite::ReadMessage(input, value);
+      }
+    }
+  }
+
+  GOOGLE_LOG(FATAL) << "Can't get here.";
+  return false;
+}
+
+// ===================================================================
+// Serialization
+
+void TableInterpreter::SerializeWithCachedSizes(
+    const MessageTable& table, const Message& message,
+    io::CodedOutputStream* output) {
+  // Merge the fields and the extension ranges, both sorted by field number.
+  const TableField* field = table.fields;
+  const TableField* fields_end = field + table.field_count;
+  const int* range = table.extension_ranges;
+  const int* ranges_end = range + 2 * table.extension_range_count;
+  while (field < fields_end || range < ranges_end) {
+    if (range == ranges_end ||
+        (field < fields_end && FieldNumber(*field) < range[0])) {
+      SerializeField(table, *field++, message, output);
+    } else {
+      GetRaw<ExtensionSet>(message, table.extensions_offset)
+          .SerializeWithCachedSizes(range[0], range[1], output);
+      range += 2;
+    }
+  }
+
+  const UnknownFieldSet& unknown_fields =
+      GetRaw<UnknownFieldSet>(message, table.unknown_fields_offset);
+  if (!unknown_fields.empty()) {
+    WireFormat::SerializeUnknownFields(unknown_fields, output);
+  }
+}
+
+void TableInterpreter::SerializeField(const MessageTable& table,
+                                      const TableField& field,
+                                      const Message& message,
+                                      io::CodedOutputStream* output) {
+  int number = FieldNumber(field);
+
+  if (field.label == TableField::SINGULAR) {
+    if (!HasBit(table, message, field)) return;
+
+    switch (TypeOf(field)) {
+#define HANDLE_TYPE(TYPE, METHOD, CPPTYPE)                                  \
+      case WireFormatLite::TYPE_##TYPE:                                     \
+        WireFormatLite::Write##METHOD(                                      \
+            number, GetRaw<CPPTYPE>(message, field.offset), output);        \
+        break;
+      FOR_EACH_PRIMITIVE_TYPE(HANDLE_TYPE)
+      HANDLE_TYPE(ENUM, Enum, int)
+#undef HANDLE_TYPE
+
+      case WireFormatLite::TYPE_STRING: {
+        const string& value = *GetRaw<const string*>(message, field.offset);
+        WireFormat::VerifyUTF8String(value.data(), value.length(),
+                                     WireFormat::SERIALIZE);
+        WireFormatLite::WriteString(number, value, output);
+        break;
+      }
+      case WireFormatLite::TYPE_BYTES:
+        WireFormatLite::WriteBytes(
+            number, *GetRaw<const string*>(message, field.offset), output);
+        break;
+
+      case WireFormatLite::TYPE_GROUP:
+      case WireFormatLite::TYPE_MESSAGE: {
+        const Message* value = GetRaw<const Message*>(message, field.offset);
+        if (value == NULL) value = &field.prototype();
+        if (TypeOf(field) == WireFormatLite::TYPE_GROUP) {
+          WireFormatLite::WriteGroupMaybeToArray(number, *value, output);
+        } else {
+          WireFormatLite::WriteMessageMaybeToArray(number, *value, output);
+        }
+        break;
+      }
+    }
+    return;
+  }
+
+  switch (TypeOf(field)) {
+#define HANDLE_TYPE(TYPE, METHOD, CPPTYPE)                                  \
+    case WireFormatLite::TYPE_##TYPE: {                                     \
+      const RepeatedField<CPPTYPE>& values =                                \
+          GetRaw<RepeatedField<CPPTYPE> >(message, field.offset);           \
+      if (field.label == TableField::PACKED) {                              \
+        if (values.size() == 0) break;                                      \
+        WireFormatLite::WriteTag(                                           \
+            number, WireFormatLite::WIRETYPE_LENGTH_DELIMITED, output);     \
+        output->WriteVarint32(GetRaw<int>(message, field.has_bit));         \
+        for (int i = 0; i < values.size(); i++) {                           \
+          WireFormatLite::Write##METHOD##NoTag(values.Get(i), output);      \
+        }                                                                   \
+      } else {                                                              \
+        for (int i = 0; i < values.size(); i++) {                           \
+          WireFormatLite::Write##METHOD(number, values.Get(i), output);     \
+        }                                                                   \
+      }                                                                     \
+      break;                                                                \
+    }
+    FOR_EACH_PRIMITIVE_TYPE(HANDLE_TYPE)
+    HANDLE_TYPE(ENUM, Enum, int)
+#undef HANDLE_TYPE
+
+    case WireFormatLite::TYPE_STRING:
+    case WireFormatLite::TYPE_BYTES: {
+      const RepeatedPtrField<string>& values =
+          GetRaw<RepeatedPtrField<string> >(message, field.offset);
+      for (int i = 0; i < values.size(); i++) {
+        if (TypeOf(field) == WireFormatLite::TYPE_STRING) {
+          WireFormat::VerifyUTF8String(values.Get(i).data(),
+                                       values.Get(i).length(),
+                                       WireFormat::SERIALIZE);
+          WireFormatLite::WriteString(number, values.Get(i), output);
+        } else {
+          WireFormatLite::WriteBytes(number, values.Get(i), output);
+        }
+      }
+      break;
+    }
+
+    case WireFormatLite::TYPE_GROUP:
+    case WireFormatLite::TYPE_MESSAGE: {
+      const RepeatedPtrFieldBase& values =
+          GetRaw<RepeatedPtrFieldBase>(message, field.offset);
+      for (int i = 0; i < values.size(); i++) {
+        const Message& value = values.Get<GenericTypeHandler<Message> >(i);
+        if (TypeOf(field) == WireFormatLite::TYPE_GROUP) {
+          WireFormatLite::WriteGroupMaybeToArray(number, value, output);
+        } else {
+          WireFormatLite::WriteMessageMaybeToArray(number, value, output);
+        }
+      }
+      break;
+    }
+  }
+}
+
+uint8* TableInterpreter::SerializeWithCachedSizesToArray(
+    const MessageTable& table, const Message& message, uint8* target) {
+  const TableField* field = table.fields;
+  const TableField* fields_end = field + table.field_count;
+  const int* range = table.extension_ranges;
+  const int* ranges_end = range + 2 * table.extension_range_count;
+  while (field < fields_end || range < ranges_end) {
+    if (range == ranges_end ||
+        (field < fields_end && FieldNumber(*field) < range[0])) {
+      target = SerializeFieldToArray(table, *field++, message, target);
+    } else {
+      target = GetRaw<ExtensionSet>(message, table.extensions_offset)
+                   .SerializeWithCachedSizesToArray(range[0], range[1],
+                                                    target);
+      range += 2;
+    }
+  }
+
+  const UnknownFieldSet& unknown_fields =
+      GetRaw<UnknownFieldSet>(message, table.unknown_fields_offset);
+  if (!unknown_fields.empty()) {
+    target = WireFormat::SerializeUnknownFieldsToArray(unknown_fields, target);
+  }
+  return target;
+}
+
+uint8* TableInterpreter::SerializeFieldToArray(const MessageTable& table,
+                                               const TableField& field,
+                                               const Message& message,
+                                               uint8* target) {
+  int number = FieldNumber(field);
+
+  if (field.label == TableField::SINGULAR) {
+    if (!HasBit(table, message, field)) return target;
+
+    switch (TypeOf(field)) {
+#define HANDLE_TYPE(TYPE, METHOD, CPPTYPE)                                  \
+      case WireFormatLite::TYPE_##TYPE:                                     \
+        return WireFormatLite::Write##METHOD##ToArray(                      \
+            number, GetRaw<CPPTYPE>(message, field.offset), target);
+      FOR_EACH_PRIMITIVE_TYPE(HANDLE_TYPE)
+      HANDLE_TYPE(ENUM, Enum, int)
+#undef HANDLE_TYPE
+
+      case WireFormatLite::TYPE_STRING: {
+        const string& value = *GetRaw<const string*>(message, field.offset);
+        WireFormat::VerifyUTF8String(value.data(), value.length(),
+                                     WireFormat::SERIALIZE);
+        return WireFormatLite::WriteStringToArray(number, value, target);
+      }
+      case WireFormatLite::TYPE_BYTES:
+        return WireFormatLite::WriteBytesToArray(
+            number, *GetRaw<const string*>(message, field.offset), target);
+
+      case WireFormatLite::TYPE_GROUP:
+      case WireFormatLite::TYPE_MESSAGE: {
+        const Message* value = GetRaw<const Message*>(message, field.offset);
+        if (value == NULL) value = &field.prototype();
+        if (TypeOf(field) == WireFormatLite::TYPE_GROUP) {
+          return WireFormatLite::WriteGroupToArray(number, *value, target);
+        } else {
+          return WireFormatLite::WriteMessageToArray(number, *value, target);
+        }
+      }
+    }
+    GOOGLE_LOG(FATAL) << "Can't get here.";
+    return target;
+  }
+
+  switch (TypeOf(field)) {
+#define HANDLE_TYPE(TYPE, METHOD, CPPTYPE)                                  \
+    case WireFormatLite::TYPE_##TYPE: {                                     \
+      const RepeatedField<CPPTYPE>& values =                                \
+          GetRaw<RepeatedField<CPPTYPE> >(message, field.offset);           \
+      if (field.label == TableField::PACKED) {                              \
+        if (values.size() == 0) break;                                      \
+        target = WireFormatLite::WriteTagToArray(                           \
+            number, WireFormatLite::WIRETYPE_LENGTH_DELIMITED, target);     \
+        target = io::CodedOutputStream::WriteVarint32ToArray(               \
+            GetRaw<int>(message, field.has_bit), target);                   \
+        for (int i = 0; i < values.size(); i++) {                           \
+          target = WireFormatLite::Write##METHOD##NoTagToArray(             \
+              values.Get(i), target);                                       \
+        }                                                                   \
+      } else {                                                              \
+        for (int i = 0; i < values.size(); i++) {                           \
+          target = WireFormatLite::Write##METHOD##ToArray(                  \
+              number, values.Get(i), target);                               \
+        }                                                                   \
+      }                                                                     \
+      break;                                                                \
+    }
+    FOR_EACH_PRIMITIVE_TYPE(HANDLE_TYPE)
+    HANDLE_TYPE(ENUM, Enum, int)
+#undef HANDLE_TYPE
+
+    case WireFormatLite::TYPE_STRING:
+    case WireFormatLite::TYPE_BYTES: {
+      const RepeatedPtrField<string>& values =
+          GetRaw<RepeatedPtrField<string> >(message, field.offset);
+      for (int i = 0; i < values.size(); i++) {
+        if (TypeOf(field) == WireFormatLite::TYPE_STRING) {
+          WireFormat::VerifyUTF8String(values.Get(i).data(),
+                                       values.Get(i).length(),
+                                       WireFormat::SERIALIZE);
+          target =
+              WireFormatLite::WriteStringToArray(number, values.Get(i), target);
+        } else {
+          target =
+              WireFormatLite::WriteBytesToArray(number, values.Get(i), target);
+        }
+      }
+      break;
+    }
+
+    case WireFormatLite::TYPE_GROUP:
+    case WireFormatLite::TYPE_MESSAGE: {
+      const RepeatedPtrFieldBase& values =
+          GetRaw<RepeatedPtrFieldBase>(message, field.offset);
+      for (int i = 0; i < values.size(); i++) {
+        const Message& value = values.Get<GenericTypeHandler<Message> >(i);
+        if (TypeOf(field) == WireFormatLite::TYPE_GROUP) {
+          target = WireFormatLite::WriteGroupToArray(number, value, target);
+        } else {
+          target = WireFormatLite::WriteMessageToArray(number, value, target);
+        }
+      }
+      break;
+    }
+  }
+  return target;
+}
+
+// ===================================================================
+// Sizes
+
+int TableInterpreter::ByteSize(const MessageTable& table,
+                               const Message& message) {
+  int total_size = 0;
+  for (int i = 0; i < table.field_count; i++) {
+    total_size += FieldByteSize(table, table.fields[i], message);
+  }
+
+  if (table.extensions_offset != -1) {
+    total_size +=
+        GetRaw<ExtensionSet>(message, table.extensions_offset).ByteSize();
+  }
+
+  const UnknownFieldSet& unknown_fields =
+      GetRaw<UnknownFieldSet>(message, table.unknown_fields_offset);
+  if (!unknown_fields.empty()) {
+    total_size += WireFormat::ComputeUnknownFieldsSize(unknown_fields);
+  }
+
+  // See the comment on _cached_size_ in generated ByteSize() methods.
+  GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
+  *MutableRaw<int>(message, table.cached_size_offset) = total_size;
+  GOOGLE_SAFE_CONCURRENT_WRITES_END();
+  return total_size;
+}
+
+int TableInterpreter::FieldByteSize(const MessageTable& table,
+                                    const TableField& field,
+                                    const Message& message) {
+  if (field.label == TableField::SINGULAR &&
+      !HasBit(table, message, field)) {
+    return 0;
+  }
+  int tag_size = WireFormatLite::TagSize(FieldNumber(field), TypeOf(field));
+
+  if (field.label == TableField::SINGULAR) {
+
+    switch (TypeOf(field)) {
+#define HANDLE_TYPE(TYPE, METHOD, CPPTYPE)                                  \
+      case WireFormatLite::TYPE_##TYPE:                                     \
+        return tag_size + WireFormatLite::METHOD##Size(                     \
+            GetRaw<CPPTYPE>(message, field.offset));
+      HANDLE_TYPE( INT32,  Int32,  int32)
+      HANDLE_TYPE( INT64,  Int64,  int64)
+      HANDLE_TYPE(SINT32, SInt32,  int32)
+      HANDLE_TYPE(SINT64, SInt64,  int64)
+      HANDLE_TYPE(UINT32, UInt32, uint32)
+      HANDLE_TYPE(UINT64, UInt64, uint64)
+      HANDLE_TYPE(  ENUM,   Enum,    int)
+#undef HANDLE_TYPE
+
+#define HANDLE_TYPE(TYPE, METHOD)                                           \
+      case WireFormatLite::TYPE_##TYPE:                                     \
+        return tag_size + WireFormatLite::k##METHOD##Size;
+      HANDLE_TYPE( FIXED32,  Fixed32)
+      HANDLE_TYPE( FIXED64,  Fixed64)
+      HANDLE_TYPE(SFIXED32, SFixed32)
+      HANDLE_TYPE(SFIXED64, SFixed64)
+      HANDLE_TYPE(   FLOAT,    Float)
+      HANDLE_TYPE(  DOUBLE,   Double)
+      HANDLE_TYPE(    BOOL,     Bool)
+#undef HANDLE_TYPE
+
+      case WireFormatLite::TYPE_STRING:
+      case WireFormatLite::TYPE_BYTES:
+        return tag_size + WireFormatLite::StringSize(
+            *GetRaw<const string*>(message, field.offset));
+
+      case WireFormatLite::TYPE_GROUP:
+      case WireFormatLite::TYPE_MESSAGE: {
+        const Message* value = GetRaw<const Message*>(message, field.offset);
+        if (value == NULL) value = &field.prototype();
+        if (TypeOf(field) == WireFormatLite::TYPE_GROUP) {
+          return tag_size + WireFormatLite::GroupSize(*value);
+        } else {
+          return tag_size + WireFormatLite::MessageSize(*value);
+        }
+      }
+    }
+    GOOGLE_LOG(FATAL) << "Can't get here.";
+    return 0;
+  }
+
+  int count = 0;
+  int data_size = 0;
+  switch (TypeOf(field)) {
+#define HANDLE_TYPE(TYPE, METHOD, CPPTYPE)                                  \
+    case WireFormatLite::TYPE_##TYPE: {                                     \
+      const RepeatedField<CPPTYPE>& values =                                \
+          GetRaw<RepeatedField<CPPTYPE> >(message, field.offset);           \
+      count = values.size();                                                \
+      for (int i = 0; i < count; i++) {                                     \
+        data_size += WireFormatLite::METHOD##Size(values.Get(i));           \
+      }                                                                     \
+      break;                                                                \
+    }
+    HANDLE_TYPE( INT32,  Int32,  int32)
+    HANDLE_TYPE( INT64,  Int64,  int64)
+    HANDLE_TYPE(SINT32, SInt32,  int32)
+    HANDLE_TYPE(SINT64, SInt64,  int64)
+    HANDLE_TYPE(UINT32, UInt32, uint32)
+    HANDLE_TYPE(UINT64, UInt64, uint64)
+    HANDLE_TYPE(  ENUM,   Enum,    int)
+#undef HANDLE_TYPE
+
+#define HANDLE_TYPE(TYPE, METHOD, CPPTYPE)                                  \
+    case WireFormatLite::TYPE_##TYPE:                                       \
+      count = GetRaw<RepeatedField<CPPTYPE> >(message, field.offset).size(); \
+      data_size = count * WireFormatLite::k##METHOD##Size;                  \
+      break;
+    HANDLE_TYPE( FIXED32,  Fixed32, uint32)
+    HANDLE_TYPE( FIXED64,  Fixed64, uint64)
+    HANDLE_TYPE(SFIXED32, SFixed32,  int32)
+    HANDLE_TYPE(SFIXED64, SFixed64,  int64)
+    HANDLE_TYPE(   FLOAT,    Float,  float)
+    HANDLE_TYPE(  DOUBLE,   Double, double)
+    HANDLE_TYPE(    BOOL,     Bool,   bool)
+#undef HANDLE_TYPE
+
+    case WireFormatLite::TYPE_STRING:
+    case WireFormatLite::TYPE_BYTES: {
+      const RepeatedPtrField<string>& values =
+          GetRaw<RepeatedPtrField<string> >(message, field.offset);
+      count = values.size();
+      for (int i = 0; i < count; i++) {
+        data_size += WireFormatLite::StringSize(values.Get(i));
+      }
+      break;
+    }
+
+    case WireFormatLite::TYPE_GROUP:
+    case WireFormatLite::TYPE_MESSAGE: {
+      const RepeatedPtrFieldBase& values =
+          GetRaw<RepeatedPtrFieldBase>(message, field.offset);
+      count = values.size();
+      for (int i = 0; i < count; i++) {
+        const Message& value = values.Get<GenericTypeHandler<Message> >(i);
+        if (TypeOf(field) == WireFormatLite::TYPE_GROUP) {
+          data_size += WireFormatLite::GroupSize(value);
+        } else {
+          data_size += WireFormatLite::MessageSize(value);
+        }
+      }
+      break;
+    }
+  }
+
+  if (field.label == TableField::PACKED) {
+    GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
+    *MutableRaw<int>(message, field.has_bit) = data_size;
+    GOOGLE_SAFE_CONCURRENT_WRITES_END();
+    if (data_size == 0) return 0;
+    return tag_size + WireFormatLite::Int32Size(data_size) + data_size;
+  }
+  return tag_size * count + data_size;
+}
+
+#undef FOR_EACH_PRIMITIVE_TYPE
+
+}  // namespace internal
+}  // namespace protobuf
+}  // namespace google
@@ -0,0 +1,162 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// This header is logically internal, but is made public because it is used
+// from protocol-compiler-generated code, which may reside in other components.
+//
+// Messages in a file with "option optimize_for = TABLE_DRIVEN;" don't get
+// their own hand-unrolled parsing and serialization code.  Instead, each
+// gets a constant table describing its fields, and TableInterpreter parses,
+// sizes and serializes them all.  Generated code is much smaller that way,
+// and the one interpreter stays hot in the instruction cache.
+
+#ifndef GOOGLE_PROTOBUF_GENERATED_MESSAGE_TABLE_DRIVEN_H__
+#define GOOGLE_PROTOBUF_GENERATED_MESSAGE_TABLE_DRIVEN_H__
+
+#include <string>
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+
+// Defined in other files.
+namespace io {
+  class CodedInputStream;      // coded_stream.h
+  class CodedOutputStream;     // coded_stream.h
+}
+class Message;                 // message.h
+
+namespace internal {
+
+// Describes one field of a table-driven message.  Generated code defines
+// these as constant arrays, sorted by field number, so they are laid out by
+// the linker and need no initialization at run time.
+struct TableField {
+  enum Label {
+    SINGULAR = 0,    // Optional or required.
+    REPEATED = 1,
+    PACKED = 2,      // Repeated with [packed=true].
+  };
+
+  // The tag the field is written with.  For packed fields, that is the tag
+  // with WIRETYPE_LENGTH_DELIMITED.
+  uint32 tag;
+  // The field's WireFormatLite::FieldType.
+  uint8 type;
+  // The field's Label.
+  uint8 label;
+  // Offset of the field's member within the message.
+  int32 offset;
+  // For singular fields, the index of the field's bit in _has_bits_.  Packed
+  // fields have no has-bit, so for them this is the offset of the member
+  // caching the size of the packed data instead.
+  int32 has_bit;
+  // For string and bytes fields, the address of the static pointer to the
+  // field's default value, or NULL if the default is empty.
+  const ::std::string* const* default_value;
+  // For enum fields, the enum type's _IsValid() function.
+  bool (*enum_is_valid)(int value);
+  // For message and group fields, TablePrototype<FieldType>.
+  const Message& (*prototype)();
+};
+
+// Describes a table-driven message.
+struct MessageTable {
+  // The message's fields, sorted by number.  NULL if there are none.
+  const TableField* fields;
+  int field_count;
+
+  // The message's extension ranges as [start, end) pairs, sorted by start.
+  // NULL if there are none.
+  const int* extension_ranges;
+  int extension_range_count;
+
+  // Offsets within the message of _has_bits_, _cached_size_,
+  // _unknown_fields_, _extensions_ and _arena_.  The last two are -1 if the
+  // message has no extension ranges or its file doesn't enable arenas.
+  int has_bits_offset;
+  int cached_size_offset;
+  int unknown_fields_offset;
+  int extensions_offset;
+  int arena_offset;
+
+  // TablePrototype<MessageType>.
+  const Message& (*default_instance)();
+};
+
+// Tables refer to default instances through this rather than to
+// default_instance_ itself, which is private to each message class.
+template <typename Type>
+const Message& TablePrototype() {
+  return Type::default_instance();
+}
+
+// Implements the parsing and serialization methods of Message for
+// table-driven messages.  The generated methods just pass their table here.
+//
+// This class is really a namespace that contains only static methods.
+class LIBPROTOBUF_EXPORT TableInterpreter {
+ public:
+  static bool MergePartialFromCodedStream(const MessageTable& table,
+                                          Message* message,
+                                          io::CodedInputStream* input);
+  static void SerializeWithCachedSizes(const MessageTable& table,
+                                       const Message& message,
+                                       io::CodedOutputStream* output);
+  static uint8* SerializeWithCachedSizesToArray(const MessageTable& table,
+                                                const Message& message,
+                                                uint8* target);
+
+  // Also updates the message's cached size, and those of its packed fields.
+  static int ByteSize(const MessageTable& table, const Message& message);
+
+ private:
+  // Per-field parts of the above.  These need to be members so as to reach
+  // into RepeatedPtrFieldBase like GeneratedMessageReflection does.
+  static bool ParseField(const MessageTable& table, const TableField& field,
+                         Message* message, io::CodedInputStream* input);
+  static void SerializeField(const MessageTable& table,
+                             const TableField& field, const Message& message,
+                             io::CodedOutputStream* output);
+  static uint8* SerializeFieldToArray(const MessageTable& table,
+                                      const TableField& field,
+                                      const Message& message, uint8* target);
+  static int FieldByteSize(const MessageTable& table, const TableField& field,
+                           const Message& message);
+
+  // All methods are static.  No need to construct.
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(TableInterpreter);
+};
+
+}  // namespace internal
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_GENERATED_MESSAGE_TABLE_DRIVEN_H__
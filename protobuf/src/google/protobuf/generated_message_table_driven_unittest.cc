@@ -0,0 +1,220 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// The messages in unittest_table_driven.proto have the same fields as ones
+// in unittest.proto, so these tests check that the table-driven ones parse
+// and serialize exactly what the generated code of the others does.
+
+#include <google/protobuf/generated_message_table_driven.h>
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/test_util.h>
+#include <google/protobuf/unittest.pb.h>
+#include <google/protobuf/unittest_table_driven.pb.h>
+#include <google/protobuf/wire_format_lite.h>
+
+#include <google/protobuf/stubs/common.h>
+#include <google/protobuf/testing/googletest.h>
+#include <gtest/gtest.h>
+
+namespace google {
+namespace protobuf {
+namespace internal {
+namespace {
+
+TEST(TableDrivenTest, AllTypes) {
+  unittest::TestAllTypes message;
+  TestUtil::SetAllFields(&message);
+  string data = message.SerializeAsString();
+
+  unittest::TestTableDrivenAllTypes table_driven;
+  ASSERT_TRUE(table_driven.ParseFromString(data));
+  EXPECT_EQ(101, table_driven.optional_int32());
+  EXPECT_EQ("116", table_driven.optional_bytes());
+  EXPECT_EQ(117, table_driven.optionalgroup().a());
+  EXPECT_EQ(118, table_driven.optional_nested_message().bb());
+  EXPECT_EQ(unittest::TestTableDrivenAllTypes::BAZ,
+            table_driven.optional_nested_enum());
+  ASSERT_EQ(2, table_driven.repeated_string_size());
+  EXPECT_EQ("315", table_driven.repeated_string(1));
+  ASSERT_EQ(2, table_driven.repeated_foreign_message_size());
+  EXPECT_EQ(319, table_driven.repeated_foreign_message(1).c());
+  EXPECT_EQ("416", table_driven.default_bytes());
+  EXPECT_EQ(0, table_driven.unknown_fields().field_count());
+
+  EXPECT_EQ(data.size(), table_driven.ByteSize());
+  EXPECT_EQ(data, table_driven.SerializeAsString());
+
+  unittest::TestAllTypes parsed;
+  ASSERT_TRUE(parsed.ParseFromString(table_driven.SerializeAsString()));
+  TestUtil::ExpectAllFieldsSet(parsed);
+}
+
+TEST(TableDrivenTest, ParseAgain) {
+  // Parsing again reuses cleared elements of the repeated message fields.
+  unittest::TestAllTypes message;
+  TestUtil::SetAllFields(&message);
+  string data = message.SerializeAsString();
+
+  unittest::TestTableDrivenAllTypes table_driven;
+  ASSERT_TRUE(table_driven.ParseFromString(data));
+  ASSERT_TRUE(table_driven.ParseFromString(data));
+  EXPECT_EQ(data, table_driven.SerializeAsString());
+
+  TestUtil::ModifyRepeatedFields(&message);
+  data = message.SerializeAsString();
+  ASSERT_TRUE(table_driven.ParseFromString(data));
+  EXPECT_EQ(data, table_driven.SerializeAsString());
+}
+
+TEST(TableDrivenTest, Defaults) {
+  unittest::TestTableDrivenAllTypes table_driven;
+  EXPECT_EQ(0, table_driven.ByteSize());
+  EXPECT_EQ("", table_driven.SerializeAsString());
+
+  // Parsing a string field with a default must not overwrite the default.
+  unittest::TestAllTypes message;
+  message.set_default_string("parsed");
+  ASSERT_TRUE(table_driven.ParseFromString(message.SerializeAsString()));
+  EXPECT_EQ("parsed", table_driven.default_string());
+  EXPECT_EQ("hello",
+            unittest::TestTableDrivenAllTypes::default_instance()
+                .default_string());
+  EXPECT_EQ("hello", unittest::TestTableDrivenAllTypes().default_string());
+
+  // A sub-message that is set but empty is still written.
+  table_driven.Clear();
+  table_driven.mutable_optional_nested_message();
+  message.Clear();
+  message.mutable_optional_nested_message();
+  EXPECT_EQ(message.SerializeAsString(), table_driven.SerializeAsString());
+}
+
+TEST(TableDrivenTest, UnknownFields) {
+  string data;
+  {
+    io::StringOutputStream raw_output(&data);
+    io::CodedOutputStream output(&raw_output);
+    // An undefined value of optional_nested_enum and repeated_nested_enum,
+    // and a field TestTableDrivenAllTypes doesn't have.
+    WireFormatLite::WriteEnum(21, 10, &output);
+    WireFormatLite::WriteEnum(51, 2, &output);
+    WireFormatLite::WriteEnum(51, 11, &output);
+    WireFormatLite::WriteString(1000, "unknown", &output);
+  }
+
+  unittest::TestTableDrivenAllTypes table_driven;
+  ASSERT_TRUE(table_driven.ParseFromString(data));
+  EXPECT_FALSE(table_driven.has_optional_nested_enum());
+  ASSERT_EQ(1, table_driven.repeated_nested_enum_size());
+  EXPECT_EQ(unittest::TestTableDrivenAllTypes::BAR,
+            table_driven.repeated_nested_enum(0));
+  ASSERT_EQ(3, table_driven.unknown_fields().field_count());
+  EXPECT_EQ(10, table_driven.unknown_fields().field(0).varint());
+  EXPECT_EQ(11, table_driven.unknown_fields().field(1).varint());
+  EXPECT_EQ("unknown",
+            table_driven.unknown_fields().field(2).length_delimited());
+
+  // Unknown fields go last.
+  unittest::TestAllTypes message;
+  ASSERT_TRUE(message.ParseFromString(data));
+  EXPECT_EQ(message.SerializeAsString(), table_driven.SerializeAsString());
+}
+
+TEST(TableDrivenTest, PackedTypes) {
+  unittest::TestPackedTypes packed;
+  TestUtil::SetPackedFields(&packed);
+  unittest::TestUnpackedTypes unpacked;
+  TestUtil::SetUnpackedFields(&unpacked);
+
+  unittest::TestTableDrivenPackedTypes table_driven_packed;
+  ASSERT_TRUE(table_driven_packed.ParseFromString(packed.SerializeAsString()));
+  EXPECT_EQ(packed.ByteSize(), table_driven_packed.ByteSize());
+  EXPECT_EQ(packed.SerializeAsString(),
+            table_driven_packed.SerializeAsString());
+
+  unittest::TestTableDrivenUnpackedTypes table_driven_unpacked;
+  ASSERT_TRUE(
+      table_driven_unpacked.ParseFromString(unpacked.SerializeAsString()));
+  EXPECT_EQ(unpacked.SerializeAsString(),
+            table_driven_unpacked.SerializeAsString());
+}
+
+TEST(TableDrivenTest, PackedAndUnpackedAreCompatible) {
+  unittest::TestPackedTypes packed;
+  TestUtil::SetPackedFields(&packed);
+  unittest::TestUnpackedTypes unpacked;
+  TestUtil::SetUnpackedFields(&unpacked);
+
+  unittest::TestTableDrivenPackedTypes table_driven_packed;
+  ASSERT_TRUE(
+      table_driven_packed.ParseFromString(unpacked.SerializeAsString()));
+  EXPECT_EQ(packed.SerializeAsString(),
+            table_driven_packed.SerializeAsString());
+
+  unittest::TestTableDrivenUnpackedTypes table_driven_unpacked;
+  ASSERT_TRUE(
+      table_driven_unpacked.ParseFromString(packed.SerializeAsString()));
+  EXPECT_EQ(unpacked.SerializeAsString(),
+            table_driven_unpacked.SerializeAsString());
+}
+
+TEST(TableDrivenTest, FieldOrderings) {
+  unittest::TestTableDrivenFieldOrderings message;
+  message.set_my_int(1);
+  message.set_my_string("foo");
+  message.set_my_float(1.0);
+  message.SetExtension(unittest::table_driven_extension_int, 23);
+  message.SetExtension(unittest::table_driven_extension_string, "bar");
+
+  string data = message.SerializeAsString();
+  EXPECT_EQ(data.size(), message.ByteSize());
+  TestUtil::ExpectAllFieldsAndExtensionsInOrder(data);
+
+  unittest::TestTableDrivenFieldOrderings parsed;
+  ASSERT_TRUE(parsed.ParseFromString(data));
+  EXPECT_EQ(23, parsed.GetExtension(unittest::table_driven_extension_int));
+  EXPECT_EQ("bar",
+            parsed.GetExtension(unittest::table_driven_extension_string));
+  EXPECT_EQ(0, parsed.unknown_fields().field_count());
+  EXPECT_EQ(data, parsed.SerializeAsString());
+}
+
+TEST(TableDrivenTest, MessageSet) {
+  unittest::TestTableDrivenMessageSet message_set;
+  EXPECT_TRUE(message_set.ParseFromString(""));
+  EXPECT_EQ(0, message_set.ByteSize());
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace protobuf
+}  // namespace google
@@ -852,6 +852,39 @@ int CodedOutputStream::VarintSize64(uint64 value) {
   }
 }
 
+// ===================================================================
+
+ReverseCodedOutputStream::ReverseCodedOutputStream()
+  : buffer_(NULL),
+    position_(NULL),
+    end_(NULL) {
+}
+
+ReverseCodedOutputStream::~ReverseCodedOutputStream() {
+  delete [] buffer_;
+}
+
+void ReverseCodedOutputStream::Grow(int size) {
+  int used = ByteCount();
+  int capacity = max(static_cast<int>(end_ - buffer_), kMinimumBufferSize);
+  while (capacity - used < size) {
+    GOOGLE_CHECK_LE(capacity, kint32max / 2)
+      << "ReverseCodedOutputStream would grow past 2GB.";
+    capacity *= 2;
+  }
+
+  uint8* new_buffer = new uint8[capacity];
+  uint8* new_end = new_buffer + capacity;
+  if (used > 0) {
+    memcpy(new_end - used, position_, used);
+  }
+  delete [] buffer_;
+
+  buffer_ = new_buffer;
+  end_ = new_end;
+  position_ = new_end - used;
+}
+
 }  // namespace io
 }  // namespace protobuf
 }  // namespace google
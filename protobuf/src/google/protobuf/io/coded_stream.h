@@ -141,6 +141,7 @@ namespace io {
 // Defined in this file.
 class CodedInputStream;
 class CodedOutputStream;
+class ReverseCodedOutputStream;
 
 // Defined in other files.
 class ZeroCopyInputStream;           // zero_copy_stream.h
@@ -208,6 +209,13 @@ class LIBPROTOBUF_EXPORT CodedInputStream {
   inline bool InternalReadStringInline(string* buffer,
                                        int size) GOOGLE_ATTRIBUTE_ALWAYS_INLINE;
 
+  // Allows fields with [ctype = STRING_PIECE] parsed from this stream to
+  // point into its buffer instead of copying their values.  This only takes
+  // effect when reading from a flat array, which the caller must then keep
+  // alive and unchanged for as long as the parsed messages are used.  Off by
+  // default.
+  void EnableAliasing(bool enabled) { aliasing_enabled_ = enabled; }
+  bool aliasing_enabled() const { return aliasing_enabled_; }
 
   // Read a 32-bit little-endian integer.
   bool ReadLittleEndian32(uint32* value);
@@ -750,6 +758,66 @@ class LIBPROTOBUF_EXPORT CodedOutputStream {
   static int VarintSize32Fallback(uint32 value);
 };
 
+// Writes binary data back to front, into a buffer that grows downward.  Each
+// Write*() call puts one complete value, encoded as CodedOutputStream would
+// encode it, in front of everything written so far; only the order of the
+// calls is reversed.
+//
+// Writing a message this way, last field first, means an embedded message is
+// written before its length is needed, and the length is just the number of
+// bytes the message took.  MessageLite::SerializeReverse() relies on this to
+// serialize a tree in a single walk, without the ByteSize() pass that
+// CodedOutputStream needs:
+//
+//   ReverseCodedOutputStream output;
+//   output.WriteString(text);               // comes last
+//   output.WriteVarint32(text.size());
+//   output.WriteLittleEndian32(magic_number);  // comes first
+//   string result(reinterpret_cast<const char*>(output.data()),
+//                 output.ByteCount());
+//
+// The buffer is on the heap and doubles whenever it fills up.
+class LIBPROTOBUF_EXPORT ReverseCodedOutputStream {
+ public:
+  ReverseCodedOutputStream();
+  ~ReverseCodedOutputStream();
+
+  // The bytes written so far, in order.  Valid until the next write.
+  const uint8* data() const { return position_; }
+  // Returns the number of bytes written so far.
+  int ByteCount() const { return static_cast<int>(end_ - position_); }
+
+  // Makes room for "size" bytes in front of those written so far and returns
+  // a pointer to them.  The caller must fill them in, for instance with the
+  // *ToArray methods of CodedOutputStream.
+  inline uint8* Reserve(int size);
+
+  // Drops everything written, keeping the buffer for reuse.
+  void Clear() { position_ = end_; }
+
+  inline void WriteRaw(const void* buffer, int size);
+  inline void WriteString(const string& str);
+  inline void WriteLittleEndian32(uint32 value);
+  inline void WriteLittleEndian64(uint64 value);
+  inline void WriteVarint32(uint32 value);
+  inline void WriteVarint64(uint64 value);
+  inline void WriteVarint32SignExtended(int32 value);
+  inline void WriteTag(uint32 value);
+
+ private:
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(ReverseCodedOutputStream);
+
+  static const int kMinimumBufferSize = 256;
+
+  uint8* buffer_;    // start of the buffer
+  uint8* position_;  // first byte written; writes move it down
+  uint8* end_;       // end of the buffer, and of the data
+
+  // Reallocates the buffer so that at least "size" more bytes fit in front
+  // of the data, which moves to the end of the new buffer.
+  void Grow(int size);
+};
+
 // inline methods ====================================================
 // The vast majority of varints are only one byte.  These inline
 // methods optimize for that case.
@@ -1047,6 +1115,56 @@ inline void CodedOutputStream::Advance(int amount) {
   buffer_size_ -= amount;
 }
 
+inline uint8* ReverseCodedOutputStream::Reserve(int size) {
+  if (position_ - buffer_ < size) {
+    Grow(size);
+  }
+  position_ -= size;
+  return position_;
+}
+
+inline void ReverseCodedOutputStream::WriteRaw(const void* buffer, int size) {
+  CodedOutputStream::WriteRawToArray(buffer, size, Reserve(size));
+}
+
+inline void ReverseCodedOutputStream::WriteString(const string& str) {
+  WriteRaw(str.data(), static_cast<int>(str.size()));
+}
+
+inline void ReverseCodedOutputStream::WriteLittleEndian32(uint32 value) {
+  CodedOutputStream::WriteLittleEndian32ToArray(value, Reserve(sizeof(value)));
+}
+
+inline void ReverseCodedOutputStream::WriteLittleEndian64(uint64 value) {
+  CodedOutputStream::WriteLittleEndian64ToArray(value, Reserve(sizeof(value)));
+}
+
+inline void ReverseCodedOutputStream::WriteVarint32(uint32 value) {
+  if (value < (1 << 7)) {
+    *Reserve(1) = static_cast<uint8>(value);
+  } else {
+    CodedOutputStream::WriteVarint32ToArray(
+        value, Reserve(CodedOutputStream::VarintSize32(value)));
+  }
+}
+
+inline void ReverseCodedOutputStream::WriteVarint64(uint64 value) {
+  CodedOutputStream::WriteVarint64ToArray(
+      value, Reserve(CodedOutputStream::VarintSize64(value)));
+}
+
+inline void ReverseCodedOutputStream::WriteVarint32SignExtended(int32 value) {
+  if (value < 0) {
+    WriteVarint64(static_cast<uint64>(value));
+  } else {
+    WriteVarint32(static_cast<uint32>(value));
+  }
+}
+
+inline void ReverseCodedOutputStream::WriteTag(uint32 value) {
+  WriteVarint32(value);
+}
+
 inline void CodedInputStream::SetRecursionLimit(int limit) {
   recursion_limit_ = limit;
 }
@@ -1182,6 +1182,125 @@ TEST_F(CodedStreamTest, InputOver2G) {
   EXPECT_EQ(0, errors.size());
 }
 
+// -------------------------------------------------------------------
+// ReverseCodedOutputStream tests.
+
+TEST_1D(CodedStreamTest, ReverseWriteVarint64, kVarintCases) {
+  ReverseCodedOutputStream output;
+  output.WriteVarint64(kVarintCases_case.value);
+
+  ASSERT_EQ(kVarintCases_case.size, output.ByteCount());
+  EXPECT_EQ(0, memcmp(output.data(), kVarintCases_case.bytes,
+                      kVarintCases_case.size));
+}
+
+TEST_1D(CodedStreamTest, ReverseWriteVarint32, kVarintCases) {
+  if (kVarintCases_case.value > ULL(0x00000000FFFFFFFF)) {
+    // Skip this test for the 64-bit values.
+    return;
+  }
+
+  ReverseCodedOutputStream output;
+  output.WriteVarint32(static_cast<uint32>(kVarintCases_case.value));
+
+  ASSERT_EQ(kVarintCases_case.size, output.ByteCount());
+  EXPECT_EQ(0, memcmp(output.data(), kVarintCases_case.bytes,
+                      kVarintCases_case.size));
+}
+
+TEST_1D(CodedStreamTest, ReverseWriteLittleEndian32, kFixed32Cases) {
+  ReverseCodedOutputStream output;
+  output.WriteLittleEndian32(kFixed32Cases_case.value);
+
+  ASSERT_EQ(sizeof(uint32), output.ByteCount());
+  EXPECT_EQ(0, memcmp(output.data(), kFixed32Cases_case.bytes,
+                      sizeof(uint32)));
+}
+
+TEST_1D(CodedStreamTest, ReverseWriteLittleEndian64, kFixed64Cases) {
+  ReverseCodedOutputStream output;
+  output.WriteLittleEndian64(kFixed64Cases_case.value);
+
+  ASSERT_EQ(sizeof(uint64), output.ByteCount());
+  EXPECT_EQ(0, memcmp(output.data(), kFixed64Cases_case.bytes,
+                      sizeof(uint64)));
+}
+
+TEST_1D(CodedStreamTest, ReverseWriteVarint32SignExtended,
+        kSignExtendedVarintCases) {
+  ReverseCodedOutputStream output;
+  output.WriteVarint32SignExtended(kSignExtendedVarintCases_case);
+
+  uint8 expected[10];
+  int size = CodedOutputStream::WriteVarint32SignExtendedToArray(
+      kSignExtendedVarintCases_case, expected) - expected;
+  ASSERT_EQ(size, output.ByteCount());
+  EXPECT_EQ(0, memcmp(output.data(), expected, size));
+}
+
+TEST_F(CodedStreamTest, ReverseWritesComeOutInFront) {
+  // Writes the same data as the CodedOutputStream example at the top of
+  // coded_stream.h, backwards.
+  ReverseCodedOutputStream output;
+  string text = "Hello world!";
+  output.WriteString(text);
+  output.WriteVarint32(text.size());
+  output.WriteLittleEndian32(1234);
+
+  string expected;
+  {
+    StringOutputStream string_output(&expected);
+    CodedOutputStream coded_output(&string_output);
+    coded_output.WriteLittleEndian32(1234);
+    coded_output.WriteVarint32(text.size());
+    coded_output.WriteString(text);
+  }
+  EXPECT_EQ(expected,
+            string(reinterpret_cast<const char*>(output.data()),
+                   output.ByteCount()));
+}
+
+TEST_F(CodedStreamTest, ReverseGrowKeepsData) {
+  ReverseCodedOutputStream output;
+  EXPECT_EQ(0, output.ByteCount());
+
+  // Enough to grow the buffer several times, one byte at a time...
+  for (int i = 0; i < 5000; i++) {
+    uint8 byte = static_cast<uint8>(i);
+    output.WriteRaw(&byte, 1);
+  }
+  // ...and then by more than it holds at once.
+  string big(100000, 'x');
+  output.WriteString(big);
+
+  ASSERT_EQ(105000, output.ByteCount());
+  EXPECT_EQ(big, string(reinterpret_cast<const char*>(output.data()),
+                        big.size()));
+  for (int i = 0; i < 5000; i++) {
+    EXPECT_EQ(static_cast<uint8>(4999 - i), output.data()[big.size() + i]);
+  }
+
+  output.Clear();
+  EXPECT_EQ(0, output.ByteCount());
+  output.WriteVarint32(1);
+  ASSERT_EQ(1, output.ByteCount());
+  EXPECT_EQ(1, output.data()[0]);
+}
+
+TEST_F(CodedStreamTest, ReverseReserve) {
+  ReverseCodedOutputStream output;
+  output.WriteVarint32(3);
+  uint8* target = output.Reserve(2);
+  target[0] = 1;
+  target[1] = 2;
+
+  ASSERT_EQ(3, output.ByteCount());
+  EXPECT_EQ(target, output.data());
+  EXPECT_EQ(1, output.data()[0]);
+  EXPECT_EQ(2, output.data()[1]);
+  EXPECT_EQ(3, output.data()[2]);
+}
+
 // ===================================================================
 
 
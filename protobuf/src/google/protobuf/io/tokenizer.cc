@@ -95,6 +95,11 @@
 #include <google/protobuf/stubs/strutil.h>
 #include <google/protobuf/stubs/stl_util.h>
 
+#if defined(__SSE2__) && defined(__GNUC__)
+#define GOOGLE_PROTOBUF_TOKENIZER_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace google {
 namespace protobuf {
 namespace io {
@@ -147,6 +152,105 @@ CHARACTER_CLASS(Escape, c == 'a' || c == 'b' || c == 'f' || c == 'n' ||
 
 #undef CHARACTER_CLASS
 
+// Scanning helpers.  RunLength<CharacterClass>() returns the number of
+// leading characters of data[0, size) in the class; FindAny() returns the
+// index of the first occurrence of any of four characters, or size.  Most
+// of a large input is identifiers, whitespace, comments and string bodies,
+// so with SSE2 these examine sixteen bytes at a time.
+
+template<typename CharacterClass>
+inline int ScalarRunLength(const char* data, int start, int size) {
+  while (start < size && CharacterClass::InClass(data[start])) ++start;
+  return start;
+}
+
+#ifdef GOOGLE_PROTOBUF_TOKENIZER_SSE2
+
+inline __m128i LoadChunk(const char* data) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+}
+
+// Mask of the bytes of chunk in (low, high).  Bytes >= 0x80 compare as
+// negative and so are never in range.
+inline __m128i InRange(__m128i chunk, char low, char high) {
+  return _mm_and_si128(_mm_cmpgt_epi8(chunk, _mm_set1_epi8(low)),
+                       _mm_cmplt_epi8(chunk, _mm_set1_epi8(high)));
+}
+
+inline __m128i Equal(__m128i chunk, char c) {
+  return _mm_cmpeq_epi8(chunk, _mm_set1_epi8(c));
+}
+
+// One bit per byte of the chunk, set if the byte is in the class.
+template<typename CharacterClass> struct ChunkClass;
+
+template<> struct ChunkClass<Whitespace> {
+  static inline int Mask(__m128i chunk) {
+    // '\t', '\n', '\v', '\f' and '\r' are 9 through 13.
+    return _mm_movemask_epi8(
+        _mm_or_si128(InRange(chunk, 8, 14), Equal(chunk, ' ')));
+  }
+};
+
+template<> struct ChunkClass<Alphanumeric> {
+  static inline int Mask(__m128i chunk) {
+    // Setting bit 5 folds upper case letters onto lower case.
+    __m128i lower = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+    return _mm_movemask_epi8(_mm_or_si128(
+        _mm_or_si128(InRange(lower, 'a' - 1, 'z' + 1),
+                     InRange(chunk, '0' - 1, '9' + 1)),
+        Equal(chunk, '_')));
+  }
+};
+
+template<typename CharacterClass>
+inline int ChunkRunLength(const char* data, int size) {
+  int i = 0;
+  for (; i + 16 <= size; i += 16) {
+    int mask = ChunkClass<CharacterClass>::Mask(LoadChunk(data + i));
+    if (mask != 0xffff) return i + __builtin_ctz(~mask);
+  }
+  return ScalarRunLength<CharacterClass>(data, i, size);
+}
+
+#endif  // GOOGLE_PROTOBUF_TOKENIZER_SSE2
+
+template<typename CharacterClass>
+inline int RunLength(const char* data, int size) {
+  return ScalarRunLength<CharacterClass>(data, 0, size);
+}
+
+#ifdef GOOGLE_PROTOBUF_TOKENIZER_SSE2
+template<>
+inline int RunLength<Whitespace>(const char* data, int size) {
+  return ChunkRunLength<Whitespace>(data, size);
+}
+
+template<>
+inline int RunLength<Alphanumeric>(const char* data, int size) {
+  return ChunkRunLength<Alphanumeric>(data, size);
+}
+#endif  // GOOGLE_PROTOBUF_TOKENIZER_SSE2
+
+inline int FindAny(const char* data, int size,
+                   char a, char b, char c, char d) {
+  int i = 0;
+#ifdef GOOGLE_PROTOBUF_TOKENIZER_SSE2
+  for (; i + 16 <= size; i += 16) {
+    __m128i chunk = LoadChunk(data + i);
+    int mask = _mm_movemask_epi8(
+        _mm_or_si128(_mm_or_si128(Equal(chunk, a), Equal(chunk, b)),
+                     _mm_or_si128(Equal(chunk, c), Equal(chunk, d))));
+    if (mask != 0) return i + __builtin_ctz(mask);
+  }
+#endif  // GOOGLE_PROTOBUF_TOKENIZER_SSE2
+  for (; i < size; ++i) {
+    char x = data[i];
+    if (x == a || x == b || x == c || x == d) return i;
+  }
+  return size;
+}
+
 // Given a char, interpret it as a numeric digit and return its value.
 // This supports any number base up to 36.
 inline int DigitValue(char digit) {
@@ -237,6 +341,47 @@ void Tokenizer::NextChar() {
   }
 }
 
+void Tokenizer::AdvanceTo(int end) {
+  const char* p = buffer_ + buffer_pos_;
+  const char* limit = buffer_ + end;
+
+  // Same bookkeeping as NextChar(), but runs without newlines or tabs
+  // only move the column.
+  while (p < limit) {
+#ifdef GOOGLE_PROTOBUF_TOKENIZER_SSE2
+    if (limit - p >= 16) {
+      __m128i chunk = LoadChunk(p);
+      int mask = _mm_movemask_epi8(
+          _mm_or_si128(Equal(chunk, '\n'), Equal(chunk, '\t')));
+      if (mask == 0) {
+        column_ += 16;
+        p += 16;
+        continue;
+      }
+      int skip = __builtin_ctz(mask);
+      column_ += skip;
+      p += skip;
+    }
+#endif  // GOOGLE_PROTOBUF_TOKENIZER_SSE2
+    if (*p == '\n') {
+      ++line_;
+      column_ = 0;
+    } else if (*p == '\t') {
+      column_ += kTabWidth - column_ % kTabWidth;
+    } else {
+      ++column_;
+    }
+    ++p;
+  }
+
+  buffer_pos_ = end;
+  if (buffer_pos_ < buffer_size_) {
+    current_char_ = buffer_[buffer_pos_];
+  } else {
+    Refresh();
+  }
+}
+
 void Tokenizer::Refresh() {
   if (read_error_) {
     current_char_ = '\0';
@@ -326,8 +471,11 @@ inline bool Tokenizer::TryConsume(char c) {
 
 template<typename CharacterClass>
 inline void Tokenizer::ConsumeZeroOrMore() {
+  // No class contains '\0', so while current_char_ is in the class it is
+  // inside the buffer and the rest of the run can be scanned in place.
   while (CharacterClass::InClass(current_char_)) {
-    NextChar();
+    AdvanceTo(buffer_pos_ + RunLength<CharacterClass>(
+        buffer_ + buffer_pos_, buffer_size_ - buffer_pos_));
   }
 }
 
@@ -336,9 +484,7 @@ inline void Tokenizer::ConsumeOneOrMore(const char* error) {
   if (!CharacterClass::InClass(current_char_)) {
     AddError(error);
   } else {
-    do {
-      NextChar();
-    } while (CharacterClass::InClass(current_char_));
+    ConsumeZeroOrMore<CharacterClass>();
   }
 }
 
@@ -401,7 +547,10 @@ void Tokenizer::ConsumeString(char delimiter) {
           NextChar();
           return;
         }
-        NextChar();
+        // Skip to the next character that needs a look.
+        int start = buffer_pos_ + 1;
+        AdvanceTo(start + FindAny(buffer_ + start, buffer_size_ - start,
+                                  delimiter, '\\', '\n', '\0'));
         break;
       }
     }
@@ -467,7 +616,9 @@ void Tokenizer::ConsumeLineComment(string* content) {
   if (content != NULL) RecordTo(content);
 
   while (current_char_ != '\0' && current_char_ != '\n') {
-    NextChar();
+    AdvanceTo(buffer_pos_ + FindAny(buffer_ + buffer_pos_,
+                                    buffer_size_ - buffer_pos_,
+                                    '\0', '\n', '\0', '\n'));
   }
   TryConsume('\n');
 
@@ -485,7 +636,9 @@ void Tokenizer::ConsumeBlockComment(string* content) {
            current_char_ != '*' &&
            current_char_ != '/' &&
            current_char_ != '\n') {
-      NextChar();
+      AdvanceTo(buffer_pos_ + FindAny(buffer_ + buffer_pos_,
+                                      buffer_size_ - buffer_pos_,
+                                      '\0', '*', '/', '\n'));
     }
 
     if (TryConsume('\n')) {
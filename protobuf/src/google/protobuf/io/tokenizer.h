@@ -269,6 +269,11 @@ class LIBPROTOBUF_EXPORT Tokenizer {
   // Consume this character and advance to the next one.
   void NextChar();
 
+  // Consume the characters from the current one up to, but not including,
+  // buffer_[end], where end <= buffer_size_.  Like NextChar(), refreshes
+  // the buffer if that consumes all of it.
+  void AdvanceTo(int end);
+
   // Read a new buffer from the input.
   void Refresh();
 
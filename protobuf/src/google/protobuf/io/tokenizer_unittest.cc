@@ -511,6 +511,51 @@ TEST_1D(TokenizerTest, ShCommentStyle, kBlockSizes) {
   EXPECT_TRUE(error_collector.text_.empty());
 }
 
+TEST_1D(TokenizerTest, LongRuns, kBlockSizes) {
+  // Runs long enough to be scanned in chunks, split across buffers at
+  // every block size.
+
+  string identifier;
+  for (int i = 0; i < 4; i++) identifier += "Abc_xyz_0123456789";
+  string literal = "\"";
+  for (int i = 0; i < 5; i++) literal += "hello, world ";
+  literal += "\\n\\\"tail\"";
+
+  string text = identifier + "  \t  " + string(40, ' ') + "\n" +
+                "\t" + literal + " // " + string(50, 'x') + "\n" +
+                "/* " + string(40, 'y') + "\n" +
+                " * " + string(40, 'z') + " */ next";
+
+  // Set up the tokenizer.
+  TestInputStream input(text.data(), text.size(), kBlockSizes_case);
+  TestErrorCollector error_collector;
+  Tokenizer tokenizer(&input, &error_collector);
+
+  ASSERT_TRUE(tokenizer.Next());
+  EXPECT_EQ(Tokenizer::TYPE_IDENTIFIER, tokenizer.current().type);
+  EXPECT_EQ(identifier, tokenizer.current().text);
+  EXPECT_EQ(0, tokenizer.current().line);
+  EXPECT_EQ(0, tokenizer.current().column);
+  EXPECT_EQ(identifier.size(), tokenizer.current().end_column);
+
+  ASSERT_TRUE(tokenizer.Next());
+  EXPECT_EQ(Tokenizer::TYPE_STRING, tokenizer.current().type);
+  EXPECT_EQ(literal, tokenizer.current().text);
+  EXPECT_EQ(1, tokenizer.current().line);
+  EXPECT_EQ(8, tokenizer.current().column);
+  EXPECT_EQ(8 + literal.size(), tokenizer.current().end_column);
+
+  ASSERT_TRUE(tokenizer.Next());
+  EXPECT_EQ("next", tokenizer.current().text);
+  EXPECT_EQ(3, tokenizer.current().line);
+  EXPECT_EQ(47, tokenizer.current().column);
+
+  // There should be no more input.
+  EXPECT_FALSE(tokenizer.Next());
+  // There should be no errors.
+  EXPECT_TRUE(error_collector.text_.empty());
+}
+
 #endif
 
 // -------------------------------------------------------------------
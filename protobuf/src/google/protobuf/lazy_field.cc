@@ -0,0 +1,273 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <google/protobuf/lazy_field.h>
+
+#include <algorithm>
+#include <google/protobuf/stubs/once.h>
+#include <google/protobuf/arena.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/generated_message_util.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/message.h>
+#include <google/protobuf/wire_format_lite_inl.h>
+
+namespace google {
+namespace protobuf {
+namespace internal {
+
+namespace {
+
+// Serializes first accesses to lazy fields from const methods, which may
+// happen on several threads at once.  Parsing is slow anyway, so one lock
+// for all fields is enough.
+Mutex* parse_mutex_ = NULL;
+GOOGLE_PROTOBUF_DECLARE_ONCE(parse_mutex_init_);
+
+void DeleteParseMutex() {
+  delete parse_mutex_;
+}
+
+void InitParseMutex() {
+  parse_mutex_ = new Mutex;
+  OnShutdown(&DeleteParseMutex);
+}
+
+}  // namespace
+
+bool IsLazyField(const FieldDescriptor* field) {
+  return field->options().lazy() &&
+         field->type() == FieldDescriptor::TYPE_MESSAGE &&
+         !field->is_repeated() && !field->is_extension() &&
+         field->file()->options().optimize_for() == FileOptions::SPEED;
+}
+
+void LazyField::Destroy() {
+  delete message_;
+  delete bytes_;
+  message_ = NULL;
+  bytes_ = NULL;
+}
+
+void LazyField::InitAsDefaultInstance(const Message* prototype) {
+  message_ = const_cast<Message*>(prototype);
+}
+
+// Get() reads message_ without the lock, so the pointer is published with
+// release semantics once the message is fully parsed.
+inline const Message* LazyField::LoadMessage() const {
+#ifdef GOOGLE_PROTOBUF_NO_THREAD_SAFETY
+  return message_;
+#else
+  return reinterpret_cast<const Message*>(Acquire_Load(
+      reinterpret_cast<const volatile AtomicWord*>(&message_)));
+#endif
+}
+
+const Message& LazyField::Parse(const Message& prototype, Arena* arena) const {
+  GoogleOnceInit(&parse_mutex_init_, &InitParseMutex);
+  MutexLock lock(parse_mutex_);
+  // Another thread may have parsed the field while we waited.
+  if (message_ == NULL) {
+    Message* message = prototype.New(arena);
+    message->ParsePartialFromString(*bytes_);
+#ifdef GOOGLE_PROTOBUF_NO_THREAD_SAFETY
+    message_ = message;
+#else
+    Release_Store(reinterpret_cast<volatile AtomicWord*>(&message_),
+                  reinterpret_cast<AtomicWord>(message));
+#endif
+  }
+  return *message_;
+}
+
+const Message& LazyField::Get(const Message& prototype, Arena* arena) const {
+  const Message* message = LoadMessage();
+  if (message != NULL) return *message;
+  if (bytes_ == NULL) return prototype;
+  return Parse(prototype, arena);
+}
+
+void LazyField::DropBytes(Arena* arena) {
+  if (bytes_ != NULL) {
+    if (arena == NULL) delete bytes_;
+    bytes_ = NULL;
+  }
+}
+
+Message* LazyField::Mutable(const Message& prototype, Arena* arena) {
+  if (message_ == NULL) {
+    if (bytes_ != NULL) {
+      Parse(prototype, arena);
+    } else {
+      message_ = prototype.New(arena);
+    }
+  }
+  DropBytes(arena);
+  return message_;
+}
+
+Message* LazyField::Release(const Message& prototype, Arena* arena) {
+  if (message_ == NULL && bytes_ != NULL) Parse(prototype, arena);
+  DropBytes(arena);
+  Message* result = message_;
+  message_ = NULL;
+  if (result != NULL && arena != NULL) {
+    // The arena keeps the original.
+    Message* copy = result->New();
+    copy->CopyFrom(*result);
+    result = copy;
+  }
+  return result;
+}
+
+void LazyField::SetAllocated(Message* message, Arena* arena) {
+  GOOGLE_DCHECK(message == NULL || message->GetArena() == NULL ||
+                message->GetArena() == arena);
+  if (arena == NULL) {
+    delete message_;
+  } else if (message != NULL && message->GetArena() != arena) {
+    // Types without arena support can't tell that they are in the arena.
+    GOOGLE_DCHECK(!arena->Contains(message));
+    arena->Own(message);
+  }
+  DropBytes(arena);
+  message_ = message;
+}
+
+void LazyField::Clear() {
+  if (message_ != NULL) message_->Clear();
+  if (bytes_ != NULL) bytes_->clear();
+}
+
+void LazyField::MergeFrom(const LazyField& other, const Message& prototype,
+                          Arena* arena) {
+  if (other.bytes_ == NULL) {
+    const Message* other_message = other.LoadMessage();
+    if (other_message != NULL) {
+      Mutable(prototype, arena)->MergeFrom(*other_message);
+    }
+  } else if (message_ != NULL) {
+    // Our message may have been modified, so merge into it.
+    Message* message = Mutable(prototype, arena);
+    io::CodedInputStream input(
+        reinterpret_cast<const uint8*>(other.bytes_->data()),
+        other.bytes_->size());
+    message->MergePartialFromCodedStream(&input);
+  } else {
+    if (bytes_ == NULL) bytes_ = Arena::New<string>(arena);
+    bytes_->append(*other.bytes_);
+  }
+}
+
+void LazyField::Swap(LazyField* other) {
+  std::swap(message_, other->message_);
+  std::swap(bytes_, other->bytes_);
+}
+
+bool LazyField::MergeFromCodedStream(io::CodedInputStream* input,
+                                     Arena* arena) {
+  if (message_ != NULL) {
+    // Once parsed, the field stays parsed: references to the message must
+    // remain valid.
+    DropBytes(arena);
+    return WireFormatLite::ReadMessage(input, message_);
+  }
+  if (bytes_ == NULL) {
+    bytes_ = Arena::New<string>(arena);
+    return WireFormatLite::ReadBytes(input, bytes_);
+  }
+  string bytes;
+  if (!WireFormatLite::ReadBytes(input, &bytes)) return false;
+  bytes_->append(bytes);
+  return true;
+}
+
+int LazyField::ByteSize() const {
+  if (bytes_ != NULL) return bytes_->size();
+  return message_ != NULL ? message_->ByteSize() : 0;
+}
+
+inline int LazyField::CachedSize() const {
+  if (bytes_ != NULL) return bytes_->size();
+  return message_ != NULL ? message_->GetCachedSize() : 0;
+}
+
+void LazyField::WriteMessage(int number,
+                             io::CodedOutputStream* output) const {
+  WireFormatLite::WriteTag(number, WireFormatLite::WIRETYPE_LENGTH_DELIMITED,
+                           output);
+  output->WriteVarint32(CachedSize());
+  if (bytes_ != NULL) {
+    output->WriteString(*bytes_);
+  } else if (message_ != NULL) {
+    message_->SerializeWithCachedSizes(output);
+  }
+}
+
+uint8* LazyField::WriteMessageToArray(int number, uint8* target) const {
+  target = WireFormatLite::WriteTagToArray(
+      number, WireFormatLite::WIRETYPE_LENGTH_DELIMITED, target);
+  target = io::CodedOutputStream::WriteVarint32ToArray(CachedSize(), target);
+  if (bytes_ != NULL) {
+    target = io::CodedOutputStream::WriteStringToArray(*bytes_, target);
+  } else if (message_ != NULL) {
+    target = message_->SerializeWithCachedSizesToArray(target);
+  }
+  return target;
+}
+
+void LazyField::WriteMessageReverse(
+    int number, io::ReverseCodedOutputStream* output) const {
+  int end = output->ByteCount();
+  if (bytes_ != NULL) {
+    output->WriteString(*bytes_);
+  } else if (message_ != NULL) {
+    message_->SerializeReverse(output);
+  }
+  output->WriteVarint32(output->ByteCount() - end);
+  WireFormatLite::WriteTagReverse(
+      number, WireFormatLite::WIRETYPE_LENGTH_DELIMITED, output);
+}
+
+int LazyField::SpaceUsedExcludingSelf() const {
+  int total_size = 0;
+  if (bytes_ != NULL) {
+    total_size += sizeof(*bytes_) + StringSpaceUsedExcludingSelf(*bytes_);
+  }
+  const Message* message = LoadMessage();
+  if (message != NULL) total_size += message->SpaceUsed();
+  return total_size;
+}
+
+}  // namespace internal
+}  // namespace protobuf
+}  // namespace google
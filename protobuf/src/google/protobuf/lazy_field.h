@@ -0,0 +1,145 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// This header is logically internal, but is made public because it is used
+// from protocol-compiler-generated code, which may reside in other components.
+//
+// A singular sub-message field marked [lazy = true] is held in a LazyField.
+// Parsing the enclosing message just stores the field's encoded bytes; they
+// are parsed the first time the field is accessed.  Until the field is
+// modified, serialization writes those bytes back out unchanged, so a
+// message that is only forwarded is never parsed at all.
+
+#ifndef GOOGLE_PROTOBUF_LAZY_FIELD_H__
+#define GOOGLE_PROTOBUF_LAZY_FIELD_H__
+
+#include <string>
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+
+// Defined in other files.
+namespace io {
+  class CodedInputStream;      // coded_stream.h
+  class CodedOutputStream;     // coded_stream.h
+  class ReverseCodedOutputStream;  // coded_stream.h
+}
+class Arena;                   // arena.h
+class FieldDescriptor;         // descriptor.h
+class Message;                 // message.h
+
+namespace internal {
+
+// Is this field stored in a LazyField?  That is the case for singular,
+// non-extension message fields marked [lazy = true] in files optimized for
+// SPEED, whose generated parsing code knows to store the bytes.  Laziness is
+// only a hint, so other fields marked lazy are parsed eagerly.  Generated
+// code, GeneratedMessageReflection and DynamicMessage all use this to agree
+// on the field's layout.
+LIBPROTOBUF_EXPORT bool IsLazyField(const FieldDescriptor* field);
+
+// The storage of a lazy field.  It holds the field's encoded bytes, the
+// message parsed from them, or both; while it holds bytes, they are what
+// gets serialized.  Modifying the message through Mutable() drops them.
+//
+// Like a sub-message pointer, a LazyField is owned by the enclosing message,
+// which calls Destroy() unless an arena owns the contents.  Methods taking
+// an `arena` allocate there when it is non-NULL.  `prototype` is always the
+// default instance of the field's type.
+//
+// Const methods are safe to call concurrently, even though Get() may parse.
+// Malformed bytes are only noticed when they are parsed; the message then
+// holds whatever was parsed before the error.  Required fields inside lazy
+// fields are never checked, parsed or not.
+class LIBPROTOBUF_EXPORT LazyField {
+ public:
+  LazyField() : message_(NULL), bytes_(NULL) {}
+
+  // Frees the message and bytes.
+  void Destroy();
+
+  // Used by default instances, whose lazy fields hold their prototypes.
+  void InitAsDefaultInstance(const Message* prototype);
+  // The prototype, given the field of a default instance.
+  const Message& prototype() const { return *message_; }
+
+  // The message, parsed from the bytes if need be, or prototype if the field
+  // holds neither.
+  const Message& Get(const Message& prototype, Arena* arena) const;
+  // The message, parsed or created if need be, for modification.
+  Message* Mutable(const Message& prototype, Arena* arena);
+  // Removes and returns the message, or NULL if there is none.  The caller
+  // takes ownership; with an arena, the result is a heap copy.
+  Message* Release(const Message& prototype, Arena* arena);
+  // Replaces the contents with `message`, which may be NULL.  With an arena,
+  // the arena takes ownership of a heap message; a message constructed in
+  // that arena is used as it is.  Messages from other arenas are not
+  // allowed.
+  void SetAllocated(Message* message, Arena* arena);
+
+  void Clear();
+  // Bytes are merged by concatenation, so merging an unparsed field into an
+  // unparsed field parses neither.
+  void MergeFrom(const LazyField& other, const Message& prototype,
+                 Arena* arena);
+  void Swap(LazyField* other);
+
+  // Reads a length-delimited message from input and merges it in.
+  bool MergeFromCodedStream(io::CodedInputStream* input, Arena* arena);
+
+  // The size of the message's encoding, without tag and length.
+  int ByteSize() const;
+  // Writes the field with the given number.  ByteSize() must have been
+  // called first, as for Message::SerializeWithCachedSizes().
+  void WriteMessage(int number, io::CodedOutputStream* output) const;
+  uint8* WriteMessageToArray(int number, uint8* target) const;
+  // Like WriteMessage(), but needs no ByteSize() call.
+  void WriteMessageReverse(int number,
+                           io::ReverseCodedOutputStream* output) const;
+
+  int SpaceUsedExcludingSelf() const;
+
+ private:
+  const Message* LoadMessage() const;
+  const Message& Parse(const Message& prototype, Arena* arena) const;
+  void DropBytes(Arena* arena);
+  int CachedSize() const;
+
+  // Set by Get() on first access; see LoadMessage().
+  mutable Message* message_;
+  string* bytes_;
+};
+
+}  // namespace internal
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_LAZY_FIELD_H__
@@ -0,0 +1,330 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+#include <string>
+
+#include <google/protobuf/lazy_field.h>
+#include <google/protobuf/arena.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/dynamic_message.h>
+#include <google/protobuf/unittest.pb.h>
+#include <google/protobuf/unittest_lazy.pb.h>
+#include <google/protobuf/wire_format_lite_inl.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/stubs/stl_util.h>
+
+#include <google/protobuf/testing/googletest.h>
+#include <gtest/gtest.h>
+
+namespace google {
+namespace protobuf {
+namespace internal {
+namespace {
+
+using protobuf_unittest::TestAllTypes;
+using protobuf_unittest::TestEagerFields;
+using protobuf_unittest::TestLazyFields;
+
+class LazyFieldTest : public testing::Test {
+ protected:
+  virtual void SetUp() {
+    // The payload's fields are out of order, which parsing and serializing
+    // it again would fix.  Seeing the same bytes come back out shows that
+    // the payload was never parsed.
+    TestAllTypes second, first;
+    second.set_optional_int64(2);
+    second.set_optional_string("payload");
+    first.set_optional_int32(1);
+    payload_bytes_ =
+        second.SerializeAsString() + first.SerializeAsString();
+
+    TestEagerFields eager;
+    eager.set_id(7);
+    ASSERT_TRUE(eager.mutable_payload()->ParseFromString(payload_bytes_));
+    // Writes the payload in field order.
+    canonical_bytes_ = eager.SerializeAsString();
+
+    // The same message with the payload's bytes as given.
+    io::StringOutputStream output(&bytes_);
+    io::CodedOutputStream coded(&output);
+    WireFormatLite::WriteInt32(1, 7, &coded);
+    WireFormatLite::WriteBytes(2, payload_bytes_, &coded);
+  }
+
+  static bool MergeFromString(const string& data, Message* message) {
+    io::CodedInputStream input(reinterpret_cast<const uint8*>(data.data()),
+                               data.size());
+    return message->MergeFromCodedStream(&input);
+  }
+
+  string payload_bytes_;
+  string canonical_bytes_;
+  string bytes_;
+};
+
+TEST_F(LazyFieldTest, IsLazyField) {
+  const Descriptor* lazy = TestLazyFields::descriptor();
+  EXPECT_TRUE(IsLazyField(lazy->FindFieldByName("payload")));
+  EXPECT_FALSE(IsLazyField(lazy->FindFieldByName("id")));
+  EXPECT_FALSE(IsLazyField(
+      TestEagerFields::descriptor()->FindFieldByName("payload")));
+}
+
+TEST_F(LazyFieldTest, UnreadFieldIsForwardedUnchanged) {
+  TestLazyFields message;
+  ASSERT_TRUE(message.ParseFromString(bytes_));
+  EXPECT_TRUE(message.has_payload());
+  EXPECT_EQ(bytes_, message.SerializeAsString());
+  EXPECT_EQ(bytes_.size(), message.ByteSize());
+
+  // Reading the field doesn't change what is written.
+  EXPECT_EQ(1, message.payload().optional_int32());
+  EXPECT_EQ(2, message.payload().optional_int64());
+  EXPECT_EQ("payload", message.payload().optional_string());
+  EXPECT_EQ(bytes_, message.SerializeAsString());
+
+  string array(message.ByteSize(), '\0');
+  message.SerializeWithCachedSizesToArray(
+      reinterpret_cast<uint8*>(string_as_array(&array)));
+  EXPECT_EQ(bytes_, array);
+}
+
+TEST_F(LazyFieldTest, ModifiedFieldIsSerializedFromMessage) {
+  TestLazyFields message;
+  ASSERT_TRUE(message.ParseFromString(bytes_));
+  message.mutable_payload()->set_optional_int32(1);
+  EXPECT_EQ(canonical_bytes_, message.SerializeAsString());
+
+  message.mutable_payload()->set_optional_int32(3);
+  TestEagerFields eager;
+  ASSERT_TRUE(eager.ParseFromString(message.SerializeAsString()));
+  EXPECT_EQ(3, eager.payload().optional_int32());
+  EXPECT_EQ(2, eager.payload().optional_int64());
+}
+
+TEST_F(LazyFieldTest, MatchesEagerField) {
+  TestEagerFields eager;
+  TestLazyFields lazy;
+  ASSERT_TRUE(eager.ParseFromString(bytes_));
+  ASSERT_TRUE(lazy.ParseFromString(bytes_));
+  EXPECT_EQ(eager.DebugString(), lazy.DebugString());
+
+  // Merging parses of the same field concatenates their bytes.
+  ASSERT_TRUE(MergeFromString(canonical_bytes_, &eager));
+  ASSERT_TRUE(MergeFromString(canonical_bytes_, &lazy));
+  EXPECT_EQ(eager.DebugString(), lazy.DebugString());
+}
+
+TEST_F(LazyFieldTest, MergeFrom) {
+  TestLazyFields parsed, other;
+  ASSERT_TRUE(parsed.ParseFromString(bytes_));
+  other.mutable_payload()->set_optional_int32(5);
+  other.mutable_payload()->add_repeated_int32(6);
+
+  // Unparsed bytes into a modified field.
+  TestLazyFields message(other);
+  message.MergeFrom(parsed);
+  EXPECT_EQ(1, message.payload().optional_int32());
+  EXPECT_EQ(2, message.payload().optional_int64());
+  EXPECT_EQ(1, message.payload().repeated_int32_size());
+
+  // A modified field into unparsed bytes.
+  message.CopyFrom(parsed);
+  message.MergeFrom(other);
+  EXPECT_EQ(5, message.payload().optional_int32());
+  EXPECT_EQ(2, message.payload().optional_int64());
+
+  // Unparsed bytes are copied without being parsed.
+  TestLazyFields copy(parsed);
+  EXPECT_EQ(bytes_, copy.SerializeAsString());
+}
+
+TEST_F(LazyFieldTest, Accessors) {
+  TestLazyFields message;
+  EXPECT_FALSE(message.has_payload());
+  EXPECT_EQ(&TestAllTypes::default_instance(), &message.payload());
+  EXPECT_TRUE(message.release_payload() == NULL);
+
+  ASSERT_TRUE(message.ParseFromString(bytes_));
+  scoped_ptr<TestAllTypes> released(message.release_payload());
+  ASSERT_TRUE(released != NULL);
+  EXPECT_EQ(2, released->optional_int64());
+  EXPECT_FALSE(message.has_payload());
+  EXPECT_EQ(0, message.payload().optional_int64());
+
+  message.set_allocated_payload(released.release());
+  EXPECT_TRUE(message.has_payload());
+  EXPECT_EQ(2, message.payload().optional_int64());
+  message.clear_payload();
+  EXPECT_FALSE(message.has_payload());
+  EXPECT_EQ(0, message.payload().optional_int64());
+  message.set_allocated_payload(NULL);
+  EXPECT_FALSE(message.has_payload());
+}
+
+TEST_F(LazyFieldTest, Swap) {
+  TestLazyFields message1, message2;
+  ASSERT_TRUE(message1.ParseFromString(bytes_));
+  message2.mutable_payload()->set_optional_int32(9);
+  message1.Swap(&message2);
+  EXPECT_EQ(9, message1.payload().optional_int32());
+  EXPECT_EQ(bytes_, message2.SerializeAsString());
+}
+
+TEST_F(LazyFieldTest, RequiredFieldsAreNotChecked) {
+  TestLazyFields message;
+  message.mutable_required_payload()->set_a(1);
+  EXPECT_TRUE(message.IsInitialized());
+  EXPECT_TRUE(message.ParseFromString(message.SerializeAsString()));
+  EXPECT_TRUE(message.IsInitialized());
+  EXPECT_TRUE(message.InitializationErrorString().empty());
+  EXPECT_FALSE(message.required_payload().IsInitialized());
+
+  TestEagerFields eager;
+  eager.mutable_required_payload()->set_a(1);
+  EXPECT_FALSE(eager.IsInitialized());
+}
+
+TEST_F(LazyFieldTest, Recursive) {
+  TestLazyFields message;
+  message.mutable_child()->mutable_child()->mutable_payload()
+         ->set_optional_int32(4);
+  TestLazyFields parsed;
+  ASSERT_TRUE(parsed.ParseFromString(message.SerializeAsString()));
+  EXPECT_EQ(4, parsed.child().child().payload().optional_int32());
+  EXPECT_EQ(message.SerializeAsString(), parsed.SerializeAsString());
+}
+
+TEST_F(LazyFieldTest, Reflection) {
+  TestLazyFields message;
+  ASSERT_TRUE(message.ParseFromString(bytes_));
+  const Reflection* reflection = message.GetReflection();
+  const FieldDescriptor* field =
+      message.GetDescriptor()->FindFieldByName("payload");
+
+  EXPECT_TRUE(reflection->HasField(message, field));
+  EXPECT_EQ(&message.payload(), &reflection->GetMessage(message, field));
+  EXPECT_GT(message.SpaceUsed(), sizeof(message) + payload_bytes_.size());
+
+  TestLazyFields other;
+  reflection->Swap(&message, &other);
+  EXPECT_FALSE(message.has_payload());
+  EXPECT_EQ(2, other.payload().optional_int64());
+
+  static_cast<TestAllTypes*>(reflection->MutableMessage(&message, field))
+      ->set_optional_int32(8);
+  EXPECT_EQ(8, message.payload().optional_int32());
+  reflection->ClearField(&message, field);
+  EXPECT_FALSE(message.has_payload());
+
+  scoped_ptr<Message> released(reflection->ReleaseMessage(&other, field));
+  EXPECT_EQ(2, static_cast<TestAllTypes*>(released.get())->optional_int64());
+  EXPECT_FALSE(other.has_payload());
+}
+
+TEST_F(LazyFieldTest, DynamicMessage) {
+  DynamicMessageFactory factory;
+  scoped_ptr<Message> message(
+      factory.GetPrototype(TestLazyFields::descriptor())->New());
+  ASSERT_TRUE(message->ParseFromString(bytes_));
+  // Reflection-based parsing is eager.
+  EXPECT_EQ(canonical_bytes_, message->SerializeAsString());
+
+  TestLazyFields generated;
+  ASSERT_TRUE(generated.ParseFromString(bytes_));
+  EXPECT_EQ(generated.DebugString(), message->DebugString());
+  EXPECT_EQ("", message->InitializationErrorString());
+}
+
+TEST_F(LazyFieldTest, Arena) {
+  Arena arena;
+  TestLazyFields* message = Arena::New<TestLazyFields>(&arena);
+  ASSERT_TRUE(message->ParseFromString(bytes_));
+  EXPECT_EQ(bytes_, message->SerializeAsString());
+  EXPECT_EQ(2, message->payload().optional_int64());
+
+  scoped_ptr<TestAllTypes> released(message->release_payload());
+  EXPECT_EQ(2, released->optional_int64());
+  message->set_allocated_payload(released.release());
+  message->mutable_child()->mutable_payload()->set_optional_int32(3);
+  EXPECT_EQ(3, message->child().payload().optional_int32());
+
+  // A child created in the arena is adopted, not owned a second time.
+  TestLazyFields* child = Arena::New<TestLazyFields>(&arena);
+  child->set_id(4);
+  message->set_allocated_child(child);
+  EXPECT_EQ(child, &message->child());
+  arena.Reset();
+}
+
+TEST_F(LazyFieldTest, MalformedBytesAreParsedLate) {
+  string bytes;
+  io::StringOutputStream output(&bytes);
+  {
+    io::CodedOutputStream coded(&output);
+    WireFormatLite::WriteBytes(2, "\x08\x01\xff", &coded);
+  }
+  TestLazyFields message;
+  ASSERT_TRUE(message.ParseFromString(bytes));
+  EXPECT_EQ(1, message.payload().optional_int32());
+}
+
+#ifdef HAVE_PTHREAD
+void* ReadPayload(void* arg) {
+  const TestLazyFields* message = static_cast<const TestLazyFields*>(arg);
+  return const_cast<TestAllTypes*>(&message->payload());
+}
+
+TEST_F(LazyFieldTest, ConcurrentFirstAccess) {
+  TestLazyFields message;
+  ASSERT_TRUE(message.ParseFromString(bytes_));
+
+  pthread_t threads[4];
+  for (int i = 0; i < 4; i++) {
+    ASSERT_EQ(0, pthread_create(&threads[i], NULL, &ReadPayload, &message));
+  }
+  for (int i = 0; i < 4; i++) {
+    void* result;
+    pthread_join(threads[i], &result);
+    EXPECT_EQ(&message.payload(), result);
+  }
+  EXPECT_EQ(2, message.payload().optional_int64());
+}
+#endif  // HAVE_PTHREAD
+
+}  // namespace
+}  // namespace internal
+}  // namespace protobuf
+}  // namespace google
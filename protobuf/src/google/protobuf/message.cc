@@ -37,6 +37,8 @@
 #include <google/protobuf/stubs/hash.h>
 
 #include <google/protobuf/message.h>
+#include <google/protobuf/arena.h>
+#include <google/protobuf/repeated_field.h>
 
 #include <google/protobuf/stubs/common.h>
 #include <google/protobuf/stubs/once.h>
@@ -59,6 +61,16 @@ using internal::ReflectionOps;
 
 Message::~Message() {}
 
+Message* Message::New(Arena* arena) const {
+  Message* message = New();
+  if (arena != NULL) arena->Own(message);
+  return message;
+}
+
+Arena* Message::GetArena() const {
+  return NULL;
+}
+
 void Message::MergeFrom(const Message& from) {
   const Descriptor* descriptor = GetDescriptor();
   GOOGLE_CHECK_EQ(from.GetDescriptor(), descriptor)
@@ -353,6 +365,16 @@ void MessageFactory::InternalRegisterGeneratedMessage(
   GeneratedMessageFactory::singleton()->RegisterType(descriptor, prototype);
 }
 
+namespace internal {
+
+template <>
+Message* GenericTypeHandler<Message>::NewFromPrototype(
+    const Message* prototype) {
+  return prototype->New();
+}
+
+}  // namespace internal
+
 
 }  // namespace protobuf
 }  // namespace google
@@ -135,6 +135,7 @@ class Reflection;
 class MessageFactory;
 
 // Defined in other files.
+class Arena;                   // arena.h
 class UnknownFieldSet;         // unknown_field_set.h
 namespace io {
   class ZeroCopyInputStream;   // zero_copy_stream.h
@@ -178,6 +179,19 @@ class LIBPROTOBUF_EXPORT Message : public MessageLite {
   // for return-type covariance.)
   virtual Message* New() const = 0;
 
+  // Construct a new instance of the same type in `arena`, which owns it and
+  // everything allocated under it; the result must not be deleted.  With a
+  // NULL arena this is New().  The default implementation allocates on the
+  // heap and has the arena delete the message; DynamicMessage places the
+  // message and its sub-objects in the arena itself.
+  virtual Message* New(Arena* arena) const;
+
+  // Returns the arena the message was constructed in, or NULL if it lives
+  // on the heap.  This includes messages that the default New(arena) put
+  // on the heap for the arena to delete; those can't be told apart from
+  // any other heap message.
+  virtual Arena* GetArena() const;
+
   // Make this message into a copy of the given message.  The given message
   // must have the same descriptor, but need not necessarily be the same class.
   // By default this is just implemented as "Clear(); MergeFrom(from);".
@@ -225,6 +225,16 @@ uint8* MessageLite::SerializeWithCachedSizesToArray(uint8* target) const {
   return target + size;
 }
 
+void MessageLite::SerializeReverse(
+    io::ReverseCodedOutputStream* output) const {
+  int size = ByteSize();
+  uint8* start = output->Reserve(size);
+  uint8* end = SerializeWithCachedSizesToArray(start);
+  if (end - start != size) {
+    ByteSizeConsistencyError(size, ByteSize(), end - start);
+  }
+}
+
 bool MessageLite::SerializeToCodedStream(io::CodedOutputStream* output) const {
   GOOGLE_DCHECK(IsInitialized()) << InitializationErrorMessage("serialize", *this);
   return SerializePartialToCodedStream(output);
@@ -286,6 +296,22 @@ bool MessageLite::AppendPartialToString(string* output) const {
   return true;
 }
 
+bool MessageLite::SerializeReverseToString(string* output) const {
+  GOOGLE_DCHECK(IsInitialized()) << InitializationErrorMessage("serialize", *this);
+  return SerializePartialReverseToString(output);
+}
+
+bool MessageLite::SerializePartialReverseToString(string* output) const {
+  io::ReverseCodedOutputStream reverse_output;
+  SerializeReverse(&reverse_output);
+  output->clear();
+  if (reverse_output.ByteCount() > 0) {
+    output->assign(reinterpret_cast<const char*>(reverse_output.data()),
+                   reverse_output.ByteCount());
+  }
+  return true;
+}
+
 bool MessageLite::SerializeToString(string* output) const {
   output->clear();
   return AppendToString(output);
@@ -47,6 +47,7 @@ namespace protobuf {
 namespace io {
   class CodedInputStream;
   class CodedOutputStream;
+  class ReverseCodedOutputStream;
   class ZeroCopyInputStream;
   class ZeroCopyOutputStream;
 }
@@ -206,6 +207,12 @@ class LIBPROTOBUF_EXPORT MessageLite {
   bool AppendToString(string* output) const;
   // Like AppendToString(), but allows missing required fields.
   bool AppendPartialToString(string* output) const;
+  // Like SerializeToString(), but serializes with SerializeReverse(), which
+  // walks the message once instead of computing ByteSize() first.  The bytes
+  // are the same either way.
+  bool SerializeReverseToString(string* output) const;
+  // Like SerializeReverseToString(), but allows missing required fields.
+  bool SerializePartialReverseToString(string* output) const;
 
   // Computes the serialized size of the message.  This recursively calls
   // ByteSize() on all embedded messages.  If a subclass does not override
@@ -223,6 +230,12 @@ class LIBPROTOBUF_EXPORT MessageLite {
   // must point at a byte array of at least ByteSize() bytes.
   virtual uint8* SerializeWithCachedSizesToArray(uint8* target) const;
 
+  // Writes the message in front of whatever "output" already holds, last
+  // field first, without using or updating cached sizes.  Generated classes
+  // override this for optimize_for = SPEED only, MessageSets excepted; the
+  // default calls ByteSize() and SerializeWithCachedSizesToArray().
+  virtual void SerializeReverse(io::ReverseCodedOutputStream* output) const;
+
   // Returns the result of the last call to ByteSize().  An embedded message's
   // size is needed both to serialize it (because embedded messages are
   // length-delimited) and to compute the outer message's size.  Caching
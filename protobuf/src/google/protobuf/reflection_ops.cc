@@ -38,6 +38,7 @@
 #include <google/protobuf/reflection_ops.h>
 #include <google/protobuf/descriptor.h>
 #include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/lazy_field.h>
 #include <google/protobuf/unknown_field_set.h>
 #include <google/protobuf/stubs/strutil.h>
 
@@ -154,7 +155,10 @@ bool ReflectionOps::IsInitialized(const Message& message) {
   reflection->ListFields(message, &fields);
   for (int i = 0; i < fields.size(); i++) {
     const FieldDescriptor* field = fields[i];
-    if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+    // Required fields inside lazy fields are never checked (see
+    // lazy_field.h).
+    if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE &&
+        !IsLazyField(field)) {
 
       if (field->is_repeated()) {
         int size = reflection->FieldSize(message, field);
@@ -240,7 +244,10 @@ void ReflectionOps::FindInitializationErrors(
   reflection->ListFields(message, &fields);
   for (int i = 0; i < fields.size(); i++) {
     const FieldDescriptor* field = fields[i];
-    if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+    // Required fields inside lazy fields are never checked (see
+    // lazy_field.h).
+    if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE &&
+        !IsLazyField(field)) {
 
       if (field->is_repeated()) {
         int size = reflection->FieldSize(message, field);
@@ -48,15 +48,23 @@ void RepeatedPtrFieldBase::Reserve(int new_size) {
   void** old_elements = elements_;
   total_size_ = max(kMinRepeatedFieldAllocationSize,
                     max(total_size_ * 2, new_size));
-  elements_ = new void*[total_size_];
+  if (arena_ != NULL) {
+    // The old array stays in the arena until it is reset.
+    elements_ = reinterpret_cast<void**>(
+        arena_->AllocateAligned(total_size_ * sizeof(elements_[0])));
+  } else {
+    elements_ = new void*[total_size_];
+  }
   if (old_elements != NULL) {
     memcpy(elements_, old_elements, allocated_size_ * sizeof(elements_[0]));
-    delete [] old_elements;
+    if (arena_ == NULL) delete [] old_elements;
   }
 }
 
 void RepeatedPtrFieldBase::Swap(RepeatedPtrFieldBase* other) {
   if (this == other) return;
+  // Arrays and elements belong to their arena; see RepeatedPtrField::Swap.
+  GOOGLE_DCHECK(arena_ == other->arena_);
   void** swap_elements       = elements_;
   int    swap_current_size   = current_size_;
   int    swap_allocated_size = allocated_size_;
@@ -76,6 +84,9 @@ void RepeatedPtrFieldBase::Swap(RepeatedPtrFieldBase* other) {
 string* StringTypeHandlerBase::New() {
   return new string;
 }
+string* StringTypeHandlerBase::New(Arena* arena) {
+  return arena == NULL ? new string : arena->Create<string>();
+}
 void StringTypeHandlerBase::Delete(string* value) {
   delete value;
 }
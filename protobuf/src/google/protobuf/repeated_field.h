@@ -51,6 +51,7 @@
 #include <iterator>
 #include <google/protobuf/stubs/common.h>
 #include <google/protobuf/stubs/type_traits.h>
+#include <google/protobuf/arena.h>
 #include <google/protobuf/generated_message_util.h>
 #include <google/protobuf/message_lite.h>
 
@@ -235,11 +236,18 @@ class LIBPROTOBUF_EXPORT RepeatedPtrFieldBase {
   // use of AddFromCleared(), which is not part of the public interface.
   friend class ExtensionSet;
 
+  // TableInterpreter, which implements table-driven generated messages, also
+  // knows their repeated message fields only as holding some kind of Message.
+  friend class TableInterpreter;
+
   // To parse directly into a proto2 generated class, the upb class GMR_Handlers
   // needs to be able to modify a RepeatedPtrFieldBase directly.
   friend class LIBPROTOBUF_EXPORT upb::google_opensource::GMR_Handlers;
 
   RepeatedPtrFieldBase();
+  explicit RepeatedPtrFieldBase(Arena* arena);
+
+  Arena* arena() const { return arena_; }
 
   // Must be called from destructor.
   template <typename TypeHandler>
@@ -299,6 +307,9 @@ class LIBPROTOBUF_EXPORT RepeatedPtrFieldBase {
 
   template <typename TypeHandler>
   void AddAllocated(typename TypeHandler::Type* value);
+  // Like AddAllocated(), for a value already owned by this field's arena.
+  template <typename TypeHandler>
+  void UnsafeArenaAddAllocated(typename TypeHandler::Type* value);
   template <typename TypeHandler>
   typename TypeHandler::Type* ReleaseLast();
 
@@ -317,6 +328,8 @@ class LIBPROTOBUF_EXPORT RepeatedPtrFieldBase {
   int    current_size_;
   int    allocated_size_;
   int    total_size_;
+  // When set, the pointer array and all elements live in the arena.
+  Arena* arena_;
 
   template <typename TypeHandler>
   static inline typename TypeHandler::Type* cast(void* element) {
@@ -333,6 +346,13 @@ class GenericTypeHandler {
  public:
   typedef GenericType Type;
   static GenericType* New() { return new GenericType; }
+  static GenericType* New(Arena* arena) {
+    return Arena::New<GenericType>(arena);
+  }
+  // Returns a new heap object of the same type as `prototype`.
+  static GenericType* NewFromPrototype(const GenericType* prototype) {
+    return New();
+  }
   static void Delete(GenericType* value) { delete value; }
   static void Clear(GenericType* value) { value->Clear(); }
   static void Merge(const GenericType& from, GenericType* to) {
@@ -348,6 +368,17 @@ inline void GenericTypeHandler<MessageLite>::Merge(
   to->CheckTypeAndMergeFrom(from);
 }
 
+template <>
+inline MessageLite* GenericTypeHandler<MessageLite>::NewFromPrototype(
+    const MessageLite* prototype) {
+  return prototype->New();
+}
+
+// Defined in message.cc, where Message is complete.
+template <>
+LIBPROTOBUF_EXPORT Message* GenericTypeHandler<Message>::NewFromPrototype(
+    const Message* prototype);
+
 template <>
 inline const MessageLite& GenericTypeHandler<MessageLite>::default_instance() {
   // Yes, the behavior of the code is undefined, but this function is only
@@ -379,6 +410,8 @@ class LIBPROTOBUF_EXPORT StringTypeHandlerBase {
  public:
   typedef string Type;
   static string* New();
+  static string* New(Arena* arena);
+  static string* NewFromPrototype(const string* prototype) { return New(); }
   static void Delete(string* value);
   static void Clear(string* value) { value->clear(); }
   static void Merge(const string& from, string* to) { *to = from; }
@@ -403,6 +436,9 @@ template <typename Element>
 class RepeatedPtrField : public internal::RepeatedPtrFieldBase {
  public:
   RepeatedPtrField();
+  // Allocates the pointer array and all elements in `arena`, which must
+  // outlive the field.
+  explicit RepeatedPtrField(Arena* arena);
   RepeatedPtrField(const RepeatedPtrField& other);
   template <typename Iter>
   RepeatedPtrField(Iter begin, const Iter& end);
@@ -497,6 +533,10 @@ class RepeatedPtrField : public internal::RepeatedPtrFieldBase {
   // Advanced memory management --------------------------------------
   // When hardcore memory management becomes necessary -- as it sometimes
   // does here at Google -- the following methods may be useful.
+  //
+  // For a field on an arena, objects passed in become owned by the arena,
+  // and objects passed out are heap copies owned by the caller.  Objects
+  // passed in must therefore come from the heap, never from an arena.
 
   // Add an already-allocated object, passing ownership to the
   // RepeatedPtrField.
@@ -803,11 +843,22 @@ inline RepeatedPtrFieldBase::RepeatedPtrFieldBase()
   : elements_(NULL),
     current_size_(0),
     allocated_size_(0),
-    total_size_(kInitialSize) {
+    total_size_(kInitialSize),
+    arena_(NULL) {
+}
+
+inline RepeatedPtrFieldBase::RepeatedPtrFieldBase(Arena* arena)
+  : elements_(NULL),
+    current_size_(0),
+    allocated_size_(0),
+    total_size_(kInitialSize),
+    arena_(arena) {
 }
 
 template <typename TypeHandler>
 void RepeatedPtrFieldBase::Destroy() {
+  // The arena frees the elements and the array itself.
+  if (arena_ != NULL) return;
   for (int i = 0; i < allocated_size_; i++) {
     TypeHandler::Delete(cast<TypeHandler>(elements_[i]));
   }
@@ -840,7 +891,7 @@ inline typename TypeHandler::Type* RepeatedPtrFieldBase::Add() {
   }
   if (allocated_size_ == total_size_) Reserve(total_size_ + 1);
   ++allocated_size_;
-  typename TypeHandler::Type* result = TypeHandler::New();
+  typename TypeHandler::Type* result = TypeHandler::New(arena_);
   elements_[current_size_++] = result;
   return result;
 }
@@ -924,7 +975,18 @@ inline typename TypeHandler::Type* RepeatedPtrFieldBase::AddFromCleared() {
 }
 
 template <typename TypeHandler>
-void RepeatedPtrFieldBase::AddAllocated(
+inline void RepeatedPtrFieldBase::AddAllocated(
+    typename TypeHandler::Type* value) {
+  if (arena_ != NULL) {
+    // Owning an object the arena created would destroy it twice.
+    GOOGLE_DCHECK(!arena_->Contains(value));
+    arena_->Own(value);
+  }
+  UnsafeArenaAddAllocated<TypeHandler>(value);
+}
+
+template <typename TypeHandler>
+void RepeatedPtrFieldBase::UnsafeArenaAddAllocated(
     typename TypeHandler::Type* value) {
   // Make room for the new pointer.
   if (current_size_ == total_size_) {
@@ -936,7 +998,9 @@ void RepeatedPtrFieldBase::AddAllocated(
     // cleared objects awaiting reuse.  We don't want to grow the array in this
     // case because otherwise a loop calling AddAllocated() followed by Clear()
     // would leak memory.
-    TypeHandler::Delete(cast<TypeHandler>(elements_[current_size_]));
+    if (arena_ == NULL) {
+      TypeHandler::Delete(cast<TypeHandler>(elements_[current_size_]));
+    }
   } else if (current_size_ < allocated_size_) {
     // We have some cleared objects.  We don't care about their order, so we
     // can just move the first one to the end to make space.
@@ -961,6 +1025,12 @@ inline typename TypeHandler::Type* RepeatedPtrFieldBase::ReleaseLast() {
     // with the last allocated element.
     elements_[current_size_] = elements_[allocated_size_];
   }
+  if (arena_ != NULL) {
+    // The caller takes ownership, so hand out a heap copy.
+    typename TypeHandler::Type* copy = TypeHandler::NewFromPrototype(result);
+    TypeHandler::Merge(*result, copy);
+    return copy;
+  }
   return result;
 }
 
@@ -971,6 +1041,10 @@ inline int RepeatedPtrFieldBase::ClearedCount() const {
 template <typename TypeHandler>
 inline void RepeatedPtrFieldBase::AddCleared(
     typename TypeHandler::Type* value) {
+  if (arena_ != NULL) {
+    GOOGLE_DCHECK(!arena_->Contains(value));
+    arena_->Own(value);
+  }
   if (allocated_size_ == total_size_) Reserve(total_size_ + 1);
   elements_[allocated_size_++] = value;
 }
@@ -978,7 +1052,12 @@ inline void RepeatedPtrFieldBase::AddCleared(
 template <typename TypeHandler>
 inline typename TypeHandler::Type* RepeatedPtrFieldBase::ReleaseCleared() {
   GOOGLE_DCHECK_GT(allocated_size_, current_size_);
-  return cast<TypeHandler>(elements_[--allocated_size_]);
+  typename TypeHandler::Type* result =
+      cast<TypeHandler>(elements_[--allocated_size_]);
+  // Cleared objects are empty, so a fresh heap object stands in for one
+  // owned by the arena.
+  if (arena_ != NULL) return TypeHandler::NewFromPrototype(result);
+  return result;
 }
 
 }  // namespace internal
@@ -999,6 +1078,10 @@ class RepeatedPtrField<string>::TypeHandler
 template <typename Element>
 inline RepeatedPtrField<Element>::RepeatedPtrField() {}
 
+template <typename Element>
+inline RepeatedPtrField<Element>::RepeatedPtrField(Arena* arena)
+  : RepeatedPtrFieldBase(arena) {}
+
 template <typename Element>
 inline RepeatedPtrField<Element>::RepeatedPtrField(
     const RepeatedPtrField& other) {
@@ -1058,8 +1141,10 @@ inline void RepeatedPtrField<Element>::DeleteSubrange(int start, int num) {
   GOOGLE_DCHECK_GE(start, 0);
   GOOGLE_DCHECK_GE(num, 0);
   GOOGLE_DCHECK_LE(start + num, size());
-  for (int i = 0; i < num; ++i)
-    delete RepeatedPtrFieldBase::Mutable<TypeHandler>(start + i);
+  if (arena() == NULL) {
+    for (int i = 0; i < num; ++i)
+      delete RepeatedPtrFieldBase::Mutable<TypeHandler>(start + i);
+  }
   ExtractSubrange(start, num, NULL);
 }
 
@@ -1073,8 +1158,16 @@ inline void RepeatedPtrField<Element>::ExtractSubrange(
   if (num > 0) {
     // Save the values of the removed elements if requested.
     if (elements != NULL) {
-      for (int i = 0; i < num; ++i)
-        elements[i] = RepeatedPtrFieldBase::Mutable<TypeHandler>(i + start);
+      for (int i = 0; i < num; ++i) {
+        Element* element = RepeatedPtrFieldBase::Mutable<TypeHandler>(i + start);
+        if (arena() != NULL) {
+          // Arena elements can't change hands; the caller gets copies.
+          Element* copy = TypeHandler::NewFromPrototype(element);
+          TypeHandler::Merge(*element, copy);
+          element = copy;
+        }
+        elements[i] = element;
+      }
     }
     CloseGap(start, num);
   }
@@ -1109,6 +1202,14 @@ inline const Element* const* RepeatedPtrField<Element>::data() const {
 
 template <typename Element>
 void RepeatedPtrField<Element>::Swap(RepeatedPtrField* other) {
+  if (arena() != other->arena()) {
+    // Elements stay with the arena that owns them; swap by copying.
+    RepeatedPtrField<Element> temp;
+    temp.MergeFrom(*this);
+    CopyFrom(*other);
+    other->CopyFrom(temp);
+    return;
+  }
   RepeatedPtrFieldBase::Swap(other);
 }
 
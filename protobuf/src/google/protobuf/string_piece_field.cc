@@ -0,0 +1,137 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <google/protobuf/string_piece_field.h>
+
+#include <algorithm>
+#include <google/protobuf/arena.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/generated_message_util.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite_inl.h>
+
+namespace google {
+namespace protobuf {
+namespace internal {
+
+bool IsStringPieceField(const FieldDescriptor* field) {
+  if (field->options().ctype() != FieldOptions::STRING_PIECE ||
+      field->cpp_type() != FieldDescriptor::CPPTYPE_STRING ||
+      field->is_repeated() || field->is_extension()) {
+    return false;
+  }
+  FileOptions::OptimizeMode mode = field->file()->options().optimize_for();
+  return mode == FileOptions::SPEED || mode == FileOptions::CODE_SIZE;
+}
+
+void StringPieceField::Destroy() {
+  delete storage_;
+  storage_ = NULL;
+  data_ = "";
+  size_ = 0;
+}
+
+void StringPieceField::Set(const char* data, int size, Arena* arena) {
+  if (storage_ == NULL) {
+    storage_ = Arena::New<string>(arena);
+  }
+  // assign() copes with data pointing into storage_ itself.
+  storage_->assign(data, size);
+  data_ = storage_->data();
+  size_ = size;
+}
+
+void StringPieceField::Swap(StringPieceField* other) {
+  std::swap(data_, other->data_);
+  std::swap(size_, other->size_);
+  std::swap(storage_, other->storage_);
+}
+
+bool StringPieceField::Read(io::CodedInputStream* input, Arena* arena) {
+  uint32 length;
+  if (!input->ReadVarint32(&length)) return false;
+  int size = static_cast<int>(length);
+  if (size < 0) return false;  // security: size is often user-supplied
+
+  // The buffer of any other stream is recycled as reading goes on.
+  if (input->aliasing_enabled() && input->IsFlat()) {
+    const void* buffer;
+    int buffer_size;
+    input->GetDirectBufferPointerInline(&buffer, &buffer_size);
+    if (buffer_size >= size) {
+      SetAliased(static_cast<const char*>(buffer), size);
+      return input->Skip(size);
+    }
+  }
+
+  if (storage_ == NULL) {
+    storage_ = Arena::New<string>(arena);
+  }
+  if (!input->ReadString(storage_, size)) return false;
+  data_ = storage_->data();
+  size_ = size;
+  return true;
+}
+
+int StringPieceField::ByteSize() const {
+  return io::CodedOutputStream::VarintSize32(size_) + size_;
+}
+
+void StringPieceField::Write(int number, io::CodedOutputStream* output) const {
+  WireFormatLite::WriteTag(number, WireFormatLite::WIRETYPE_LENGTH_DELIMITED,
+                           output);
+  output->WriteVarint32(size_);
+  output->WriteRaw(data_, size_);
+}
+
+uint8* StringPieceField::WriteToArray(int number, uint8* target) const {
+  target = WireFormatLite::WriteTagToArray(
+      number, WireFormatLite::WIRETYPE_LENGTH_DELIMITED, target);
+  target = io::CodedOutputStream::WriteVarint32ToArray(size_, target);
+  return io::CodedOutputStream::WriteRawToArray(data_, size_, target);
+}
+
+void StringPieceField::WriteReverse(
+    int number, io::ReverseCodedOutputStream* output) const {
+  output->WriteRaw(data_, size_);
+  output->WriteVarint32(size_);
+  WireFormatLite::WriteTagReverse(
+      number, WireFormatLite::WIRETYPE_LENGTH_DELIMITED, output);
+}
+
+int StringPieceField::SpaceUsedExcludingSelf() const {
+  if (storage_ == NULL) return 0;
+  return sizeof(*storage_) + StringSpaceUsedExcludingSelf(*storage_);
+}
+
+}  // namespace internal
+}  // namespace protobuf
+}  // namespace google
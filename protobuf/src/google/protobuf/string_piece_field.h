@@ -0,0 +1,125 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// This header is logically internal, but is made public because it is used
+// from protocol-compiler-generated code, which may reside in other components.
+//
+// A singular string or bytes field with [ctype = STRING_PIECE] is held in a
+// StringPieceField, and its accessors deal in StringPieces.  The value is
+// either a copy owned by the field or, after set_aliased_foo() or a parse
+// with aliasing enabled, a pointer into memory owned by the caller.  Parsing
+// a large message from a flat buffer that outlives it can thus leave its
+// string fields pointing into the buffer instead of copying every one:
+//
+//   io::CodedInputStream input(buffer, size);
+//   input.EnableAliasing(true);
+//   message.MergePartialFromCodedStream(&input);
+//   // buffer must stay alive and unchanged while message is in use.
+
+#ifndef GOOGLE_PROTOBUF_STRING_PIECE_FIELD_H__
+#define GOOGLE_PROTOBUF_STRING_PIECE_FIELD_H__
+
+#include <string>
+#include <google/protobuf/stubs/common.h>
+#include <google/protobuf/stubs/stringpiece.h>
+
+namespace google {
+namespace protobuf {
+
+// Defined in other files.
+namespace io {
+  class CodedInputStream;      // coded_stream.h
+  class CodedOutputStream;     // coded_stream.h
+  class ReverseCodedOutputStream;  // coded_stream.h
+}
+class Arena;                   // arena.h
+class FieldDescriptor;         // descriptor.h
+
+namespace internal {
+
+// Is this field stored in a StringPieceField?  That is the case for
+// singular, non-extension fields with [ctype = STRING_PIECE] in files
+// optimized for SPEED or CODE_SIZE.  Other STRING_PIECE fields are stored as
+// plain strings, as are all fields of lite and table-driven files.
+// Generated code, GeneratedMessageReflection and DynamicMessage all use this
+// to agree on the field's layout.
+LIBPROTOBUF_EXPORT bool IsStringPieceField(const FieldDescriptor* field);
+
+// The storage of a STRING_PIECE field: a pointer and a length, plus a string
+// that holds the value when the field owns it.  The string is kept when the
+// field is cleared or aliased, so that later copies can reuse it.
+//
+// Like a string pointer, a StringPieceField is owned by the enclosing
+// message, which calls Destroy() unless an arena owns the string.  Methods
+// taking an `arena` allocate there when it is non-NULL.
+class LIBPROTOBUF_EXPORT StringPieceField {
+ public:
+  StringPieceField() : data_(""), size_(0), storage_(NULL) {}
+
+  // Frees the owned copy, if any.
+  void Destroy();
+
+  StringPiece Get() const { return StringPiece(data_, size_); }
+  // Copies the value into storage owned by the field.
+  void Set(const char* data, int size, Arena* arena);
+  // Points the field at the value, which the caller keeps alive.  Also used
+  // to reset the field to its default, which is a literal.
+  void SetAliased(const char* data, int size) {
+    data_ = data;
+    size_ = size;
+  }
+
+  void Swap(StringPieceField* other);
+
+  // Reads a length-delimited value from input.  If input has aliasing
+  // enabled and reads from a flat array, the field points into the array;
+  // otherwise the value is copied.
+  bool Read(io::CodedInputStream* input, Arena* arena);
+
+  // The size of the value's encoding, without tag.
+  int ByteSize() const;
+  // Writes the field with the given number.
+  void Write(int number, io::CodedOutputStream* output) const;
+  uint8* WriteToArray(int number, uint8* target) const;
+  void WriteReverse(int number, io::ReverseCodedOutputStream* output) const;
+
+  int SpaceUsedExcludingSelf() const;
+
+ private:
+  const char* data_;
+  int size_;
+  string* storage_;
+};
+
+}  // namespace internal
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_STRING_PIECE_FIELD_H__
@@ -0,0 +1,238 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <string>
+
+#include <google/protobuf/string_piece_field.h>
+#include <google/protobuf/arena.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/dynamic_message.h>
+#include <google/protobuf/unittest.pb.h>
+#include <google/protobuf/unittest_string_piece.pb.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/stubs/stringpiece.h>
+
+#include <google/protobuf/testing/googletest.h>
+#include <gtest/gtest.h>
+
+namespace google {
+namespace protobuf {
+namespace internal {
+namespace {
+
+using protobuf_unittest::TestAllTypes;
+using protobuf_unittest::TestStringFields;
+using protobuf_unittest::TestStringPieceFields;
+
+class StringPieceFieldTest : public testing::Test {
+ protected:
+  virtual void SetUp() {
+    TestStringFields message;
+    message.set_name("name");
+    message.set_payload(string("\0\1\2", 3));
+    message.set_with_default("value");
+    message.mutable_child()->set_name("child");
+    message.add_tags("tag");
+    bytes_ = message.SerializeAsString();
+  }
+
+  // Does `piece` point into bytes_?
+  bool PointsIntoBytes(const StringPiece& piece) {
+    return piece.data() >= bytes_.data() &&
+           piece.data() + piece.size() <= bytes_.data() + bytes_.size();
+  }
+
+  static bool ParseAliased(const string& data, Message* message) {
+    io::CodedInputStream input(reinterpret_cast<const uint8*>(data.data()),
+                               data.size());
+    input.EnableAliasing(true);
+    return message->MergeFromCodedStream(&input);
+  }
+
+  string bytes_;
+};
+
+TEST_F(StringPieceFieldTest, IsStringPieceField) {
+  const Descriptor* descriptor = TestStringPieceFields::descriptor();
+  EXPECT_TRUE(IsStringPieceField(descriptor->FindFieldByName("name")));
+  EXPECT_TRUE(IsStringPieceField(descriptor->FindFieldByName("payload")));
+  EXPECT_FALSE(IsStringPieceField(descriptor->FindFieldByName("tags")));
+  EXPECT_FALSE(IsStringPieceField(
+      TestStringFields::descriptor()->FindFieldByName("name")));
+  EXPECT_TRUE(IsStringPieceField(
+      TestAllTypes::descriptor()->FindFieldByName("optional_string_piece")));
+}
+
+TEST_F(StringPieceFieldTest, Accessors) {
+  TestStringPieceFields message;
+  EXPECT_FALSE(message.has_name());
+  EXPECT_EQ("", message.name());
+  EXPECT_EQ(StringPiece("a\0b", 3), message.with_default());
+
+  string value = "value";
+  message.set_name(value);
+  value[0] = 'V';
+  EXPECT_TRUE(message.has_name());
+  EXPECT_EQ("value", message.name());
+
+  message.set_aliased_name(value);
+  EXPECT_EQ(value.data(), message.name().data());
+  EXPECT_EQ("Value", message.name());
+
+  // Setting a field to its own value is safe.
+  message.set_name("copy");
+  message.set_name(message.name());
+  EXPECT_EQ("copy", message.name());
+
+  message.set_payload("\0\1", 2);
+  EXPECT_EQ(StringPiece("\0\1", 2), message.payload());
+
+  message.set_with_default("other");
+  message.Clear();
+  EXPECT_FALSE(message.has_name());
+  EXPECT_EQ("", message.name());
+  EXPECT_EQ(StringPiece("a\0b", 3), message.with_default());
+}
+
+TEST_F(StringPieceFieldTest, ParseCopiesByDefault) {
+  TestStringPieceFields message;
+  ASSERT_TRUE(message.ParseFromString(bytes_));
+  EXPECT_EQ("name", message.name());
+  EXPECT_FALSE(PointsIntoBytes(message.name()));
+  EXPECT_EQ(bytes_, message.SerializeAsString());
+}
+
+TEST_F(StringPieceFieldTest, ParseWithAliasing) {
+  TestStringPieceFields message;
+  ASSERT_TRUE(ParseAliased(bytes_, &message));
+  EXPECT_EQ("name", message.name());
+  EXPECT_EQ(StringPiece("\0\1\2", 3), message.payload());
+  EXPECT_EQ("value", message.with_default());
+  EXPECT_EQ("child", message.child().name());
+  EXPECT_TRUE(PointsIntoBytes(message.name()));
+  EXPECT_TRUE(PointsIntoBytes(message.payload()));
+  EXPECT_TRUE(PointsIntoBytes(message.child().name()));
+  EXPECT_EQ(bytes_, message.SerializeAsString());
+  EXPECT_EQ(bytes_.size(), message.ByteSize());
+
+  // Copies own their values.
+  TestStringPieceFields copy(message);
+  EXPECT_FALSE(PointsIntoBytes(copy.name()));
+  EXPECT_FALSE(PointsIntoBytes(copy.child().name()));
+  EXPECT_EQ(bytes_, copy.SerializeAsString());
+}
+
+TEST_F(StringPieceFieldTest, AliasingNeedsFlatArray) {
+  io::ArrayInputStream stream(bytes_.data(), bytes_.size());
+  io::CodedInputStream input(&stream);
+  input.EnableAliasing(true);
+  TestStringPieceFields message;
+  ASSERT_TRUE(message.MergeFromCodedStream(&input));
+  EXPECT_EQ("name", message.name());
+  EXPECT_FALSE(PointsIntoBytes(message.name()));
+}
+
+TEST_F(StringPieceFieldTest, TruncatedInput) {
+  TestStringPieceFields message;
+  EXPECT_FALSE(ParseAliased(bytes_.substr(0, 4), &message));
+  EXPECT_FALSE(message.ParseFromString(bytes_.substr(0, 4)));
+}
+
+TEST_F(StringPieceFieldTest, Swap) {
+  TestStringPieceFields message1, message2;
+  ASSERT_TRUE(ParseAliased(bytes_, &message1));
+  message2.set_name("other");
+  message1.Swap(&message2);
+  EXPECT_EQ("other", message1.name());
+  EXPECT_FALSE(message1.has_payload());
+  EXPECT_EQ(bytes_, message2.SerializeAsString());
+}
+
+TEST_F(StringPieceFieldTest, Reflection) {
+  TestStringPieceFields message;
+  const Reflection* reflection = message.GetReflection();
+  const FieldDescriptor* name =
+      message.GetDescriptor()->FindFieldByName("name");
+  const FieldDescriptor* with_default =
+      message.GetDescriptor()->FindFieldByName("with_default");
+
+  EXPECT_EQ(string("a\0b", 3), reflection->GetString(message, with_default));
+  reflection->SetString(&message, name, "value");
+  EXPECT_TRUE(message.has_name());
+  EXPECT_EQ("value", message.name());
+  string scratch;
+  EXPECT_EQ("value", reflection->GetStringReference(message, name, &scratch));
+  EXPECT_GT(message.SpaceUsed(), sizeof(message));
+
+  message.set_with_default("other");
+  reflection->ClearField(&message, with_default);
+  EXPECT_EQ(StringPiece("a\0b", 3), message.with_default());
+
+  TestStringPieceFields other;
+  reflection->Swap(&message, &other);
+  EXPECT_EQ("value", other.name());
+  EXPECT_FALSE(message.has_name());
+}
+
+TEST_F(StringPieceFieldTest, DynamicMessage) {
+  DynamicMessageFactory factory;
+  const Message* prototype =
+      factory.GetPrototype(TestStringPieceFields::descriptor());
+  EXPECT_EQ(string("a\0b", 3), prototype->GetReflection()->GetString(
+      *prototype, prototype->GetDescriptor()->FindFieldByName(
+          "with_default")));
+
+  scoped_ptr<Message> message(prototype->New());
+  ASSERT_TRUE(message->ParseFromString(bytes_));
+  EXPECT_EQ(bytes_, message->SerializeAsString());
+
+  TestStringPieceFields generated;
+  ASSERT_TRUE(generated.ParseFromString(bytes_));
+  EXPECT_EQ(generated.DebugString(), message->DebugString());
+  message->Clear();
+  EXPECT_EQ("", message->SerializeAsString());
+}
+
+TEST_F(StringPieceFieldTest, Arena) {
+  Arena arena;
+  TestStringPieceFields* message = Arena::New<TestStringPieceFields>(&arena);
+  ASSERT_TRUE(message->ParseFromString(bytes_));
+  EXPECT_EQ(bytes_, message->SerializeAsString());
+  message->set_name("a longer name that does not fit in a small string");
+  EXPECT_EQ("a longer name that does not fit in a small string",
+            message->name());
+  EXPECT_GT(arena.SpaceUsed(), 0);
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace protobuf
+}  // namespace google
@@ -319,6 +319,55 @@ void Mutex::AssertHeld() {
 
 #endif
 
+// ===================================================================
+// Threads
+
+namespace internal {
+
+#ifdef _WIN32
+static DWORD WINAPI RunThread(void* arg) {
+  reinterpret_cast<Closure*>(arg)->Run();
+  return 0;
+}
+#elif defined(HAVE_PTHREAD)
+static void* RunThread(void* arg) {
+  reinterpret_cast<Closure*>(arg)->Run();
+  return NULL;
+}
+#endif
+
+void RunOnThreads(Closure* callback, int num_threads) {
+#ifdef _WIN32
+  vector<HANDLE> threads;
+  for (int i = 1; i < num_threads; i++) {
+    HANDLE thread = CreateThread(NULL, 0, &RunThread, callback, 0, NULL);
+    if (thread == NULL) break;
+    threads.push_back(thread);
+  }
+  callback->Run();
+  for (int i = 0; i < threads.size(); i++) {
+    WaitForSingleObject(threads[i], INFINITE);
+    CloseHandle(threads[i]);
+  }
+#elif defined(HAVE_PTHREAD)
+  vector<pthread_t> threads;
+  for (int i = 1; i < num_threads; i++) {
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, &RunThread, callback) != 0) break;
+    threads.push_back(thread);
+  }
+  callback->Run();
+  for (int i = 0; i < threads.size(); i++) {
+    pthread_join(threads[i], NULL);
+  }
+#else
+  // No thread support: the calling thread does all of the work.
+  callback->Run();
+#endif
+}
+
+}  // namespace internal
+
 // ===================================================================
 // emulates google3/util/endian/endian.h
 //
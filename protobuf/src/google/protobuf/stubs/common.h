@@ -1153,6 +1153,19 @@ using internal::ReaderMutexLock;
 using internal::WriterMutexLock;
 using internal::MutexLockMaybe;
 
+// ===================================================================
+// Threads
+
+namespace internal {
+
+// Runs a permanent callback on num_threads threads, one of which is the
+// calling thread, and returns once all of them have finished.  If threads
+// can't be created, runs it on fewer; without thread support, it runs just
+// once, on the calling thread.
+LIBPROTOBUF_EXPORT void RunOnThreads(Closure* callback, int num_threads);
+
+}  // namespace internal
+
 // ===================================================================
 // from google3/util/utf8/public/unilib.h
 
@@ -352,6 +352,36 @@ TEST_F(ClosureTest, TestPermanentClosureDeleteInCallback) {
   permanent_closure_->Run();
 }
 
+// -------------------------------------------------------------------
+
+void CountRun(Mutex* mutex, int* count) {
+  MutexLock lock(mutex);
+  ++*count;
+}
+
+TEST(ThreadsTest, RunOnOneThread) {
+  Mutex mutex;
+  int count = 0;
+  scoped_ptr<Closure> callback(
+      NewPermanentCallback(&CountRun, &mutex, &count));
+  internal::RunOnThreads(callback.get(), 1);
+  EXPECT_EQ(1, count);
+}
+
+TEST(ThreadsTest, RunOnThreads) {
+  Mutex mutex;
+  int count = 0;
+  scoped_ptr<Closure> callback(
+      NewPermanentCallback(&CountRun, &mutex, &count));
+  internal::RunOnThreads(callback.get(), 4);
+#if defined(_WIN32) || defined(HAVE_PTHREAD)
+  EXPECT_EQ(4, count);
+#else
+  // Without thread support the callback still runs, just once.
+  EXPECT_EQ(1, count);
+#endif
+}
+
 }  // anonymous namespace
 }  // namespace protobuf
 }  // namespace google
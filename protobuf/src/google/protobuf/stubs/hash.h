@@ -51,6 +51,43 @@
 namespace google {
 namespace protobuf {
 
+// Hashes the given bytes (this is MurmurHash64A).  Reads eight bytes at a
+// time and mixes every bit of the input into every bit of the result, so
+// that names sharing long prefixes, as fully-qualified symbols do, still
+// spread evenly over a table.  Different seeds give independent hashes.
+inline uint64 HashString64(const char* data, size_t size, uint64 seed) {
+  static const uint64 kMul = GOOGLE_ULONGLONG(0xc6a4a7935bd1e995);
+  static const int kShift = 47;
+
+  uint64 result = seed ^ (size * kMul);
+  for (; size >= 8; data += 8, size -= 8) {
+    uint64 word;
+    memcpy(&word, data, sizeof(word));
+    word *= kMul;
+    word ^= word >> kShift;
+    word *= kMul;
+    result ^= word;
+    result *= kMul;
+  }
+
+  if (size > 0) {
+    const uint8* tail = reinterpret_cast<const uint8*>(data);
+    for (int i = size - 1; i >= 0; i--) {
+      result ^= static_cast<uint64>(tail[i]) << (8 * i);
+    }
+    result *= kMul;
+  }
+
+  result ^= result >> kShift;
+  result *= kMul;
+  result ^= result >> kShift;
+  return result;
+}
+
+inline size_t HashString(const char* data, size_t size) {
+  return static_cast<size_t>(HashString64(data, size, 0));
+}
+
 #ifdef MISSING_HASH
 
 // This system doesn't have hash_map or hash_set.  Emulate them using map and
@@ -158,11 +195,7 @@ struct hash<const Key*> {
 template <>
 struct hash<const char*> {
   inline size_t operator()(const char* str) const {
-    size_t result = 0;
-    for (; *str != '\0'; str++) {
-      result = 5 * result + *str;
-    }
-    return result;
+    return HashString(str, strlen(str));
   }
 };
 
@@ -189,7 +222,7 @@ class hash_set : public HASH_NAMESPACE::HASH_SET_CLASS<
 template <>
 struct hash<string> {
   inline size_t operator()(const string& key) const {
-    return hash<const char*>()(key.c_str());
+    return HashString(key.data(), key.size());
   }
 
   static const size_t bucket_size = 4;
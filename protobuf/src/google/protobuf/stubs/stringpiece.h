@@ -0,0 +1,105 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// StringPiece is a read-only view of a run of bytes owned by someone else:
+// a pointer and a length.  It is what the accessors of string fields with
+// [ctype = STRING_PIECE] return, so that a value aliasing the buffer it was
+// parsed from can be read without a copy.  A StringPiece is only valid for
+// as long as the bytes it points at.
+//
+// This is a minimal version of the class of the same name used inside
+// Google; it has just what protobuf and its users need.
+
+#ifndef GOOGLE_PROTOBUF_STUBS_STRINGPIECE_H__
+#define GOOGLE_PROTOBUF_STUBS_STRINGPIECE_H__
+
+#include <string.h>
+#include <string>
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+
+class StringPiece {
+ public:
+  StringPiece() : ptr_(NULL), length_(0) {}
+  // Implicit, so that strings and C strings can be passed where a
+  // StringPiece is expected.
+  StringPiece(const char* str)
+    : ptr_(str), length_(str == NULL ? 0 : static_cast<int>(strlen(str))) {}
+  StringPiece(const string& str)
+    : ptr_(str.data()), length_(static_cast<int>(str.size())) {}
+  StringPiece(const char* data, int length) : ptr_(data), length_(length) {}
+
+  const char* data() const { return ptr_; }
+  int size() const { return length_; }
+  int length() const { return length_; }
+  bool empty() const { return length_ == 0; }
+
+  const char* begin() const { return ptr_; }
+  const char* end() const { return ptr_ + length_; }
+  char operator[](int i) const { return ptr_[i]; }
+
+  string ToString() const {
+    return empty() ? string() : string(ptr_, length_);
+  }
+  string as_string() const { return ToString(); }
+  void CopyToString(string* target) const { target->assign(ptr_, length_); }
+  void AppendToString(string* target) const { target->append(ptr_, length_); }
+
+  // Returns <0, 0 or >0 as this compares less than, equal to or greater than
+  // x, ordering bytes as unsigned.
+  int compare(const StringPiece& x) const {
+    int min_length = length_ < x.length_ ? length_ : x.length_;
+    int r = min_length == 0 ? 0 : memcmp(ptr_, x.ptr_, min_length);
+    if (r != 0) return r;
+    return length_ < x.length_ ? -1 : (length_ > x.length_ ? 1 : 0);
+  }
+
+ private:
+  const char* ptr_;
+  int length_;
+};
+
+inline bool operator==(const StringPiece& x, const StringPiece& y) {
+  return x.size() == y.size() &&
+         (x.size() == 0 || memcmp(x.data(), y.data(), x.size()) == 0);
+}
+inline bool operator!=(const StringPiece& x, const StringPiece& y) {
+  return !(x == y);
+}
+inline bool operator<(const StringPiece& x, const StringPiece& y) {
+  return x.compare(y) < 0;
+}
+
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_STUBS_STRINGPIECE_H__
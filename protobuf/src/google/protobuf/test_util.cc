@@ -84,8 +84,10 @@ void TestUtil::SetOptionalFields(unittest::TestAllTypes* message) {
   message->set_optional_foreign_enum(unittest::FOREIGN_BAZ      );
   message->set_optional_import_enum (unittest_import::IMPORT_BAZ);
 
-  // StringPiece and Cord fields are only accessible via reflection in the
-  // open source release; see comments in compiler/cpp/string_field.cc.
+  // Cord fields and repeated StringPiece fields are only accessible via
+  // reflection in the open source release; see comments in
+  // compiler/cpp/cpp_string_field.cc.  Singular StringPiece fields are set
+  // the same way so that reflection covers both of their representations.
 #ifndef PROTOBUF_TEST_NO_DESCRIPTORS
   message->GetReflection()->SetString(
     message,
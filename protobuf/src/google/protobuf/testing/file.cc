@@ -166,7 +166,8 @@ void File::DeleteRecursively(const string& name,
     closedir(dir);
     rmdir(name.c_str());
 
-  } else if (S_ISREG(stats.st_mode)) {
+  } else {
+    // Plain files, but also e.g. sockets left by plugin servers.
     remove(name.c_str());
   }
 #endif
@@ -45,17 +45,35 @@ namespace google {
 namespace protobuf {
 
 UnknownFieldSet::UnknownFieldSet()
-  : fields_(NULL) {}
+  : arena_(NULL),
+    fields_(NULL) {}
+
+UnknownFieldSet::UnknownFieldSet(Arena* arena)
+  : arena_(arena),
+    fields_(NULL) {}
 
 UnknownFieldSet::~UnknownFieldSet() {
-  Clear();
-  delete fields_;
+  // Everything in an arena goes away with it.
+  if (arena_ == NULL) {
+    Clear();
+    delete fields_;
+  }
+}
+
+void UnknownFieldSet::InitFields() {
+  internal::ArenaAllocator<UnknownField> allocator(arena_);
+  if (arena_ == NULL) {
+    fields_ = new FieldVector(allocator);
+  } else {
+    fields_ = new(arena_->AllocateAligned(sizeof(FieldVector)))
+        FieldVector(allocator);
+  }
 }
 
 void UnknownFieldSet::ClearFallback() {
   GOOGLE_DCHECK(fields_ != NULL);
   for (int i = 0; i < fields_->size(); i++) {
-    (*fields_)[i].Delete();
+    (*fields_)[i].Delete(arena_);
   }
   fields_->clear();
 }
@@ -63,11 +81,20 @@ void UnknownFieldSet::ClearFallback() {
 void UnknownFieldSet::ClearAndFreeMemory() {
   if (fields_ != NULL) {
     Clear();
-    delete fields_;
+    if (arena_ == NULL) delete fields_;
     fields_ = NULL;
   }
 }
 
+void UnknownFieldSet::SwapFallback(UnknownFieldSet* x) {
+  UnknownFieldSet temp;
+  temp.MergeFrom(*this);
+  Clear();
+  MergeFrom(*x);
+  x->Clear();
+  x->MergeFrom(temp);
+}
+
 void UnknownFieldSet::MergeFrom(const UnknownFieldSet& other) {
   for (int i = 0; i < other.field_count(); i++) {
     AddField(other.field(i));
@@ -101,7 +128,7 @@ int UnknownFieldSet::SpaceUsed() const {
 }
 
 void UnknownFieldSet::AddVarint(int number, uint64 value) {
-  if (fields_ == NULL) fields_ = new vector<UnknownField>;
+  if (fields_ == NULL) InitFields();
   UnknownField field;
   field.number_ = number;
   field.type_ = UnknownField::TYPE_VARINT;
@@ -110,7 +137,7 @@ void UnknownFieldSet::AddVarint(int number, uint64 value) {
 }
 
 void UnknownFieldSet::AddFixed32(int number, uint32 value) {
-  if (fields_ == NULL) fields_ = new vector<UnknownField>;
+  if (fields_ == NULL) InitFields();
   UnknownField field;
   field.number_ = number;
   field.type_ = UnknownField::TYPE_FIXED32;
@@ -119,7 +146,7 @@ void UnknownFieldSet::AddFixed32(int number, uint32 value) {
 }
 
 void UnknownFieldSet::AddFixed64(int number, uint64 value) {
-  if (fields_ == NULL) fields_ = new vector<UnknownField>;
+  if (fields_ == NULL) InitFields();
   UnknownField field;
   field.number_ = number;
   field.type_ = UnknownField::TYPE_FIXED64;
@@ -128,37 +155,37 @@ void UnknownFieldSet::AddFixed64(int number, uint64 value) {
 }
 
 string* UnknownFieldSet::AddLengthDelimited(int number) {
-  if (fields_ == NULL) fields_ = new vector<UnknownField>;
+  if (fields_ == NULL) InitFields();
   UnknownField field;
   field.number_ = number;
   field.type_ = UnknownField::TYPE_LENGTH_DELIMITED;
-  field.length_delimited_.string_value_ = new string;
+  field.length_delimited_.string_value_ = Arena::New<string>(arena_);
   fields_->push_back(field);
   return field.length_delimited_.string_value_;
 }
 
 
 UnknownFieldSet* UnknownFieldSet::AddGroup(int number) {
-  if (fields_ == NULL) fields_ = new vector<UnknownField>;
+  if (fields_ == NULL) InitFields();
   UnknownField field;
   field.number_ = number;
   field.type_ = UnknownField::TYPE_GROUP;
-  field.group_ = new UnknownFieldSet;
+  field.group_ = Arena::New<UnknownFieldSet>(arena_, arena_);
   fields_->push_back(field);
   return field.group_;
 }
 
 void UnknownFieldSet::AddField(const UnknownField& field) {
-  if (fields_ == NULL) fields_ = new vector<UnknownField>;
+  if (fields_ == NULL) InitFields();
   fields_->push_back(field);
-  fields_->back().DeepCopy();
+  fields_->back().DeepCopy(arena_);
 }
 
 void UnknownFieldSet::DeleteSubrange(int start, int num) {
   GOOGLE_DCHECK(fields_ != NULL);
   // Delete the specified fields.
   for (int i = 0; i < num; ++i) {
-    (*fields_)[i + start].Delete();
+    (*fields_)[i + start].Delete(arena_);
   }
   // Slide down the remaining fields.
   for (int i = start + num; i < fields_->size(); ++i) {
@@ -176,7 +203,7 @@ void UnknownFieldSet::DeleteByNumber(int number) {
   for (int i = 0; i < fields_->size(); ++i) {
     UnknownField* field = &(*fields_)[i];
     if (field->number() == number) {
-      field->Delete();
+      field->Delete(arena_);
     } else {
       if (i != left) {
         (*fields_)[left] = (*fields_)[i];
@@ -215,7 +242,8 @@ bool UnknownFieldSet::ParseFromArray(const void* data, int size) {
   return ParseFromZeroCopyStream(&input);
 }
 
-void UnknownField::Delete() {
+void UnknownField::Delete(Arena* arena) {
+  if (arena != NULL) return;
   switch (type()) {
     case UnknownField::TYPE_LENGTH_DELIMITED:
       delete length_delimited_.string_value_;
@@ -228,14 +256,14 @@ void UnknownField::Delete() {
   }
 }
 
-void UnknownField::DeepCopy() {
+void UnknownField::DeepCopy(Arena* arena) {
   switch (type()) {
     case UnknownField::TYPE_LENGTH_DELIMITED:
-      length_delimited_.string_value_ = new string(
-          *length_delimited_.string_value_);
+      length_delimited_.string_value_ = Arena::New<string>(
+          arena, *length_delimited_.string_value_);
       break;
     case UnknownField::TYPE_GROUP: {
-      UnknownFieldSet* group = new UnknownFieldSet;
+      UnknownFieldSet* group = Arena::New<UnknownFieldSet>(arena, arena);
       group->MergeFrom(*group_);
       group_ = group;
       break;
@@ -42,6 +42,7 @@
 #include <string>
 #include <vector>
 #include <google/protobuf/stubs/common.h>
+#include <google/protobuf/arena.h>
 // TODO(jasonh): some people seem to rely on protobufs to include this for them!
 
 namespace google {
@@ -75,6 +76,9 @@ class UnknownField;                 // below
 class LIBPROTOBUF_EXPORT UnknownFieldSet {
  public:
   UnknownFieldSet();
+  // Allocates the fields, and their strings and groups, in the arena.  They
+  // are freed with the arena rather than when cleared or destroyed.
+  explicit UnknownFieldSet(Arena* arena);
   ~UnknownFieldSet();
 
   // Remove all fields.
@@ -89,7 +93,8 @@ class LIBPROTOBUF_EXPORT UnknownFieldSet {
   // Merge the contents of some other UnknownFieldSet with this one.
   void MergeFrom(const UnknownFieldSet& other);
 
-  // Swaps the contents of some other UnknownFieldSet with this one.
+  // Swaps the contents of some other UnknownFieldSet with this one.  Sets
+  // in different arenas exchange copies.
   inline void Swap(UnknownFieldSet* x);
 
   // Computes (an estimate of) the total number of bytes currently used for
@@ -143,10 +148,15 @@ class LIBPROTOBUF_EXPORT UnknownFieldSet {
   }
 
  private:
+  typedef vector<UnknownField, internal::ArenaAllocator<UnknownField> >
+      FieldVector;
 
   void ClearFallback();
+  void SwapFallback(UnknownFieldSet* x);
+  void InitFields();
 
-  vector<UnknownField>* fields_;
+  Arena* arena_;
+  FieldVector* fields_;
 
   GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(UnknownFieldSet);
 };
@@ -196,11 +206,13 @@ class LIBPROTOBUF_EXPORT UnknownField {
  private:
   friend class UnknownFieldSet;
 
-  // If this UnknownField contains a pointer, delete it.
-  void Delete();
+  // If this UnknownField contains a pointer, delete it, unless it was
+  // allocated in an arena.
+  void Delete(Arena* arena);
 
-  // Make a deep copy of any pointers in this UnknownField.
-  void DeepCopy();
+  // Make a deep copy of any pointers in this UnknownField, in the arena if
+  // it is not NULL.
+  void DeepCopy(Arena* arena);
 
 
   unsigned int number_ : 29;
@@ -230,7 +242,11 @@ inline bool UnknownFieldSet::empty() const {
 }
 
 inline void UnknownFieldSet::Swap(UnknownFieldSet* x) {
-  std::swap(fields_, x->fields_);
+  if (arena_ == x->arena_) {
+    std::swap(fields_, x->fields_);
+  } else {
+    SwapFallback(x);
+  }
 }
 
 inline int UnknownFieldSet::field_count() const {
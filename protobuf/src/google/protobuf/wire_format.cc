@@ -230,6 +230,40 @@ uint8* WireFormat::SerializeUnknownFieldsToArray(
   return target;
 }
 
+void WireFormat::SerializeUnknownFieldsReverse(
+    const UnknownFieldSet& unknown_fields,
+    io::ReverseCodedOutputStream* output) {
+  for (int i = unknown_fields.field_count() - 1; i >= 0; i--) {
+    const UnknownField& field = unknown_fields.field(i);
+
+    switch (field.type()) {
+      case UnknownField::TYPE_VARINT:
+        WireFormatLite::WriteUInt64Reverse(
+            field.number(), field.varint(), output);
+        break;
+      case UnknownField::TYPE_FIXED32:
+        WireFormatLite::WriteFixed32Reverse(
+            field.number(), field.fixed32(), output);
+        break;
+      case UnknownField::TYPE_FIXED64:
+        WireFormatLite::WriteFixed64Reverse(
+            field.number(), field.fixed64(), output);
+        break;
+      case UnknownField::TYPE_LENGTH_DELIMITED:
+        WireFormatLite::WriteBytesReverse(
+            field.number(), field.length_delimited(), output);
+        break;
+      case UnknownField::TYPE_GROUP:
+        WireFormatLite::WriteTagReverse(
+            field.number(), WireFormatLite::WIRETYPE_END_GROUP, output);
+        SerializeUnknownFieldsReverse(field.group(), output);
+        WireFormatLite::WriteTagReverse(
+            field.number(), WireFormatLite::WIRETYPE_START_GROUP, output);
+        break;
+    }
+  }
+}
+
 void WireFormat::SerializeUnknownMessageSetItems(
     const UnknownFieldSet& unknown_fields,
     io::CodedOutputStream* output) {
@@ -56,6 +56,7 @@ namespace protobuf {
   namespace io {
     class CodedInputStream;      // coded_stream.h
     class CodedOutputStream;     // coded_stream.h
+    class ReverseCodedOutputStream;  // coded_stream.h
   }
   class UnknownFieldSet;         // unknown_field_set.h
 }
@@ -149,6 +150,10 @@ class LIBPROTOBUF_EXPORT WireFormat {
   static uint8* SerializeUnknownFieldsToArray(
       const UnknownFieldSet& unknown_fields,
       uint8* target);
+  // Same as above, except writing back to front, for SerializeReverse().
+  static void SerializeUnknownFieldsReverse(
+      const UnknownFieldSet& unknown_fields,
+      io::ReverseCodedOutputStream* output);
 
   // Same thing except for messages that have the message_set_wire_format
   // option.
@@ -434,6 +434,79 @@ class LIBPROTOBUF_EXPORT WireFormatLite {
   static inline uint8* WriteMessageNoVirtualToArray(
     field_number, const MessageType& value, output) INL;
 
+#undef output
+#define output io::ReverseCodedOutputStream* output
+
+  // Like above, but for ReverseCodedOutputStream, which writes back to front.
+  // Each call still writes one whole field; the tag is written last because
+  // it ends up in front of the value.  Messages are written before their
+  // length, so nothing here depends on cached sizes.
+  static inline void WriteTagReverse(field_number, WireType type, output) INL;
+
+  // Write fields, without tags.
+  static inline void WriteInt32NoTagReverse(int32 value, output) INL;
+  static inline void WriteInt64NoTagReverse(int64 value, output) INL;
+  static inline void WriteUInt32NoTagReverse(uint32 value, output) INL;
+  static inline void WriteUInt64NoTagReverse(uint64 value, output) INL;
+  static inline void WriteSInt32NoTagReverse(int32 value, output) INL;
+  static inline void WriteSInt64NoTagReverse(int64 value, output) INL;
+  static inline void WriteFixed32NoTagReverse(uint32 value, output) INL;
+  static inline void WriteFixed64NoTagReverse(uint64 value, output) INL;
+  static inline void WriteSFixed32NoTagReverse(int32 value, output) INL;
+  static inline void WriteSFixed64NoTagReverse(int64 value, output) INL;
+  static inline void WriteFloatNoTagReverse(float value, output) INL;
+  static inline void WriteDoubleNoTagReverse(double value, output) INL;
+  static inline void WriteBoolNoTagReverse(bool value, output) INL;
+  static inline void WriteEnumNoTagReverse(int value, output) INL;
+
+  // Write fields, including tags.
+  static inline void WriteInt32Reverse(
+    field_number, int32 value, output) INL;
+  static inline void WriteInt64Reverse(
+    field_number, int64 value, output) INL;
+  static inline void WriteUInt32Reverse(
+    field_number, uint32 value, output) INL;
+  static inline void WriteUInt64Reverse(
+    field_number, uint64 value, output) INL;
+  static inline void WriteSInt32Reverse(
+    field_number, int32 value, output) INL;
+  static inline void WriteSInt64Reverse(
+    field_number, int64 value, output) INL;
+  static inline void WriteFixed32Reverse(
+    field_number, uint32 value, output) INL;
+  static inline void WriteFixed64Reverse(
+    field_number, uint64 value, output) INL;
+  static inline void WriteSFixed32Reverse(
+    field_number, int32 value, output) INL;
+  static inline void WriteSFixed64Reverse(
+    field_number, int64 value, output) INL;
+  static inline void WriteFloatReverse(
+    field_number, float value, output) INL;
+  static inline void WriteDoubleReverse(
+    field_number, double value, output) INL;
+  static inline void WriteBoolReverse(
+    field_number, bool value, output) INL;
+  static inline void WriteEnumReverse(
+    field_number, int value, output) INL;
+
+  static inline void WriteStringReverse(
+    field_number, const string& value, output) INL;
+  static inline void WriteBytesReverse(
+    field_number, const string& value, output) INL;
+
+  static inline void WriteGroupReverse(
+      field_number, const MessageLite& value, output) INL;
+  static inline void WriteMessageReverse(
+      field_number, const MessageLite& value, output) INL;
+
+  // Like above, but de-virtualize the call to SerializeReverse().
+  template<typename MessageType>
+  static inline void WriteGroupNoVirtualReverse(
+    field_number, const MessageType& value, output) INL;
+  template<typename MessageType>
+  static inline void WriteMessageNoVirtualReverse(
+    field_number, const MessageType& value, output) INL;
+
 #undef output
 #undef input
 #undef INL
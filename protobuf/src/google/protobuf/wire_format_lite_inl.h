@@ -710,6 +710,188 @@ inline uint8* WireFormatLite::WriteMessageNoVirtualToArray(
       ::SerializeWithCachedSizesToArray(target);
 }
 
+inline void WireFormatLite::WriteTagReverse(
+    int field_number, WireType type, io::ReverseCodedOutputStream* output) {
+  output->WriteTag(MakeTag(field_number, type));
+}
+
+inline void WireFormatLite::WriteInt32NoTagReverse(
+    int32 value, io::ReverseCodedOutputStream* output) {
+  output->WriteVarint32SignExtended(value);
+}
+inline void WireFormatLite::WriteInt64NoTagReverse(
+    int64 value, io::ReverseCodedOutputStream* output) {
+  output->WriteVarint64(static_cast<uint64>(value));
+}
+inline void WireFormatLite::WriteUInt32NoTagReverse(
+    uint32 value, io::ReverseCodedOutputStream* output) {
+  output->WriteVarint32(value);
+}
+inline void WireFormatLite::WriteUInt64NoTagReverse(
+    uint64 value, io::ReverseCodedOutputStream* output) {
+  output->WriteVarint64(value);
+}
+inline void WireFormatLite::WriteSInt32NoTagReverse(
+    int32 value, io::ReverseCodedOutputStream* output) {
+  output->WriteVarint32(ZigZagEncode32(value));
+}
+inline void WireFormatLite::WriteSInt64NoTagReverse(
+    int64 value, io::ReverseCodedOutputStream* output) {
+  output->WriteVarint64(ZigZagEncode64(value));
+}
+inline void WireFormatLite::WriteFixed32NoTagReverse(
+    uint32 value, io::ReverseCodedOutputStream* output) {
+  output->WriteLittleEndian32(value);
+}
+inline void WireFormatLite::WriteFixed64NoTagReverse(
+    uint64 value, io::ReverseCodedOutputStream* output) {
+  output->WriteLittleEndian64(value);
+}
+inline void WireFormatLite::WriteSFixed32NoTagReverse(
+    int32 value, io::ReverseCodedOutputStream* output) {
+  output->WriteLittleEndian32(static_cast<uint32>(value));
+}
+inline void WireFormatLite::WriteSFixed64NoTagReverse(
+    int64 value, io::ReverseCodedOutputStream* output) {
+  output->WriteLittleEndian64(static_cast<uint64>(value));
+}
+inline void WireFormatLite::WriteFloatNoTagReverse(
+    float value, io::ReverseCodedOutputStream* output) {
+  output->WriteLittleEndian32(EncodeFloat(value));
+}
+inline void WireFormatLite::WriteDoubleNoTagReverse(
+    double value, io::ReverseCodedOutputStream* output) {
+  output->WriteLittleEndian64(EncodeDouble(value));
+}
+inline void WireFormatLite::WriteBoolNoTagReverse(
+    bool value, io::ReverseCodedOutputStream* output) {
+  output->WriteVarint32(value ? 1 : 0);
+}
+inline void WireFormatLite::WriteEnumNoTagReverse(
+    int value, io::ReverseCodedOutputStream* output) {
+  output->WriteVarint32SignExtended(value);
+}
+
+inline void WireFormatLite::WriteInt32Reverse(
+    int field_number, int32 value, io::ReverseCodedOutputStream* output) {
+  WriteInt32NoTagReverse(value, output);
+  WriteTagReverse(field_number, WIRETYPE_VARINT, output);
+}
+inline void WireFormatLite::WriteInt64Reverse(
+    int field_number, int64 value, io::ReverseCodedOutputStream* output) {
+  WriteInt64NoTagReverse(value, output);
+  WriteTagReverse(field_number, WIRETYPE_VARINT, output);
+}
+inline void WireFormatLite::WriteUInt32Reverse(
+    int field_number, uint32 value, io::ReverseCodedOutputStream* output) {
+  WriteUInt32NoTagReverse(value, output);
+  WriteTagReverse(field_number, WIRETYPE_VARINT, output);
+}
+inline void WireFormatLite::WriteUInt64Reverse(
+    int field_number, uint64 value, io::ReverseCodedOutputStream* output) {
+  WriteUInt64NoTagReverse(value, output);
+  WriteTagReverse(field_number, WIRETYPE_VARINT, output);
+}
+inline void WireFormatLite::WriteSInt32Reverse(
+    int field_number, int32 value, io::ReverseCodedOutputStream* output) {
+  WriteSInt32NoTagReverse(value, output);
+  WriteTagReverse(field_number, WIRETYPE_VARINT, output);
+}
+inline void WireFormatLite::WriteSInt64Reverse(
+    int field_number, int64 value, io::ReverseCodedOutputStream* output) {
+  WriteSInt64NoTagReverse(value, output);
+  WriteTagReverse(field_number, WIRETYPE_VARINT, output);
+}
+inline void WireFormatLite::WriteFixed32Reverse(
+    int field_number, uint32 value, io::ReverseCodedOutputStream* output) {
+  WriteFixed32NoTagReverse(value, output);
+  WriteTagReverse(field_number, WIRETYPE_FIXED32, output);
+}
+inline void WireFormatLite::WriteFixed64Reverse(
+    int field_number, uint64 value, io::ReverseCodedOutputStream* output) {
+  WriteFixed64NoTagReverse(value, output);
+  WriteTagReverse(field_number, WIRETYPE_FIXED64, output);
+}
+inline void WireFormatLite::WriteSFixed32Reverse(
+    int field_number, int32 value, io::ReverseCodedOutputStream* output) {
+  WriteSFixed32NoTagReverse(value, output);
+  WriteTagReverse(field_number, WIRETYPE_FIXED32, output);
+}
+inline void WireFormatLite::WriteSFixed64Reverse(
+    int field_number, int64 value, io::ReverseCodedOutputStream* output) {
+  WriteSFixed64NoTagReverse(value, output);
+  WriteTagReverse(field_number, WIRETYPE_FIXED64, output);
+}
+inline void WireFormatLite::WriteFloatReverse(
+    int field_number, float value, io::ReverseCodedOutputStream* output) {
+  WriteFloatNoTagReverse(value, output);
+  WriteTagReverse(field_number, WIRETYPE_FIXED32, output);
+}
+inline void WireFormatLite::WriteDoubleReverse(
+    int field_number, double value, io::ReverseCodedOutputStream* output) {
+  WriteDoubleNoTagReverse(value, output);
+  WriteTagReverse(field_number, WIRETYPE_FIXED64, output);
+}
+inline void WireFormatLite::WriteBoolReverse(
+    int field_number, bool value, io::ReverseCodedOutputStream* output) {
+  WriteBoolNoTagReverse(value, output);
+  WriteTagReverse(field_number, WIRETYPE_VARINT, output);
+}
+inline void WireFormatLite::WriteEnumReverse(
+    int field_number, int value, io::ReverseCodedOutputStream* output) {
+  WriteEnumNoTagReverse(value, output);
+  WriteTagReverse(field_number, WIRETYPE_VARINT, output);
+}
+
+inline void WireFormatLite::WriteStringReverse(
+    int field_number, const string& value,
+    io::ReverseCodedOutputStream* output) {
+  output->WriteString(value);
+  output->WriteVarint32(value.size());
+  WriteTagReverse(field_number, WIRETYPE_LENGTH_DELIMITED, output);
+}
+inline void WireFormatLite::WriteBytesReverse(
+    int field_number, const string& value,
+    io::ReverseCodedOutputStream* output) {
+  output->WriteString(value);
+  output->WriteVarint32(value.size());
+  WriteTagReverse(field_number, WIRETYPE_LENGTH_DELIMITED, output);
+}
+
+inline void WireFormatLite::WriteGroupReverse(
+    int field_number, const MessageLite& value,
+    io::ReverseCodedOutputStream* output) {
+  WriteTagReverse(field_number, WIRETYPE_END_GROUP, output);
+  value.SerializeReverse(output);
+  WriteTagReverse(field_number, WIRETYPE_START_GROUP, output);
+}
+inline void WireFormatLite::WriteMessageReverse(
+    int field_number, const MessageLite& value,
+    io::ReverseCodedOutputStream* output) {
+  int end = output->ByteCount();
+  value.SerializeReverse(output);
+  output->WriteVarint32(output->ByteCount() - end);
+  WriteTagReverse(field_number, WIRETYPE_LENGTH_DELIMITED, output);
+}
+
+template<typename MessageType_WorkAroundCppLookupDefect>
+inline void WireFormatLite::WriteGroupNoVirtualReverse(
+    int field_number, const MessageType_WorkAroundCppLookupDefect& value,
+    io::ReverseCodedOutputStream* output) {
+  WriteTagReverse(field_number, WIRETYPE_END_GROUP, output);
+  value.MessageType_WorkAroundCppLookupDefect::SerializeReverse(output);
+  WriteTagReverse(field_number, WIRETYPE_START_GROUP, output);
+}
+template<typename MessageType_WorkAroundCppLookupDefect>
+inline void WireFormatLite::WriteMessageNoVirtualReverse(
+    int field_number, const MessageType_WorkAroundCppLookupDefect& value,
+    io::ReverseCodedOutputStream* output) {
+  int end = output->ByteCount();
+  value.MessageType_WorkAroundCppLookupDefect::SerializeReverse(output);
+  output->WriteVarint32(output->ByteCount() - end);
+  WriteTagReverse(field_number, WIRETYPE_LENGTH_DELIMITED, output);
+}
+
 // ===================================================================
 
 inline int WireFormatLite::Int32Size(int32 value) {
@@ -0,0 +1,184 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+
+#include <assert.h>
+
+#include <string>
+
+#include <node.h>
+#include <nan.h>
+#include <uv.h>
+
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/message.h>
+
+#include "channel.h"
+#include "controller.h"
+#include "descriptor.h"
+#include "schema.h"
+
+using google::protobuf::Message;
+using google::protobuf::MethodDescriptor;
+using google::protobuf::NewCallback;
+
+namespace node {
+namespace protobuf {
+
+const char E_UNKNOWN_METHOD_NAME[] = "Unknown method";
+
+// One call in flight. The channel is referenced until `done` has run, so
+// that it can not be collected with calls outstanding.
+class Channel::Call {
+public:
+  Call (
+    Channel *channel,
+    const Schema *schema,
+    const MethodDescriptor *method,
+    Message *request,
+    Message *response,
+    v8::Local<v8::Function> callback
+  ) : channel_(channel), schema_(schema), method_(method),
+      request_(request), response_(response), callback_(callback) {
+    channel_->Ref();
+  }
+
+  ~Call () {
+    delete request_;
+    delete response_;
+    channel_->Unref();
+  }
+
+  void Start () {
+    channel_->channel_.CallMethod(method_, &controller_, request_, response_,
+      NewCallback(this, &Call::Done));
+  }
+
+private:
+  Channel *channel_;
+  const Schema *schema_;
+  const MethodDescriptor *method_;
+  Controller controller_;
+  Message *request_;
+  Message *response_;
+  NanCallback callback_;
+
+  void Done () {
+    NanScope();
+
+    if (controller_.Failed()) {
+      v8::Local<v8::Value> argv[] = {
+        NanError(controller_.ErrorText().c_str())
+      };
+      callback_.Call(1, argv);
+    } else {
+      const Descriptor *descriptor = schema_->Lookup(method_->output_type());
+      assert(descriptor != NULL);
+      v8::Local<v8::Value> argv[] = {
+        NanNull(),
+        descriptor->ToJS(*response_)
+      };
+      callback_.Call(2, argv);
+    }
+
+    delete this;
+  }
+};
+
+Channel::Channel (v8::Local<v8::Object> handle)
+  : channel_(uv_default_loop()) {
+  NanAssignPersistent(persistentHandle, handle);
+}
+
+Channel::~Channel () {
+  NanDisposePersistent(persistentHandle);
+}
+
+/* V8 exposed functions *****************************/
+
+void Channel::Init (v8::Handle<v8::Object> exports) {
+  v8::Local<v8::FunctionTemplate> t = NanNew<v8::FunctionTemplate>(Channel::New);
+  t->SetClassName(NanSymbol("Channel"));
+  t->InstanceTemplate()->SetInternalFieldCount(1);
+
+  NODE_SET_PROTOTYPE_METHOD(t, "call", CallMethod);
+  NODE_SET_PROTOTYPE_METHOD(t, "close", Close);
+
+  exports->Set(NanSymbol("Channel"), t->GetFunction());
+}
+
+NAN_METHOD(Channel::New) {
+  NanScope();
+
+  if (args.Length() < 2 || !args[0]->IsObject() || !args[1]->IsString()) {
+    return NanThrowError("Expected a schema and an address");
+  }
+
+  Channel *channel = new Channel(args[0]->ToObject());
+  channel->Wrap(args.This());
+
+  int r = channel->channel_.Connect(*v8::String::Utf8Value(args[1]));
+  if (r) {
+    return NanThrowError(uv_strerror(r));
+  }
+
+  NanReturnValue(args.This());
+}
+
+NAN_METHOD(Channel::CallMethod) {
+  NanScope();
+
+  Channel *channel = node::ObjectWrap::Unwrap<Channel>(args.This());
+  Schema *schema = node::ObjectWrap::Unwrap<Schema>(
+    NanNew(channel->persistentHandle));
+
+  if (args.Length() < 3 || !args[0]->IsString() || !args[1]->IsObject() ||
+      !args[2]->IsFunction()) {
+    return NanThrowError("Expected a method name, a request and a callback");
+  }
+
+  const MethodDescriptor *method =
+    schema->pool_->FindMethodByName(*v8::String::Utf8Value(args[0]));
+  if (method == NULL) {
+    return NanThrowError(E_UNKNOWN_METHOD_NAME);
+  }
+
+  const Descriptor *input = schema->Lookup(method->input_type());
+  assert(input != NULL);
+
+  Message *request = schema->NewMessage(method->input_type());
+  const char *error = input->FromJS(request, args[1]->ToObject());
+  if (error) {
+    delete request;
+    return NanThrowError(error);
+  }
+
+  Call *call = new Call(channel, schema, method, request,
+    schema->NewMessage(method->output_type()), args[2].As<v8::Function>());
+  call->Start();
+
+  NanReturnUndefined();
+}
+
+NAN_METHOD(Channel::Close) {
+  NanScope();
+
+  Channel *channel = node::ObjectWrap::Unwrap<Channel>(args.This());
+  channel->channel_.Close();
+
+  NanReturnUndefined();
+}
+
+} // namespace protobuf
+} // namespace node
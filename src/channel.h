@@ -0,0 +1,56 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+
+#pragma once
+
+#include <node.h>
+#include <nan.h>
+
+#include "rpc.h"
+
+namespace node {
+namespace protobuf {
+
+// JS handle on a SocketChannel:
+//
+//   var channel = new Channel(schema, '/tmp/sidecar.sock');
+//   channel.call('pkg.Service.Method', request, function (err, response) {
+//     ...
+//   });
+//   channel.close();
+//
+// Method names are resolved against the schema, so it must have been
+// loaded from a descriptor set that includes the service. The open
+// connection keeps the process alive until close() is called.
+class Channel : public node::ObjectWrap {
+public:
+  static void Init (v8::Handle<v8::Object> exports);
+
+  Channel (v8::Local<v8::Object> handle);
+  ~Channel ();
+
+private:
+  class Call;
+
+  SocketChannel channel_;
+  v8::Persistent<v8::Object> persistentHandle;
+
+  static NAN_METHOD(New);
+  static NAN_METHOD(CallMethod);
+  static NAN_METHOD(Close);
+};
+
+} // namespace protobuf
+} // namespace node
@@ -0,0 +1,49 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#pragma once
+
+#include <string>
+
+#include <google/protobuf/service.h>
+
+namespace node {
+namespace protobuf {
+
+// Calls made through the binding can not be cancelled; the controller
+// only carries failures back.
+class Controller : public google::protobuf::RpcController {
+public:
+  Controller () : failed_(false) {}
+
+  void Reset () { failed_ = false; reason_.clear(); }
+  bool Failed () const { return failed_; }
+  std::string ErrorText () const { return reason_; }
+  void StartCancel () {}
+
+  void SetFailed (const std::string &reason) {
+    failed_ = true;
+    reason_ = reason;
+  }
+
+  bool IsCanceled () const { return false; }
+  void NotifyOnCancel (google::protobuf::Closure *callback) {}
+
+private:
+  bool failed_;
+  std::string reason_;
+};
+
+} // namespace protobuf
+} // namespace node
@@ -22,11 +22,19 @@
 #include <node.h>
 #include <node_buffer.h>
 #include <node_object_wrap.h>
+#include <uv.h>
 
+#include <google/protobuf/arena.h>
 #include <google/protobuf/descriptor.h>
 #include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/unknown_field_set.h>
+#include <google/protobuf/wire_format.h>
 
+#include "diff.h"
+#include "fingerprint.h"
 #include "schema.h"
+#include "serializer.h"
 
 using google::protobuf::Descriptor;
 using google::protobuf::DescriptorPool;
@@ -34,6 +42,8 @@ using google::protobuf::FieldDescriptor;
 using google::protobuf::Message;
 using google::protobuf::MethodDescriptor;
 using google::protobuf::Reflection;
+using google::protobuf::UnknownFieldSet;
+using google::protobuf::internal::WireFormat;
 
 using std::map;
 using std::string;
@@ -49,6 +59,13 @@ static v8::Persistent<v8::FunctionTemplate> descriptor_constructor;
 const char E_NO_ARRAY[] = "Not an array";
 const char E_NO_OBJECT[] = "Not an object";
 const char E_UNKNOWN_ENUM[] = "Unknown enum value";
+const char E_MALFORMED_UNKNOWN[] = "Malformed unknown fields";
+const char E_NO_BUFFERS[] = "Expected two Buffers";
+const char E_MALFORMED_MESSAGE[] = "Malformed message";
+
+// Messages that only live for one call are built in an arena whose first
+// block is on the stack; larger trees chain heap blocks as needed.
+static const size_t kArenaBlockSize = 4096;
 
 Descriptor::Descriptor (
   v8::Local<v8::Object> handle,
@@ -64,8 +81,38 @@ Descriptor::~Descriptor () {
   NanDisposePersistent(persistentHandle);
 }
 
-google::protobuf::Message *Descriptor::NewMessage () {
-  return const_cast<Schema *>(schema_)->NewMessage(descriptor_);
+google::protobuf::Message *Descriptor::NewMessage (
+  google::protobuf::Arena *arena
+) {
+  return const_cast<Schema *>(schema_)->NewMessage(descriptor_, arena);
+}
+
+// Each descriptor carries its own `_arrayAsObject`/`_objectAsArray` pair
+// (see index.js); nested messages must be converted with theirs, not the
+// converter of the message being parsed or serialized. Descriptors that
+// were never wrapped by index.js, e.g. those of exported services, have
+// none and are converted natively by field name.
+v8::Local<v8::Function> Descriptor::Converter (const char *name) const {
+  v8::Local<v8::Object> handle =
+    NanObjectWrapHandle(const_cast<Descriptor *>(this));
+  v8::Local<v8::Value> converter = handle->Get(NanSymbol(name));
+  if (!converter->IsFunction()) {
+    return v8::Local<v8::Function>();
+  }
+  return converter.As<v8::Function>();
+}
+
+v8::Local<v8::Value> Descriptor::ToJS (
+  const google::protobuf::Message &message
+) const {
+  return ProtoToJS(Converter("_arrayAsObject"), message);
+}
+
+const char *Descriptor::FromJS (
+  google::protobuf::Message *message,
+  v8::Local<v8::Object> src
+) const {
+  return JSToProto(Converter("_objectAsArray"), message, src);
 }
 
 const Descriptor *Descriptor::DescriptorFor (
@@ -83,8 +130,14 @@ void Descriptor::Init (v8::Handle<v8::Object> exports) {
   t->InstanceTemplate()->SetInternalFieldCount(1);
   NODE_SET_PROTOTYPE_METHOD(t, "parse", Parse);
   NODE_SET_PROTOTYPE_METHOD(t, "serialize", Serialize);
+  NODE_SET_PROTOTYPE_METHOD(t, "equals", Equals);
+  NODE_SET_PROTOTYPE_METHOD(t, "diff", Diff);
+  NODE_SET_PROTOTYPE_METHOD(t, "fingerprint", Fingerprint);
   NODE_SET_PROTOTYPE_METHOD(t, "fields", Fields);
+  NODE_SET_PROTOTYPE_METHOD(t, "extensions", Extensions);
   NODE_SET_PROTOTYPE_METHOD(t, "toString", ToString);
+  NODE_SET_PROTOTYPE_METHOD(t, "stats", GetStats);
+  NODE_SET_PROTOTYPE_METHOD(t, "resetStats", ResetStats);
   exports->Set(NanSymbol("Descriptor"), t->GetFunction());
 }
 
@@ -133,21 +186,25 @@ NAN_METHOD(Descriptor::Parse) {
 
   Descriptor *descriptor = node::ObjectWrap::Unwrap<Descriptor>(args.This());
   v8::Local<v8::Object> buf = args[0]->ToObject();
+  size_t length = node::Buffer::Length(buf);
+
+  bool stats = descriptor->schema_->stats_;
+  google::protobuf::uint64 start = stats ? uv_hrtime() : 0;
 
-  google::protobuf::Message *message = descriptor->NewMessage();
-  bool success =
-    message->ParseFromArray(node::Buffer::Data(buf), node::Buffer::Length(buf));
+  char block[kArenaBlockSize];
+  google::protobuf::Arena arena(block, sizeof(block));
+  google::protobuf::Message *message = descriptor->NewMessage(&arena);
+  bool success = message->ParseFromArray(node::Buffer::Data(buf), length);
 
   v8::Local<v8::Value> result;
 
   if (success) {
-    v8::Local<v8::Function> converter_ =
-      args.This()->Get(NanSymbol("_arrayAsObject")).As<v8::Function>();
-    assert(!converter_.IsEmpty());
-    result = descriptor->ProtoToJS(converter_, *message);
+    result = descriptor->ToJS(*message);
   }
 
-  delete message;
+  if (stats) {
+    descriptor->parse_stats_.Record(start, length, success);
+  }
 
   if (!success) {
     return NanThrowError("Malformed message");
@@ -156,34 +213,46 @@ NAN_METHOD(Descriptor::Parse) {
   NanReturnValue(result);
 }
 
+// Options:
+//   canonical: write the canonical encoding, see Serializer.
 NAN_METHOD(Descriptor::Serialize) {
   NanScope();
 
-  if (args.Length() != 1) {
-    return NanThrowError("Expected single argument");
+  if (args.Length() < 1 || args.Length() > 2) {
+    return NanThrowError("Expected an Object and options");
   } else if (!args[0]->IsObject()) {
     return NanThrowError("Expected argument to be an Object");
   }
 
   Descriptor *descriptor = node::ObjectWrap::Unwrap<Descriptor>(args.This());
 
-  v8::Local<v8::Function> converter_ =
-    args.This()->Get(NanSymbol("_objectAsArray")).As<v8::Function>();
-  assert(!converter_.IsEmpty());
+  bool canonical = false;
+  if (args.Length() > 1 && args[1]->IsObject()) {
+    canonical =
+      args[1]->ToObject()->Get(NanSymbol("canonical"))->BooleanValue();
+  }
+
+  bool stats = descriptor->schema_->stats_;
+  google::protobuf::uint64 start = stats ? uv_hrtime() : 0;
 
-  google::protobuf::Message *message = descriptor->NewMessage();
-  const char *error =
-    descriptor->JSToProto(converter_, message, args[0]->ToObject());
+  char block[kArenaBlockSize];
+  google::protobuf::Arena arena(block, sizeof(block));
+  google::protobuf::Message *message = descriptor->NewMessage(&arena);
+  const char *error = descriptor->FromJS(message, args[0]->ToObject());
 
   v8::Local<v8::Object> buf;
 
   if (!error) {
-    buf = NanNewBufferHandle(message->ByteSize());
-    message->SerializeWithCachedSizesToArray(
+    Serializer serializer(canonical, descriptor->schema_->unknown_fields_);
+    buf = NanNewBufferHandle(serializer.ByteSize(*message));
+    serializer.SerializeToArray(*message,
       reinterpret_cast<google::protobuf::uint8 *>(node::Buffer::Data(buf)));
   }
 
-  delete message;
+  if (stats) {
+    descriptor->serialize_stats_.Record(
+      start, error ? 0 : node::Buffer::Length(buf), !error);
+  }
 
   if (error) {
     return NanThrowError(error);
@@ -192,6 +261,127 @@ NAN_METHOD(Descriptor::Serialize) {
   NanReturnValue(buf);
 }
 
+// Parses the arguments of equals() and diff() into `a` and `b`. Missing
+// required fields are not an error: they compare like any other.
+const char *Descriptor::ParsePair (
+  v8::Local<v8::Value> bufA,
+  v8::Local<v8::Value> bufB,
+  google::protobuf::Message *a,
+  google::protobuf::Message *b
+) {
+  if (!Buffer::HasInstance(bufA) || !Buffer::HasInstance(bufB)) {
+    return E_NO_BUFFERS;
+  }
+
+  v8::Local<v8::Object> objA = bufA->ToObject();
+  v8::Local<v8::Object> objB = bufB->ToObject();
+
+  if (!a->ParsePartialFromArray(Buffer::Data(objA), Buffer::Length(objA)) ||
+      !b->ParsePartialFromArray(Buffer::Data(objB), Buffer::Length(objB))) {
+    return E_MALFORMED_MESSAGE;
+  }
+
+  return NULL;
+}
+
+NAN_METHOD(Descriptor::Equals) {
+  NanScope();
+
+  Descriptor *descriptor = node::ObjectWrap::Unwrap<Descriptor>(args.This());
+  char block[kArenaBlockSize];
+  google::protobuf::Arena arena(block, sizeof(block));
+  google::protobuf::Message *a = descriptor->NewMessage(&arena);
+  google::protobuf::Message *b = descriptor->NewMessage(&arena);
+
+  const char *error = ParsePair(args[0], args[1], a, b);
+  bool equal = false;
+
+  if (!error) {
+    MessageDiff diff(descriptor->schema_->unknown_fields_);
+    equal = diff.Equals(*a, *b);
+  }
+
+  if (error) {
+    return NanThrowError(error);
+  }
+
+  NanReturnValue(equal ? NanTrue() : NanFalse());
+}
+
+NAN_METHOD(Descriptor::Diff) {
+  NanScope();
+
+  Descriptor *descriptor = node::ObjectWrap::Unwrap<Descriptor>(args.This());
+  char block[kArenaBlockSize];
+  google::protobuf::Arena arena(block, sizeof(block));
+  google::protobuf::Message *a = descriptor->NewMessage(&arena);
+  google::protobuf::Message *b = descriptor->NewMessage(&arena);
+
+  const char *error = ParsePair(args[0], args[1], a, b);
+  vector<string> paths;
+
+  if (!error) {
+    MessageDiff diff(descriptor->schema_->unknown_fields_);
+    diff.Compare(*a, *b, &paths);
+  }
+
+  if (error) {
+    return NanThrowError(error);
+  }
+
+  v8::Local<v8::Array> result = NanNew<v8::Array>(paths.size());
+  for (size_t i = 0; i < paths.size(); i++) {
+    result->Set(i, NanNew<v8::String>(paths[i].c_str()));
+  }
+
+  NanReturnValue(result);
+}
+
+// Hashes the canonical encoding of a message, given as an Object or an
+// encoded Buffer, as it is serialized. Returns 16 hex digits of XXH64.
+NAN_METHOD(Descriptor::Fingerprint) {
+  NanScope();
+
+  if (args.Length() != 1 || !args[0]->IsObject()) {
+    return NanThrowError("Expected an Object or a Buffer");
+  }
+
+  Descriptor *descriptor = node::ObjectWrap::Unwrap<Descriptor>(args.This());
+  char block[kArenaBlockSize];
+  google::protobuf::Arena arena(block, sizeof(block));
+  google::protobuf::Message *message = descriptor->NewMessage(&arena);
+  const char *error = NULL;
+
+  if (Buffer::HasInstance(args[0])) {
+    v8::Local<v8::Object> buf = args[0]->ToObject();
+    if (!message->ParsePartialFromArray(Buffer::Data(buf),
+                                        Buffer::Length(buf))) {
+      error = E_MALFORMED_MESSAGE;
+    }
+  } else {
+    error = descriptor->FromJS(message, args[0]->ToObject());
+  }
+
+  std::string hex;
+
+  if (!error) {
+    Serializer serializer(true, descriptor->schema_->unknown_fields_);
+    node::protobuf::Fingerprint fingerprint;
+    serializer.ByteSize(*message);
+    {
+      google::protobuf::io::CodedOutputStream output(&fingerprint);
+      serializer.Serialize(*message, &output);
+    }
+    hex = fingerprint.Hex();
+  }
+
+  if (error) {
+    return NanThrowError(error);
+  }
+
+  NanReturnValue(NanNew<v8::String>(hex.c_str()));
+}
+
 NAN_METHOD(Descriptor::Fields) {
   Descriptor *descriptor = node::ObjectWrap::Unwrap<Descriptor>(args.This());
   const google::protobuf::Descriptor *descriptor_ = descriptor->descriptor_;
@@ -206,11 +396,48 @@ NAN_METHOD(Descriptor::Fields) {
   NanReturnValue(fields);
 }
 
+NAN_METHOD(Descriptor::Extensions) {
+  Descriptor *descriptor = node::ObjectWrap::Unwrap<Descriptor>(args.This());
+  const Schema::extension_list_type *extensions =
+    descriptor->schema_->ExtensionsFor(descriptor->descriptor_);
+
+  int count = extensions ? extensions->size() : 0;
+  v8::Local<v8::Array> names = NanNew<v8::Array>(count);
+
+  for (int i = 0; i < count; i++) {
+    const google::protobuf::FieldDescriptor *field = (*extensions)[i];
+    names->Set(i, NanNew<v8::String>(field->full_name().c_str()));
+  }
+
+  NanReturnValue(names);
+}
+
 NAN_METHOD(Descriptor::ToString) {
   Descriptor *descriptor = node::ObjectWrap::Unwrap<Descriptor>(args.This());
   NanReturnValue(NanNew<v8::String>(descriptor->descriptor_->full_name().c_str()));
 }
 
+NAN_METHOD(Descriptor::GetStats) {
+  NanScope();
+  Descriptor *descriptor = node::ObjectWrap::Unwrap<Descriptor>(args.This());
+
+  v8::Local<v8::Object> result = NanNew<v8::Object>();
+  result->Set(NanSymbol("parse"), descriptor->parse_stats_.ToJS());
+  result->Set(NanSymbol("serialize"), descriptor->serialize_stats_.ToJS());
+
+  NanReturnValue(result);
+}
+
+NAN_METHOD(Descriptor::ResetStats) {
+  NanScope();
+  Descriptor *descriptor = node::ObjectWrap::Unwrap<Descriptor>(args.This());
+
+  descriptor->parse_stats_.Reset();
+  descriptor->serialize_stats_.Reset();
+
+  NanReturnUndefined();
+}
+
 v8::Local<v8::Value> Descriptor::ProtoToJS(
   v8::Local<v8::Function> converter_,
   const google::protobuf::Message &message
@@ -222,32 +449,88 @@ v8::Local<v8::Value> Descriptor::ProtoToJS(
 
   for (int i = 0; i < descriptor->field_count(); i++) {
     const google::protobuf::FieldDescriptor *field = descriptor->field(i);
+    v8::Local<v8::Value> value =
+      ProtoToJS(converter_, message, reflection, field);
+    if (!value.IsEmpty()) properties->Set(i, value);
+  }
 
-    bool repeated = field->is_repeated();
-    if (repeated && !reflection->FieldSize(message, field)) continue;
-    if (!repeated && !reflection->HasField(message, field)) continue;
-
-    const Descriptor *child = DescriptorFor(field);
+  v8::Local<v8::Value> result;
 
-    v8::Local<v8::Value> value;
+  if (converter_.IsEmpty()) {
+    v8::Local<v8::Object> object = NanNew<v8::Object>();
+    for (int i = 0; i < descriptor->field_count(); i++) {
+      v8::Local<v8::Value> value = properties->Get(i);
+      if (value->IsUndefined()) continue;
+      object->Set(NanSymbol(descriptor->field(i)->name().c_str()), value);
+    }
+    result = object;
+  } else {
+    result = converter_->Call(properties, 0, NULL);
+  }
 
-    if (field->is_repeated()) {
-      int size = reflection->FieldSize(message, field);
-      v8::Local<v8::Array> array = NanNew<v8::Array>(size);
-      for (int j = 0; j < size; j++) {
-        array->Set(j, ProtoToJS(converter_, message, reflection, field, child, j));
+  const Schema::extension_list_type *extensions =
+    schema_->ExtensionsFor(descriptor);
+
+  if (extensions) {
+    v8::Local<v8::Object> object = result->ToObject();
+    for (size_t i = 0; i < extensions->size(); i++) {
+      const google::protobuf::FieldDescriptor *field = (*extensions)[i];
+      v8::Local<v8::Value> value =
+        ProtoToJS(converter_, message, reflection, field);
+      if (!value.IsEmpty()) {
+        object->Set(NanSymbol(field->full_name().c_str()), value);
       }
-      value = array;
-    } else {
-      value = ProtoToJS(converter_, message, reflection, field, child, -1);
     }
+  }
+
+  if (schema_->unknown_fields_) {
+    const UnknownFieldSet &unknown = reflection->GetUnknownFields(message);
+    if (!unknown.empty()) {
+      v8::Local<v8::Object> buf =
+        NanNewBufferHandle(WireFormat::ComputeUnknownFieldsSize(unknown));
+      WireFormat::SerializeUnknownFieldsToArray(unknown,
+        reinterpret_cast<google::protobuf::uint8 *>(node::Buffer::Data(buf)));
+      result->ToObject()->ForceSet(NanSymbol("_unknownFields"), buf,
+        v8::DontEnum);
+    }
+  }
+
+  return result;
+}
+
+// Converts a whole field, repeated or not. Returns an empty handle if the
+// field is not set.
+v8::Local<v8::Value> Descriptor::ProtoToJS(
+  v8::Local<v8::Function> converter_,
+  const google::protobuf::Message &message,
+  const google::protobuf::Reflection *reflection,
+  const google::protobuf::FieldDescriptor *field
+) const {
+  bool repeated = field->is_repeated();
+  if (repeated && !reflection->FieldSize(message, field)) {
+    return v8::Local<v8::Value>();
+  }
+  if (!repeated && !reflection->HasField(message, field)) {
+    return v8::Local<v8::Value>();
+  }
+
+  const Descriptor *child = DescriptorFor(field);
+
+  v8::Local<v8::Value> value;
 
-    assert(!value.IsEmpty());
-    properties->Set(i, value);
+  if (repeated) {
+    int size = reflection->FieldSize(message, field);
+    v8::Local<v8::Array> array = NanNew<v8::Array>(size);
+    for (int j = 0; j < size; j++) {
+      array->Set(j, ProtoToJS(converter_, message, reflection, field, child, j));
+    }
+    value = array;
+  } else {
+    value = ProtoToJS(converter_, message, reflection, field, child, -1);
   }
 
-  assert(!converter_.IsEmpty());
-  return converter_->Call(properties, 0, NULL);
+  assert(!value.IsEmpty());
+  return value;
 }
 
 #define GET(TYPE) (                                                  \
@@ -266,7 +549,7 @@ v8::Local<v8::Value> Descriptor::ProtoToJS(
   switch (field->cpp_type()) {
   case FieldDescriptor::CPPTYPE_MESSAGE:
     assert(descriptor != NULL);
-    return descriptor->ProtoToJS(converter_, GET(Message));
+    return descriptor->ToJS(GET(Message));
   case FieldDescriptor::CPPTYPE_STRING: {
     const string &value = GET(String);
     if (field->type() == FieldDescriptor::TYPE_BYTES) {
@@ -311,38 +594,81 @@ const char *Descriptor::JSToProto (
   google::protobuf::Message *message,
   v8::Local<v8::Object> src
 ) const {
-  assert(!converter_.IsEmpty());
-  v8::Local<v8::Array> properties = converter_->Call(src, 0, NULL).As<v8::Array>();
+  v8::Local<v8::Array> properties;
+  if (!converter_.IsEmpty()) {
+    properties = converter_->Call(src, 0, NULL).As<v8::Array>();
+  }
 
   const char *error = NULL;
 
   for (int i = 0; error == NULL && i < descriptor_->field_count(); i++) {
-    v8::Local<v8::Value> value = properties->Get(i);
-
-    if (value->IsUndefined() || value->IsNull()) continue;
-
     const google::protobuf::FieldDescriptor *field = descriptor_->field(i);
-    const Descriptor *child = DescriptorFor(field);
+    error = JSToProto(converter_, message, field,
+      converter_.IsEmpty() ?
+      src->Get(NanSymbol(field->name().c_str())) :
+      properties->Get(i));
+  }
 
-    if (field->is_repeated()) {
-      if (!value->IsArray()) {
-        return E_NO_ARRAY;
-      }
+  const Schema::extension_list_type *extensions =
+    schema_->ExtensionsFor(descriptor_);
 
-      v8::Local<v8::Array> array = value.As<v8::Array>();
+  if (extensions) {
+    for (size_t i = 0; error == NULL && i < extensions->size(); i++) {
+      const google::protobuf::FieldDescriptor *field = (*extensions)[i];
+      error = JSToProto(converter_, message, field,
+        src->Get(NanSymbol(field->full_name().c_str())));
+    }
+  }
 
-      int length = array->Length();
-      for (int j = 0; j < length; j++) {
-        error = JSToProto(converter_, message, field, array->Get(j), child, true);
+  if (error == NULL && schema_->unknown_fields_) {
+    v8::Local<v8::Value> unknown = src->Get(NanSymbol("_unknownFields"));
+    if (node::Buffer::HasInstance(unknown)) {
+      v8::Local<v8::Object> buf = unknown->ToObject();
+      UnknownFieldSet *fields =
+        message->GetReflection()->MutableUnknownFields(message);
+      google::protobuf::io::CodedInputStream input(
+        reinterpret_cast<const google::protobuf::uint8 *>(
+          node::Buffer::Data(buf)),
+        node::Buffer::Length(buf));
+      if (!fields->MergeFromCodedStream(&input)) {
+        error = E_MALFORMED_UNKNOWN;
       }
-    } else {
-      error = JSToProto(converter_, message, field, value, child, false);
     }
   }
 
   return error;
 }
 
+// Converts a whole field, repeated or not. Unset values are skipped.
+const char *Descriptor::JSToProto (
+  v8::Local<v8::Function> converter_,
+  google::protobuf::Message *message,
+  const google::protobuf::FieldDescriptor *field,
+  v8::Local<v8::Value> value
+) const {
+  if (value->IsUndefined() || value->IsNull()) return NULL;
+
+  const Descriptor *child = DescriptorFor(field);
+
+  if (!field->is_repeated()) {
+    return JSToProto(converter_, message, field, value, child, false);
+  }
+
+  if (!value->IsArray()) {
+    return E_NO_ARRAY;
+  }
+
+  v8::Local<v8::Array> array = value.As<v8::Array>();
+
+  const char *error = NULL;
+  int length = array->Length();
+  for (int j = 0; error == NULL && j < length; j++) {
+    error = JSToProto(converter_, message, field, array->Get(j), child, true);
+  }
+
+  return error;
+}
+
 #define SET(TYPE, EXPR)                                              \
   if (repeated) reflection->Add##TYPE(message, field, EXPR);         \
   else reflection->Set##TYPE(message, field, EXPR)
@@ -362,13 +688,12 @@ const char *Descriptor::JSToProto(
     if (!value->IsObject()) {
       return E_NO_OBJECT;
     }
-    descriptor->JSToProto(converter_,
+    return descriptor->FromJS(
       repeated ?
       reflection->AddMessage(message, field) :
       reflection->MutableMessage(message, field),
       value->ToObject()
     );
-    break;
   case FieldDescriptor::CPPTYPE_STRING: {
     if (node::Buffer::HasInstance(value)) {
       v8::Local<v8::Object> buf = value->ToObject();
@@ -17,8 +17,11 @@
 #include <node.h>
 #include <nan.h>
 
+#include <google/protobuf/arena.h>
 #include <google/protobuf/descriptor.h>
 
+#include "stats.h"
+
 namespace node {
 namespace protobuf {
 
@@ -41,18 +44,46 @@ public:
 
   ~Descriptor ();
 
+  v8::Local<v8::Value> ToJS (
+    const google::protobuf::Message &message
+  ) const;
+
+  const char *FromJS (
+    google::protobuf::Message *message,
+    v8::Local<v8::Object> src
+  ) const;
+
 private:
   const Schema *schema_;
   const google::protobuf::Descriptor *descriptor_;
   v8::Persistent<v8::Object> persistentHandle;
+  Stats parse_stats_;
+  Stats serialize_stats_;
 
   static NAN_METHOD(New);
   static NAN_METHOD(Parse);
   static NAN_METHOD(Serialize);
+  static NAN_METHOD(Equals);
+  static NAN_METHOD(Diff);
+  static NAN_METHOD(Fingerprint);
   static NAN_METHOD(Fields);
+  static NAN_METHOD(Extensions);
   static NAN_METHOD(ToString);
+  static NAN_METHOD(GetStats);
+  static NAN_METHOD(ResetStats);
+
+  google::protobuf::Message *NewMessage (
+    google::protobuf::Arena *arena = NULL
+  );
 
-  google::protobuf::Message *NewMessage ();
+  static const char *ParsePair (
+    v8::Local<v8::Value> bufA,
+    v8::Local<v8::Value> bufB,
+    google::protobuf::Message *a,
+    google::protobuf::Message *b
+  );
+
+  v8::Local<v8::Function> Converter (const char *name) const;
 
   const Descriptor *DescriptorFor (
     const google::protobuf::FieldDescriptor *field
@@ -63,6 +94,13 @@ private:
     const google::protobuf::Message &message
   ) const;
 
+  v8::Local<v8::Value> ProtoToJS (
+    v8::Local<v8::Function> converter_,
+    const google::protobuf::Message &message,
+    const google::protobuf::Reflection *reflection,
+    const google::protobuf::FieldDescriptor *field
+  ) const;
+
   v8::Local<v8::Value> ProtoToJS (
     v8::Local<v8::Function> converter_,
     const google::protobuf::Message &message,
@@ -78,6 +116,13 @@ private:
     v8::Local<v8::Object> src
   ) const;
 
+  const char *JSToProto (
+    v8::Local<v8::Function> converter_,
+    google::protobuf::Message *message,
+    const google::protobuf::FieldDescriptor *field,
+    v8::Local<v8::Value> value
+  ) const;
+
   const char *JSToProto (
     v8::Local<v8::Function> converter_,
     google::protobuf::Message *message,
@@ -0,0 +1,278 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+
+#include <algorithm>
+
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/stubs/strutil.h>
+
+#include "diff.h"
+
+using google::protobuf::FieldDescriptor;
+using google::protobuf::Message;
+using google::protobuf::Reflection;
+using google::protobuf::UnknownField;
+using google::protobuf::UnknownFieldSet;
+
+namespace node {
+namespace protobuf {
+
+const char UNKNOWN_FIELDS_PATH[] = "_unknownFields";
+
+static bool FieldNumberLess (const UnknownField *a, const UnknownField *b) {
+  return a->number() < b->number();
+}
+
+template <typename T>
+static bool FloatEquals (T a, T b) {
+  return a == b || (a != a && b != b);
+}
+
+bool MessageDiff::Equals (const Message &a, const Message &b) {
+  paths_ = NULL;
+  path_.clear();
+  return CompareMessage(a, b);
+}
+
+bool MessageDiff::Compare (
+  const Message &a,
+  const Message &b,
+  std::vector<std::string> *paths
+) {
+  paths_ = paths;
+  path_.clear();
+  bool equal = CompareMessage(a, b);
+  paths_ = NULL;
+  return equal;
+}
+
+void MessageDiff::Report () {
+  if (paths_ != NULL) paths_->push_back(path_);
+}
+
+bool MessageDiff::CompareMessage (const Message &a, const Message &b) {
+  const google::protobuf::Descriptor *descriptor = a.GetDescriptor();
+  const Reflection *ra = a.GetReflection();
+  const Reflection *rb = b.GetReflection();
+  bool equal = true;
+
+  for (int i = 0; i < descriptor->field_count(); i++) {
+    if (!CompareField(a, b, descriptor->field(i))) {
+      equal = false;
+      if (paths_ == NULL) return false;
+    }
+  }
+
+  // Extensions set on either side, in field number order.
+  if (descriptor->extension_range_count()) {
+    std::vector<const FieldDescriptor *> fa, fb, extensions;
+    ra->ListFields(a, &fa);
+    rb->ListFields(b, &fb);
+
+    std::vector<const FieldDescriptor *>::iterator ia = fa.begin();
+    std::vector<const FieldDescriptor *>::iterator ib = fb.begin();
+    while (ia != fa.end() || ib != fb.end()) {
+      const FieldDescriptor *field;
+      if (ib == fb.end() ||
+          (ia != fa.end() && (*ia)->number() < (*ib)->number())) {
+        field = *ia++;
+      } else if (ia == fa.end() || (*ib)->number() < (*ia)->number()) {
+        field = *ib++;
+      } else {
+        field = *ia++;
+        ib++;
+      }
+      if (field->is_extension()) extensions.push_back(field);
+    }
+
+    for (size_t i = 0; i < extensions.size(); i++) {
+      if (!CompareField(a, b, extensions[i])) {
+        equal = false;
+        if (paths_ == NULL) return false;
+      }
+    }
+  }
+
+  if (unknown_fields_ &&
+      !CompareUnknownFields(ra->GetUnknownFields(a),
+                            rb->GetUnknownFields(b))) {
+    size_t length = path_.size();
+    if (length) path_ += '.';
+    path_ += UNKNOWN_FIELDS_PATH;
+    Report();
+    path_.resize(length);
+    equal = false;
+  }
+
+  return equal;
+}
+
+bool MessageDiff::CompareField (
+  const Message &a,
+  const Message &b,
+  const FieldDescriptor *field
+) {
+  // Paths are only built when differences are wanted.
+  bool paths = paths_ != NULL;
+  size_t length = path_.size();
+  if (paths) {
+    if (length) path_ += '.';
+    if (field->is_extension()) {
+      path_ += '[';
+      path_ += field->full_name();
+      path_ += ']';
+    } else {
+      path_ += field->name();
+    }
+  }
+
+  bool equal = true;
+
+  if (!field->is_repeated()) {
+    equal = CompareValue(a, b, field, -1);
+  } else {
+    int sa = a.GetReflection()->FieldSize(a, field);
+    int sb = b.GetReflection()->FieldSize(b, field);
+    size_t prefix = path_.size();
+
+    for (int i = 0; i < std::max(sa, sb); i++) {
+      if (paths) {
+        path_ += '[';
+        path_ += google::protobuf::SimpleItoa(i);
+        path_ += ']';
+      }
+
+      bool same;
+      if (i < sa && i < sb) {
+        same = CompareValue(a, b, field, i);
+      } else {
+        same = false;
+        Report();
+      }
+
+      path_.resize(prefix);
+
+      if (!same) {
+        equal = false;
+        if (!paths) break;
+      }
+    }
+  }
+
+  path_.resize(length);
+  return equal;
+}
+
+// Compares element `index` of a repeated field, or a singular field if
+// `index` is negative. Records the difference, unless the values are
+// messages, whose differences are recorded by field.
+bool MessageDiff::CompareValue (
+  const Message &a,
+  const Message &b,
+  const FieldDescriptor *field,
+  int index
+) {
+  const Reflection *ra = a.GetReflection();
+  const Reflection *rb = b.GetReflection();
+  bool repeated = index >= 0;
+  bool equal;
+
+  switch (field->cpp_type()) {
+#define COMPARE(CPPTYPE, METHOD, EQUALS)                                   \
+    case FieldDescriptor::CPPTYPE_##CPPTYPE:                              \
+      equal = repeated                                                    \
+        ? EQUALS(ra->GetRepeated##METHOD(a, field, index),                \
+                 rb->GetRepeated##METHOD(b, field, index))                \
+        : EQUALS(ra->Get##METHOD(a, field), rb->Get##METHOD(b, field));   \
+      break;
+#define EQ(x, y) ((x) == (y))
+
+    COMPARE(INT32, Int32, EQ)
+    COMPARE(INT64, Int64, EQ)
+    COMPARE(UINT32, UInt32, EQ)
+    COMPARE(UINT64, UInt64, EQ)
+    COMPARE(BOOL, Bool, EQ)
+    COMPARE(ENUM, Enum, EQ)
+    COMPARE(FLOAT, Float, FloatEquals)
+    COMPARE(DOUBLE, Double, FloatEquals)
+#undef EQ
+#undef COMPARE
+
+    case FieldDescriptor::CPPTYPE_STRING: {
+      std::string sa, sb;
+      equal = repeated
+        ? ra->GetRepeatedStringReference(a, field, index, &sa) ==
+          rb->GetRepeatedStringReference(b, field, index, &sb)
+        : ra->GetStringReference(a, field, &sa) ==
+          rb->GetStringReference(b, field, &sb);
+      break;
+    }
+
+    case FieldDescriptor::CPPTYPE_MESSAGE:
+      // Unset sub-messages read as their default instance.
+      return repeated
+        ? CompareMessage(ra->GetRepeatedMessage(a, field, index),
+                         rb->GetRepeatedMessage(b, field, index))
+        : CompareMessage(ra->GetMessage(a, field), rb->GetMessage(b, field));
+  }
+
+  if (!equal) Report();
+  return equal;
+}
+
+bool MessageDiff::CompareUnknownFields (
+  const UnknownFieldSet &a,
+  const UnknownFieldSet &b
+) const {
+  if (a.field_count() != b.field_count()) return false;
+  if (a.empty()) return true;
+
+  // Same-numbered fields keep their order, as repeated values do.
+  std::vector<const UnknownField *> fa, fb;
+  for (int i = 0; i < a.field_count(); i++) fa.push_back(&a.field(i));
+  for (int i = 0; i < b.field_count(); i++) fb.push_back(&b.field(i));
+  std::stable_sort(fa.begin(), fa.end(), FieldNumberLess);
+  std::stable_sort(fb.begin(), fb.end(), FieldNumberLess);
+
+  for (size_t i = 0; i < fa.size(); i++) {
+    const UnknownField &x = *fa[i];
+    const UnknownField &y = *fb[i];
+
+    if (x.number() != y.number() || x.type() != y.type()) return false;
+
+    switch (x.type()) {
+      case UnknownField::TYPE_VARINT:
+        if (x.varint() != y.varint()) return false;
+        break;
+      case UnknownField::TYPE_FIXED32:
+        if (x.fixed32() != y.fixed32()) return false;
+        break;
+      case UnknownField::TYPE_FIXED64:
+        if (x.fixed64() != y.fixed64()) return false;
+        break;
+      case UnknownField::TYPE_LENGTH_DELIMITED:
+        if (x.length_delimited() != y.length_delimited()) return false;
+        break;
+      case UnknownField::TYPE_GROUP:
+        if (!CompareUnknownFields(x.group(), y.group())) return false;
+        break;
+    }
+  }
+
+  return true;
+}
+
+} // namespace protobuf
+} // namespace node
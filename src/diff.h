@@ -0,0 +1,91 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <google/protobuf/message.h>
+#include <google/protobuf/unknown_field_set.h>
+
+namespace node {
+namespace protobuf {
+
+// Compares two messages of the same type field by field, through
+// reflection. Parsed messages have no memory of field order or of packed
+// versus unpacked encoding, and fields are compared by value, so a field
+// set to its default equals an unset one, and an empty sub-message an
+// absent one. NaN equals NaN.
+//
+// Differences are reported as paths such as "a.b[2].c", with extensions
+// named "[package.extension]". A repeated field of different lengths
+// differs at every index past the shorter one. Unknown fields are only
+// compared if `unknown_fields` is set, by number and value, and differ as
+// "_unknownFields".
+class MessageDiff {
+public:
+  explicit MessageDiff (bool unknown_fields)
+    : unknown_fields_(unknown_fields), paths_(NULL) {}
+
+  // Returns whether the messages are equal, stopping at the first
+  // difference.
+  bool Equals (
+    const google::protobuf::Message &a,
+    const google::protobuf::Message &b
+  );
+
+  // Returns whether the messages are equal, appending the path of every
+  // difference to `paths`.
+  bool Compare (
+    const google::protobuf::Message &a,
+    const google::protobuf::Message &b,
+    std::vector<std::string> *paths
+  );
+
+private:
+  bool unknown_fields_;
+  std::vector<std::string> *paths_;
+  std::string path_;
+
+  bool CompareMessage (
+    const google::protobuf::Message &a,
+    const google::protobuf::Message &b
+  );
+
+  bool CompareField (
+    const google::protobuf::Message &a,
+    const google::protobuf::Message &b,
+    const google::protobuf::FieldDescriptor *field
+  );
+
+  bool CompareValue (
+    const google::protobuf::Message &a,
+    const google::protobuf::Message &b,
+    const google::protobuf::FieldDescriptor *field,
+    int index
+  );
+
+  bool CompareUnknownFields (
+    const google::protobuf::UnknownFieldSet &a,
+    const google::protobuf::UnknownFieldSet &b
+  ) const;
+
+  // Records a difference at the current path, if differences are wanted.
+  void Report ();
+};
+
+} // namespace protobuf
+} // namespace node
@@ -0,0 +1,168 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+
+#include <assert.h>
+#include <string.h>
+
+#include "fingerprint.h"
+
+using google::protobuf::int64;
+using google::protobuf::uint8;
+using google::protobuf::uint32;
+using google::protobuf::uint64;
+
+namespace node {
+namespace protobuf {
+
+static const uint64 kPrime1 = GOOGLE_ULONGLONG(11400714785074694791);
+static const uint64 kPrime2 = GOOGLE_ULONGLONG(14029467366897019727);
+static const uint64 kPrime3 = GOOGLE_ULONGLONG(1609587929392839161);
+static const uint64 kPrime4 = GOOGLE_ULONGLONG(9650029242287828579);
+static const uint64 kPrime5 = GOOGLE_ULONGLONG(2870177450012600261);
+
+static inline uint64 Rotate (uint64 x, int bits) {
+  return (x << bits) | (x >> (64 - bits));
+}
+
+static inline uint64 Read64 (const uint8 *p) {
+  return static_cast<uint64>(p[0]) | static_cast<uint64>(p[1]) << 8 |
+    static_cast<uint64>(p[2]) << 16 | static_cast<uint64>(p[3]) << 24 |
+    static_cast<uint64>(p[4]) << 32 | static_cast<uint64>(p[5]) << 40 |
+    static_cast<uint64>(p[6]) << 48 | static_cast<uint64>(p[7]) << 56;
+}
+
+static inline uint32 Read32 (const uint8 *p) {
+  return static_cast<uint32>(p[0]) | static_cast<uint32>(p[1]) << 8 |
+    static_cast<uint32>(p[2]) << 16 | static_cast<uint32>(p[3]) << 24;
+}
+
+static inline uint64 Round (uint64 acc, uint64 input) {
+  acc += input * kPrime2;
+  return Rotate(acc, 31) * kPrime1;
+}
+
+static inline uint64 Merge (uint64 acc, uint64 value) {
+  acc ^= Round(0, value);
+  return acc * kPrime1 + kPrime4;
+}
+
+Fingerprint::Fingerprint (uint64 seed)
+  : seed_(seed),
+    v1_(seed + kPrime1 + kPrime2), v2_(seed + kPrime2),
+    v3_(seed), v4_(seed - kPrime1),
+    total_(0), used_(0), pending_(0) {}
+
+bool Fingerprint::Next (void **data, int *size) {
+  Consume();
+  *data = buffer_ + used_;
+  *size = kBufferSize - used_;
+  pending_ = *size;
+  used_ = kBufferSize;
+  return true;
+}
+
+void Fingerprint::BackUp (int count) {
+  assert(count <= pending_);
+  used_ -= count;
+  pending_ -= count;
+}
+
+int64 Fingerprint::ByteCount () const {
+  return total_ + used_;
+}
+
+// Hashes the whole stripes in the buffer and moves the rest to the front.
+void Fingerprint::Consume () {
+  int stripes = used_ / 32 * 32;
+
+  for (const uint8 *p = buffer_; p < buffer_ + stripes; p += 32) {
+    v1_ = Round(v1_, Read64(p));
+    v2_ = Round(v2_, Read64(p + 8));
+    v3_ = Round(v3_, Read64(p + 16));
+    v4_ = Round(v4_, Read64(p + 24));
+  }
+
+  total_ += stripes;
+  used_ -= stripes;
+  memmove(buffer_, buffer_ + stripes, used_);
+  pending_ = 0;
+}
+
+uint64 Fingerprint::Digest () const {
+  // Stripes are only consumed on Next(), so these are the stripes seen
+  // so far plus a tail, which may itself hold whole stripes.
+  uint64 v1 = v1_, v2 = v2_, v3 = v3_, v4 = v4_;
+  const uint8 *p = buffer_;
+  const uint8 *end = buffer_ + used_;
+  uint64 length = total_ + used_;
+
+  for (; p + 32 <= end; p += 32) {
+    v1 = Round(v1, Read64(p));
+    v2 = Round(v2, Read64(p + 8));
+    v3 = Round(v3, Read64(p + 16));
+    v4 = Round(v4, Read64(p + 24));
+  }
+
+  uint64 hash;
+  if (length >= 32) {
+    hash = Rotate(v1, 1) + Rotate(v2, 7) + Rotate(v3, 12) + Rotate(v4, 18);
+    hash = Merge(hash, v1);
+    hash = Merge(hash, v2);
+    hash = Merge(hash, v3);
+    hash = Merge(hash, v4);
+  } else {
+    hash = seed_ + kPrime5;
+  }
+
+  hash += length;
+
+  for (; p + 8 <= end; p += 8) {
+    hash ^= Round(0, Read64(p));
+    hash = Rotate(hash, 27) * kPrime1 + kPrime4;
+  }
+
+  if (p + 4 <= end) {
+    hash ^= static_cast<uint64>(Read32(p)) * kPrime1;
+    hash = Rotate(hash, 23) * kPrime2 + kPrime3;
+    p += 4;
+  }
+
+  for (; p < end; p++) {
+    hash ^= *p * kPrime5;
+    hash = Rotate(hash, 11) * kPrime1;
+  }
+
+  hash ^= hash >> 33;
+  hash *= kPrime2;
+  hash ^= hash >> 29;
+  hash *= kPrime3;
+  hash ^= hash >> 32;
+
+  return hash;
+}
+
+std::string Fingerprint::Hex () const {
+  static const char kDigits[] = "0123456789abcdef";
+  uint64 hash = Digest();
+  std::string hex(16, '0');
+  for (int i = 15; i >= 0; i--) {
+    hex[i] = kDigits[hash & 0xF];
+    hash >>= 4;
+  }
+  return hex;
+}
+
+} // namespace protobuf
+} // namespace node
@@ -0,0 +1,62 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+
+#pragma once
+
+#include <string>
+
+#include <google/protobuf/io/zero_copy_stream.h>
+#include <google/protobuf/stubs/common.h>
+
+namespace node {
+namespace protobuf {
+
+// An output stream that keeps nothing but an XXH64 hash of what is
+// written to it, so that a message can be hashed while it is serialized
+// without being materialized.
+class Fingerprint : public google::protobuf::io::ZeroCopyOutputStream {
+public:
+  explicit Fingerprint (google::protobuf::uint64 seed = 0);
+
+  // Returns the hash of everything written so far. Writing must be
+  // finished: any CodedOutputStream on top must have been destroyed.
+  google::protobuf::uint64 Digest () const;
+
+  // The digest as 16 lowercase hex digits.
+  std::string Hex () const;
+
+  bool Next (void **data, int *size);
+  void BackUp (int count);
+  google::protobuf::int64 ByteCount () const;
+
+private:
+  static const int kBufferSize = 8192;
+
+  google::protobuf::uint64 seed_;
+  google::protobuf::uint64 v1_, v2_, v3_, v4_;
+  google::protobuf::uint64 total_;
+  // Bytes handed out by Next() but not yet hashed. Whole stripes are
+  // hashed as the buffer is recycled; the tail carries over.
+  google::protobuf::uint8 buffer_[kBufferSize];
+  int used_;
+  int pending_;
+
+  void Consume ();
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(Fingerprint);
+};
+
+} // namespace protobuf
+} // namespace node
@@ -15,8 +15,11 @@
 #include <node.h>
 #include <nan.h>
 
+#include "channel.h"
 #include "schema.h"
 #include "descriptor.h"
+#include "server.h"
+#include "service.h"
 
 namespace node {
 namespace protobuf {
@@ -24,6 +27,9 @@ namespace protobuf {
 void Init(v8::Handle<v8::Object> exports) {
   Schema::Init(exports);
   Descriptor::Init(exports);
+  Service::Init(exports);
+  Channel::Init(exports);
+  Server::Init(exports);
 }
 
 NODE_MODULE(protobuf, Init)
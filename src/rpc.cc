@@ -0,0 +1,742 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include <set>
+#include <string>
+
+#include <uv.h>
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
+#include <google/protobuf/wire_format_lite_inl.h>
+
+#include "controller.h"
+#include "rpc.h"
+
+using google::protobuf::Closure;
+using google::protobuf::Message;
+using google::protobuf::MethodDescriptor;
+using google::protobuf::NewCallback;
+using google::protobuf::RpcController;
+using google::protobuf::uint8;
+using google::protobuf::uint32;
+using google::protobuf::uint64;
+using google::protobuf::io::CodedInputStream;
+using google::protobuf::io::CodedOutputStream;
+using google::protobuf::internal::WireFormatLite;
+
+namespace node {
+namespace protobuf {
+
+const char E_CHANNEL_CLOSED[] = "Channel closed";
+const char E_CONNECTION_CLOSED[] = "Connection closed";
+const char E_INVALID_ADDRESS[] = "Invalid address";
+const char E_FRAME_TOO_LARGE[] = "Frame too large";
+const char E_MALFORMED_FRAME[] = "Malformed frame";
+const char E_MALFORMED_REQUEST[] = "Malformed request";
+const char E_MALFORMED_RESPONSE[] = "Malformed response";
+const char E_NOT_CONNECTED[] = "Channel is not connected";
+const char E_UNKNOWN_METHOD[] = "Unknown method";
+
+// A write in flight. Owns the bytes until libuv is done with them.
+struct WriteRequest {
+  uv_write_t req;
+  std::string data;
+};
+
+// Decodes the body of a frame, without its length prefix.
+static bool DecodeFrame (const char *data, int size, Frame *frame) {
+  CodedInputStream input(reinterpret_cast<const uint8 *>(data), size);
+
+  frame->id = 0;
+  frame->method.clear();
+  frame->payload = NULL;
+  frame->payload_size = 0;
+  frame->error.clear();
+  frame->failed = false;
+
+  uint32 tag;
+  while ((tag = input.ReadTag()) != 0) {
+    WireFormatLite::WireType type = WireFormatLite::GetTagWireType(tag);
+    int number = WireFormatLite::GetTagFieldNumber(tag);
+
+    if (number == 1 && type == WireFormatLite::WIRETYPE_VARINT) {
+      if (!input.ReadVarint64(&frame->id)) return false;
+    } else if (number == 2 && type == WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+      if (!WireFormatLite::ReadString(&input, &frame->method)) return false;
+    } else if (number == 3 && type == WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+      // Not copied: the payload is parsed straight out of the read buffer.
+      uint32 length;
+      if (!input.ReadVarint32(&length)) return false;
+      frame->payload = data + input.CurrentPosition();
+      frame->payload_size = length;
+      if (!input.Skip(length)) return false;
+    } else if (number == 4 && type == WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+      if (!WireFormatLite::ReadString(&input, &frame->error)) return false;
+      frame->failed = true;
+    } else if (!WireFormatLite::SkipField(&input, tag)) {
+      return false;
+    }
+  }
+
+  return input.ConsumedEntireMessage();
+}
+
+// Reads a varint32 from the front of [data, data + size). Returns the
+// number of bytes consumed, 0 if more input is needed or -1 if malformed.
+static int ReadLength (const uint8 *data, size_t size, uint32 *length) {
+  uint32 result = 0;
+  for (size_t i = 0; i < 5; i++) {
+    if (i == size) return 0;
+    result |= static_cast<uint32>(data[i] & 0x7F) << (7 * i);
+    if (!(data[i] & 0x80)) {
+      *length = result;
+      return i + 1;
+    }
+  }
+  return -1;
+}
+
+/* FrameStream **************************************/
+
+FrameStream::FrameStream (uv_loop_t *loop)
+  : loop_(loop), open_(false), connected_(false), closing_(false),
+    handles_(0), refs_(0) {}
+
+FrameStream::~FrameStream () {}
+
+bool FrameStream::ParseAddress (
+  const std::string &address,
+  bool *pipe,
+  std::string *path,
+  std::string *host,
+  int *port
+) {
+  static const std::string kUnixPrefix = "unix:";
+
+  if (address.compare(0, kUnixPrefix.size(), kUnixPrefix) == 0) {
+    *pipe = true;
+    *path = address.substr(kUnixPrefix.size());
+    return !path->empty();
+  }
+
+  if (!address.empty() && address[0] == '/') {
+    *pipe = true;
+    *path = address;
+    return true;
+  }
+
+  size_t colon = address.rfind(':');
+  if (colon == std::string::npos || colon == 0) return false;
+
+  const char *start = address.c_str() + colon + 1;
+  char *end;
+  long value = strtol(start, &end, 10);
+  if (end == start || *end != '\0' || value <= 0 || value > 65535) {
+    return false;
+  }
+
+  *pipe = false;
+  *host = address.substr(0, colon);
+  *port = static_cast<int>(value);
+  return true;
+}
+
+void FrameStream::Start () {
+  stream()->data = this;
+  uv_idle_init(loop_, &flush_);
+  flush_.data = this;
+  open_ = true;
+  handles_ = 2;
+}
+
+int FrameStream::Connect (const std::string &address) {
+  bool pipe;
+  std::string path, host;
+  int port;
+
+  if (!ParseAddress(address, &pipe, &path, &host, &port)) {
+    Close(E_INVALID_ADDRESS);
+    return UV_EINVAL;
+  }
+
+  connect_.data = this;
+
+  if (pipe) {
+    uv_pipe_init(loop_, &handle_.pipe, 0);
+    Start();
+    uv_pipe_connect(&connect_, &handle_.pipe, path.c_str(), OnConnect);
+    return 0;
+  }
+
+  struct sockaddr_in addr;
+  int r = uv_ip4_addr(host.c_str(), port, &addr);
+  if (r) {
+    Close(E_INVALID_ADDRESS);
+    return r;
+  }
+
+  uv_tcp_init(loop_, &handle_.tcp);
+  Start();
+  uv_tcp_nodelay(&handle_.tcp, 1);
+
+  r = uv_tcp_connect(&connect_, &handle_.tcp,
+    reinterpret_cast<const struct sockaddr *>(&addr), OnConnect);
+  if (r) {
+    Close(uv_strerror(r));
+  }
+
+  return r;
+}
+
+int FrameStream::Accept (uv_stream_t *server, bool pipe) {
+  if (pipe) {
+    uv_pipe_init(loop_, &handle_.pipe, 0);
+  } else {
+    uv_tcp_init(loop_, &handle_.tcp);
+    uv_tcp_nodelay(&handle_.tcp, 1);
+  }
+  Start();
+
+  int r = uv_accept(server, stream());
+  if (!r) r = uv_read_start(stream(), OnAlloc, OnRead);
+  if (r) {
+    Close(uv_strerror(r));
+    return r;
+  }
+
+  connected_ = true;
+  Connected();
+  return 0;
+}
+
+void FrameStream::Write (
+  uint64 id,
+  const std::string *method,
+  const Message *payload,
+  const std::string *error
+) {
+  if (closing_) return;
+
+  int payload_size = payload ? payload->ByteSize() : 0;
+
+  int size = 1 + CodedOutputStream::VarintSize64(id);
+  if (method) {
+    size += 1 + CodedOutputStream::VarintSize32(method->size())
+      + method->size();
+  }
+  if (payload) {
+    size += 1 + CodedOutputStream::VarintSize32(payload_size) + payload_size;
+  }
+  if (error) {
+    size += 1 + CodedOutputStream::VarintSize32(error->size())
+      + error->size();
+  }
+
+  // Frames are encoded straight onto the end of the pending output.
+  size_t offset = output_.size();
+  output_.resize(offset + CodedOutputStream::VarintSize32(size) + size);
+  uint8 *target = reinterpret_cast<uint8 *>(&output_[offset]);
+
+  target = CodedOutputStream::WriteVarint32ToArray(size, target);
+  target = WireFormatLite::WriteUInt64ToArray(1, id, target);
+  if (method) {
+    target = WireFormatLite::WriteStringToArray(2, *method, target);
+  }
+  if (payload) {
+    target = WireFormatLite::WriteTagToArray(
+      3, WireFormatLite::WIRETYPE_LENGTH_DELIMITED, target);
+    target = CodedOutputStream::WriteVarint32ToArray(payload_size, target);
+    target = payload->SerializeWithCachedSizesToArray(target);
+  }
+  if (error) {
+    target = WireFormatLite::WriteStringToArray(4, *error, target);
+  }
+
+  assert(target == reinterpret_cast<uint8 *>(&output_[0]) + output_.size());
+
+  if (output_.size() >= kFlushThreshold) {
+    Flush();
+  } else {
+    ScheduleFlush();
+  }
+}
+
+void FrameStream::ScheduleFlush () {
+  if (connected_ && !uv_is_active(reinterpret_cast<uv_handle_t *>(&flush_))) {
+    uv_idle_start(&flush_, OnIdle);
+  }
+}
+
+void FrameStream::Flush () {
+  if (!connected_ || closing_ || output_.empty()) return;
+
+  WriteRequest *write = new WriteRequest;
+  write->req.data = this;
+  write->data.swap(output_);
+
+  uv_buf_t buf = uv_buf_init(&write->data[0], write->data.size());
+  int r = uv_write(&write->req, stream(), &buf, 1, OnWrite);
+  if (r) {
+    delete write;
+    Close(uv_strerror(r));
+  }
+}
+
+void FrameStream::Consume () {
+  size_t offset = 0;
+
+  while (!closing_) {
+    const uint8 *data =
+      reinterpret_cast<const uint8 *>(input_.data()) + offset;
+    size_t available = input_.size() - offset;
+
+    uint32 length;
+    int header = ReadLength(data, available, &length);
+    if (header == 0) break;
+    if (header < 0) {
+      Close(E_MALFORMED_FRAME);
+      return;
+    }
+    if (length > kMaxFrameSize) {
+      Close(E_FRAME_TOO_LARGE);
+      return;
+    }
+    if (available < header + static_cast<size_t>(length)) break;
+
+    Frame frame;
+    if (!DecodeFrame(reinterpret_cast<const char *>(data) + header,
+                     length, &frame)) {
+      Close(E_MALFORMED_FRAME);
+      return;
+    }
+
+    offset += header + length;
+    OnFrame(frame);
+  }
+
+  input_.erase(0, offset);
+}
+
+void FrameStream::Close (const std::string &reason) {
+  if (closing_) return;
+  closing_ = true;
+  connected_ = false;
+
+  if (open_) {
+    uv_close(reinterpret_cast<uv_handle_t *>(stream()), OnClosed);
+    uv_close(reinterpret_cast<uv_handle_t *>(&flush_), OnClosed);
+  }
+
+  OnClose(reason);
+  MaybeDelete();
+}
+
+void FrameStream::Release () {
+  assert(refs_ > 0);
+  refs_--;
+  MaybeDelete();
+}
+
+void FrameStream::MaybeDelete () {
+  if (closing_ && handles_ == 0 && refs_ == 0) delete this;
+}
+
+void FrameStream::OnConnect (uv_connect_t *req, int status) {
+  FrameStream *self = static_cast<FrameStream *>(req->data);
+
+  // Cancelled by Close().
+  if (self->closing_) return;
+
+  if (status == 0) status = uv_read_start(self->stream(), OnAlloc, OnRead);
+  if (status) {
+    self->Close(uv_strerror(status));
+    return;
+  }
+
+  self->connected_ = true;
+  self->Connected();
+  self->Flush();
+}
+
+void FrameStream::OnAlloc (uv_handle_t *handle, size_t size, uv_buf_t *buf) {
+  FrameStream *self = static_cast<FrameStream *>(handle->data);
+  *buf = uv_buf_init(self->read_buffer_, sizeof(self->read_buffer_));
+}
+
+void FrameStream::OnRead (
+  uv_stream_t *stream,
+  ssize_t nread,
+  const uv_buf_t *buf
+) {
+  FrameStream *self = static_cast<FrameStream *>(stream->data);
+
+  if (nread < 0) {
+    self->Close(nread == UV_EOF ? E_CONNECTION_CLOSED : uv_strerror(nread));
+    return;
+  }
+
+  if (nread == 0) return;
+
+  self->input_.append(buf->base, nread);
+  self->Consume();
+}
+
+void FrameStream::OnWrite (uv_write_t *req, int status) {
+  FrameStream *self = static_cast<FrameStream *>(req->data);
+  delete reinterpret_cast<WriteRequest *>(req);
+
+  if (status && status != UV_ECANCELED) {
+    self->Close(uv_strerror(status));
+  }
+}
+
+void FrameStream::OnIdle (uv_idle_t *idle) {
+  FrameStream *self = static_cast<FrameStream *>(idle->data);
+  uv_idle_stop(idle);
+  self->Flush();
+}
+
+void FrameStream::OnClosed (uv_handle_t *handle) {
+  FrameStream *self = static_cast<FrameStream *>(handle->data);
+  self->handles_--;
+  self->MaybeDelete();
+}
+
+/* SocketChannel ************************************/
+
+class SocketChannel::Connection : public FrameStream {
+public:
+  Connection (uv_loop_t *loop, SocketChannel *channel)
+    : FrameStream(loop), channel_(channel) {}
+
+  void Detach () { channel_ = NULL; }
+
+protected:
+  void OnFrame (const Frame &frame) {
+    if (channel_) channel_->Complete(frame);
+  }
+
+  void OnClose (const std::string &reason) {
+    SocketChannel *channel = channel_;
+    channel_ = NULL;
+    if (channel) channel->Disconnected(reason);
+  }
+
+private:
+  SocketChannel *channel_;
+};
+
+SocketChannel::SocketChannel (uv_loop_t *loop)
+  : loop_(loop), connection_(NULL), next_id_(1) {}
+
+SocketChannel::~SocketChannel () {
+  Close();
+}
+
+int SocketChannel::Connect (const std::string &address) {
+  Close();
+  error_.clear();
+
+  // On failure the connection closes itself and clears connection_.
+  connection_ = new Connection(loop_, this);
+  return connection_->Connect(address);
+}
+
+void SocketChannel::Close () {
+  if (connection_) {
+    Connection *connection = connection_;
+    connection_ = NULL;
+    connection->Detach();
+    connection->Close(E_CHANNEL_CLOSED);
+  }
+
+  Disconnected(E_CHANNEL_CLOSED);
+}
+
+void SocketChannel::CallMethod (
+  const MethodDescriptor *method,
+  RpcController *controller,
+  const Message *request,
+  Message *response,
+  Closure *done
+) {
+  if (!connection_) {
+    controller->SetFailed(error_.empty() ? E_NOT_CONNECTED : error_);
+    done->Run();
+    return;
+  }
+
+  uint64 id = next_id_++;
+  Call call = { controller, response, done };
+  calls_[id] = call;
+
+  connection_->Write(id, &method->full_name(), request, NULL);
+}
+
+void SocketChannel::Complete (const Frame &frame) {
+  call_map_type::iterator it = calls_.find(frame.id);
+  if (it == calls_.end()) return;
+
+  Call call = it->second;
+  calls_.erase(it);
+
+  if (frame.failed) {
+    call.controller->SetFailed(frame.error);
+  } else if (!call.response->ParseFromArray(frame.payload,
+                                           frame.payload_size)) {
+    call.controller->SetFailed(E_MALFORMED_RESPONSE);
+  }
+
+  call.done->Run();
+}
+
+void SocketChannel::Disconnected (const std::string &reason) {
+  connection_ = NULL;
+  error_ = reason;
+
+  // `done` may issue new calls, which fail straight away.
+  call_map_type calls;
+  calls.swap(calls_);
+
+  for (call_map_type::iterator it = calls.begin(); it != calls.end(); ++it) {
+    it->second.controller->SetFailed(reason);
+    it->second.done->Run();
+  }
+}
+
+/* SocketServer *************************************/
+
+class SocketServer::Connection : public FrameStream {
+public:
+  Connection (uv_loop_t *loop, SocketServer *server)
+    : FrameStream(loop), server_(server) {}
+
+protected:
+  void OnFrame (const Frame &frame) {
+    server_->Dispatch(this, frame);
+  }
+
+  void OnClose (const std::string &reason) {
+    server_->connections_.erase(this);
+  }
+
+private:
+  SocketServer *server_;
+};
+
+// A call being served. Holds a reference on its connection so that a
+// response can be dropped safely if the client has gone away.
+struct SocketServer::Call {
+  Connection *connection;
+  uint64 id;
+  Message *request;
+  Message *response;
+  Controller controller;
+};
+
+SocketServer::SocketServer (uv_loop_t *loop)
+  : loop_(loop), pipe_(false), listening_(false), destroyed_(false),
+    handles_(0), calls_(0) {
+  uv_mutex_init(&mutex_);
+}
+
+SocketServer::~SocketServer () {
+  assert(!listening_ && handles_ == 0 && calls_ == 0);
+  uv_mutex_destroy(&mutex_);
+}
+
+void SocketServer::AddService (google::protobuf::Service *service) {
+  services_[service->GetDescriptor()->full_name()] = service;
+}
+
+int SocketServer::Listen (const std::string &address) {
+  bool pipe;
+  std::string path, host;
+  int port;
+  int r;
+
+  if (listening_) return UV_EALREADY;
+  // Still closing from an earlier Close().
+  if (handles_) return UV_EBUSY;
+
+  if (!FrameStream::ParseAddress(address, &pipe, &path, &host, &port)) {
+    return UV_EINVAL;
+  }
+
+  uv_stream_t *stream = reinterpret_cast<uv_stream_t *>(&handle_);
+
+  if (pipe) {
+    uv_pipe_init(loop_, &handle_.pipe, 0);
+    r = uv_pipe_bind(&handle_.pipe, path.c_str());
+  } else {
+    struct sockaddr_in addr;
+    r = uv_ip4_addr(host.c_str(), port, &addr);
+    if (r) return r;
+    uv_tcp_init(loop_, &handle_.tcp);
+    r = uv_tcp_bind(&handle_.tcp,
+      reinterpret_cast<const struct sockaddr *>(&addr), 0);
+  }
+
+  stream->data = this;
+  handles_++;
+  if (!r) r = uv_listen(stream, 128, OnConnection);
+  if (r) {
+    uv_close(reinterpret_cast<uv_handle_t *>(stream), OnClosed);
+    return r;
+  }
+
+  uv_async_init(loop_, &completions_, OnCompletions);
+  completions_.data = this;
+  handles_++;
+
+  pipe_ = pipe;
+  listening_ = true;
+  return 0;
+}
+
+void SocketServer::Close () {
+  if (!listening_) return;
+  listening_ = false;
+
+  uv_close(reinterpret_cast<uv_handle_t *>(&handle_), OnClosed);
+  MaybeCloseCompletions();
+
+  connection_set_type connections;
+  connections.swap(connections_);
+  for (connection_set_type::iterator it = connections.begin();
+       it != connections.end(); ++it) {
+    (*it)->Close(E_CONNECTION_CLOSED);
+  }
+}
+
+void SocketServer::Destroy () {
+  Close();
+  destroyed_ = true;
+  MaybeDelete();
+}
+
+// Outstanding calls still signal completions_ when they are done, so it
+// is only closed once all of them have been answered.
+void SocketServer::MaybeCloseCompletions () {
+  uv_handle_t *handle = reinterpret_cast<uv_handle_t *>(&completions_);
+  if (!listening_ && calls_ == 0 && !uv_is_closing(handle)) {
+    uv_close(handle, OnClosed);
+  }
+}
+
+void SocketServer::MaybeDelete () {
+  if (destroyed_ && handles_ == 0) delete this;
+}
+
+void SocketServer::Dispatch (Connection *connection, const Frame &frame) {
+  size_t dot = frame.method.rfind('.');
+  const MethodDescriptor *method = NULL;
+  google::protobuf::Service *service = NULL;
+
+  if (dot != std::string::npos) {
+    service_map_type::const_iterator it =
+      services_.find(frame.method.substr(0, dot));
+    if (it != services_.end()) {
+      service = it->second;
+      method = service->GetDescriptor()->FindMethodByName(
+        frame.method.substr(dot + 1));
+    }
+  }
+
+  if (method == NULL) {
+    std::string error(E_UNKNOWN_METHOD);
+    connection->Write(frame.id, NULL, NULL, &error);
+    return;
+  }
+
+  Message *request = service->GetRequestPrototype(method).New();
+  if (!request->ParseFromArray(frame.payload, frame.payload_size)) {
+    delete request;
+    std::string error(E_MALFORMED_REQUEST);
+    connection->Write(frame.id, NULL, NULL, &error);
+    return;
+  }
+
+  Call *call = new Call;
+  call->connection = connection;
+  call->id = frame.id;
+  call->request = request;
+  call->response = service->GetResponsePrototype(method).New();
+  connection->Retain();
+  calls_++;
+
+  service->CallMethod(method, &call->controller, call->request,
+    call->response, NewCallback(this, &SocketServer::Done, call));
+}
+
+void SocketServer::Done (Call *call) {
+  // Signalled under the lock: once the loop thread has taken this call,
+  // completions_ may be closed.
+  uv_mutex_lock(&mutex_);
+  completed_.push_back(call);
+  uv_async_send(&completions_);
+  uv_mutex_unlock(&mutex_);
+}
+
+void SocketServer::OnConnection (uv_stream_t *stream, int status) {
+  SocketServer *server = static_cast<SocketServer *>(stream->data);
+  if (status) return;
+
+  // On failure the connection closes and frees itself.
+  Connection *connection = new Connection(server->loop_, server);
+  server->connections_.insert(connection);
+  connection->Accept(stream, server->pipe_);
+}
+
+void SocketServer::OnCompletions (uv_async_t *async) {
+  SocketServer *server = static_cast<SocketServer *>(async->data);
+
+  // Completions are answered in a batch, so their frames share writes.
+  std::vector<Call *> completed;
+  uv_mutex_lock(&server->mutex_);
+  completed.swap(server->completed_);
+  uv_mutex_unlock(&server->mutex_);
+
+  for (size_t i = 0; i < completed.size(); i++) {
+    Call *call = completed[i];
+
+    if (call->controller.Failed()) {
+      std::string error = call->controller.ErrorText();
+      call->connection->Write(call->id, NULL, NULL, &error);
+    } else {
+      call->connection->Write(call->id, NULL, call->response, NULL);
+    }
+
+    call->connection->Release();
+    delete call->request;
+    delete call->response;
+    delete call;
+  }
+
+  server->calls_ -= completed.size();
+  server->MaybeCloseCompletions();
+}
+
+void SocketServer::OnClosed (uv_handle_t *handle) {
+  SocketServer *server = static_cast<SocketServer *>(handle->data);
+  server->handles_--;
+  server->MaybeDelete();
+}
+
+} // namespace protobuf
+} // namespace node
@@ -0,0 +1,255 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+// Protobuf RPC over local stream sockets, built on libuv and free of any
+// V8 dependency so that C++ sidecars can link it without node.
+//
+// Addresses are either a Unix domain socket path ("/tmp/rpc.sock" or
+// "unix:/tmp/rpc.sock") or an IPv4 "host:port" pair.
+//
+// Both directions carry frames: a varint32 length followed by that many
+// bytes encoding, in protobuf wire format,
+//
+//   message Frame {
+//     optional uint64 id = 1;       // chosen by the client, echoed back
+//     optional string method = 2;   // full method name, requests only
+//     optional bytes payload = 3;   // request or response message
+//     optional string error = 4;    // set if the call failed
+//   }
+//
+// Calls are multiplexed by id: a connection may have any number of calls
+// in flight and responses come back in completion order. Frames queued
+// during one loop iteration are written with a single write.
+
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <uv.h>
+
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/message.h>
+#include <google/protobuf/service.h>
+#include <google/protobuf/stubs/common.h>
+
+namespace node {
+namespace protobuf {
+
+// A decoded frame. `payload` points into the connection's read buffer
+// and is only valid during the FrameStream::OnFrame call.
+struct Frame {
+  google::protobuf::uint64 id;
+  std::string method;
+  const char *payload;
+  int payload_size;
+  std::string error;
+  bool failed;
+};
+
+// A framed, buffered stream connection. Owns itself once opened: it is
+// freed after Close() once libuv has released its handles, and when
+// Release() has been called as many times as Retain().
+class FrameStream {
+public:
+  explicit FrameStream (uv_loop_t *loop);
+
+  // Starts an outgoing connection; Connected() follows.
+  int Connect (const std::string &address);
+
+  // Accepts a pending connection on `server`.
+  int Accept (uv_stream_t *server, bool pipe);
+
+  // Queues a frame. Writes are coalesced until the next loop iteration
+  // or until enough data is queued.
+  void Write (
+    google::protobuf::uint64 id,
+    const std::string *method,
+    const google::protobuf::Message *payload,
+    const std::string *error
+  );
+
+  void Close (const std::string &reason);
+
+  void Retain () { refs_++; }
+  void Release ();
+
+  bool closed () const { return closing_; }
+
+  // Splits an address into a socket path or an IPv4 host and port.
+  static bool ParseAddress (
+    const std::string &address,
+    bool *pipe,
+    std::string *path,
+    std::string *host,
+    int *port
+  );
+
+protected:
+  virtual ~FrameStream ();
+
+  virtual void Connected () {}
+  virtual void OnFrame (const Frame &frame) = 0;
+  virtual void OnClose (const std::string &reason) {}
+
+private:
+  static const size_t kFlushThreshold = 64 * 1024;
+  static const size_t kMaxFrameSize = 64 * 1024 * 1024;
+
+  union {
+    uv_pipe_t pipe;
+    uv_tcp_t tcp;
+  } handle_;
+  uv_idle_t flush_;
+  uv_connect_t connect_;
+  uv_loop_t *loop_;
+
+  std::string input_;
+  std::string output_;
+  char read_buffer_[64 * 1024];
+
+  bool open_;
+  bool connected_;
+  bool closing_;
+  int handles_;
+  int refs_;
+
+  uv_stream_t *stream () {
+    return reinterpret_cast<uv_stream_t *>(&handle_);
+  }
+
+  void Start ();
+  void Flush ();
+  void ScheduleFlush ();
+  void Consume ();
+  void MaybeDelete ();
+
+  static void OnConnect (uv_connect_t *req, int status);
+  static void OnAlloc (uv_handle_t *handle, size_t size, uv_buf_t *buf);
+  static void OnRead (uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf);
+  static void OnWrite (uv_write_t *req, int status);
+  static void OnIdle (uv_idle_t *idle);
+  static void OnClosed (uv_handle_t *handle);
+};
+
+// RpcChannel talking to a SocketServer. CallMethod may be used as soon as
+// Connect() returns; calls are queued until the connection is up. All
+// methods, and every `done` closure, run on the loop thread. If the
+// connection fails or is closed, outstanding calls fail with the reason.
+class SocketChannel : public google::protobuf::RpcChannel {
+public:
+  explicit SocketChannel (uv_loop_t *loop);
+  ~SocketChannel ();
+
+  // Returns 0, or a libuv error code.
+  int Connect (const std::string &address);
+  void Close ();
+
+  void CallMethod (
+    const google::protobuf::MethodDescriptor *method,
+    google::protobuf::RpcController *controller,
+    const google::protobuf::Message *request,
+    google::protobuf::Message *response,
+    google::protobuf::Closure *done
+  );
+
+  size_t pending () const { return calls_.size(); }
+
+private:
+  class Connection;
+  friend class Connection;
+
+  struct Call {
+    google::protobuf::RpcController *controller;
+    google::protobuf::Message *response;
+    google::protobuf::Closure *done;
+  };
+
+  typedef std::map<google::protobuf::uint64, Call> call_map_type;
+
+  uv_loop_t *loop_;
+  Connection *connection_;
+  call_map_type calls_;
+  google::protobuf::uint64 next_id_;
+  std::string error_;
+
+  void Complete (const Frame &frame);
+  void Disconnected (const std::string &reason);
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(SocketChannel);
+};
+
+// Serves the methods of any number of services to SocketChannels.
+// Services are not owned, are invoked on the loop thread and must stay
+// alive until the server is closed; `done` may be run from any thread.
+// Responses to calls that complete together are coalesced like any other
+// frames.
+//
+// Allocate servers with new and free them with Destroy(), which closes
+// the server; it is deleted once libuv has released its handles, which
+// waits for outstanding calls to complete.
+class SocketServer {
+public:
+  explicit SocketServer (uv_loop_t *loop);
+
+  void AddService (google::protobuf::Service *service);
+
+  // Returns 0, or a libuv error code.
+  int Listen (const std::string &address);
+  void Close ();
+  void Destroy ();
+
+private:
+  class Connection;
+  struct Call;
+  friend class Connection;
+
+  ~SocketServer ();
+
+  typedef std::map<std::string, google::protobuf::Service *> service_map_type;
+  typedef std::set<Connection *> connection_set_type;
+
+  union {
+    uv_pipe_t pipe;
+    uv_tcp_t tcp;
+  } handle_;
+  uv_async_t completions_;
+  uv_mutex_t mutex_;
+  uv_loop_t *loop_;
+
+  bool pipe_;
+  bool listening_;
+  bool destroyed_;
+  int handles_;
+  size_t calls_;
+  service_map_type services_;
+  connection_set_type connections_;
+  std::vector<Call *> completed_;
+
+  void Dispatch (Connection *connection, const Frame &frame);
+  void Done (Call *call);
+  void MaybeCloseCompletions ();
+  void MaybeDelete ();
+
+  static void OnConnection (uv_stream_t *server, int status);
+  static void OnCompletions (uv_async_t *async);
+  static void OnClosed (uv_handle_t *handle);
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(SocketServer);
+};
+
+} // namespace protobuf
+} // namespace node
@@ -28,7 +28,8 @@ namespace protobuf {
 
 static v8::Persistent<v8::FunctionTemplate> schema_constructor;
 
-Schema::Schema (const google::protobuf::DescriptorPool *pool) : pool_(pool) {
+Schema::Schema (const google::protobuf::DescriptorPool *pool)
+  : pool_(pool), stats_(false), unknown_fields_(false) {
   assert(pool_ != NULL);
   v8::Local<v8::Object> array = NanNew<v8::Array>();
   NanAssignPersistent(persistentHandle, array);
@@ -43,9 +44,16 @@ Schema::~Schema () {
 }
 
 google::protobuf::Message *Schema::NewMessage (
-  const google::protobuf::Descriptor *descriptor
+  const google::protobuf::Descriptor *descriptor,
+  google::protobuf::Arena *arena
 ) {
-  return factory_.GetPrototype(descriptor)->New();
+  return factory_.GetPrototype(descriptor)->New(arena);
+}
+
+// Options are passed as the second constructor argument, see index.js.
+void Schema::Configure (v8::Local<v8::Object> options) {
+  stats_ = options->Get(NanSymbol("stats"))->BooleanValue();
+  unknown_fields_ = options->Get(NanSymbol("unknownFields"))->BooleanValue();
 }
 
 const Descriptor *Schema::DescriptorFor (
@@ -59,6 +67,42 @@ const Descriptor *Schema::DescriptorFor (
   return NULL;
 }
 
+const Descriptor *Schema::Lookup (
+  const google::protobuf::Descriptor *descriptor
+) const {
+  descriptor_map_type::const_iterator it = descriptors_.find(descriptor);
+  return it == descriptors_.end() ? NULL : it->second;
+}
+
+// Makes the message types of a file that is already in the pool, and of
+// everything it imports, available. Used for the generated pool, whose
+// files are not loaded from a descriptor set.
+void Schema::Import (
+  const google::protobuf::FileDescriptor *fileDescriptor
+) {
+  ImportFile(fileDescriptor);
+  BuildExtensions();
+}
+
+void Schema::ImportFile (
+  const google::protobuf::FileDescriptor *fileDescriptor
+) {
+  if (!imported_.insert(fileDescriptor).second) return;
+
+  for (int i = 0; i < fileDescriptor->dependency_count(); i++) {
+    ImportFile(fileDescriptor->dependency(i));
+  }
+
+  BuildDescriptors(fileDescriptor);
+}
+
+const Schema::extension_list_type *Schema::ExtensionsFor (
+  const google::protobuf::Descriptor *descriptor
+) const {
+  extension_map_type::const_iterator it = extensions_.find(descriptor);
+  return it == extensions_.end() ? NULL : &it->second;
+}
+
 /* V8 exposed functions *****************************/
 
 void Schema::Init (v8::Handle<v8::Object> exports) {
@@ -92,7 +136,7 @@ NAN_METHOD(Schema::New) {
 
   Schema *schema;
 
-  if (!args.Length()) {
+  if (!args.Length() || args[0]->IsUndefined()) {
 
     const google::protobuf::DescriptorPool *pool =
       google::protobuf::DescriptorPool::generated_pool();
@@ -126,6 +170,15 @@ NAN_METHOD(Schema::New) {
       schema->BuildDescriptors(fileDescriptor);
     }
 
+    // Nothing is added to the pool after this.
+    const_cast<google::protobuf::DescriptorPool *>(pool)->Seal();
+
+    schema->BuildExtensions();
+
+  }
+
+  if (args.Length() > 1 && args[1]->IsObject()) {
+    schema->Configure(args[1]->ToObject());
   }
 
   NanReturnValue(args.This());
@@ -137,21 +190,55 @@ void Schema::BuildDescriptors (
   for (int i = 0; i < fileDescriptor->message_type_count(); i++) {
     const google::protobuf::Descriptor *pdesc =
       fileDescriptor->message_type(i);
-    std::string pname = fileDescriptor->package() + "." + pdesc->name();
-    v8::Local<v8::String> name =
-      NanNew<v8::String>(pname.c_str(), pname.size());
+    BuildDescriptor(pdesc, fileDescriptor->package() + "." + pdesc->name());
+  }
+
+  // Builds the file's prototypes now so that parsing, including on the
+  // threadpool, never waits on the factory's lock.
+  factory_.PrebuildPrototypes(fileDescriptor);
+}
+
+void Schema::BuildDescriptor (
+  const google::protobuf::Descriptor *pdesc,
+  const std::string &pname
+) {
+  v8::Local<v8::String> name =
+    NanNew<v8::String>(pname.c_str(), pname.size());
+
+  v8::Local<v8::Object> handle = NanObjectWrapHandle(this);
+  assert(!handle.IsEmpty());
+  v8::Local<v8::Object> wrap = Descriptor::NewInstance(handle, pdesc);
+  assert(!wrap.IsEmpty());
+
+  Descriptor *descriptor = node::ObjectWrap::Unwrap<Descriptor>(wrap);
+  assert(descriptor != NULL);
+  descriptors_[pdesc] = descriptor;
+
+  handle->Set(name, wrap,
+    static_cast<v8::PropertyAttribute>(v8::ReadOnly | v8:: DontDelete));
+
+  // Nested types (including groups) are reachable from their parents'
+  // fields, so they need descriptors of their own.
+  for (int i = 0; i < pdesc->nested_type_count(); i++) {
+    const google::protobuf::Descriptor *nested = pdesc->nested_type(i);
+    BuildDescriptor(nested, pname + "." + nested->name());
+  }
+}
 
-    v8::Local<v8::Object> handle = NanObjectWrapHandle(this);
-    assert(!handle.IsEmpty());
-    v8::Local<v8::Object> wrap = Descriptor::NewInstance(handle, pdesc);
-    assert(!wrap.IsEmpty());
+// Extensions may be declared in any file of the set, so the table can only
+// be built once all of them are in the pool. Looking extensions up here,
+// once, keeps the per-message conversions off the pool's symbol tables.
+void Schema::BuildExtensions () {
+  for (descriptor_map_type::const_iterator it = descriptors_.begin();
+       it != descriptors_.end(); ++it) {
+    const google::protobuf::Descriptor *pdesc = it->first;
+    if (!pdesc->extension_range_count()) continue;
 
-    Descriptor *descriptor = node::ObjectWrap::Unwrap<Descriptor>(wrap);
-    assert(descriptor != NULL);
-    descriptors_[pdesc] = descriptor;
+    extension_list_type extensions;
+    pool_->FindAllExtensions(pdesc, &extensions);
+    if (extensions.empty()) continue;
 
-    handle->Set(name, wrap,
-      static_cast<v8::PropertyAttribute>(v8::ReadOnly | v8:: DontDelete));
+    extensions_[pdesc].swap(extensions);
   }
 }
 
@@ -15,6 +15,8 @@
 #pragma once
 
 #include <tr1/unordered_map>
+#include <tr1/unordered_set>
+#include <vector>
 
 #include <node.h>
 #include <nan.h>
@@ -30,7 +32,9 @@ namespace protobuf {
 NAN_METHOD(Protobuf);
 
 class Schema : public node::ObjectWrap {
+  friend class Channel;
   friend class Descriptor;
+  friend class Server;
 
 public:
   static void Init (v8::Handle<v8::Object> exports);
@@ -39,31 +43,72 @@ public:
   Schema (const google::protobuf::DescriptorPool *pool);
   ~Schema ();
 
+  void Import (const google::protobuf::FileDescriptor *fileDescriptor);
+
+  const Descriptor *Lookup (
+    const google::protobuf::Descriptor *descriptor
+  ) const;
+
 private:
   typedef std::tr1::unordered_map<
     const google::protobuf::Descriptor *,
     const Descriptor *
   > descriptor_map_type;
 
+  typedef std::vector<
+    const google::protobuf::FieldDescriptor *
+  > extension_list_type;
+
+  typedef std::tr1::unordered_map<
+    const google::protobuf::Descriptor *,
+    extension_list_type
+  > extension_map_type;
+
+  typedef std::tr1::unordered_set<
+    const google::protobuf::FileDescriptor *
+  > file_set_type;
+
   const google::protobuf::DescriptorPool *pool_;
   google::protobuf::DynamicMessageFactory factory_;
   v8::Persistent<v8::Object> persistentHandle;
   descriptor_map_type descriptors_;
+  extension_map_type extensions_;
+  file_set_type imported_;
+  bool stats_;
+  bool unknown_fields_;
 
   static NAN_METHOD(New);
   // static NAN_METHOD(DescriptorGetter);
 
+  void Configure (v8::Local<v8::Object> options);
+
   void BuildDescriptors (
     const google::protobuf::FileDescriptor *fileDescriptor
   );
 
+  void BuildDescriptor (
+    const google::protobuf::Descriptor *pdesc,
+    const std::string &pname
+  );
+
+  void BuildExtensions ();
+
+  void ImportFile (const google::protobuf::FileDescriptor *fileDescriptor);
+
+  // With an arena, the message is owned by the arena and must not be
+  // deleted.
   google::protobuf::Message *NewMessage (
-    const google::protobuf::Descriptor *descriptor
+    const google::protobuf::Descriptor *descriptor,
+    google::protobuf::Arena *arena = NULL
   );
 
   const Descriptor *DescriptorFor (
     const google::protobuf::FieldDescriptor *field
   ) const;
+
+  const extension_list_type *ExtensionsFor (
+    const google::protobuf::Descriptor *descriptor
+  ) const;
 };
 
 } // namespace protobuf
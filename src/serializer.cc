@@ -0,0 +1,571 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+
+#include <assert.h>
+
+#include <algorithm>
+
+#include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/wire_format.h>
+#include <google/protobuf/wire_format_lite.h>
+#include <google/protobuf/wire_format_lite_inl.h>
+
+#include "serializer.h"
+
+using google::protobuf::FieldDescriptor;
+using google::protobuf::Message;
+using google::protobuf::Reflection;
+using google::protobuf::RepeatedField;
+using google::protobuf::UnknownField;
+using google::protobuf::UnknownFieldSet;
+using google::protobuf::int32;
+using google::protobuf::int64;
+using google::protobuf::uint8;
+using google::protobuf::uint32;
+using google::protobuf::uint64;
+using google::protobuf::internal::WireFormat;
+using google::protobuf::internal::WireFormatLite;
+using google::protobuf::io::CodedOutputStream;
+
+namespace node {
+namespace protobuf {
+
+static bool FieldNumberLess (const UnknownField *a, const UnknownField *b) {
+  return a->number() < b->number();
+}
+
+// Whether `field` is written as an item of a MessageSet, as WireFormat
+// does.
+static bool IsMessageSetItem (const FieldDescriptor *field) {
+  return field->is_extension() &&
+    field->containing_type()->options().message_set_wire_format() &&
+    field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE &&
+    !field->is_repeated();
+}
+
+static bool IsMessageSet (const Message &message) {
+  return message.GetDescriptor()->options().message_set_wire_format();
+}
+
+template <typename T>
+static bool FloatEquals (T a, T b) {
+  return a == b || (a != a && b != b);
+}
+
+// Whether a singular, non-message field holds its default value.
+static bool IsDefault (
+  const Message &message,
+  const Reflection *reflection,
+  const FieldDescriptor *field
+) {
+  switch (field->cpp_type()) {
+#define IS_DEFAULT(CPPTYPE, METHOD, DEFAULT)                              \
+    case FieldDescriptor::CPPTYPE_##CPPTYPE:                              \
+      return reflection->Get##METHOD(message, field) ==                   \
+        field->default_value_##DEFAULT();
+
+    IS_DEFAULT(INT32, Int32, int32)
+    IS_DEFAULT(INT64, Int64, int64)
+    IS_DEFAULT(UINT32, UInt32, uint32)
+    IS_DEFAULT(UINT64, UInt64, uint64)
+    IS_DEFAULT(BOOL, Bool, bool)
+    IS_DEFAULT(ENUM, Enum, enum)
+#undef IS_DEFAULT
+
+    case FieldDescriptor::CPPTYPE_FLOAT:
+      return FloatEquals(reflection->GetFloat(message, field),
+                         field->default_value_float());
+
+    case FieldDescriptor::CPPTYPE_DOUBLE:
+      return FloatEquals(reflection->GetDouble(message, field),
+                         field->default_value_double());
+
+    case FieldDescriptor::CPPTYPE_STRING: {
+      std::string scratch;
+      return reflection->GetStringReference(message, field, &scratch) ==
+        field->default_value_string();
+    }
+
+    case FieldDescriptor::CPPTYPE_MESSAGE:
+      break;
+  }
+
+  return false;
+}
+
+int Serializer::ByteSize (const Message &message) {
+  sizes_.clear();
+  fields_.clear();
+  return MessageSize(message);
+}
+
+uint8 *Serializer::SerializeToArray (const Message &message, uint8 *target) {
+  next_size_ = 0;
+  next_field_ = 0;
+  target = WriteMessage(message, target);
+  assert(next_size_ == sizes_.size());
+  assert(next_field_ == fields_.size());
+  return target;
+}
+
+void Serializer::Serialize (const Message &message, CodedOutputStream *output) {
+  next_size_ = 0;
+  next_field_ = 0;
+  WriteMessage(message, output);
+  assert(next_size_ == sizes_.size());
+  assert(next_field_ == fields_.size());
+}
+
+const UnknownFieldSet &Serializer::UnknownFields (
+  const UnknownFieldSet &fields,
+  UnknownFieldSet *sorted
+) const {
+  if (!unknown_fields_) return *sorted;
+  if (!canonical_ || fields.field_count() < 2) return fields;
+
+  std::vector<const UnknownField *> order;
+  for (int i = 0; i < fields.field_count(); i++) {
+    order.push_back(&fields.field(i));
+  }
+  std::stable_sort(order.begin(), order.end(), FieldNumberLess);
+
+  for (size_t i = 0; i < order.size(); i++) {
+    sorted->AddField(*order[i]);
+  }
+  return *sorted;
+}
+
+int Serializer::MessageSize (const Message &message) {
+  const Reflection *reflection = message.GetReflection();
+
+  size_t slot = sizes_.size();
+  sizes_.push_back(0);
+  sizes_.push_back(0);
+
+  reflection->ListFields(message, &scratch_);
+  size_t first = fields_.size();
+  size_t count = scratch_.size();
+  fields_.insert(fields_.end(), scratch_.begin(), scratch_.end());
+
+  // Sub-messages append to fields_, so index rather than iterate.
+  int size = 0;
+  for (size_t i = first; i < first + count; i++) {
+    const FieldDescriptor *field = fields_[i];
+
+    if (!canonical_ || field->is_repeated() || field->is_required()) {
+      size += FieldSize(message, reflection, field);
+    } else if (field->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE) {
+      if (IsDefault(message, reflection, field)) {
+        fields_[i] = NULL;
+      } else {
+        size += FieldSize(message, reflection, field);
+      }
+    } else {
+      // Drop an empty sub-message along with what it recorded.
+      size_t sizes = sizes_.size();
+      size_t fields = fields_.size();
+      int field_size = FieldSize(message, reflection, field);
+      if (sizes_[sizes] == 0) {
+        sizes_.resize(sizes);
+        fields_.resize(fields);
+        fields_[i] = NULL;
+      } else {
+        size += field_size;
+      }
+    }
+  }
+
+  if (unknown_fields_) {
+    const UnknownFieldSet &unknown = reflection->GetUnknownFields(message);
+    size += IsMessageSet(message)
+      ? WireFormat::ComputeUnknownMessageSetItemsSize(unknown)
+      : WireFormat::ComputeUnknownFieldsSize(unknown);
+  }
+
+  sizes_[slot] = size;
+  sizes_[slot + 1] = count;
+  return size;
+}
+
+int Serializer::FieldSize (
+  const Message &message,
+  const Reflection *reflection,
+  const FieldDescriptor *field
+) {
+  if (IsMessageSetItem(field)) {
+    return WireFormatLite::kMessageSetItemTagsSize +
+      CodedOutputStream::VarintSize32(field->number()) +
+      WireFormatLite::LengthDelimitedSize(
+        MessageSize(reflection->GetMessage(message, field)));
+  }
+
+  bool repeated = field->is_repeated();
+  int count = repeated ? reflection->FieldSize(message, field) : 1;
+  int data = 0;
+
+  switch (field->type()) {
+#define FIXED_SIZE(TYPE, SIZE)                                            \
+    case FieldDescriptor::TYPE_##TYPE:                                    \
+      data = count * WireFormatLite::SIZE;                                \
+      break;
+
+    FIXED_SIZE(FIXED32, kFixed32Size)
+    FIXED_SIZE(FIXED64, kFixed64Size)
+    FIXED_SIZE(SFIXED32, kSFixed32Size)
+    FIXED_SIZE(SFIXED64, kSFixed64Size)
+    FIXED_SIZE(FLOAT, kFloatSize)
+    FIXED_SIZE(DOUBLE, kDoubleSize)
+    FIXED_SIZE(BOOL, kBoolSize)
+#undef FIXED_SIZE
+
+#define VARINT_SIZE(TYPE, CPPTYPE, METHOD, SIZE)                          \
+    case FieldDescriptor::TYPE_##TYPE:                                    \
+      if (repeated) {                                                     \
+        const RepeatedField<CPPTYPE> &values =                            \
+          reflection->GetRepeatedField<CPPTYPE>(message, field);          \
+        for (int i = 0; i < count; i++) {                                 \
+          data += WireFormatLite::SIZE(values.Get(i));                    \
+        }                                                                 \
+      } else {                                                            \
+        data = WireFormatLite::SIZE(reflection->Get##METHOD(message, field)); \
+      }                                                                   \
+      break;
+
+    VARINT_SIZE(INT32, int32, Int32, Int32Size)
+    VARINT_SIZE(INT64, int64, Int64, Int64Size)
+    VARINT_SIZE(UINT32, uint32, UInt32, UInt32Size)
+    VARINT_SIZE(UINT64, uint64, UInt64, UInt64Size)
+    VARINT_SIZE(SINT32, int32, Int32, SInt32Size)
+    VARINT_SIZE(SINT64, int64, Int64, SInt64Size)
+#undef VARINT_SIZE
+
+    case FieldDescriptor::TYPE_ENUM:
+      if (repeated) {
+        for (int i = 0; i < count; i++) {
+          data += WireFormatLite::EnumSize(
+            reflection->GetRepeatedEnum(message, field, i)->number());
+        }
+      } else {
+        data = WireFormatLite::EnumSize(
+          reflection->GetEnum(message, field)->number());
+      }
+      break;
+
+    case FieldDescriptor::TYPE_STRING:
+    case FieldDescriptor::TYPE_BYTES: {
+      std::string scratch;
+      if (repeated) {
+        for (int i = 0; i < count; i++) {
+          data += WireFormatLite::StringSize(
+            reflection->GetRepeatedStringReference(message, field, i,
+                                                   &scratch));
+        }
+      } else {
+        data = WireFormatLite::StringSize(
+          reflection->GetStringReference(message, field, &scratch));
+      }
+      break;
+    }
+
+    case FieldDescriptor::TYPE_GROUP:
+      if (repeated) {
+        for (int i = 0; i < count; i++) {
+          data += MessageSize(reflection->GetRepeatedMessage(message, field, i));
+        }
+      } else {
+        data = MessageSize(reflection->GetMessage(message, field));
+      }
+      break;
+
+    case FieldDescriptor::TYPE_MESSAGE:
+      if (repeated) {
+        for (int i = 0; i < count; i++) {
+          data += WireFormatLite::LengthDelimitedSize(
+            MessageSize(reflection->GetRepeatedMessage(message, field, i)));
+        }
+      } else {
+        data = WireFormatLite::LengthDelimitedSize(
+          MessageSize(reflection->GetMessage(message, field)));
+      }
+      break;
+  }
+
+  int tag_size = WireFormat::TagSize(field->number(), field->type());
+
+  if (field->options().packed()) {
+    sizes_.push_back(data);
+    return tag_size + WireFormatLite::LengthDelimitedSize(data);
+  }
+
+  return tag_size * count + data;
+}
+
+uint8 *Serializer::WriteMessage (const Message &message, uint8 *target) {
+  const Reflection *reflection = message.GetReflection();
+
+  next_size_++;
+  size_t count = sizes_[next_size_++];
+  size_t first = next_field_;
+  next_field_ += count;
+
+  for (size_t i = first; i < first + count; i++) {
+    if (fields_[i]) {
+      target = WriteField(message, reflection, fields_[i], target);
+    }
+  }
+
+  UnknownFieldSet sorted;
+  const UnknownFieldSet &unknown =
+    UnknownFields(reflection->GetUnknownFields(message), &sorted);
+  return IsMessageSet(message)
+    ? WireFormat::SerializeUnknownMessageSetItemsToArray(unknown, target)
+    : WireFormat::SerializeUnknownFieldsToArray(unknown, target);
+}
+
+void Serializer::WriteMessage (
+  const Message &message,
+  CodedOutputStream *output
+) {
+  uint8 *target = output->GetDirectBufferForNBytesAndAdvance(
+    sizes_[next_size_]);
+  if (target) {
+    WriteMessage(message, target);
+    return;
+  }
+
+  const Reflection *reflection = message.GetReflection();
+
+  next_size_++;
+  size_t count = sizes_[next_size_++];
+  size_t first = next_field_;
+  next_field_ += count;
+
+  for (size_t i = first; i < first + count; i++) {
+    if (fields_[i]) {
+      WriteField(message, reflection, fields_[i], output);
+    }
+  }
+
+  UnknownFieldSet sorted;
+  const UnknownFieldSet &unknown =
+    UnknownFields(reflection->GetUnknownFields(message), &sorted);
+  if (IsMessageSet(message)) {
+    WireFormat::SerializeUnknownMessageSetItems(unknown, output);
+  } else {
+    WireFormat::SerializeUnknownFields(unknown, output);
+  }
+}
+
+// Strings and sub-messages are streamed; anything else is written to a
+// scratch buffer with the array writer first.
+void Serializer::WriteField (
+  const Message &message,
+  const Reflection *reflection,
+  const FieldDescriptor *field,
+  CodedOutputStream *output
+) {
+  int number = field->number();
+  bool repeated = field->is_repeated();
+  int count = repeated ? reflection->FieldSize(message, field) : 1;
+
+  if (IsMessageSetItem(field)) {
+    output->WriteVarint32(WireFormatLite::kMessageSetItemStartTag);
+    output->WriteVarint32(WireFormatLite::kMessageSetTypeIdTag);
+    output->WriteVarint32(number);
+    output->WriteVarint32(WireFormatLite::kMessageSetMessageTag);
+    output->WriteVarint32(sizes_[next_size_]);
+    WriteMessage(reflection->GetMessage(message, field), output);
+    output->WriteVarint32(WireFormatLite::kMessageSetItemEndTag);
+    return;
+  }
+
+  switch (field->type()) {
+    case FieldDescriptor::TYPE_STRING:
+    case FieldDescriptor::TYPE_BYTES: {
+      std::string scratch;
+      for (int i = 0; i < count; i++) {
+        const std::string &value = repeated
+          ? reflection->GetRepeatedStringReference(message, field, i, &scratch)
+          : reflection->GetStringReference(message, field, &scratch);
+        WireFormatLite::WriteTag(
+          number, WireFormatLite::WIRETYPE_LENGTH_DELIMITED, output);
+        output->WriteVarint32(value.size());
+        output->WriteString(value);
+      }
+      return;
+    }
+
+    case FieldDescriptor::TYPE_GROUP:
+      for (int i = 0; i < count; i++) {
+        WireFormatLite::WriteTag(
+          number, WireFormatLite::WIRETYPE_START_GROUP, output);
+        WriteMessage(repeated
+          ? reflection->GetRepeatedMessage(message, field, i)
+          : reflection->GetMessage(message, field), output);
+        WireFormatLite::WriteTag(
+          number, WireFormatLite::WIRETYPE_END_GROUP, output);
+      }
+      return;
+
+    case FieldDescriptor::TYPE_MESSAGE:
+      for (int i = 0; i < count; i++) {
+        WireFormatLite::WriteTag(
+          number, WireFormatLite::WIRETYPE_LENGTH_DELIMITED, output);
+        output->WriteVarint32(sizes_[next_size_]);
+        WriteMessage(repeated
+          ? reflection->GetRepeatedMessage(message, field, i)
+          : reflection->GetMessage(message, field), output);
+      }
+      return;
+
+    default:
+      break;
+  }
+
+  // A tag and a 64-bit varint per value, plus a packed length.
+  size_t bound = (count + 1) * 15;
+  if (buffer_.size() < bound) buffer_.resize(bound);
+
+  uint8 *start = reinterpret_cast<uint8 *>(&buffer_[0]);
+  uint8 *end = WriteField(message, reflection, field, start);
+  output->WriteRaw(start, end - start);
+}
+
+uint8 *Serializer::WriteField (
+  const Message &message,
+  const Reflection *reflection,
+  const FieldDescriptor *field,
+  uint8 *target
+) {
+  int number = field->number();
+  bool repeated = field->is_repeated();
+  int count = repeated ? reflection->FieldSize(message, field) : 1;
+  bool packed = field->options().packed();
+
+  if (IsMessageSetItem(field)) {
+    target = CodedOutputStream::WriteTagToArray(
+      WireFormatLite::kMessageSetItemStartTag, target);
+    target = CodedOutputStream::WriteTagToArray(
+      WireFormatLite::kMessageSetTypeIdTag, target);
+    target = CodedOutputStream::WriteVarint32ToArray(number, target);
+    target = CodedOutputStream::WriteTagToArray(
+      WireFormatLite::kMessageSetMessageTag, target);
+    target = CodedOutputStream::WriteVarint32ToArray(
+      sizes_[next_size_], target);
+    target = WriteMessage(reflection->GetMessage(message, field), target);
+    return CodedOutputStream::WriteTagToArray(
+      WireFormatLite::kMessageSetItemEndTag, target);
+  }
+
+  if (packed) {
+    target = WireFormatLite::WriteTagToArray(
+      number, WireFormatLite::WIRETYPE_LENGTH_DELIMITED, target);
+    target = CodedOutputStream::WriteVarint32ToArray(
+      sizes_[next_size_++], target);
+  }
+
+  switch (field->type()) {
+#define WRITE_PRIMITIVE(TYPE, CPPTYPE, METHOD, WRITE)                     \
+    case FieldDescriptor::TYPE_##TYPE:                                    \
+      if (repeated) {                                                     \
+        const RepeatedField<CPPTYPE> &values =                            \
+          reflection->GetRepeatedField<CPPTYPE>(message, field);          \
+        if (packed) {                                                     \
+          for (int i = 0; i < count; i++) {                               \
+            target = WireFormatLite::Write##WRITE##NoTagToArray(          \
+              values.Get(i), target);                                     \
+          }                                                               \
+        } else {                                                          \
+          for (int i = 0; i < count; i++) {                               \
+            target = WireFormatLite::Write##WRITE##ToArray(               \
+              number, values.Get(i), target);                             \
+          }                                                               \
+        }                                                                 \
+      } else {                                                            \
+        target = WireFormatLite::Write##WRITE##ToArray(                   \
+          number, reflection->Get##METHOD(message, field), target);       \
+      }                                                                   \
+      break;
+
+    WRITE_PRIMITIVE(INT32, int32, Int32, Int32)
+    WRITE_PRIMITIVE(INT64, int64, Int64, Int64)
+    WRITE_PRIMITIVE(UINT32, uint32, UInt32, UInt32)
+    WRITE_PRIMITIVE(UINT64, uint64, UInt64, UInt64)
+    WRITE_PRIMITIVE(SINT32, int32, Int32, SInt32)
+    WRITE_PRIMITIVE(SINT64, int64, Int64, SInt64)
+    WRITE_PRIMITIVE(FIXED32, uint32, UInt32, Fixed32)
+    WRITE_PRIMITIVE(FIXED64, uint64, UInt64, Fixed64)
+    WRITE_PRIMITIVE(SFIXED32, int32, Int32, SFixed32)
+    WRITE_PRIMITIVE(SFIXED64, int64, Int64, SFixed64)
+    WRITE_PRIMITIVE(FLOAT, float, Float, Float)
+    WRITE_PRIMITIVE(DOUBLE, double, Double, Double)
+    WRITE_PRIMITIVE(BOOL, bool, Bool, Bool)
+#undef WRITE_PRIMITIVE
+
+    case FieldDescriptor::TYPE_ENUM:
+      for (int i = 0; i < count; i++) {
+        int value = repeated
+          ? reflection->GetRepeatedEnum(message, field, i)->number()
+          : reflection->GetEnum(message, field)->number();
+        target = packed
+          ? WireFormatLite::WriteEnumNoTagToArray(value, target)
+          : WireFormatLite::WriteEnumToArray(number, value, target);
+      }
+      break;
+
+    case FieldDescriptor::TYPE_STRING:
+    case FieldDescriptor::TYPE_BYTES: {
+      std::string scratch;
+      for (int i = 0; i < count; i++) {
+        const std::string &value = repeated
+          ? reflection->GetRepeatedStringReference(message, field, i, &scratch)
+          : reflection->GetStringReference(message, field, &scratch);
+        target = WireFormatLite::WriteBytesToArray(number, value, target);
+      }
+      break;
+    }
+
+    case FieldDescriptor::TYPE_GROUP:
+      for (int i = 0; i < count; i++) {
+        const Message &value = repeated
+          ? reflection->GetRepeatedMessage(message, field, i)
+          : reflection->GetMessage(message, field);
+        target = WireFormatLite::WriteTagToArray(
+          number, WireFormatLite::WIRETYPE_START_GROUP, target);
+        target = WriteMessage(value, target);
+        target = WireFormatLite::WriteTagToArray(
+          number, WireFormatLite::WIRETYPE_END_GROUP, target);
+      }
+      break;
+
+    case FieldDescriptor::TYPE_MESSAGE:
+      for (int i = 0; i < count; i++) {
+        const Message &value = repeated
+          ? reflection->GetRepeatedMessage(message, field, i)
+          : reflection->GetMessage(message, field);
+        target = WireFormatLite::WriteTagToArray(
+          number, WireFormatLite::WIRETYPE_LENGTH_DELIMITED, target);
+        target = CodedOutputStream::WriteVarint32ToArray(
+          sizes_[next_size_], target);
+        target = WriteMessage(value, target);
+      }
+      break;
+  }
+
+  return target;
+}
+
+} // namespace protobuf
+} // namespace node
@@ -0,0 +1,132 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/message.h>
+#include <google/protobuf/unknown_field_set.h>
+
+namespace node {
+namespace protobuf {
+
+// Serializes reflection-backed messages, such as DynamicMessages, in two
+// passes. The size pass lists each message's fields once and records the
+// sizes of sub-messages and packed fields in flat side arrays, in the
+// order the write pass needs them; the write pass then streams the bytes
+// out without asking reflection which fields are set, or how big they
+// are, a second time.
+//
+// Equivalent to Message::ByteSize() followed by
+// SerializeWithCachedSizesToArray(), but does not touch cached sizes.
+// A Serializer may be reused; its arrays keep their capacity.
+//
+// A canonical Serializer writes any two messages that MessageDiff finds
+// equal, given the same `unknown_fields`, to the same bytes: fields in
+// field number order, packed as the schema says, without optional fields
+// equal to their defaults or empty optional sub-messages, and with
+// unknown fields after the known ones, stably sorted by number. Required
+// fields are always written, so that the bytes parse; two messages that
+// differ only in whether a required field is set to its default do not
+// encode alike.
+//
+// Unknown fields are only written if `unknown_fields` is set. MessageSets
+// go through the same passes, their extensions and unknown fields written
+// as MessageSet items.
+class Serializer {
+public:
+  explicit Serializer (bool canonical = false, bool unknown_fields = true)
+    : canonical_(canonical), unknown_fields_(unknown_fields) {}
+
+  // Returns the encoded size of `message` and prepares to write it.
+  int ByteSize (const google::protobuf::Message &message);
+
+  // Writes the message last passed to ByteSize(), which must not have
+  // been modified since, and returns the end of the written bytes.
+  google::protobuf::uint8 *SerializeToArray (
+    const google::protobuf::Message &message,
+    google::protobuf::uint8 *target
+  );
+
+  // Like SerializeToArray(), but to a stream. Messages that fit in the
+  // stream's current buffer are written directly into it.
+  void Serialize (
+    const google::protobuf::Message &message,
+    google::protobuf::io::CodedOutputStream *output
+  );
+
+private:
+  bool canonical_;
+  bool unknown_fields_;
+  // Per message: its size, then its number of fields set. Per packed
+  // field: the size of its data.
+  std::vector<int> sizes_;
+  // The fields set in each message, in the order they are written, or
+  // NULL where a canonical Serializer leaves a field out.
+  std::vector<const google::protobuf::FieldDescriptor *> fields_;
+  std::vector<const google::protobuf::FieldDescriptor *> scratch_;
+  std::string buffer_;
+  size_t next_size_;
+  size_t next_field_;
+
+  int MessageSize (const google::protobuf::Message &message);
+
+  int FieldSize (
+    const google::protobuf::Message &message,
+    const google::protobuf::Reflection *reflection,
+    const google::protobuf::FieldDescriptor *field
+  );
+
+  google::protobuf::uint8 *WriteMessage (
+    const google::protobuf::Message &message,
+    google::protobuf::uint8 *target
+  );
+
+  google::protobuf::uint8 *WriteField (
+    const google::protobuf::Message &message,
+    const google::protobuf::Reflection *reflection,
+    const google::protobuf::FieldDescriptor *field,
+    google::protobuf::uint8 *target
+  );
+
+  void WriteMessage (
+    const google::protobuf::Message &message,
+    google::protobuf::io::CodedOutputStream *output
+  );
+
+  void WriteField (
+    const google::protobuf::Message &message,
+    const google::protobuf::Reflection *reflection,
+    const google::protobuf::FieldDescriptor *field,
+    google::protobuf::io::CodedOutputStream *output
+  );
+
+  // Returns the unknown fields to write: `fields` itself, a sorted copy
+  // in `sorted` if canonical, or the empty `sorted` if they are not
+  // written.
+  const google::protobuf::UnknownFieldSet &UnknownFields (
+    const google::protobuf::UnknownFieldSet &fields,
+    google::protobuf::UnknownFieldSet *sorted
+  ) const;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(Serializer);
+};
+
+} // namespace protobuf
+} // namespace node
@@ -0,0 +1,329 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+
+#include <assert.h>
+
+#include <string>
+
+#include <node.h>
+#include <nan.h>
+#include <uv.h>
+
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/message.h>
+#include <google/protobuf/service.h>
+
+#include "descriptor.h"
+#include "schema.h"
+#include "server.h"
+
+using google::protobuf::Closure;
+using google::protobuf::Message;
+using google::protobuf::MethodDescriptor;
+using google::protobuf::RpcController;
+using google::protobuf::ServiceDescriptor;
+
+namespace node {
+namespace protobuf {
+
+const char E_UNKNOWN_SERVICE_NAME[] = "Unknown service";
+const char E_NOT_IMPLEMENTED[] = "Not implemented";
+const char E_ALREADY_RESPONDED[] = "Callback already called";
+
+// A service implemented by a JS object, invoked on the loop thread.
+class Server::Service : public google::protobuf::Service {
+public:
+  Service (
+    Server *server,
+    const ServiceDescriptor *descriptor,
+    v8::Local<v8::Object> implementation
+  ) : server_(server), descriptor_(descriptor) {
+    NanAssignPersistent(implementation_, implementation);
+  }
+
+  ~Service () {
+    NanDisposePersistent(implementation_);
+  }
+
+  const ServiceDescriptor *GetDescriptor () {
+    return descriptor_;
+  }
+
+  void CallMethod (
+    const MethodDescriptor *method,
+    RpcController *controller,
+    const Message *request,
+    Message *response,
+    Closure *done
+  );
+
+  const Message &GetRequestPrototype (const MethodDescriptor *method) const {
+    return server_->Prototype(method->input_type());
+  }
+
+  const Message &GetResponsePrototype (const MethodDescriptor *method) const {
+    return server_->Prototype(method->output_type());
+  }
+
+private:
+  Server *server_;
+  const ServiceDescriptor *descriptor_;
+  v8::Persistent<v8::Object> implementation_;
+};
+
+// A call waiting for the JS callback. The server is referenced until the
+// call is finished, so that it can not be collected with calls
+// outstanding.
+class Server::Call {
+public:
+  Call (
+    Server *server,
+    const Descriptor *output,
+    RpcController *controller,
+    Message *response,
+    Closure *done
+  ) : server_(server), output_(output), controller_(controller),
+      response_(response), done_(done) {
+    server_->Ref();
+  }
+
+  ~Call () {
+    server_->Unref();
+  }
+
+  // Returns the data bound to the `callback(err, response)` passed to the
+  // implementation: the call, until it is taken out by Take().
+  v8::Local<v8::Array> Data () {
+    v8::Local<v8::Array> data = NanNew<v8::Array>(1);
+    data->Set(0, NanNew<v8::External>(this));
+    return data;
+  }
+
+  static v8::Local<v8::Function> Callback (v8::Local<v8::Array> data) {
+    return NanNew<v8::FunctionTemplate>(Respond, data)->GetFunction();
+  }
+
+  // Takes the call out of `data`, or returns NULL if it has been finished.
+  // Only the first invocation of the callback counts.
+  static Call *Take (v8::Local<v8::Array> data) {
+    if (!data->Get(0)->IsExternal()) return NULL;
+    Call *call =
+      static_cast<Call *>(data->Get(0).As<v8::External>()->Value());
+    data->Set(0, NanNull());
+    return call;
+  }
+
+  // Completes the call with `error`, or else with `response`, and deletes
+  // it.
+  void Finish (v8::Local<v8::Value> error, v8::Local<v8::Value> response);
+
+private:
+  Server *server_;
+  const Descriptor *output_;
+  RpcController *controller_;
+  Message *response_;
+  Closure *done_;
+
+  static NAN_METHOD(Respond);
+};
+
+void Server::Service::CallMethod (
+  const MethodDescriptor *method,
+  RpcController *controller,
+  const Message *request,
+  Message *response,
+  Closure *done
+) {
+  NanScope();
+
+  Schema *schema = node::ObjectWrap::Unwrap<Schema>(
+    NanNew(server_->persistentHandle));
+
+  v8::Local<v8::Object> implementation = NanNew(implementation_);
+  v8::Local<v8::Value> function = implementation->Get(
+    NanSymbol(method->name().c_str()));
+  if (!function->IsFunction()) {
+    controller->SetFailed(E_NOT_IMPLEMENTED);
+    done->Run();
+    return;
+  }
+
+  const Descriptor *input = schema->Lookup(method->input_type());
+  const Descriptor *output = schema->Lookup(method->output_type());
+  assert(input != NULL && output != NULL);
+
+  Call *call = new Call(server_, output, controller, response, done);
+  v8::Local<v8::Array> data = call->Data();
+  v8::Local<v8::Value> argv[] = {
+    input->ToJS(*request),
+    Call::Callback(data)
+  };
+
+  v8::TryCatch try_catch;
+  // Methods are called on the implementation, so they can use `this`.
+  function.As<v8::Function>()->Call(implementation, 2, argv);
+  if (try_catch.HasCaught()) {
+    // A method that throws before responding fails the call with the
+    // exception. Either way the exception is reported as uncaught.
+    call = Call::Take(data);
+    if (call != NULL) call->Finish(try_catch.Exception(), NanUndefined());
+    node::FatalException(try_catch);
+  }
+}
+
+void Server::Call::Finish (
+  v8::Local<v8::Value> error,
+  v8::Local<v8::Value> response
+) {
+  if (!error->IsNull() && !error->IsUndefined()) {
+    // Errors fail the call with their message, other values as strings.
+    if (error->IsObject()) {
+      v8::Local<v8::Value> message =
+        error->ToObject()->Get(NanSymbol("message"));
+      if (!message->IsUndefined()) error = message;
+    }
+    controller_->SetFailed(*v8::String::Utf8Value(error));
+  } else if (response->IsObject()) {
+    const char *failure = output_->FromJS(response_, response->ToObject());
+    if (failure) controller_->SetFailed(failure);
+  }
+
+  done_->Run();
+  delete this;
+}
+
+NAN_METHOD(Server::Call::Respond) {
+  NanScope();
+
+  Call *call = Take(args.Data().As<v8::Array>());
+  if (call == NULL) {
+    return NanThrowError(E_ALREADY_RESPONDED);
+  }
+
+  v8::Local<v8::Value> error = NanUndefined();
+  v8::Local<v8::Value> response = NanUndefined();
+  if (args.Length() > 0) error = args[0];
+  if (args.Length() > 1) response = args[1];
+  call->Finish(error, response);
+
+  NanReturnUndefined();
+}
+
+Server::Server (v8::Local<v8::Object> handle)
+  : server_(new SocketServer(uv_default_loop())), listening_(false) {
+  NanAssignPersistent(persistentHandle, handle);
+}
+
+Server::~Server () {
+  // The server no longer invokes services once closed.
+  server_->Destroy();
+  for (size_t i = 0; i < services_.size(); i++) delete services_[i];
+  NanDisposePersistent(persistentHandle);
+}
+
+const Message &Server::Prototype (
+  const google::protobuf::Descriptor *descriptor
+) {
+  Schema *schema = node::ObjectWrap::Unwrap<Schema>(
+    NanNew(persistentHandle));
+  return *schema->factory_.GetPrototype(descriptor);
+}
+
+/* V8 exposed functions *****************************/
+
+void Server::Init (v8::Handle<v8::Object> exports) {
+  v8::Local<v8::FunctionTemplate> t = NanNew<v8::FunctionTemplate>(Server::New);
+  t->SetClassName(NanSymbol("Server"));
+  t->InstanceTemplate()->SetInternalFieldCount(1);
+
+  NODE_SET_PROTOTYPE_METHOD(t, "addService", AddService);
+  NODE_SET_PROTOTYPE_METHOD(t, "listen", Listen);
+  NODE_SET_PROTOTYPE_METHOD(t, "close", Close);
+
+  exports->Set(NanSymbol("Server"), t->GetFunction());
+}
+
+NAN_METHOD(Server::New) {
+  NanScope();
+
+  if (args.Length() < 1 || !args[0]->IsObject()) {
+    return NanThrowError("Expected a schema");
+  }
+
+  Server *server = new Server(args[0]->ToObject());
+  server->Wrap(args.This());
+
+  NanReturnValue(args.This());
+}
+
+NAN_METHOD(Server::AddService) {
+  NanScope();
+
+  Server *server = node::ObjectWrap::Unwrap<Server>(args.This());
+  Schema *schema = node::ObjectWrap::Unwrap<Schema>(
+    NanNew(server->persistentHandle));
+
+  if (args.Length() < 2 || !args[0]->IsString() || !args[1]->IsObject()) {
+    return NanThrowError("Expected a service name and an implementation");
+  }
+
+  const ServiceDescriptor *descriptor =
+    schema->pool_->FindServiceByName(*v8::String::Utf8Value(args[0]));
+  if (descriptor == NULL) {
+    return NanThrowError(E_UNKNOWN_SERVICE_NAME);
+  }
+
+  Service *service = new Service(server, descriptor, args[1]->ToObject());
+  server->services_.push_back(service);
+  server->server_->AddService(service);
+
+  NanReturnUndefined();
+}
+
+NAN_METHOD(Server::Listen) {
+  NanScope();
+
+  Server *server = node::ObjectWrap::Unwrap<Server>(args.This());
+
+  if (args.Length() < 1 || !args[0]->IsString()) {
+    return NanThrowError("Expected an address");
+  }
+
+  int r = server->server_->Listen(*v8::String::Utf8Value(args[0]));
+  if (r) {
+    return NanThrowError(uv_strerror(r));
+  }
+
+  // Listening servers stay alive until closed.
+  if (!server->listening_) server->Ref();
+  server->listening_ = true;
+
+  NanReturnUndefined();
+}
+
+NAN_METHOD(Server::Close) {
+  NanScope();
+
+  Server *server = node::ObjectWrap::Unwrap<Server>(args.This());
+  server->server_->Close();
+
+  if (server->listening_) server->Unref();
+  server->listening_ = false;
+
+  NanReturnUndefined();
+}
+
+} // namespace protobuf
+} // namespace node
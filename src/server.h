@@ -0,0 +1,71 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#pragma once
+
+#include <vector>
+
+#include <node.h>
+#include <nan.h>
+
+#include <google/protobuf/message.h>
+
+#include "rpc.h"
+
+namespace node {
+namespace protobuf {
+
+// JS handle on a SocketServer whose services are implemented in JS:
+//
+//   var server = new Server(schema);
+//   server.addService('pkg.Service', {
+//     Method: function (request, callback) {
+//       callback(null, response);  // or callback(err)
+//     }
+//   });
+//   server.listen('/tmp/sidecar.sock');
+//   server.close();
+//
+// Service names are resolved against the schema. Methods are called with
+// the implementation as `this`; those it lacks fail with "Not
+// implemented". The listening socket
+// keeps the process alive until close() is called.
+class Server : public node::ObjectWrap {
+public:
+  static void Init (v8::Handle<v8::Object> exports);
+
+  Server (v8::Local<v8::Object> handle);
+  ~Server ();
+
+private:
+  class Service;
+  class Call;
+
+  SocketServer *server_;
+  std::vector<Service *> services_;
+  bool listening_;
+  v8::Persistent<v8::Object> persistentHandle;
+
+  const google::protobuf::Message &Prototype (
+    const google::protobuf::Descriptor *descriptor
+  );
+
+  static NAN_METHOD(New);
+  static NAN_METHOD(AddService);
+  static NAN_METHOD(Listen);
+  static NAN_METHOD(Close);
+};
+
+} // namespace protobuf
+} // namespace node
@@ -0,0 +1,353 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <assert.h>
+
+#include <string>
+
+#include <node.h>
+#include <nan.h>
+#include <uv.h>
+
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/message.h>
+#include <google/protobuf/service.h>
+
+#include "controller.h"
+#include "schema.h"
+#include "descriptor.h"
+#include "service.h"
+
+using google::protobuf::Closure;
+using google::protobuf::Message;
+using google::protobuf::MethodDescriptor;
+using google::protobuf::NewCallback;
+using google::protobuf::ServiceDescriptor;
+
+namespace node {
+namespace protobuf {
+
+static v8::Persistent<v8::FunctionTemplate> service_constructor;
+
+const char E_NOT_SYNCHRONOUS[] =
+  "Service did not complete synchronously, pass a callback";
+
+// State of one invocation. Owns request and response.
+class Service::Call {
+public:
+  Call (const Service *service, const MethodDescriptor *method)
+    : service_(service), method_(method),
+      request_(service->service_->GetRequestPrototype(method).New()),
+      response_(service->service_->GetResponsePrototype(method).New()) {}
+
+  virtual ~Call () {
+    delete request_;
+    delete response_;
+  }
+
+  const char *Prepare (v8::Local<v8::Object> src) {
+    const Descriptor *descriptor =
+      service_->schema_->Lookup(method_->input_type());
+    assert(descriptor != NULL);
+    return descriptor->FromJS(request_, src);
+  }
+
+  void Run (Closure *done) {
+    service_->service_->CallMethod(
+      method_, &controller_, request_, response_, done);
+  }
+
+  // Returns the response, or an empty handle and the error in `error`.
+  v8::Local<v8::Value> Result (v8::Local<v8::Value> *error) const {
+    if (controller_.Failed()) {
+      *error = NanError(controller_.ErrorText().c_str());
+      return v8::Local<v8::Value>();
+    }
+
+    const Descriptor *descriptor =
+      service_->schema_->Lookup(method_->output_type());
+    assert(descriptor != NULL);
+    return descriptor->ToJS(*response_);
+  }
+
+protected:
+  const Service *service_;
+  const MethodDescriptor *method_;
+  Controller controller_;
+  Message *request_;
+  Message *response_;
+};
+
+// A call made without a callback. If the implementation does not finish
+// before CallMethod returns, the caller gets an exception and the call
+// cleans up after itself whenever `done` finally runs.
+class Service::SyncCall : public Service::Call {
+public:
+  SyncCall (const Service *service, const MethodDescriptor *method)
+    : Call(service, method), done_(false), abandoned_(false) {
+    uv_mutex_init(&mutex_);
+  }
+
+  ~SyncCall () {
+    uv_mutex_destroy(&mutex_);
+  }
+
+  // Returns whether the call completed. If not, the call now owns itself.
+  bool Invoke () {
+    Run(NewCallback(this, &SyncCall::Done));
+
+    uv_mutex_lock(&mutex_);
+    bool done = done_;
+    abandoned_ = !done;
+    uv_mutex_unlock(&mutex_);
+
+    return done;
+  }
+
+private:
+  uv_mutex_t mutex_;
+  bool done_;
+  bool abandoned_;
+
+  void Done () {
+    uv_mutex_lock(&mutex_);
+    done_ = true;
+    bool abandoned = abandoned_;
+    uv_mutex_unlock(&mutex_);
+
+    if (abandoned) delete this;
+  }
+};
+
+// A call made with a callback. CallMethod runs on the threadpool and
+// `done`, wherever it runs, wakes the loop through an async handle. The
+// call is freed once both the work request and the handle are finished,
+// both of which happen on the loop thread.
+class Service::AsyncCall : public Service::Call {
+public:
+  AsyncCall (
+    const Service *service,
+    const MethodDescriptor *method,
+    v8::Local<v8::Object> handle,
+    v8::Local<v8::Function> callback
+  ) : Call(service, method), callback_(callback),
+      executed_(false), closed_(false) {
+    NanAssignPersistent(persistentHandle, handle);
+    work_.data = this;
+    async_.data = this;
+  }
+
+  ~AsyncCall () {
+    NanDisposePersistent(persistentHandle);
+  }
+
+  void Start () {
+    uv_async_init(uv_default_loop(), &async_, Complete);
+    uv_queue_work(uv_default_loop(), &work_, Execute, AfterExecute);
+  }
+
+private:
+  // Keeps the service, and with it the schema, alive while in flight.
+  v8::Persistent<v8::Object> persistentHandle;
+  NanCallback callback_;
+  uv_work_t work_;
+  uv_async_t async_;
+  bool executed_;
+  bool closed_;
+
+  void Done () {
+    uv_async_send(&async_);
+  }
+
+  static void Execute (uv_work_t *work) {
+    AsyncCall *call = static_cast<AsyncCall *>(work->data);
+    call->Run(NewCallback(call, &AsyncCall::Done));
+  }
+
+  static void AfterExecute (uv_work_t *work, int status) {
+    AsyncCall *call = static_cast<AsyncCall *>(work->data);
+    call->executed_ = true;
+    if (call->closed_) delete call;
+  }
+
+  static void Complete (uv_async_t *async) {
+    NanScope();
+
+    AsyncCall *call = static_cast<AsyncCall *>(async->data);
+
+    v8::Local<v8::Value> error;
+    v8::Local<v8::Value> response = call->Result(&error);
+
+    if (response.IsEmpty()) {
+      v8::Local<v8::Value> argv[] = { error };
+      call->callback_.Call(1, argv);
+    } else {
+      v8::Local<v8::Value> argv[] = { NanNull(), response };
+      call->callback_.Call(2, argv);
+    }
+
+    uv_close(reinterpret_cast<uv_handle_t *>(async), Closed);
+  }
+
+  static void Closed (uv_handle_t *handle) {
+    AsyncCall *call = static_cast<AsyncCall *>(handle->data);
+    call->closed_ = true;
+    if (call->executed_) delete call;
+  }
+};
+
+void ExportService (
+  v8::Handle<v8::Object> target,
+  const char *name,
+  google::protobuf::Service *service
+) {
+  NanScope();
+
+  // Services may be exported from another addon's initializer, before
+  // this module's own templates exist. Only those the service uses are
+  // needed, so that addons can link this file without protobuf.cc.
+  if (service_constructor.IsEmpty()) {
+    v8::Local<v8::Object> exports = NanNew<v8::Object>();
+    Schema::Init(exports);
+    Descriptor::Init(exports);
+    Service::Init(exports);
+  }
+
+  target->Set(NanSymbol(name), Service::NewInstance(service));
+}
+
+Service::Service (
+  v8::Local<v8::Object> handle,
+  google::protobuf::Service *service
+) : service_(service) {
+  assert(service_ != NULL);
+  NanAssignPersistent(persistentHandle, handle);
+  Schema *schema = node::ObjectWrap::Unwrap<Schema>(handle);
+  schema->Import(service->GetDescriptor()->file());
+  schema_ = schema;
+}
+
+Service::~Service () {
+  NanDisposePersistent(persistentHandle);
+  delete service_;
+}
+
+/* V8 exposed functions *****************************/
+
+void Service::Init (v8::Handle<v8::Object> exports) {
+  v8::Local<v8::FunctionTemplate> t = NanNew<v8::FunctionTemplate>(Service::New);
+  NanAssignPersistent(service_constructor, t);
+  t->SetClassName(NanSymbol("Service"));
+  t->InstanceTemplate()->SetInternalFieldCount(1);
+  exports->Set(NanSymbol("Service"), t->GetFunction());
+}
+
+v8::Local<v8::Object> Service::NewInstance (
+  google::protobuf::Service *service
+) {
+  v8::Local<v8::FunctionTemplate> constructorHandle =
+    NanNew(service_constructor);
+
+  assert(!constructorHandle.IsEmpty());
+
+  v8::Local<v8::Value> argv[] = {
+    Schema::NewInstance(v8::Local<v8::Value>()),
+    NanNew<v8::External>((void *)service)
+  };
+
+  return constructorHandle->GetFunction()->NewInstance(2, argv);
+}
+
+NAN_METHOD(Service::New) {
+  NanScope();
+
+  assert(args.Length() == 2);
+
+  v8::Local<v8::Object> handle = args[0]->ToObject();
+  v8::Local<v8::External> wrap = v8::Local<v8::External>::Cast(args[1]);
+  google::protobuf::Service *pservice =
+    static_cast<google::protobuf::Service *>(wrap->Value());
+
+  Service *service = new Service(handle, pservice);
+  service->Wrap(args.This());
+
+  // One function per method. Each is bound to the service object and
+  // the method index, so it still works when detached from the object.
+  const ServiceDescriptor *descriptor = pservice->GetDescriptor();
+  for (int i = 0; i < descriptor->method_count(); i++) {
+    v8::Local<v8::Array> data = NanNew<v8::Array>(2);
+    data->Set(0, args.This());
+    data->Set(1, NanNew<v8::Int32>(i));
+
+    v8::Local<v8::FunctionTemplate> t =
+      NanNew<v8::FunctionTemplate>(Invoke, data);
+    args.This()->Set(NanSymbol(descriptor->method(i)->name().c_str()),
+      t->GetFunction());
+  }
+
+  NanReturnValue(args.This());
+}
+
+NAN_METHOD(Service::Invoke) {
+  NanScope();
+
+  v8::Local<v8::Array> data = args.Data().As<v8::Array>();
+  v8::Local<v8::Object> handle = data->Get(0)->ToObject();
+  Service *service = node::ObjectWrap::Unwrap<Service>(handle);
+  const MethodDescriptor *method =
+    service->service_->GetDescriptor()->method(data->Get(1)->Int32Value());
+
+  if (args.Length() < 1 || !args[0]->IsObject()) {
+    return NanThrowError("Expected request to be an Object");
+  }
+
+  if (args.Length() > 1 && args[1]->IsFunction()) {
+    AsyncCall *call =
+      new AsyncCall(service, method, handle, args[1].As<v8::Function>());
+
+    const char *error = call->Prepare(args[0]->ToObject());
+    if (error) {
+      delete call;
+      return NanThrowError(error);
+    }
+
+    call->Start();
+    NanReturnUndefined();
+  }
+
+  SyncCall *call = new SyncCall(service, method);
+
+  const char *error = call->Prepare(args[0]->ToObject());
+  if (error) {
+    delete call;
+    return NanThrowError(error);
+  }
+
+  if (!call->Invoke()) {
+    return NanThrowError(E_NOT_SYNCHRONOUS);
+  }
+
+  v8::Local<v8::Value> exception;
+  v8::Local<v8::Value> response = call->Result(&exception);
+  delete call;
+
+  if (response.IsEmpty()) {
+    return NanThrowError(exception);
+  }
+
+  NanReturnValue(response);
+}
+
+} // namespace protobuf
+} // namespace node
@@ -0,0 +1,108 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#pragma once
+
+#include <string>
+
+#include <node.h>
+#include <nan.h>
+
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/service.h>
+
+namespace node {
+namespace protobuf {
+
+// Exports a protobuf service implementation to JS as `target[name]`, an
+// object with one function per service method:
+//
+//   service.Method(request)            // synchronous
+//   service.Method(request, callback)  // callback(err, response)
+//
+// Requests and responses are plain JS objects as produced and consumed
+// by Descriptor#parse and Descriptor#serialize.
+//
+// Synchronous calls run on the JS thread and require the implementation
+// to invoke `done` before CallMethod returns. Calls with a callback run
+// CallMethod on the uv threadpool, so the implementation must be safe to
+// call from several threads at once; any number of calls may be in
+// flight. `done` may be invoked from any thread, at any time: the
+// response is converted and the callback invoked on the JS thread.
+//
+// Takes ownership of `service`.
+void ExportService (
+  v8::Handle<v8::Object> target,
+  const char *name,
+  google::protobuf::Service *service
+);
+
+// Bundles the arguments of a service call for implementations that
+// complete asynchronously through C-style callbacks: pass a ServiceCall
+// as the callbacks' `void *data`, and delete it once the response is
+// complete, which runs the `done` closure.
+template <typename Request, typename Response>
+class ServiceCall {
+public:
+  ServiceCall (
+    Request *request,
+    Response *response,
+    google::protobuf::Closure *done
+  ) : request(request), response(response), done_(done) {}
+
+  ~ServiceCall () {
+    done_->Run();
+  }
+
+  static ServiceCall *Cast (void *data) {
+    return static_cast<ServiceCall *>(data);
+  }
+
+  Request *const request;
+  Response *const response;
+
+private:
+  google::protobuf::Closure *done_;
+};
+
+class Schema;
+class Service : public node::ObjectWrap {
+public:
+  static void Init (v8::Handle<v8::Object> exports);
+  static v8::Local<v8::Object> NewInstance (
+    google::protobuf::Service *service
+  );
+
+  Service (
+    v8::Local<v8::Object> handle,
+    google::protobuf::Service *service
+  );
+
+  ~Service ();
+
+private:
+  class Call;
+  class SyncCall;
+  class AsyncCall;
+
+  google::protobuf::Service *service_;
+  const Schema *schema_;
+  v8::Persistent<v8::Object> persistentHandle;
+
+  static NAN_METHOD(New);
+  static NAN_METHOD(Invoke);
+};
+
+} // namespace protobuf
+} // namespace node
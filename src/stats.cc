@@ -0,0 +1,133 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#include <string.h>
+
+#include <node.h>
+#include <nan.h>
+#include <uv.h>
+
+#include "stats.h"
+
+using google::protobuf::uint64;
+
+namespace node {
+namespace protobuf {
+
+Histogram::Histogram () {
+  Reset();
+}
+
+void Histogram::Reset () {
+  memset(buckets_, 0, sizeof(buckets_));
+  count_ = 0;
+  sum_ = 0;
+  min_ = 0;
+  max_ = 0;
+}
+
+int Histogram::BucketFor (uint64 value) {
+  if (value < kLinear) {
+    return static_cast<int>(value);
+  }
+
+  int bits = 63 - __builtin_clzll(value);
+  if (bits >= kMaxBits) {
+    return kBuckets - 1;
+  }
+
+  int sub = static_cast<int>(value >> (bits - kSubBits)) & (kSubBuckets - 1);
+  return kLinear + (bits - kSubBits - 1) * kSubBuckets + sub;
+}
+
+uint64 Histogram::UpperBound (int bucket) {
+  if (bucket < kLinear) {
+    return bucket;
+  }
+
+  int bits = (bucket - kLinear) / kSubBuckets + kSubBits + 1;
+  uint64 sub = (bucket - kLinear) % kSubBuckets;
+  return ((kSubBuckets + sub + 1) << (bits - kSubBits)) - 1;
+}
+
+void Histogram::Record (uint64 value) {
+  buckets_[BucketFor(value)]++;
+  if (!count_ || value < min_) min_ = value;
+  if (value > max_) max_ = value;
+  sum_ += value;
+  count_++;
+}
+
+uint64 Histogram::Percentile (double q) const {
+  if (!count_) {
+    return 0;
+  }
+
+  uint64 rank = static_cast<uint64>(q * count_ + 0.5);
+  if (rank < 1) rank = 1;
+
+  uint64 seen = 0;
+  for (int i = 0; i < kBuckets; i++) {
+    seen += buckets_[i];
+    if (seen >= rank) {
+      uint64 bound = UpperBound(i);
+      return bound < max_ ? bound : max_;
+    }
+  }
+
+  return max_;
+}
+
+v8::Local<v8::Object> Histogram::ToJS () const {
+  v8::Local<v8::Object> result = NanNew<v8::Object>();
+  result->Set(NanSymbol("count"), NanNew<v8::Number>(count_));
+  result->Set(NanSymbol("min"), NanNew<v8::Number>(min_));
+  result->Set(NanSymbol("max"), NanNew<v8::Number>(max_));
+  result->Set(NanSymbol("mean"),
+    NanNew<v8::Number>(count_ ? static_cast<double>(sum_) / count_ : 0));
+  result->Set(NanSymbol("p50"), NanNew<v8::Number>(Percentile(0.5)));
+  result->Set(NanSymbol("p90"), NanNew<v8::Number>(Percentile(0.9)));
+  result->Set(NanSymbol("p99"), NanNew<v8::Number>(Percentile(0.99)));
+  result->Set(NanSymbol("p999"), NanNew<v8::Number>(Percentile(0.999)));
+  return result;
+}
+
+void Stats::Record (uint64 start, size_t size, bool success) {
+  calls++;
+  if (success) {
+    bytes += size;
+  } else {
+    errors++;
+  }
+  latency.Record(uv_hrtime() - start);
+}
+
+void Stats::Reset () {
+  calls = 0;
+  errors = 0;
+  bytes = 0;
+  latency.Reset();
+}
+
+v8::Local<v8::Object> Stats::ToJS () const {
+  v8::Local<v8::Object> result = NanNew<v8::Object>();
+  result->Set(NanSymbol("calls"), NanNew<v8::Number>(calls));
+  result->Set(NanSymbol("errors"), NanNew<v8::Number>(errors));
+  result->Set(NanSymbol("bytes"), NanNew<v8::Number>(bytes));
+  result->Set(NanSymbol("latency"), latency.ToJS());
+  return result;
+}
+
+} // namespace protobuf
+} // namespace node
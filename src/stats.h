@@ -0,0 +1,81 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+#pragma once
+
+#include <node.h>
+#include <nan.h>
+
+#include <google/protobuf/stubs/common.h>
+
+namespace node {
+namespace protobuf {
+
+// Log-linear latency histogram in the spirit of HdrHistogram: values
+// below kLinear nanoseconds get a bucket each, above that every power of
+// two is split into kSubBuckets, which keeps the relative error of any
+// reported percentile under 1/kSubBuckets. Recording is a handful of
+// integer operations and never allocates.
+class Histogram {
+public:
+  Histogram ();
+
+  void Record (google::protobuf::uint64 value);
+  void Reset ();
+
+  google::protobuf::uint64 Count () const { return count_; }
+  google::protobuf::uint64 Percentile (double q) const;
+
+  v8::Local<v8::Object> ToJS () const;
+
+private:
+  static const int kSubBits = 3;
+  static const int kSubBuckets = 1 << kSubBits;
+  static const int kLinear = 2 * kSubBuckets;
+  static const int kMaxBits = 48;
+  static const int kBuckets =
+    kLinear + (kMaxBits - kSubBits - 1) * kSubBuckets;
+
+  static int BucketFor (google::protobuf::uint64 value);
+  static google::protobuf::uint64 UpperBound (int bucket);
+
+  google::protobuf::uint64 buckets_[kBuckets];
+  google::protobuf::uint64 count_;
+  google::protobuf::uint64 sum_;
+  google::protobuf::uint64 min_;
+  google::protobuf::uint64 max_;
+};
+
+// Counters kept per message type and direction. Only ever touched from
+// the thread running JS, so plain increments are enough.
+struct Stats {
+  google::protobuf::uint64 calls;
+  google::protobuf::uint64 errors;
+  google::protobuf::uint64 bytes;
+  Histogram latency;
+
+  Stats () : calls(0), errors(0), bytes(0) {}
+
+  void Record (
+    google::protobuf::uint64 start,
+    size_t size,
+    bool success
+  );
+  void Reset ();
+
+  v8::Local<v8::Object> ToJS () const;
+};
+
+} // namespace protobuf
+} // namespace node
@@ -1,7 +1,10 @@
 var assert = require('assert'),
     puts = require('util').puts,
     read = require('fs').readFileSync,
-    Schema = require('../').Schema;
+    unlink = require('fs').unlinkSync,
+    Schema = require('../').Schema,
+    Channel = require('../').Channel,
+    Server = require('../').Server;
 
 /* hack to make the tests pass with node v0.3.0's new Buffer model */
 /* copied from http://github.com/bnoordhuis/node-iconv/blob/master/test.js */
@@ -30,6 +33,348 @@ describe('protobuf', function () {
     assert(this.message);  // currently rather crashes
   });
 
+  it('should serialize golden messages byte for byte', function () {
+    // The flat-array serializer writes what WireFormat does: fields in
+    // number order, repeated, packed and nested ones alike, followed by
+    // unknown fields in the order they were read.
+    var T = this.descriptor;
+    assert.bufferEqual(T.serialize(T.parse(this.golden)), this.golden);
+
+    var packed = read(__dirname + '/golden_packed_fields_message');
+    var P = this.schema['protobuf_unittest.TestPackedTypes'];
+    assert.bufferEqual(P.serialize(P.parse(packed)), packed);
+
+    // The packed fields are unknown to TestAllTypes, and come last.
+    var schema = new Schema(this.source, { unknownFields: true });
+    var mixed = Buffer.concat([this.golden, packed]);
+    T = schema['protobuf_unittest.TestAllTypes'];
+    assert.bufferEqual(T.serialize(T.parse(mixed)), mixed);
+    var Empty = schema['protobuf_unittest.TestEmptyMessage'];
+    assert.bufferEqual(Empty.serialize(Empty.parse(mixed)), mixed);
+  });
+
+  it('should collect stats when enabled', function () {
+    var schema = new Schema(this.source, { stats: true });
+    var T = schema['protobuf_unittest.TestAllTypes'];
+
+    var serialized = T.serialize(T.parse(this.golden));
+    T.parse(serialized);
+    assert.throws(function () { T.parse(new Buffer('invalid')); });
+
+    var stats = schema.stats()['protobuf_unittest.TestAllTypes'];
+    assert.equal(stats.parse.calls, 3);
+    assert.equal(stats.parse.errors, 1);
+    assert.equal(stats.parse.bytes, this.golden.length + serialized.length);
+    assert.equal(stats.parse.latency.count, 3);
+    assert.equal(stats.serialize.calls, 1);
+    assert.equal(stats.serialize.bytes, serialized.length);
+
+    schema.resetStats();
+    assert.deepEqual(schema.stats(), {});
+  });
+
+  it('should list extensions', function () {
+    var T = this.schema['protobuf_unittest.TestAllExtensions'];
+    var extensions = T.extensions();
+    assert(extensions.indexOf('protobuf_unittest.optional_int32_extension') >= 0);
+    assert(extensions.indexOf('protobuf_unittest.TestNestedExtension.test') >= 0);
+    assert.deepEqual(this.descriptor.extensions(), []);
+  });
+
+  it('should roundtrip extensions', function () {
+    var T = this.schema['protobuf_unittest.TestAllExtensions'];
+    var message = T.parse(T.serialize({
+      'protobuf_unittest.optional_int32_extension': 101,
+      'protobuf_unittest.repeated_string_extension': ['a', 'b'],
+      'protobuf_unittest.optional_nested_message_extension': { bb: 118 },
+      'protobuf_unittest.TestNestedExtension.test': 'nested'
+    }));
+
+    assert.strictEqual(message['protobuf_unittest.optional_int32_extension'], 101);
+    assert.deepEqual(message['protobuf_unittest.repeated_string_extension'], ['a', 'b']);
+    assert.strictEqual(
+      message['protobuf_unittest.optional_nested_message_extension'].bb, 118);
+    assert.strictEqual(message['protobuf_unittest.TestNestedExtension.test'], 'nested');
+    assert(!('protobuf_unittest.optional_int64_extension' in message));
+  });
+
+  it('should pass unknown fields through', function () {
+    var schema = new Schema(this.source, { unknownFields: true });
+    var T = schema['protobuf_unittest.TestAllTypes'];
+    var Empty = schema['protobuf_unittest.TestEmptyMessage'];
+
+    var serialized = T.serialize({
+      optional_int32: 101,
+      optional_string: 'unknown',
+      repeated_fixed64: ['1', '2']
+    });
+    var message = Empty.parse(serialized);
+
+    assert(Buffer.isBuffer(message._unknownFields));
+    assert.deepEqual(Object.keys(message), []);
+    assert.bufferEqual(Empty.serialize(message), serialized);
+  });
+
+  it('should drop unknown fields by default', function () {
+    var Empty = this.schema['protobuf_unittest.TestEmptyMessage'];
+    var T = this.descriptor;
+
+    var message = Empty.parse(T.serialize({ optional_int32: 101 }));
+    assert.strictEqual(message._unknownFields, undefined);
+    assert.equal(Empty.serialize(message).length, 0);
+  });
+
+  it('should not collect stats by default', function () {
+    this.descriptor.parse(this.golden);
+    assert.deepEqual(this.schema.stats(), {});
+  });
+
+  it('should compare encoded messages', function () {
+    var T = this.descriptor;
+    assert(T.equals(this.golden, T.serialize(T.parse(this.golden))));
+    assert(T.equals(new Buffer(0), T.serialize({ optional_int32: 0 })));
+
+    var changed = T.parse(this.golden);
+    changed.optional_int32 = 7;
+    changed.optional_nested_message = { bb: 8 };
+    changed.repeated_string.push('extra');
+    var buf = T.serialize(changed);
+
+    assert(!T.equals(this.golden, buf));
+    assert.deepEqual(T.diff(this.golden, buf), [
+      'optional_int32',
+      'optional_nested_message.bb',
+      'repeated_string[2]'
+    ]);
+    assert.deepEqual(T.diff(this.golden, this.golden), []);
+    assert.throws(function () {
+      T.equals(new Buffer('invalid'), buf);
+    }, /Malformed message/);
+  });
+
+  it('should serialize canonically', function () {
+    var T = this.descriptor;
+    var canonical = { canonical: true };
+    assert.equal(T.serialize({ optional_int32: 0 }).length, 2);
+    assert.equal(T.serialize({ optional_int32: 0 }, canonical).length, 0);
+    assert.equal(T.serialize({ optional_nested_message: {} }, canonical).length, 0);
+    assert(T.equals(this.golden, T.serialize(T.parse(this.golden), canonical)));
+
+    // Required fields are kept even at their defaults, so the bytes parse.
+    var R = this.schema['protobuf_unittest.TestRequired'];
+    var required = R.serialize({ a: 0, b: 0 }, canonical);
+    assert.equal(required.length, 4);
+    assert.deepEqual(R.parse(required), { a: 0, b: 0 });
+  });
+
+  it('should fingerprint messages', function () {
+    var T = this.descriptor;
+    var fingerprint = T.fingerprint(this.golden);
+    assert(/^[0-9a-f]{16}$/.test(fingerprint));
+    assert.equal(T.fingerprint(T.parse(this.golden)), fingerprint);
+    assert.equal(T.fingerprint({ optional_int32: 0 }), T.fingerprint({}));
+
+    var changed = T.parse(this.golden);
+    changed.optional_int32 = 7;
+    assert.notEqual(T.fingerprint(changed), fingerprint);
+  });
+
+  it('should fingerprint equal messages alike', function () {
+    var Empty = this.schema['protobuf_unittest.TestEmptyMessage'];
+    var a = new Buffer(0);
+    var b = this.descriptor.serialize({ optional_int32: 101 });
+
+    // Unknown fields are ignored unless the schema keeps them.
+    assert(Empty.equals(a, b));
+    assert.equal(Empty.fingerprint(b), Empty.fingerprint(a));
+    assert.equal(Empty.fingerprint(Empty.parse(b)), Empty.fingerprint(b));
+
+    var schema = new Schema(this.source, { unknownFields: true });
+    Empty = schema['protobuf_unittest.TestEmptyMessage'];
+    assert(!Empty.equals(a, b));
+    assert.notEqual(Empty.fingerprint(b), Empty.fingerprint(a));
+    assert.equal(Empty.fingerprint(Empty.parse(b)), Empty.fingerprint(b));
+  });
+
+  it('should serialize MessageSets', function () {
+    var source = read(__dirname + '/unittest_mset.desc');
+    var schema = new Schema(source, { unknownFields: true });
+    var Raw = schema['protobuf_unittest.RawMessageSet'];
+    var Extension = schema['protobuf_unittest.TestMessageSetExtension1'];
+    var extension = 'protobuf_unittest.TestMessageSetExtension1.message_set_extension';
+    var known = { type_id: 1545008, message: Extension.serialize({ i: 123 }) };
+    var unknown = { type_id: 4, message: new Buffer('unknown') };
+    var serialized = Raw.serialize({ item: [known, unknown] });
+
+    var Set = schema['protobuf_unittest.TestMessageSet'];
+    var message = Set.parse(serialized);
+    assert.strictEqual(message[extension].i, 123);
+    assert.bufferEqual(Set.serialize(message), serialized);
+
+    // Unknown items are dropped unless the schema keeps them.
+    Set = new Schema(source)['protobuf_unittest.TestMessageSet'];
+    var stripped = Raw.serialize({ item: [known] });
+    assert.bufferEqual(Set.serialize(Set.parse(serialized)), stripped);
+    assert.equal(Set.fingerprint(serialized), Set.fingerprint(stripped));
+
+    // Canonically, empty items are left out like empty sub-messages.
+    var empty = {};
+    empty['protobuf_unittest.TestMessageSetExtension2.message_set_extension'] = {};
+    assert.equal(Set.serialize(empty, { canonical: true }).length, 0);
+  });
+
+  it('should reject unknown channel methods', function () {
+    var channel = new Channel(this.schema, __dirname + '/missing.sock');
+    assert.throws(function () {
+      channel.call('protobuf_unittest.TestService.Baz', {}, function () {});
+    }, /Unknown method/);
+    channel.close();
+  });
+
+  it('should fail calls when the channel can not connect', function (done) {
+    var channel = new Channel(this.schema, __dirname + '/missing.sock');
+    channel.call('protobuf_unittest.TestService.Foo', {}, function (err) {
+      assert(err instanceof Error);
+      channel.close();
+      done();
+    });
+  });
+
+  it('should serve calls over a pipe', function (done) {
+    var address = __dirname + '/server.sock';
+    try { unlink(address); } catch (err) {}
+
+    // Requests and responses are empty messages, so calls are told apart
+    // by unknown fields that the server echoes back.
+    var schema = new Schema(this.source, { unknownFields: true });
+    var T = this.descriptor;
+    function tag (n) {
+      return { _unknownFields: T.serialize({ optional_int32: n }) };
+    }
+
+    var pending = [];
+    var server = new Server(schema);
+    server.addService('protobuf_unittest.TestService', {
+      // The first call is answered after the second.
+      Foo: function (request, callback) {
+        pending.push(function () { callback(null, request); });
+        if (pending.length == 2) {
+          pending[1]();
+          pending[0]();
+        }
+      },
+      Bar: function (request, callback) {
+        callback(new Error('Bar failed'));
+      }
+    });
+    server.listen(address);
+
+    var channel = new Channel(schema, address);
+    var responses = [];
+    function respond (err, response) {
+      assert.ifError(err);
+      responses.push(T.parse(response._unknownFields).optional_int32);
+    }
+
+    // Pipelined on one connection, and answered in completion order.
+    channel.call('protobuf_unittest.TestService.Foo', tag(1), respond);
+    channel.call('protobuf_unittest.TestService.Foo', tag(2), respond);
+    channel.call('protobuf_unittest.TestService.Bar', tag(3), function (err) {
+      assert(err instanceof Error);
+      assert.equal(err.message, 'Bar failed');
+      assert.deepEqual(responses, [2, 1]);
+      channel.close();
+      server.close();
+      done();
+    });
+  });
+
+  it('should fail calls the server can not serve', function (done) {
+    var address = __dirname + '/server.sock';
+    try { unlink(address); } catch (err) {}
+
+    var server = new Server(this.schema);
+    server.listen(address);
+
+    var channel = new Channel(this.schema, address);
+    channel.call('protobuf_unittest.TestService.Foo', {}, function (err) {
+      assert(err instanceof Error);
+      assert.equal(err.message, 'Unknown method');
+
+      server.addService('protobuf_unittest.TestService', {});
+      channel.call('protobuf_unittest.TestService.Bar', {}, function (err) {
+        assert(err instanceof Error);
+        assert.equal(err.message, 'Not implemented');
+        channel.close();
+        server.close();
+        done();
+      });
+    });
+  });
+
+  it('should call service methods on the implementation', function (done) {
+    var address = __dirname + '/server.sock';
+    try { unlink(address); } catch (err) {}
+
+    // Requests and responses are empty, so the answer is an unknown field.
+    var schema = new Schema(this.source, { unknownFields: true });
+    var T = this.descriptor;
+
+    function Implementation (answer) {
+      this.answer = answer;
+    }
+    Implementation.prototype.Foo = function (request, callback) {
+      callback(null, {
+        _unknownFields: T.serialize({ optional_int32: this.answer })
+      });
+    };
+
+    var server = new Server(schema);
+    server.addService('protobuf_unittest.TestService', new Implementation(42));
+    server.listen(address);
+
+    var channel = new Channel(schema, address);
+    channel.call('protobuf_unittest.TestService.Foo', {}, function (err, response) {
+      assert.ifError(err);
+      assert.equal(T.parse(response._unknownFields).optional_int32, 42);
+      channel.close();
+      server.close();
+      done();
+    });
+  });
+
+  it('should fail calls whose method throws', function (done) {
+    var address = __dirname + '/server.sock';
+    try { unlink(address); } catch (err) {}
+
+    var server = new Server(this.schema);
+    server.addService('protobuf_unittest.TestService', {
+      Foo: function (request, callback) {
+        throw new Error('Foo threw');
+      }
+    });
+    server.listen(address);
+
+    // The exception is still reported as uncaught, so keep it from mocha.
+    var listeners = process.listeners('uncaughtException');
+    var caught;
+    process.removeAllListeners('uncaughtException');
+    process.once('uncaughtException', function (err) { caught = err; });
+
+    var channel = new Channel(this.schema, address);
+    channel.call('protobuf_unittest.TestService.Foo', {}, function (err) {
+      listeners.forEach(function (listener) {
+        process.on('uncaughtException', listener);
+      });
+      assert(err instanceof Error);
+      assert.equal(err.message, 'Foo threw');
+      assert.equal(caught.message, 'Foo threw');
+      channel.close();
+      server.close();
+      done();
+    });
+  });
+
 });
 
 /*
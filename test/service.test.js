@@ -0,0 +1,82 @@
+var assert = require('assert');
+
+var binding;
+
+try {
+  binding = require('../build/Release/service_test.node');
+} catch (err) {
+  binding = require('../build/Debug/service_test.node');
+}
+
+// service_test.TestService, implemented in test/service_test.cc.
+describe('ExportService', function () {
+
+  before(function () {
+    this.service = binding.service;
+  });
+
+  it('should call synchronously', function () {
+    assert.deepEqual(this.service.Double({ value: 21 }), { value: 42 });
+  });
+
+  it('should throw errors from a synchronous call', function () {
+    var service = this.service;
+    assert.throws(function () {
+      service.Double({ value: 1, error: 'Double failed' });
+    }, /Double failed/);
+  });
+
+  it('should call on the threadpool with a callback', function (done) {
+    this.service.Double({ value: 21 }, function (err, response) {
+      assert.ifError(err);
+      assert.deepEqual(response, { value: 42 });
+      done();
+    });
+  });
+
+  it('should pass errors to the callback', function (done) {
+    this.service.Double({ error: 'Double failed' }, function (err, response) {
+      assert(err instanceof Error);
+      assert.equal(err.message, 'Double failed');
+      assert.strictEqual(response, undefined);
+      done();
+    });
+  });
+
+  it('should keep several calls in flight', function (done) {
+    var service = this.service;
+    var values = [];
+    for (var i = 1; i <= 4; i++) {
+      service.DoubleLater({ value: i }, function (err, response) {
+        assert.ifError(err);
+        values.push(response.value);
+        if (values.length == 4) {
+          assert.deepEqual(values.sort(), [2, 4, 6, 8]);
+          done();
+        }
+      });
+    }
+  });
+
+  it('should reject bad requests', function () {
+    var service = this.service;
+    assert.throws(function () {
+      service.Double('not a request');
+    }, /Expected request to be an Object/);
+  });
+
+  it('should abandon calls that do not finish synchronously', function (done) {
+    var service = this.service;
+    var finished = service.Finished({}).count;
+    assert.throws(function () {
+      service.DoubleLater({ value: 1 });
+    }, /did not complete synchronously/);
+
+    // The abandoned call still finishes, and frees itself, later.
+    (function poll () {
+      if (service.Finished({}).count > finished) return done();
+      setTimeout(poll, 10);
+    })();
+  });
+
+});
@@ -0,0 +1,96 @@
+// Copyright 2010 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you
+// may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+
+// Exports service_test.TestService for test/service.test.js.
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include <uv.h>
+
+#include "service.h"
+#include "service_test.pb.h"
+
+namespace {
+
+typedef node::protobuf::ServiceCall<
+  const service_test::Request, service_test::Response> Call;
+
+uv_mutex_t finished_mutex;
+int finished = 0;
+
+// Answers a DoubleLater call once the caller has had time to give up on
+// it. It is counted first, so that a callback sees its own call counted.
+void *FinishLater (void *data) {
+  usleep(20 * 1000);
+
+  uv_mutex_lock(&finished_mutex);
+  finished++;
+  uv_mutex_unlock(&finished_mutex);
+
+  Call *call = Call::Cast(data);
+  call->response->set_value(call->request->value() * 2);
+  delete call;  // runs done
+  return NULL;
+}
+
+class TestService : public service_test::TestService {
+public:
+  virtual void Double (
+    google::protobuf::RpcController *controller,
+    const service_test::Request *request,
+    service_test::Response *response,
+    google::protobuf::Closure *done
+  ) {
+    if (request->has_error()) {
+      controller->SetFailed(request->error());
+    } else {
+      response->set_value(request->value() * 2);
+    }
+    done->Run();
+  }
+
+  virtual void DoubleLater (
+    google::protobuf::RpcController *controller,
+    const service_test::Request *request,
+    service_test::Response *response,
+    google::protobuf::Closure *done
+  ) {
+    pthread_t thread;
+    pthread_create(&thread, NULL, FinishLater,
+                   new Call(request, response, done));
+    pthread_detach(thread);
+  }
+
+  virtual void Finished (
+    google::protobuf::RpcController *controller,
+    const service_test::CountRequest *request,
+    service_test::CountResponse *response,
+    google::protobuf::Closure *done
+  ) {
+    uv_mutex_lock(&finished_mutex);
+    response->set_count(finished);
+    uv_mutex_unlock(&finished_mutex);
+    done->Run();
+  }
+};
+
+void Init (v8::Handle<v8::Object> exports) {
+  uv_mutex_init(&finished_mutex);
+  node::protobuf::ExportService(exports, "service", new TestService);
+}
+
+} // namespace
+
+NODE_MODULE(service_test, Init)
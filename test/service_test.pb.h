@@ -0,0 +1,633 @@
+// Generated by the protocol buffer compiler.  DO NOT EDIT!
+// source: service_test.proto
+
+#ifndef PROTOBUF_service_5ftest_2eproto__INCLUDED
+#define PROTOBUF_service_5ftest_2eproto__INCLUDED
+
+#include <string>
+
+#include <google/protobuf/stubs/common.h>
+
+#if GOOGLE_PROTOBUF_VERSION < 2005000
+#error This file was generated by a newer version of protoc which is
+#error incompatible with your Protocol Buffer headers.  Please update
+#error your headers.
+#endif
+#if 2005000 < GOOGLE_PROTOBUF_MIN_PROTOC_VERSION
+#error This file was generated by an older version of protoc which is
+#error incompatible with your Protocol Buffer headers.  Please
+#error regenerate this file with a newer version of protoc.
+#endif
+
+#include <google/protobuf/generated_message_util.h>
+#include <google/protobuf/message.h>
+#include <google/protobuf/repeated_field.h>
+#include <google/protobuf/extension_set.h>
+#include <google/protobuf/service.h>
+#include <google/protobuf/unknown_field_set.h>
+// @@protoc_insertion_point(includes)
+
+namespace service_test {
+
+// Internal implementation detail -- do not call these.
+void  protobuf_AddDesc_service_5ftest_2eproto();
+void protobuf_AssignDesc_service_5ftest_2eproto();
+void protobuf_ShutdownFile_service_5ftest_2eproto();
+
+class Request;
+class Response;
+class CountRequest;
+class CountResponse;
+
+// ===================================================================
+
+class Request : public ::google::protobuf::Message {
+ public:
+  Request();
+  virtual ~Request();
+
+  Request(const Request& from);
+
+  inline Request& operator=(const Request& from) {
+    CopyFrom(from);
+    return *this;
+  }
+
+  inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
+    return _unknown_fields_;
+  }
+
+  inline ::google::protobuf::UnknownFieldSet* mutable_unknown_fields() {
+    return &_unknown_fields_;
+  }
+
+  static const ::google::protobuf::Descriptor* descriptor();
+  static const Request& default_instance();
+
+  void Swap(Request* other);
+
+  // implements Message ----------------------------------------------
+
+  Request* New() const;
+  Request* New(::google::protobuf::Arena* arena) const;
+  void CopyFrom(const ::google::protobuf::Message& from);
+  void MergeFrom(const ::google::protobuf::Message& from);
+  void CopyFrom(const Request& from);
+  void MergeFrom(const Request& from);
+  void Clear();
+  bool IsInitialized() const;
+
+  int ByteSize() const;
+  bool MergePartialFromCodedStream(
+      ::google::protobuf::io::CodedInputStream* input);
+  void SerializeWithCachedSizes(
+      ::google::protobuf::io::CodedOutputStream* output) const;
+  ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;
+  void SerializeReverse(
+      ::google::protobuf::io::ReverseCodedOutputStream* output) const;
+  int GetCachedSize() const { return _cached_size_; }
+  private:
+  void SharedCtor();
+  void SharedDtor();
+  void SetCachedSize(int size) const;
+  public:
+
+  ::google::protobuf::Metadata GetMetadata() const;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  // optional int32 value = 1;
+  inline bool has_value() const;
+  inline void clear_value();
+  static const int kValueFieldNumber = 1;
+  inline ::google::protobuf::int32 value() const;
+  inline void set_value(::google::protobuf::int32 value);
+
+  // optional string error = 2;
+  inline bool has_error() const;
+  inline void clear_error();
+  static const int kErrorFieldNumber = 2;
+  inline const ::std::string& error() const;
+  inline void set_error(const ::std::string& value);
+  inline void set_error(const char* value);
+  inline void set_error(const char* value, size_t size);
+  inline ::std::string* mutable_error();
+  inline ::std::string* release_error();
+  inline void set_allocated_error(::std::string* error);
+
+  // @@protoc_insertion_point(class_scope:service_test.Request)
+ private:
+  inline void set_has_value();
+  inline void clear_has_value();
+  inline void set_has_error();
+  inline void clear_has_error();
+
+  ::google::protobuf::UnknownFieldSet _unknown_fields_;
+
+  ::std::string* error_;
+  ::google::protobuf::int32 value_;
+
+  mutable int _cached_size_;
+  ::google::protobuf::uint32 _has_bits_[(2 + 31) / 32];
+
+  friend void  protobuf_AddDesc_service_5ftest_2eproto();
+  friend void protobuf_AssignDesc_service_5ftest_2eproto();
+  friend void protobuf_ShutdownFile_service_5ftest_2eproto();
+
+  void InitAsDefaultInstance();
+  static Request* default_instance_;
+};
+// -------------------------------------------------------------------
+
+class Response : public ::google::protobuf::Message {
+ public:
+  Response();
+  virtual ~Response();
+
+  Response(const Response& from);
+
+  inline Response& operator=(const Response& from) {
+    CopyFrom(from);
+    return *this;
+  }
+
+  inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
+    return _unknown_fields_;
+  }
+
+  inline ::google::protobuf::UnknownFieldSet* mutable_unknown_fields() {
+    return &_unknown_fields_;
+  }
+
+  static const ::google::protobuf::Descriptor* descriptor();
+  static const Response& default_instance();
+
+  void Swap(Response* other);
+
+  // implements Message ----------------------------------------------
+
+  Response* New() const;
+  Response* New(::google::protobuf::Arena* arena) const;
+  void CopyFrom(const ::google::protobuf::Message& from);
+  void MergeFrom(const ::google::protobuf::Message& from);
+  void CopyFrom(const Response& from);
+  void MergeFrom(const Response& from);
+  void Clear();
+  bool IsInitialized() const;
+
+  int ByteSize() const;
+  bool MergePartialFromCodedStream(
+      ::google::protobuf::io::CodedInputStream* input);
+  void SerializeWithCachedSizes(
+      ::google::protobuf::io::CodedOutputStream* output) const;
+  ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;
+  void SerializeReverse(
+      ::google::protobuf::io::ReverseCodedOutputStream* output) const;
+  int GetCachedSize() const { return _cached_size_; }
+  private:
+  void SharedCtor();
+  void SharedDtor();
+  void SetCachedSize(int size) const;
+  public:
+
+  ::google::protobuf::Metadata GetMetadata() const;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  // optional int32 value = 1;
+  inline bool has_value() const;
+  inline void clear_value();
+  static const int kValueFieldNumber = 1;
+  inline ::google::protobuf::int32 value() const;
+  inline void set_value(::google::protobuf::int32 value);
+
+  // @@protoc_insertion_point(class_scope:service_test.Response)
+ private:
+  inline void set_has_value();
+  inline void clear_has_value();
+
+  ::google::protobuf::UnknownFieldSet _unknown_fields_;
+
+  ::google::protobuf::int32 value_;
+
+  mutable int _cached_size_;
+  ::google::protobuf::uint32 _has_bits_[(1 + 31) / 32];
+
+  friend void  protobuf_AddDesc_service_5ftest_2eproto();
+  friend void protobuf_AssignDesc_service_5ftest_2eproto();
+  friend void protobuf_ShutdownFile_service_5ftest_2eproto();
+
+  void InitAsDefaultInstance();
+  static Response* default_instance_;
+};
+// -------------------------------------------------------------------
+
+class CountRequest : public ::google::protobuf::Message {
+ public:
+  CountRequest();
+  virtual ~CountRequest();
+
+  CountRequest(const CountRequest& from);
+
+  inline CountRequest& operator=(const CountRequest& from) {
+    CopyFrom(from);
+    return *this;
+  }
+
+  inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
+    return _unknown_fields_;
+  }
+
+  inline ::google::protobuf::UnknownFieldSet* mutable_unknown_fields() {
+    return &_unknown_fields_;
+  }
+
+  static const ::google::protobuf::Descriptor* descriptor();
+  static const CountRequest& default_instance();
+
+  void Swap(CountRequest* other);
+
+  // implements Message ----------------------------------------------
+
+  CountRequest* New() const;
+  CountRequest* New(::google::protobuf::Arena* arena) const;
+  void CopyFrom(const ::google::protobuf::Message& from);
+  void MergeFrom(const ::google::protobuf::Message& from);
+  void CopyFrom(const CountRequest& from);
+  void MergeFrom(const CountRequest& from);
+  void Clear();
+  bool IsInitialized() const;
+
+  int ByteSize() const;
+  bool MergePartialFromCodedStream(
+      ::google::protobuf::io::CodedInputStream* input);
+  void SerializeWithCachedSizes(
+      ::google::protobuf::io::CodedOutputStream* output) const;
+  ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;
+  void SerializeReverse(
+      ::google::protobuf::io::ReverseCodedOutputStream* output) const;
+  int GetCachedSize() const { return _cached_size_; }
+  private:
+  void SharedCtor();
+  void SharedDtor();
+  void SetCachedSize(int size) const;
+  public:
+
+  ::google::protobuf::Metadata GetMetadata() const;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  // @@protoc_insertion_point(class_scope:service_test.CountRequest)
+ private:
+
+  ::google::protobuf::UnknownFieldSet _unknown_fields_;
+
+
+  mutable int _cached_size_;
+  ::google::protobuf::uint32 _has_bits_[1];
+
+  friend void  protobuf_AddDesc_service_5ftest_2eproto();
+  friend void protobuf_AssignDesc_service_5ftest_2eproto();
+  friend void protobuf_ShutdownFile_service_5ftest_2eproto();
+
+  void InitAsDefaultInstance();
+  static CountRequest* default_instance_;
+};
+// -------------------------------------------------------------------
+
+class CountResponse : public ::google::protobuf::Message {
+ public:
+  CountResponse();
+  virtual ~CountResponse();
+
+  CountResponse(const CountResponse& from);
+
+  inline CountResponse& operator=(const CountResponse& from) {
+    CopyFrom(from);
+    return *this;
+  }
+
+  inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
+    return _unknown_fields_;
+  }
+
+  inline ::google::protobuf::UnknownFieldSet* mutable_unknown_fields() {
+    return &_unknown_fields_;
+  }
+
+  static const ::google::protobuf::Descriptor* descriptor();
+  static const CountResponse& default_instance();
+
+  void Swap(CountResponse* other);
+
+  // implements Message ----------------------------------------------
+
+  CountResponse* New() const;
+  CountResponse* New(::google::protobuf::Arena* arena) const;
+  void CopyFrom(const ::google::protobuf::Message& from);
+  void MergeFrom(const ::google::protobuf::Message& from);
+  void CopyFrom(const CountResponse& from);
+  void MergeFrom(const CountResponse& from);
+  void Clear();
+  bool IsInitialized() const;
+
+  int ByteSize() const;
+  bool MergePartialFromCodedStream(
+      ::google::protobuf::io::CodedInputStream* input);
+  void SerializeWithCachedSizes(
+      ::google::protobuf::io::CodedOutputStream* output) const;
+  ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;
+  void SerializeReverse(
+      ::google::protobuf::io::ReverseCodedOutputStream* output) const;
+  int GetCachedSize() const { return _cached_size_; }
+  private:
+  void SharedCtor();
+  void SharedDtor();
+  void SetCachedSize(int size) const;
+  public:
+
+  ::google::protobuf::Metadata GetMetadata() const;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  // optional int32 count = 1;
+  inline bool has_count() const;
+  inline void clear_count();
+  static const int kCountFieldNumber = 1;
+  inline ::google::protobuf::int32 count() const;
+  inline void set_count(::google::protobuf::int32 value);
+
+  // @@protoc_insertion_point(class_scope:service_test.CountResponse)
+ private:
+  inline void set_has_count();
+  inline void clear_has_count();
+
+  ::google::protobuf::UnknownFieldSet _unknown_fields_;
+
+  ::google::protobuf::int32 count_;
+
+  mutable int _cached_size_;
+  ::google::protobuf::uint32 _has_bits_[(1 + 31) / 32];
+
+  friend void  protobuf_AddDesc_service_5ftest_2eproto();
+  friend void protobuf_AssignDesc_service_5ftest_2eproto();
+  friend void protobuf_ShutdownFile_service_5ftest_2eproto();
+
+  void InitAsDefaultInstance();
+  static CountResponse* default_instance_;
+};
+// ===================================================================
+
+class TestService_Stub;
+
+class TestService : public ::google::protobuf::Service {
+ protected:
+  // This class should be treated as an abstract interface.
+  inline TestService() {};
+ public:
+  virtual ~TestService();
+
+  typedef TestService_Stub Stub;
+
+  static const ::google::protobuf::ServiceDescriptor* descriptor();
+
+  virtual void Double(::google::protobuf::RpcController* controller,
+                       const ::service_test::Request* request,
+                       ::service_test::Response* response,
+                       ::google::protobuf::Closure* done);
+  virtual void DoubleLater(::google::protobuf::RpcController* controller,
+                       const ::service_test::Request* request,
+                       ::service_test::Response* response,
+                       ::google::protobuf::Closure* done);
+  virtual void Finished(::google::protobuf::RpcController* controller,
+                       const ::service_test::CountRequest* request,
+                       ::service_test::CountResponse* response,
+                       ::google::protobuf::Closure* done);
+
+  // implements Service ----------------------------------------------
+
+  const ::google::protobuf::ServiceDescriptor* GetDescriptor();
+  void CallMethod(const ::google::protobuf::MethodDescriptor* method,
+                  ::google::protobuf::RpcController* controller,
+                  const ::google::protobuf::Message* request,
+                  ::google::protobuf::Message* response,
+                  ::google::protobuf::Closure* done);
+  const ::google::protobuf::Message& GetRequestPrototype(
+    const ::google::protobuf::MethodDescriptor* method) const;
+  const ::google::protobuf::Message& GetResponsePrototype(
+    const ::google::protobuf::MethodDescriptor* method) const;
+
+ private:
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(TestService);
+};
+
+class TestService_Stub : public TestService {
+ public:
+  TestService_Stub(::google::protobuf::RpcChannel* channel);
+  TestService_Stub(::google::protobuf::RpcChannel* channel,
+                   ::google::protobuf::Service::ChannelOwnership ownership);
+  ~TestService_Stub();
+
+  inline ::google::protobuf::RpcChannel* channel() { return channel_; }
+
+  // implements TestService ------------------------------------------
+
+  void Double(::google::protobuf::RpcController* controller,
+                       const ::service_test::Request* request,
+                       ::service_test::Response* response,
+                       ::google::protobuf::Closure* done);
+  void DoubleLater(::google::protobuf::RpcController* controller,
+                       const ::service_test::Request* request,
+                       ::service_test::Response* response,
+                       ::google::protobuf::Closure* done);
+  void Finished(::google::protobuf::RpcController* controller,
+                       const ::service_test::CountRequest* request,
+                       ::service_test::CountResponse* response,
+                       ::google::protobuf::Closure* done);
+ private:
+  ::google::protobuf::RpcChannel* channel_;
+  bool owns_channel_;
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(TestService_Stub);
+};
+
+
+// ===================================================================
+
+
+// ===================================================================
+
+// Request
+
+// optional int32 value = 1;
+inline bool Request::has_value() const {
+  return (_has_bits_[0] & 0x00000001u) != 0;
+}
+inline void Request::set_has_value() {
+  _has_bits_[0] |= 0x00000001u;
+}
+inline void Request::clear_has_value() {
+  _has_bits_[0] &= ~0x00000001u;
+}
+inline void Request::clear_value() {
+  value_ = 0;
+  clear_has_value();
+}
+inline ::google::protobuf::int32 Request::value() const {
+  return value_;
+}
+inline void Request::set_value(::google::protobuf::int32 value) {
+  set_has_value();
+  value_ = value;
+}
+
+// optional string error = 2;
+inline bool Request::has_error() const {
+  return (_has_bits_[0] & 0x00000002u) != 0;
+}
+inline void Request::set_has_error() {
+  _has_bits_[0] |= 0x00000002u;
+}
+inline void Request::clear_has_error() {
+  _has_bits_[0] &= ~0x00000002u;
+}
+inline void Request::clear_error() {
+  if (error_ != &::google::protobuf::internal::kEmptyString) {
+    error_->clear();
+  }
+  clear_has_error();
+}
+inline const ::std::string& Request::error() const {
+  return *error_;
+}
+inline void Request::set_error(const ::std::string& value) {
+  set_has_error();
+  if (error_ == &::google::protobuf::internal::kEmptyString) {
+    error_ = new ::std::string;
+  }
+  error_->assign(value);
+}
+inline void Request::set_error(const char* value) {
+  set_has_error();
+  if (error_ == &::google::protobuf::internal::kEmptyString) {
+    error_ = new ::std::string;
+  }
+  error_->assign(value);
+}
+inline void Request::set_error(const char* value, size_t size) {
+  set_has_error();
+  if (error_ == &::google::protobuf::internal::kEmptyString) {
+    error_ = new ::std::string;
+  }
+  error_->assign(reinterpret_cast<const char*>(value), size);
+}
+inline ::std::string* Request::mutable_error() {
+  set_has_error();
+  if (error_ == &::google::protobuf::internal::kEmptyString) {
+    error_ = new ::std::string;
+  }
+  return error_;
+}
+inline ::std::string* Request::release_error() {
+  clear_has_error();
+  if (error_ == &::google::protobuf::internal::kEmptyString) {
+    return NULL;
+  } else {
+    ::std::string* temp = error_;
+    error_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+    return temp;
+  }
+}
+inline void Request::set_allocated_error(::std::string* error) {
+  if (error_ != &::google::protobuf::internal::kEmptyString) {
+    delete error_;
+  }
+  if (error) {
+    set_has_error();
+    error_ = error;
+  } else {
+    clear_has_error();
+    error_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  }
+}
+
+// -------------------------------------------------------------------
+
+// Response
+
+// optional int32 value = 1;
+inline bool Response::has_value() const {
+  return (_has_bits_[0] & 0x00000001u) != 0;
+}
+inline void Response::set_has_value() {
+  _has_bits_[0] |= 0x00000001u;
+}
+inline void Response::clear_has_value() {
+  _has_bits_[0] &= ~0x00000001u;
+}
+inline void Response::clear_value() {
+  value_ = 0;
+  clear_has_value();
+}
+inline ::google::protobuf::int32 Response::value() const {
+  return value_;
+}
+inline void Response::set_value(::google::protobuf::int32 value) {
+  set_has_value();
+  value_ = value;
+}
+
+// -------------------------------------------------------------------
+
+// CountRequest
+
+// -------------------------------------------------------------------
+
+// CountResponse
+
+// optional int32 count = 1;
+inline bool CountResponse::has_count() const {
+  return (_has_bits_[0] & 0x00000001u) != 0;
+}
+inline void CountResponse::set_has_count() {
+  _has_bits_[0] |= 0x00000001u;
+}
+inline void CountResponse::clear_has_count() {
+  _has_bits_[0] &= ~0x00000001u;
+}
+inline void CountResponse::clear_count() {
+  count_ = 0;
+  clear_has_count();
+}
+inline ::google::protobuf::int32 CountResponse::count() const {
+  return count_;
+}
+inline void CountResponse::set_count(::google::protobuf::int32 value) {
+  set_has_count();
+  count_ = value;
+}
+
+
+// @@protoc_insertion_point(namespace_scope)
+
+}  // namespace service_test
+
+#ifndef SWIG
+namespace google {
+namespace protobuf {
+
+
+}  // namespace google
+}  // namespace protobuf
+#endif  // SWIG
+
+// @@protoc_insertion_point(global_scope)
+
+#endif  // PROTOBUF_service_5ftest_2eproto__INCLUDED